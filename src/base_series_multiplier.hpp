@@ -24,6 +24,7 @@
 #include <algorithm>
 #include <array>
 #include <boost/numeric/conversion/cast.hpp>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
 #include <future>
@@ -39,6 +40,7 @@
 #include "config.hpp"
 #include "detail/atomic_utils.hpp"
 #include "detail/gcd.hpp"
+#include "detail/hll_sketch.hpp"
 #include "exceptions.hpp"
 #include "key_is_multipliable.hpp"
 #include "mp_integer.hpp"
@@ -120,7 +122,7 @@ struct base_series_multiplier_impl
 			future_list<std::future<void>> ff_list;
 			try {
 				for (unsigned i = 0u; i < n_threads; ++i) {
-					ff_list.push_back(thread_pool::enqueue(i,thread_func,i,c,&(vv[static_cast<vv_size_t>(i)])));
+					ff_list.push_back(thread_pool::enqueue_task(i,thread_func,i,c,&(vv[static_cast<vv_size_t>(i)])));
 				}
 				// First let's wait for everything to finish.
 				ff_list.wait_all();
@@ -148,34 +150,126 @@ struct base_series_multiplier_impl<Series,Derived,typename std::enable_if<is_mp_
 	using rat_type = typename term_type::cf_type;
 	using int_type = typename std::decay<decltype(std::declval<rat_type>().num())>::type;
 	using container_type = typename std::decay<decltype(std::declval<Series>()._container())>::type;
+	using c_size_type = typename container_type::size_type;
+	// Run f(thread_idx,start_idx,end_idx) over n_threads ranges of buckets of c.
+	template <typename F>
+	static void bucket_range_apply(const container_type &c, unsigned n_threads, const F &f)
+	{
+		piranha_assert(n_threads > 0u);
+		if (n_threads == 1u) {
+			f(0u,c_size_type(0u),c.bucket_count());
+			return;
+		}
+		const auto bpt = static_cast<c_size_type>(c.bucket_count() / n_threads);
+		future_list<decltype(thread_pool::enqueue(0u,f,0u,c_size_type(0u),c_size_type(0u)))> ff_list;
+		try {
+			for (unsigned i = 0u; i < n_threads; ++i) {
+				const auto start_idx = static_cast<c_size_type>(bpt * i);
+				// Special casing for the last thread.
+				const auto end_idx = (i == n_threads - 1u) ? c.bucket_count() : static_cast<c_size_type>(bpt * (i + 1u));
+				ff_list.push_back(thread_pool::enqueue_task(i,f,i,start_idx,end_idx));
+			}
+			// First let's wait for everything to finish.
+			ff_list.wait_all();
+			// Then, let's handle the exceptions.
+			ff_list.get_all();
+		} catch (...) {
+			ff_list.wait_all();
+			throw;
+		}
+	}
+	// Update l with the least common multiple of l and n. All quantities are positive.
+	static void lcm_update(int_type &l, const int_type &n)
+	{
+		// Unitary denominators are very common, skip them.
+		if (math::is_unitary(n)) {
+			return;
+		}
+		const auto g = gcd(l,n);
+		// If n divides l there is nothing to do.
+		if (g == n) {
+			return;
+		}
+		// NOTE: divide before multiplying to keep the intermediate result small.
+		l *= n / g;
+	}
+	// Compute the least common multiple of the denominators in c, with each thread
+	// reducing a separate range of buckets.
+	static void container_lcm(int_type &l, const container_type &c, unsigned n_threads)
+	{
+		std::vector<int_type> partial(safe_cast<typename std::vector<int_type>::size_type>(n_threads),int_type(1));
+		bucket_range_apply(c,n_threads,[&c,&partial](unsigned t_idx, c_size_type start_idx, c_size_type end_idx) {
+			auto &p = partial[static_cast<typename std::vector<int_type>::size_type>(t_idx)];
+			for (; start_idx != end_idx; ++start_idx) {
+				for (const auto &t: c._get_bucket_list(start_idx)) {
+					lcm_update(p,t.m_cf.den());
+				}
+			}
+		});
+		for (const auto &p: partial) {
+			lcm_update(l,p);
+		}
+	}
+	// Copy the terms of c into v renormalising them to the lcm, with each thread writing
+	// into a separate, precomputed, range of v.
+	void renormalise(const container_type &c, std::vector<term_type> &v, unsigned n_threads) const
+	{
+		using v_size_type = typename std::vector<term_type>::size_type;
+		v.resize(safe_cast<v_size_type>(c.size()));
+		// Compute the offset in v of the first term of each range of buckets.
+		const auto bpt = static_cast<c_size_type>(c.bucket_count() / n_threads);
+		std::vector<v_size_type> offsets(safe_cast<v_size_type>(n_threads),v_size_type(0u));
+		v_size_type cur = 0u;
+		c_size_type idx = 0u;
+		for (unsigned i = 0u; i < n_threads; ++i) {
+			offsets[static_cast<v_size_type>(i)] = cur;
+			const auto end_idx = (i == n_threads - 1u) ? c.bucket_count() : static_cast<c_size_type>(bpt * (i + 1u));
+			for (; idx != end_idx; ++idx) {
+				const auto &b = c._get_bucket_list(idx);
+				cur = static_cast<v_size_type>(cur + static_cast<v_size_type>(std::distance(b.begin(),b.end())));
+			}
+		}
+		piranha_assert(cur == v.size());
+		bucket_range_apply(c,n_threads,[&c,&v,&offsets,this](unsigned t_idx, c_size_type start_idx, c_size_type end_idx) {
+			auto i = offsets[static_cast<v_size_type>(t_idx)];
+			for (; start_idx != end_idx; ++start_idx) {
+				for (const auto &t: c._get_bucket_list(start_idx)) {
+					// NOTE: the denominator of the new coefficient is one, so the numerator can be set directly.
+					auto &cf = v[i].m_cf;
+					cf._num() = this->m_lcm / t.m_cf.den();
+					cf._num() *= t.m_cf.num();
+					v[i].m_key = t.m_key;
+					++i;
+				}
+			}
+		});
+	}
 	void fill_term_pointers(const container_type &c1, const container_type &c2,
 		std::vector<term_type const *> &v1, std::vector<term_type const *> &v2)
 	{
+		// Fetch the number of threads from the derived class.
+		const unsigned n_threads = static_cast<Derived *>(this)->m_n_threads;
+		piranha_assert(n_threads > 0u);
 		// Compute the least common multiplier.
 		m_lcm = 1;
-		auto it_f = c1.end();
-		for (auto it = c1.begin(); it != it_f; ++it) {
-			m_lcm = (m_lcm * it->m_cf.den()) / gcd(m_lcm,it->m_cf.den());
-		}
-		it_f = c2.end();
-		for (auto it = c2.begin(); it != it_f; ++it) {
-			m_lcm = (m_lcm * it->m_cf.den()) / gcd(m_lcm,it->m_cf.den());
-		}
+		container_lcm(m_lcm,c1,n_threads);
+		container_lcm(m_lcm,c2,n_threads);
 		// All these computations involve only positive numbers,
 		// the GCD must always be positive.
 		piranha_assert(m_lcm.sign() == 1);
-		// Copy over the terms and renormalise to lcm.
-		it_f = c1.end();
-		for (auto it = c1.begin(); it != it_f; ++it) {
-			m_terms1.push_back(term_type(rat_type(m_lcm / it->m_cf.den() * it->m_cf.num(),int_type(1)),it->m_key));
-		}
-		it_f = c2.end();
-		for (auto it = c2.begin(); it != it_f; ++it) {
-			m_terms2.push_back(term_type(rat_type(m_lcm / it->m_cf.den() * it->m_cf.num(),int_type(1)),it->m_key));
+		if (math::is_unitary(m_lcm)) {
+			// All the coefficients are integral already: no renormalisation is needed and
+			// the original terms can be used directly.
+			std::transform(c1.begin(),c1.end(),std::back_inserter(v1),[](const term_type &t) {return &t;});
+			std::transform(c2.begin(),c2.end(),std::back_inserter(v2),[](const term_type &t) {return &t;});
+		} else {
+			// Copy over the terms and renormalise to lcm.
+			renormalise(c1,m_terms1,n_threads);
+			renormalise(c2,m_terms2,n_threads);
+			// Copy over the pointers.
+			std::transform(m_terms1.begin(),m_terms1.end(),std::back_inserter(v1),[](const term_type &t) {return &t;});
+			std::transform(m_terms2.begin(),m_terms2.end(),std::back_inserter(v2),[](const term_type &t) {return &t;});
 		}
-		// Copy over the pointers.
-		std::transform(m_terms1.begin(),m_terms1.end(),std::back_inserter(v1),[](const term_type &t) {return &t;});
-		std::transform(m_terms2.begin(),m_terms2.end(),std::back_inserter(v2),[](const term_type &t) {return &t;});
 		piranha_assert(v1.size() == c1.size());
 		piranha_assert(v2.size() == c2.size());
 	}
@@ -275,7 +369,7 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 				const bucket_size_type end_idx = t_idx == (this->m_n_threads - 1u) ? container.bucket_count() :
 					static_cast<bucket_size_type>((t_idx + 1u) * bpt);
 				for (; start_idx != end_idx; ++start_idx) {
-					auto &list = container._get_bucket_list(start_idx);
+					const auto &list = container._get_bucket_list(start_idx);
 					for (const auto &t: list) {
 						t.m_cf._set_den(l2);
 						t.m_cf.canonicalise();
@@ -286,7 +380,7 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 			future_list<decltype(thread_pool::enqueue(0u,thread_func,0u))> ff_list;
 			try {
 				for (unsigned i = 0u; i < m_n_threads; ++i) {
-					ff_list.push_back(thread_pool::enqueue(i,thread_func,i));
+					ff_list.push_back(thread_pool::enqueue_task(i,thread_func,i));
 				}
 				// First let's wait for everything to finish.
 				ff_list.wait_all();
@@ -325,7 +419,7 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 		explicit base_series_multiplier(const Series &s1, const Series &s2):m_ss(s1.get_symbol_set()),
 			m_n_threads((s1.size() && s2.size()) ?
 			thread_pool::use_threads(integer(s1.size()) * s2.size(),integer(settings::get_min_work_per_thread())) :
-			1u)
+			1u),m_est_data()
 		{
 			if (unlikely(s1.get_symbol_set() != s2.get_symbol_set())) {
 				piranha_throw(std::invalid_argument,"incompatible arguments sets");
@@ -351,6 +445,25 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 		base_series_multiplier &operator=(const base_series_multiplier &) = delete;
 		/// Deleted move assignment operator.
 		base_series_multiplier &operator=(base_series_multiplier &&) = delete;
+		/// Estimate the size of the result of the multiplication.
+		/**
+		 * \note
+		 * This method is enabled only if the coefficient and key types of \p Series satisfy piranha::key_is_multipliable.
+		 *
+		 * This method is used outside the multiplication routines to gauge the cost of a multiplication (e.g., in
+		 * piranha::series::pow()). Derived classes can hide it in order to account for features of their multiplication
+		 * algorithms (e.g., truncation).
+		 *
+		 * @return the output of estimate_final_series_size() with base_series_multiplier::plain_multiplier as multiplication functor.
+		 *
+		 * @throws unspecified any exception thrown by estimate_final_series_size().
+		 */
+		template <typename T = Series, typename std::enable_if<key_is_multipliable<typename T::term_type::cf_type,
+			typename T::term_type::key_type>::value,int>::type = 0>
+		bucket_size_type estimate_result_size() const
+		{
+			return estimate_final_series_size<T::term_type::key_type::multiply_arity,plain_multiplier<false>>();
+		}
 	protected:
 		/// Blocked multiplication.
 		/**
@@ -476,9 +589,11 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 		 * term of the first series by the <tt>j</tt>-th term of the second series, accumulating the result into the \p Series
 		 * passed as second parameter for construction.
 		 *
-		 * This method will apply a statistical approach to estimate the final size of the result of the multiplication of the first
-		 * series by the second. It will perform random term-by-term multiplications
-		 * and deduce the estimate from the number of term multiplications performed before finding the first duplicate term.
+		 * This method will estimate the final size of the result of the multiplication of the first series by the second,
+		 * using the method selected by piranha::tuning::get_size_estimator() (see the documentation of that method for
+		 * a description of the available methods). If one of the two series has a single term, the estimate is exact.
+		 * The method used, the estimate and the time spent computing it are recorded, and they will be passed to the size estimation
+		 * hook (if any) by finalise_series().
 		 * The \p MultArity parameter represents the arity of term multiplications - that is, the number of terms generated by a single
 		 * term-by-term multiplication. It must be strictly positive.
 		 *
@@ -508,17 +623,57 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 			PIRANHA_TT_CHECK(is_function_object,MultFunctor,void,const size_type &, const size_type &);
 			PIRANHA_TT_CHECK(std::is_constructible,MultFunctor,const base_series_multiplier &, Series &);
 			PIRANHA_TT_CHECK(is_function_object,LimitFunctor,size_type,const size_type &);
+			static_assert(MultArity > 0u,"Invalid multiplication arity.");
 			// Cache these.
 			const size_type size1 = m_v1.size(), size2 = m_v2.size();
-			constexpr std::size_t result_size = MultArity;
-			// If one of the two series is empty, just return 0.
+			const auto method = tuning::get_size_estimator();
+			const auto t_start = std::chrono::steady_clock::now();
+			bucket_size_type retval;
 			if (unlikely(!size1 || !size2)) {
-				return 1u;
+				// If one of the two series is empty, just return 1.
+				retval = 1u;
+			} else if (size1 == 1u || size2 == 1u) {
+				// If either series has a size of 1, just return size1 * size2 * MultArity.
+				retval = static_cast<bucket_size_type>(integer(size1) * size2 * MultArity);
+			} else if (method == size_estimator::distinct_count) {
+				retval = estimate_distinct_count<MultArity,MultFunctor>(lf);
+			} else if (method == size_estimator::upper_bound) {
+				retval = estimate_upper_bound<MultArity>(lf);
+			} else {
+				retval = estimate_first_duplicate<MultArity,MultFunctor>(lf);
 			}
-			// If either series has a size of 1, just return size1 * size2 * result_size.
-			if (size1 == 1u || size2 == 1u) {
-				return static_cast<bucket_size_type>(integer(size1) * size2 * result_size);
+			m_est_data = estimation_data{true,method,retval,
+				std::chrono::duration<double>(std::chrono::steady_clock::now() - t_start).count()};
+			return retval;
+		}
+		/// Limit the size estimate.
+		/**
+		 * This method can be used by derived classes to refine, via an exact upper \p bound on the size of the result
+		 * of the multiplication, the output of the last call to estimate_final_series_size(). If the last estimation
+		 * was performed with the piranha::size_estimator::upper_bound method and \p estimate is greater than \p bound,
+		 * \p estimate will be set to \p bound (or 1, if \p bound is zero), and the new value will be the one passed
+		 * to the size estimation hook. Otherwise, this method has no effect.
+		 *
+		 * @param[in,out] estimate the size estimate to be limited.
+		 * @param[in] bound an upper bound on the size of the result of the multiplication.
+		 *
+		 * @throws unspecified any exception thrown by the conversion operator of piranha::integer.
+		 */
+		void limit_size_estimate(bucket_size_type &estimate, const integer &bound) const
+		{
+			if (!m_est_data.m_valid || m_est_data.m_method != size_estimator::upper_bound || bound >= estimate) {
+				return;
 			}
+			estimate = (bound.sign() == 0) ? bucket_size_type(1u) : static_cast<bucket_size_type>(bound);
+			m_est_data.m_estimate = estimate;
+		}
+	private:
+		// First duplicate estimation method.
+		template <std::size_t MultArity, typename MultFunctor, typename LimitFunctor>
+		bucket_size_type estimate_first_duplicate(const LimitFunctor &lf) const
+		{
+			const size_type size1 = m_v1.size();
+			constexpr std::size_t result_size = MultArity;
 			// NOTE: Hard-coded number of trials.
 			// NOTE: here consider that in case of extremely sparse series with few terms this will incur in noticeable
 			// overhead, since we will need many term-by-term before encountering the first duplicate.
@@ -643,7 +798,7 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 				future_list<std::future<void>> f_list;
 				try {
 					for (unsigned i = 0u; i < n_threads; ++i) {
-						f_list.push_back(thread_pool::enqueue(i,estimator,i));
+						f_list.push_back(thread_pool::enqueue_task(i,estimator,i));
 					}
 					// First let's wait for everything to finish.
 					f_list.wait_all();
@@ -658,6 +813,181 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 			// Return the mean.
 			return static_cast<bucket_size_type>(c_estimate / n_trials);
 		}
+		// Distinct count estimation method. A fixed number of term-by-term multiplications is performed, sampling
+		// the pairs of terms uniformly, and the number D of distinct terms generated is counted with a HyperLogLog
+		// sketch. Assuming that each term of the result is generated by the same number of pairs, after T random
+		// draws a result with M terms yields on average D = M * (1 - exp(-T / M)) distinct terms, and this relation
+		// is inverted to give the estimate. If the total number of term-by-term multiplications is not larger
+		// than the sample size, all the multiplications are performed instead and the estimate is D.
+		template <std::size_t MultArity, typename MultFunctor, typename LimitFunctor>
+		bucket_size_type estimate_distinct_count(const LimitFunctor &lf) const
+		{
+			const size_type size1 = m_v1.size();
+			// NOTE: hard-coded sample size and number of sampling chunks. Each chunk uses its own random engine,
+			// seeded with the chunk index, so that the estimate does not depend on the number of threads.
+			const size_type n_samples = 32768u;
+			const unsigned n_chunks = 16u;
+			// Number of terms in tmp after which they are added to the sketch and tmp is cleared.
+			const bucket_size_type flush_size = 1024u;
+			// Number of term-by-term multiplications in the full product, and the weights for
+			// the random selection of the terms in the first series.
+			integer n_pairs(0);
+			std::vector<double> weights;
+			weights.reserve(static_cast<typename std::vector<double>::size_type>(size1));
+			for (size_type i = 0u; i < size1; ++i) {
+				const size_type l = lf(i);
+				n_pairs += l;
+				weights.push_back(static_cast<double>(l));
+			}
+			if (n_pairs.sign() == 0) {
+				return 1u;
+			}
+			const bool exhaustive = n_pairs <= n_samples;
+			const unsigned n_threads = (n_chunks >= m_n_threads) ? m_n_threads : n_chunks;
+			using dist1_type = std::discrete_distribution<size_type>;
+			using dist2_type = std::uniform_int_distribution<size_type>;
+			const dist1_type dist1(weights.begin(),weights.end());
+			detail::hll_sketch sketch;
+			std::mutex mut;
+			auto estimator = [&lf,&sketch,&mut,&dist1,size1,n_samples,n_chunks,flush_size,exhaustive,n_threads,this]
+				(unsigned thread_idx)
+			{
+				Series tmp;
+				tmp.set_symbol_set(m_ss);
+				MultFunctor mf(*this,tmp);
+				detail::hll_sketch local;
+				auto flush = [&tmp,&local]() {
+					for (const auto &t: tmp._container()) {
+						local.add(t.hash());
+					}
+					tmp._container().clear();
+				};
+				std::mt19937 engine;
+				auto d1 = dist1;
+				dist2_type d2;
+				for (unsigned c = thread_idx; c < n_chunks; c += n_threads) {
+					if (exhaustive) {
+						// Multiply all the pairs in the c-th range of terms of the first series.
+						const auto start = static_cast<size_type>(size1 / n_chunks * c),
+							end = (c == n_chunks - 1u) ? size1 : static_cast<size_type>(size1 / n_chunks * (c + 1u));
+						for (size_type i = start; i < end; ++i) {
+							const size_type limit = lf(i);
+							for (size_type j = 0u; j < limit; ++j) {
+								mf(i,j);
+								if (tmp.size() >= flush_size) {
+									flush();
+								}
+							}
+						}
+					} else {
+						engine.seed(static_cast<std::mt19937::result_type>(c));
+						d1.reset();
+						const auto cur_samples = (c == n_chunks - 1u) ? static_cast<size_type>(n_samples - n_samples / n_chunks * c) :
+							static_cast<size_type>(n_samples / n_chunks);
+						for (size_type n = 0u; n < cur_samples; ++n) {
+							const size_type i = d1(engine);
+							piranha_assert(lf(i) > 0u);
+							mf(i,d2(engine,typename dist2_type::param_type(static_cast<size_type>(0u),
+								static_cast<size_type>(lf(i) - 1u))));
+							if (tmp.size() >= flush_size) {
+								flush();
+							}
+						}
+					}
+				}
+				flush();
+				std::lock_guard<std::mutex> lock(mut);
+				sketch.merge(local);
+			};
+			if (n_threads == 1u) {
+				estimator(0u);
+			} else {
+				future_list<std::future<void>> f_list;
+				try {
+					for (unsigned i = 0u; i < n_threads; ++i) {
+						f_list.push_back(thread_pool::enqueue_task(i,estimator,i));
+					}
+					// First let's wait for everything to finish.
+					f_list.wait_all();
+					// Then, let's handle the exceptions.
+					f_list.get_all();
+				} catch (...) {
+					f_list.wait_all();
+					throw;
+				}
+			}
+			// Number of distinct terms in the sample, and the maximum possible size of the result.
+			const double d = sketch.estimate(), max_size = static_cast<double>(n_pairs * MultArity);
+			double retval;
+			if (exhaustive) {
+				retval = std::min(d,max_size);
+			} else {
+				const double t = static_cast<double>(n_samples) * static_cast<double>(MultArity);
+				auto f = [t](double m) {return m * -std::expm1(-t / m);};
+				if (d >= f(max_size)) {
+					retval = max_size;
+				} else {
+					// Solve f(m) = d with a bisection in logarithmic scale, f being monotonically increasing.
+					double lo = std::max(d,1.), hi = max_size;
+					for (int i = 0; i < 100 && hi > lo * (1. + 1E-6); ++i) {
+						const double mid = std::sqrt(lo * hi);
+						if (f(mid) < d) {
+							lo = mid;
+						} else {
+							hi = mid;
+						}
+					}
+					retval = hi;
+				}
+			}
+			retval = std::ceil(retval);
+			if (!std::isfinite(retval) || retval >= static_cast<double>(std::numeric_limits<bucket_size_type>::max())) {
+				return std::numeric_limits<bucket_size_type>::max();
+			}
+			return (retval < 1.) ? bucket_size_type(1u) : static_cast<bucket_size_type>(retval);
+		}
+		// Upper bound estimation method: the total number of terms generated by the term-by-term multiplications.
+		template <std::size_t MultArity, typename LimitFunctor>
+		bucket_size_type estimate_upper_bound(const LimitFunctor &lf) const
+		{
+			const size_type size1 = m_v1.size();
+			integer retval(0);
+			for (size_type i = 0u; i < size1; ++i) {
+				retval += lf(i);
+			}
+			retval *= MultArity;
+			if (retval.sign() == 0) {
+				return 1u;
+			}
+			if (retval > std::numeric_limits<bucket_size_type>::max()) {
+				return std::numeric_limits<bucket_size_type>::max();
+			}
+			return static_cast<bucket_size_type>(retval);
+		}
+	protected:
+		/// Default key multiplication functor.
+		/**
+		 * This functor will multiply two terms via the <tt>multiply()</tt> method of the key type of \p Series
+		 * (see piranha::key_is_multipliable). It is used by default by base_series_multiplier::plain_multiplier
+		 * and base_series_multiplier::plain_multiplication().
+		 */
+		struct default_key_multiplier
+		{
+			/// Call operator.
+			/**
+			 * @param[out] res the result of the multiplication.
+			 * @param[in] t1 first argument.
+			 * @param[in] t2 second argument.
+			 * @param[in] args reference set of piranha::symbol.
+			 *
+			 * @throws unspecified any exception thrown by the <tt>multiply()</tt> method of the key type of \p Series.
+			 */
+			template <typename ResArray, typename Term>
+			void operator()(ResArray &res, const Term &t1, const Term &t2, const symbol_set &args) const
+			{
+				Term::key_type::multiply(res,t1,t2,args);
+			}
+		};
 		/// Estimate size of series multiplication (convenience overload)
 		/**
 		 * @return the output of the other overload of estimate_final_series_size(), with a limit
@@ -679,14 +1009,16 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 		 * This is a functor that conforms to the protocol expected by base_series_multiplier::blocked_multiplication() and
 		 * base_series_multiplier::estimate_final_series_size().
 		 *
-		 * This functor requires that the key and coefficient types of \p Series satisfy piranha::key_is_multipliable, and it will
-		 * use the key's <tt>multiply()</tt> method to perform term-by-term multiplications.
+		 * This functor requires that the key and coefficient types of \p Series satisfy piranha::key_is_multipliable. The
+		 * term-by-term multiplications are performed via an instance of \p KeyMultiplier, which must be a function object
+		 * with the same signature as the <tt>multiply()</tt> method of the key type. By default,
+		 * base_series_multiplier::default_key_multiplier is used, which will call the key's <tt>multiply()</tt> method.
 		 *
 		 * If the \p FastMode boolean parameter is \p true, then the call operator will insert terms into the return value series
 		 * using the low-level interface of piranha::hash_set, otherwise the call operator will use piranha::series::insert() for
 		 * term insertion.
 		 */
-		template <bool FastMode>
+		template <bool FastMode, typename KeyMultiplier = default_key_multiplier>
 		class plain_multiplier
 		{
 				using term_type = typename Series::term_type;
@@ -702,9 +1034,10 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 				 * @param[in] bsm a const reference to an instance of piranha::base_series_multiplier, from which
 				 * the vectors of term pointers will be extracted.
 				 * @param[in] retval the \p Series instance into which terms resulting from multiplications will be inserted.
+				 * @param[in] km the key multiplication functor.
 				 */
-				explicit plain_multiplier(const base_series_multiplier &bsm, Series &retval):
-					m_v1(bsm.m_v1),m_v2(bsm.m_v2),m_retval(retval),m_c_end(retval._container().end())
+				explicit plain_multiplier(const base_series_multiplier &bsm, Series &retval, const KeyMultiplier &km = KeyMultiplier{}):
+					m_v1(bsm.m_v1),m_v2(bsm.m_v2),m_retval(retval),m_c_end(retval._container().end()),m_km(km)
 				{}
 				/// Deleted copy constructor.
 				plain_multiplier(const plain_multiplier &) = delete;
@@ -726,12 +1059,13 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 				 * - piranha::series::insert(),
 				 * - the low-level interface of piranha::hash_set,
 				 * - the in-place addition operator of the coefficient type,
-				 * - term construction.
+				 * - term construction,
+				 * - the call operator of \p KeyMultiplier.
 				 */
 				void operator()(const size_type &i, const size_type &j) const
 				{
 					// First perform the multiplication.
-					key_type::multiply(m_tmp_t,*m_v1[i],*m_v2[j],m_retval.get_symbol_set());
+					m_km(m_tmp_t,*m_v1[i],*m_v2[j],m_retval.get_symbol_set());
 					for (std::size_t n = 0u; n < m_arity; ++n) {
 						auto &tmp_term = m_tmp_t[n];
 						if (FastMode) {
@@ -755,6 +1089,7 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 				const std::vector<term_type const *>	&m_v2;
 				Series					&m_retval;
 				const it_type				m_c_end;
+				const KeyMultiplier			m_km;
 		};
 		/// Sanitise series.
 		/**
@@ -853,24 +1188,14 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 				std::lock_guard<std::mutex> lock(m);
 				global_count += count;
 			};
-			future_list<decltype(thread_pool::enqueue(0u,eraser,bucket_size_type(),bucket_size_type()))> f_list;
-			try {
-				for (unsigned i = 0u; i < n_threads; ++i) {
-					const auto start = static_cast<bucket_size_type>((b_count / n_threads) * i),
-						end = static_cast<bucket_size_type>((i == n_threads - 1u) ? b_count : (b_count / n_threads) * (i + 1u));
-					f_list.push_back(thread_pool::enqueue(i,eraser,start,end));
-				}
-				// First let's wait for everything to finish.
-				f_list.wait_all();
-				// Then, let's handle the exceptions.
-				f_list.get_all();
-			} catch (...) {
-				f_list.wait_all();
-				// NOTE: there's not need to clear retval here - it was already in an inconsistent
-				// state coming into this method. We rather need to make sure sanitise_series() is always
-				// called in a try/catch block that clears retval in case of errors.
-				throw;
-			}
+			// NOTE: there's not need to clear retval in case of errors - it was already in an inconsistent
+			// state coming into this method. We rather need to make sure sanitise_series() is always
+			// called in a try/catch block that clears retval in case of errors.
+			thread_pool::parallel_invoke(n_threads,[&eraser,b_count,n_threads](unsigned i) {
+				const auto start = static_cast<bucket_size_type>((b_count / n_threads) * i),
+					end = static_cast<bucket_size_type>((i == n_threads - 1u) ? b_count : (b_count / n_threads) * (i + 1u));
+				eraser(start,end);
+			});
 			// Final update of the total count.
 			container._update_size(static_cast<bucket_size_type>(global_count));
 		}
@@ -885,11 +1210,14 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 		 * The implementation is either single-threaded or multi-threaded, depending on the sizes of the input series, and it will use
 		 * either base_series_multiplier::plain_multiplier or a similar thread-safe multiplier for the term-by-term multiplications.
 		 * The \p lf functor will be forwarded as limit functor to base_series_multiplier::blocked_multiplication()
-		 * and base_series_multiplier::estimate_final_series_size().
+		 * and base_series_multiplier::estimate_final_series_size(). The keys of the terms will be multiplied via \p km,
+		 * a function object with the same signature as the <tt>multiply()</tt> method of the key type
+		 * (see base_series_multiplier::plain_multiplier).
 		 *
-		 * Note that, in multithreaded mode, \p lf will be shared among (and called concurrently from) all the threads.
+		 * Note that, in multithreaded mode, \p lf and \p km will be shared among (and called concurrently from) all the threads.
 		 *
 		 * @param[in] lf the limit functor (see base_series_multiplier::blocked_multiplication()).
+		 * @param[in] km the key multiplication functor.
 		 *
 		 * @return the series resulting from the multiplication of the two series used to construct \p this.
 		 *
@@ -900,14 +1228,14 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 		 * - the public interface of piranha::hash_set,
 		 * - base_series_multiplier::blocked_multiplication(),
 		 * - base_series_multiplier::sanitise_series(),
-		 * - the <tt>multiply()</tt> method of the key type of \p Series,
+		 * - the call operator of \p km,
 		 * - thread_pool::enqueue(),
 		 * - future_list::push_back(),
 		 * - the construction of terms,
 		 * - in-place addition of coefficients.
 		 */
-		template <typename LimitFunctor>
-		Series plain_multiplication(const LimitFunctor &lf) const
+		template <typename LimitFunctor, typename KeyMultiplier = default_key_multiplier>
+		Series plain_multiplication(const LimitFunctor &lf, const KeyMultiplier &km = KeyMultiplier{}) const
 		{
 			// Shortcuts.
 			using term_type = typename Series::term_type;
@@ -943,7 +1271,7 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 			if (n_threads == 1u) {
 				try {
 					// Single-thread case.
-					blocked_multiplication(plain_multiplier<true>(*this,retval),0u,size1,lf);
+					blocked_multiplication(plain_multiplier<true,KeyMultiplier>(*this,retval,km),0u,size1,lf);
 					sanitise_series(retval,static_cast<unsigned>(n_threads));
 					finalise_series(retval);
 					return retval;
@@ -962,7 +1290,7 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 			try {
 				for (size_type idx = 0u; idx < n_threads; ++idx) {
 					// Thread functor.
-					auto tf = [idx,this,block_size,n_threads,&sl_array,&retval,&lf]()
+					auto tf = [idx,this,block_size,n_threads,&sl_array,&retval,&lf,&km]()
 					{
 						// Used to store the result of term multiplication.
 						std::array<term_type,key_type::multiply_arity> tmp_t;
@@ -971,10 +1299,10 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 						// Block functor.
 						// NOTE: this is very similar to the plain functor, but it does the bucket locking
 						// additionally.
-						auto f = [&c_end,&tmp_t,this,&retval,&sl_array] (const size_type &i, const size_type &j)
+						auto f = [&c_end,&tmp_t,this,&retval,&sl_array,&km] (const size_type &i, const size_type &j)
 						{
 							// Run the term multiplication.
-							key_type::multiply(tmp_t,*(this->m_v1[i]),*(this->m_v2[j]),retval.get_symbol_set());
+							km(tmp_t,*(this->m_v1[i]),*(this->m_v2[j]),retval.get_symbol_set());
 							for (std::size_t n = 0u; n < key_type::multiply_arity; ++n) {
 								auto &container = retval._container();
 								auto &tmp_term = tmp_t[n];
@@ -995,7 +1323,7 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 							static_cast<size_type>((idx + 1u) * block_size);
 						this->blocked_multiplication(f,static_cast<size_type>(idx * block_size),e1,lf);
 					};
-					f_list.push_back(thread_pool::enqueue(static_cast<unsigned>(idx),tf));
+					f_list.push_back(thread_pool::enqueue_task(static_cast<unsigned>(idx),tf));
 				}
 				f_list.wait_all();
 				f_list.get_all();
@@ -1029,13 +1357,28 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 		 *
 		 * @param[in,out] s the \p Series to be finalised.
 		 *
+		 * If a size estimation was performed via estimate_final_series_size() since the last call to this method,
+		 * the size estimation hook (if any) will be then called (see piranha::tuning::set_size_estimation_hook()).
+		 *
 		 * @throws unspecified any exception thrown by:
 		 * - thread_pool::enqueue(),
-		 * - future_list::push_back().
+		 * - future_list::push_back(),
+		 * - piranha::tuning::get_size_estimation_hook(),
+		 * - piranha::safe_cast().
 		 */
 		void finalise_series(Series &s) const
 		{
 			finalise_impl(s);
+			if (!m_est_data.m_valid) {
+				return;
+			}
+			m_est_data.m_valid = false;
+			const auto hook = tuning::get_size_estimation_hook();
+			if (hook) {
+				hook(size_estimation_record{m_est_data.m_method,safe_cast<std::size_t>(m_v1.size()),
+					safe_cast<std::size_t>(m_v2.size()),safe_cast<std::size_t>(m_est_data.m_estimate),
+					safe_cast<std::size_t>(s.size()),m_est_data.m_runtime});
+			}
 		}
 	protected:
 		/// Vector of const pointers to the terms in the larger series.
@@ -1051,6 +1394,16 @@ class base_series_multiplier: private detail::base_series_multiplier_impl<Series
 		 * via thread_pool::use_threads().
 		 */
 		const unsigned		m_n_threads;
+	private:
+		// Data about the last size estimation, to be passed to the size estimation hook.
+		struct estimation_data
+		{
+			bool			m_valid;
+			size_estimator		m_method;
+			bucket_size_type	m_estimate;
+			double			m_runtime;
+		};
+		mutable estimation_data	m_est_data;
 };
 
 }
@@ -268,8 +268,8 @@ struct binomial_impl<T,U,detail::integer_binomial_enabler<T,U>>
 	 *
 	 * @throws unspecified any exception thrown by piranha::mp_integer::binomial().
 	 */
-	template <int NBits>
-	mp_integer<NBits> operator()(const mp_integer<NBits> &x, const mp_integer<NBits> &y) const
+	template <int NBits, std::size_t NLimbs>
+	mp_integer<NBits,NLimbs> operator()(const mp_integer<NBits,NLimbs> &x, const mp_integer<NBits,NLimbs> &y) const
 	{
 		return x.binomial(y);
 	}
@@ -282,8 +282,8 @@ struct binomial_impl<T,U,detail::integer_binomial_enabler<T,U>>
 	 *
 	 * @throws unspecified any exception thrown by piranha::mp_integer::binomial().
 	 */
-	template <int NBits, typename T2, typename std::enable_if<std::is_integral<T2>::value,int>::type = 0>
-	mp_integer<NBits> operator()(const mp_integer<NBits> &x, const T2 &y) const
+	template <int NBits, std::size_t NLimbs, typename T2, typename std::enable_if<std::is_integral<T2>::value,int>::type = 0>
+	mp_integer<NBits,NLimbs> operator()(const mp_integer<NBits,NLimbs> &x, const T2 &y) const
 	{
 		return x.binomial(y);
 	}
@@ -297,8 +297,8 @@ struct binomial_impl<T,U,detail::integer_binomial_enabler<T,U>>
 	 * @throws unspecified any exception thrown by the conversion operator of piranha::mp_integer
 	 * or by piranha::math::binomial().
 	 */
-	template <int NBits, typename T2, typename std::enable_if<std::is_floating_point<T2>::value,int>::type = 0>
-	T2 operator()(const mp_integer<NBits> &x, const T2 &y) const
+	template <int NBits, std::size_t NLimbs, typename T2, typename std::enable_if<std::is_floating_point<T2>::value,int>::type = 0>
+	T2 operator()(const mp_integer<NBits,NLimbs> &x, const T2 &y) const
 	{
 		return math::binomial(static_cast<T2>(x),y);
 	}
@@ -312,10 +312,10 @@ struct binomial_impl<T,U,detail::integer_binomial_enabler<T,U>>
 	 * @throws unspecified any exception thrown by constructing piranha::mp_integer
 	 * or by piranha::mp_integer::binomial().
 	 */
-	template <int NBits, typename T2, typename std::enable_if<std::is_integral<T2>::value,int>::type = 0>
-	mp_integer<NBits> operator()(const T2 &x, const mp_integer<NBits> &y) const
+	template <int NBits, std::size_t NLimbs, typename T2, typename std::enable_if<std::is_integral<T2>::value,int>::type = 0>
+	mp_integer<NBits,NLimbs> operator()(const T2 &x, const mp_integer<NBits,NLimbs> &y) const
 	{
-		return mp_integer<NBits>(x).binomial(y);
+		return mp_integer<NBits,NLimbs>(x).binomial(y);
 	}
 	/// Call operator, floating-point--integer overload.
 	/**
@@ -327,8 +327,8 @@ struct binomial_impl<T,U,detail::integer_binomial_enabler<T,U>>
 	 * @throws unspecified any exception thrown by the conversion operator of piranha::mp_integer
 	 * or by piranha::math::binomial().
 	 */
-	template <int NBits, typename T2, typename std::enable_if<std::is_floating_point<T2>::value,int>::type = 0>
-	T2 operator()(const T2 &x, const mp_integer<NBits> &y) const
+	template <int NBits, std::size_t NLimbs, typename T2, typename std::enable_if<std::is_floating_point<T2>::value,int>::type = 0>
+	T2 operator()(const T2 &x, const mp_integer<NBits,NLimbs> &y) const
 	{
 		return math::binomial(x,static_cast<T2>(y));
 	}
@@ -0,0 +1,137 @@
+/***************************************************************************
+ *   Copyright (C) 2009-2011 by Francesco Biscani                          *
+ *   bluescarni@gmail.com                                                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef PIRANHA_DETAIL_CF_KERNELS_HPP
+#define PIRANHA_DETAIL_CF_KERNELS_HPP
+
+#include <gmp.h>
+#include <type_traits>
+
+#include "../config.hpp"
+#include "../exceptions.hpp"
+#include "../math.hpp"
+#include "../mp_integer.hpp"
+#include "../symbol_set.hpp"
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// Bulk kernels for the in-place transformation of all the coefficients of a series. A kernel is constructed
+// once from the scalar operand, so that any preprocessing of the scalar (conversions, checks, etc.) is not
+// repeated for each term, and it is then applied to each coefficient in turn.
+
+// Generic division kernel: cf /= y.
+template <typename Cf, typename T, typename = void>
+class cf_div_kernel
+{
+	public:
+		explicit cf_div_kernel(const T &y):m_y(y) {}
+		void operator()(Cf &cf) const
+		{
+			cf /= m_y;
+		}
+	private:
+		const T m_y;
+};
+
+// Division of mp_integer coefficients by an integral value or by an mp_integer. The divisor is converted and checked
+// only once. If its absolute value is a power of two, the division is performed with a bit shift, which for static storage
+// avoids the general division algorithm altogether.
+template <typename Cf, typename T>
+class cf_div_kernel<Cf,T,typename std::enable_if<is_mp_integer<Cf>::value &&
+	(std::is_integral<T>::value || std::is_same<T,Cf>::value)>::type>
+{
+	public:
+		explicit cf_div_kernel(const T &y):m_y(y),m_shift(0u),m_pow2(false),m_neg(false)
+		{
+			if (unlikely(math::is_zero(m_y))) {
+				piranha_throw(zero_division_error,"division by zero in mp_integer");
+			}
+			if (m_y.sign() < 0) {
+				m_neg = true;
+				m_y.negate();
+			}
+			const auto v = m_y.get_mpz_view();
+			const mpz_struct_t *p = v;
+			if (::mpz_popcount(p) == 1u) {
+				m_pow2 = true;
+				m_shift = ::mpz_scan1(p,0u);
+			}
+		}
+		void operator()(Cf &cf) const
+		{
+			if (m_pow2) {
+				cf.div_2exp(m_shift);
+			} else {
+				cf /= m_y;
+			}
+			// NOTE: truncated division by a negative value is the negation of the truncated
+			// division by its absolute value.
+			if (m_neg) {
+				cf.negate();
+			}
+		}
+	private:
+		// Absolute value of the divisor.
+		Cf		m_y;
+		::mp_bitcnt_t	m_shift;
+		bool		m_pow2;
+		bool		m_neg;
+};
+
+// Negation kernel.
+template <typename Cf>
+struct cf_negate_kernel
+{
+	void operator()(Cf &cf) const
+	{
+		math::negate(cf);
+	}
+};
+
+// Apply the kernel f to the coefficients of all the terms in the container c, erasing the terms that become
+// ignorable. In case of errors, c is cleared.
+template <typename Container, typename F>
+inline void apply_cf_kernel(Container &c, const F &f, const symbol_set &args)
+{
+	try {
+		const auto it_f = c.end();
+		for (auto it = c.begin(); it != it_f;) {
+			f(it->m_cf);
+			if (unlikely(it->is_ignorable(args))) {
+				it = c.erase(it);
+			} else {
+				++it;
+			}
+		}
+	} catch (...) {
+		c.clear();
+		throw;
+	}
+}
+
+}
+
+}
+
+#endif
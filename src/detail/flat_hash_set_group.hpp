@@ -0,0 +1,135 @@
+/***************************************************************************
+ *   Copyright (C) 2009-2011 by Francesco Biscani                          *
+ *   bluescarni@gmail.com                                                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef PIRANHA_DETAIL_FLAT_HASH_SET_GROUP_HPP
+#define PIRANHA_DETAIL_FLAT_HASH_SET_GROUP_HPP
+
+#include <cstddef>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+#include "../config.hpp"
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// Control bytes of piranha::flat_hash_set. A slot is either empty, deleted (i.e., a tombstone left
+// behind by an erasure) or full. Full slots store a 7-bit tag in the control byte, so that the
+// sign bit distinguishes full slots from the special values.
+using fhs_ctrl_t = signed char;
+
+constexpr fhs_ctrl_t fhs_empty = -128;
+constexpr fhs_ctrl_t fhs_deleted = -2;
+
+// Number of control bytes examined at once during probing.
+constexpr std::size_t fhs_group_width = 16u;
+
+// Index of the lowest set bit in a nonzero mask.
+inline unsigned fhs_lowest_bit(unsigned mask)
+{
+	piranha_assert(mask);
+#if defined(__GNUC__)
+	return static_cast<unsigned>(__builtin_ctz(mask));
+#else
+	unsigned retval = 0u;
+	for (; !(mask & 1u); mask >>= 1u) {
+		++retval;
+	}
+	return retval;
+#endif
+}
+
+// A group of fhs_group_width consecutive control bytes. The match functions return a mask whose
+// i-th bit is set if the i-th control byte in the group satisfies the condition. With SSE2 each match
+// is a single comparison on a 16-byte vector, otherwise we fall back to a plain loop on the bytes
+// (which the compiler is often able to vectorise anyway).
+class fhs_group
+{
+	public:
+		explicit fhs_group(const fhs_ctrl_t *ctrl)
+		{
+#if defined(__SSE2__)
+			m_ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(ctrl));
+#else
+			for (std::size_t i = 0u; i < fhs_group_width; ++i) {
+				m_ctrl[i] = ctrl[i];
+			}
+#endif
+		}
+		// Full slots with the given tag.
+		unsigned match(fhs_ctrl_t tag) const
+		{
+#if defined(__SSE2__)
+			return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag),m_ctrl)));
+#else
+			return match_impl([tag](fhs_ctrl_t c) {return c == tag;});
+#endif
+		}
+		// Empty slots.
+		unsigned match_empty() const
+		{
+			return match(fhs_empty);
+		}
+		// Empty or deleted slots (i.e., the slots available for insertion).
+		unsigned match_empty_or_deleted() const
+		{
+#if defined(__SSE2__)
+			return static_cast<unsigned>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(fhs_ctrl_t(-1)),m_ctrl)));
+#else
+			return match_impl([](fhs_ctrl_t c) {return c < fhs_ctrl_t(-1);});
+#endif
+		}
+		// Full slots.
+		unsigned match_full() const
+		{
+#if defined(__SSE2__)
+			// NOTE: the sign bit is unset only in full slots.
+			return static_cast<unsigned>(~_mm_movemask_epi8(m_ctrl)) & 0xFFFFu;
+#else
+			return match_impl([](fhs_ctrl_t c) {return c >= fhs_ctrl_t(0);});
+#endif
+		}
+	private:
+#if defined(__SSE2__)
+		__m128i		m_ctrl;
+#else
+		template <typename F>
+		unsigned match_impl(const F &f) const
+		{
+			unsigned retval = 0u;
+			for (std::size_t i = 0u; i < fhs_group_width; ++i) {
+				retval |= static_cast<unsigned>(f(m_ctrl[i])) << i;
+			}
+			return retval;
+		}
+		fhs_ctrl_t	m_ctrl[fhs_group_width];
+#endif
+};
+
+}
+
+}
+
+#endif
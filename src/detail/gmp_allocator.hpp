@@ -0,0 +1,242 @@
+/***************************************************************************
+ *   Copyright (C) 2009-2011 by Francesco Biscani                          *
+ *   bluescarni@gmail.com                                                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+#ifndef PIRANHA_DETAIL_GMP_ALLOCATOR_HPP
+#define PIRANHA_DETAIL_GMP_ALLOCATOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <gmp.h>
+
+#include "../config.hpp"
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// Allocation functions for GMP (and MPFR, which allocates through GMP), with per-thread caches of free blocks.
+// The size classes are the exact limb counts from 1 to gmp_alloc_max_limbs: the allocation sizes requested by
+// GMP for integer limbs and by MPFR for significands are whole numbers of limbs, and the small counts are by far
+// the most common in series coefficients. Requests of any other size go directly to the C allocation functions.
+// NOTE: each block is a plain malloc() block of exactly the requested size, so that the blocks are
+// interchangeable with the ones managed by the default GMP allocation functions (which are thin wrappers around
+// the C functions). This makes it safe to install and remove these functions at any time, even while GMP/MPFR
+// objects created with the default functions are alive.
+// NOTE: these are tuning parameters.
+static const std::size_t gmp_alloc_max_limbs = 64u;
+static const unsigned gmp_alloc_max_blocks = 64u;
+// Thresholds for the flush of the per-thread statistics into the global counters.
+static const unsigned gmp_alloc_stats_max_ops = 256u;
+static const long long gmp_alloc_stats_max_bytes = 1ll << 16;
+
+template <typename = int>
+struct base_gmp_allocator
+{
+	// Global statistics.
+	static std::atomic<unsigned long long>	s_n_allocs;
+	static std::atomic<long long>		s_bytes;
+	static std::atomic<long long>		s_peak;
+	// Allocation functions in use before the installation.
+	static void *(*s_old_alloc)(std::size_t);
+	static void *(*s_old_realloc)(void *, std::size_t, std::size_t);
+	static void (*s_old_free)(void *, std::size_t);
+	static bool s_installed;
+};
+
+template <typename T>
+std::atomic<unsigned long long> base_gmp_allocator<T>::s_n_allocs(0u);
+
+template <typename T>
+std::atomic<long long> base_gmp_allocator<T>::s_bytes(0);
+
+template <typename T>
+std::atomic<long long> base_gmp_allocator<T>::s_peak(0);
+
+template <typename T>
+void *(*base_gmp_allocator<T>::s_old_alloc)(std::size_t) = nullptr;
+
+template <typename T>
+void *(*base_gmp_allocator<T>::s_old_realloc)(void *, std::size_t, std::size_t) = nullptr;
+
+template <typename T>
+void (*base_gmp_allocator<T>::s_old_free)(void *, std::size_t) = nullptr;
+
+template <typename T>
+bool base_gmp_allocator<T>::s_installed = false;
+
+// The per-thread cache. This is trivially constructible and destructible, so that it can be used at any
+// time during the life of a thread, including the destruction of static objects at program exit.
+struct gmp_thread_cache
+{
+	// Link in the free lists, stored in the memory of the free blocks.
+	struct free_block
+	{
+		free_block *m_next;
+	};
+	// Free lists and their lengths, indexed by the number of limbs.
+	free_block	*m_lists[gmp_alloc_max_limbs + 1u];
+	unsigned	m_sizes[gmp_alloc_max_limbs + 1u];
+	// Statistics not yet flushed into the global counters.
+	unsigned long long	m_n_allocs;
+	long long		m_bytes;
+	unsigned		m_n_ops;
+	// Flags signalling if the guard below has been created and destroyed.
+	bool		m_registered;
+	bool		m_disabled;
+};
+
+inline gmp_thread_cache &get_gmp_thread_cache()
+{
+	static thread_local gmp_thread_cache cache;
+	return cache;
+}
+
+// Flush the statistics of the current thread into the global counters.
+inline void gmp_alloc_flush_stats(gmp_thread_cache &c)
+{
+	using base = base_gmp_allocator<>;
+	base::s_n_allocs.fetch_add(c.m_n_allocs,std::memory_order_relaxed);
+	const auto cur = base::s_bytes.fetch_add(c.m_bytes,std::memory_order_relaxed) + c.m_bytes;
+	auto peak = base::s_peak.load(std::memory_order_relaxed);
+	while (cur > peak && !base::s_peak.compare_exchange_weak(peak,cur,std::memory_order_relaxed)) {}
+	c.m_n_allocs = 0u;
+	c.m_bytes = 0;
+	c.m_n_ops = 0u;
+}
+
+inline void gmp_alloc_update_stats(gmp_thread_cache &c, unsigned long long n_allocs, long long bytes)
+{
+	c.m_n_allocs += n_allocs;
+	c.m_bytes += bytes;
+	if (unlikely(++c.m_n_ops == gmp_alloc_stats_max_ops || c.m_bytes >= gmp_alloc_stats_max_bytes ||
+		c.m_bytes <= -gmp_alloc_stats_max_bytes))
+	{
+		gmp_alloc_flush_stats(c);
+	}
+}
+
+// Release the cached blocks and flush the statistics of the current thread.
+inline void gmp_alloc_clear_cache(gmp_thread_cache &c)
+{
+	for (std::size_t i = 0u; i <= gmp_alloc_max_limbs; ++i) {
+		while (c.m_lists[i] != nullptr) {
+			auto b = c.m_lists[i];
+			c.m_lists[i] = b->m_next;
+			std::free(static_cast<void *>(b));
+		}
+		c.m_sizes[i] = 0u;
+	}
+	gmp_alloc_flush_stats(c);
+}
+
+// The destruction of this object at thread exit releases the blocks cached by the thread. Afterwards,
+// freed blocks are not cached any more.
+struct gmp_thread_cache_guard
+{
+	~gmp_thread_cache_guard()
+	{
+		auto &c = get_gmp_thread_cache();
+		gmp_alloc_clear_cache(c);
+		c.m_disabled = true;
+	}
+};
+
+// Index of the size class of a block, or zero if the block is not to be cached.
+inline std::size_t gmp_alloc_class(std::size_t size)
+{
+	return (size % sizeof(::mp_limb_t) == 0u && size <= gmp_alloc_max_limbs * sizeof(::mp_limb_t)) ?
+		size / sizeof(::mp_limb_t) : 0u;
+}
+
+inline void *gmp_alloc_malloc(std::size_t size)
+{
+	void *retval = std::malloc(size);
+	if (unlikely(retval == nullptr)) {
+		// NOTE: GMP requires the allocation functions not to return on failure.
+		std::fputs("piranha GMP allocator: cannot allocate memory\n",stderr);
+		std::abort();
+	}
+	return retval;
+}
+
+inline void *gmp_alloc_func(std::size_t size)
+{
+	auto &c = get_gmp_thread_cache();
+	gmp_alloc_update_stats(c,1u,static_cast<long long>(size));
+	const auto idx = gmp_alloc_class(size);
+	if (idx != 0u && c.m_lists[idx] != nullptr) {
+		auto b = c.m_lists[idx];
+		c.m_lists[idx] = b->m_next;
+		--c.m_sizes[idx];
+		return static_cast<void *>(b);
+	}
+	return gmp_alloc_malloc(size);
+}
+
+inline void gmp_free_func(void *ptr, std::size_t size)
+{
+	auto &c = get_gmp_thread_cache();
+	gmp_alloc_update_stats(c,0u,-static_cast<long long>(size));
+	const auto idx = gmp_alloc_class(size);
+	if (idx == 0u || c.m_disabled || c.m_sizes[idx] == gmp_alloc_max_blocks) {
+		std::free(ptr);
+		return;
+	}
+	if (unlikely(!c.m_registered)) {
+		// First block cached by this thread: create the guard that will release the cache at thread exit.
+		c.m_registered = true;
+		static thread_local gmp_thread_cache_guard guard;
+		(void)guard;
+	}
+	auto b = static_cast<gmp_thread_cache::free_block *>(ptr);
+	b->m_next = c.m_lists[idx];
+	c.m_lists[idx] = b;
+	++c.m_sizes[idx];
+}
+
+inline void *gmp_realloc_func(void *ptr, std::size_t old_size, std::size_t new_size)
+{
+	if (gmp_alloc_class(old_size) == 0u && gmp_alloc_class(new_size) == 0u) {
+		// Neither block size is cached, let the C library resize in place if possible.
+		auto &c = get_gmp_thread_cache();
+		gmp_alloc_update_stats(c,1u,static_cast<long long>(new_size) - static_cast<long long>(old_size));
+		void *retval = std::realloc(ptr,new_size);
+		if (unlikely(retval == nullptr)) {
+			std::fputs("piranha GMP allocator: cannot allocate memory\n",stderr);
+			std::abort();
+		}
+		return retval;
+	}
+	void *retval = gmp_alloc_func(new_size);
+	std::memcpy(retval,ptr,std::min(old_size,new_size));
+	gmp_free_func(ptr,old_size);
+	return retval;
+}
+
+}
+
+}
+
+#endif
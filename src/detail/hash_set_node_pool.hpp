@@ -0,0 +1,209 @@
+/***************************************************************************
+ *   Copyright (C) 2009-2011 by Francesco Biscani                          *
+ *   bluescarni@gmail.com                                                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+#ifndef PIRANHA_DETAIL_HASH_SET_NODE_POOL_HPP
+#define PIRANHA_DETAIL_HASH_SET_NODE_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include "../config.hpp"
+#include "../exceptions.hpp"
+#include "../thread_pool.hpp"
+#include "atomic_utils.hpp"
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// Pool of nodes for the overflow chains of piranha::hash_set. The nodes are carved out of slabs of
+// geometrically increasing size, recycled via free lists and released in bulk on destruction.
+// The pool is split in stripes, each one protected by a spinlock: the threads in the thread pool
+// use each a different stripe, so that concurrent insertions/erasures in different buckets of the same
+// container (as in the multithreaded multiplication) do not contend on the same free list. The stripes
+// are created on first use, so that a pool used by a single thread holds a single stripe.
+// NOTE: the pool deals only with raw memory, construction and destruction of the nodes are
+// up to the user. All the nodes must have been destroyed before the pool is destroyed.
+template <typename Node>
+class hs_node_pool
+{
+		// Link in the free lists, stored in the memory of the free nodes.
+		struct free_node
+		{
+			free_node *m_next;
+		};
+		static_assert(sizeof(Node) >= sizeof(free_node),"Invalid node size.");
+		// NOTE: these are tuning parameters.
+		static const unsigned n_stripes = 16u;
+		static const std::size_t min_slab_size = 1u;
+		static const std::size_t max_slab_size = 4096u;
+		struct stripe
+		{
+			stripe():m_free(nullptr),m_slab_size(min_slab_size),m_capacity(0u)
+			{
+				m_lock.clear();
+			}
+			~stripe()
+			{
+				for (auto p: m_slabs) {
+					::operator delete(p);
+				}
+			}
+			// Add a slab of size nodes to the free list.
+			void add_slab(std::size_t size)
+			{
+				// Make sure the new slab can be recorded before allocating it.
+				m_slabs.reserve(m_slabs.size() + 1u);
+				if (unlikely(size > std::numeric_limits<std::size_t>::max() / sizeof(Node))) {
+					piranha_throw(std::bad_alloc,);
+				}
+				auto slab = static_cast<char *>(::operator new(size * sizeof(Node)));
+				m_slabs.push_back(static_cast<void *>(slab));
+				// Thread the nodes of the new slab into the free list.
+				for (std::size_t i = 0u; i < size; ++i) {
+					auto fn = ::new (static_cast<void *>(slab + i * sizeof(Node))) free_node;
+					fn->m_next = m_free;
+					m_free = fn;
+				}
+				m_capacity += size;
+			}
+			std::atomic_flag	m_lock;
+			free_node		*m_free;
+			std::size_t		m_slab_size;
+			std::size_t		m_capacity;
+			std::vector<void *>	m_slabs;
+			// Padding to avoid false sharing between stripes.
+			char			m_pad[64u];
+		};
+		stripe &get_stripe()
+		{
+			const auto idx = pool_thread_index();
+			// NOTE: all the threads outside the pool share the last stripe.
+			auto &ptr = m_stripes[(idx == std::numeric_limits<unsigned>::max()) ? (n_stripes - 1u) : (idx % (n_stripes - 1u))];
+			auto s = ptr.load(std::memory_order_acquire);
+			if (unlikely(s == nullptr)) {
+				std::unique_ptr<stripe> new_s(::new stripe);
+				if (ptr.compare_exchange_strong(s,new_s.get(),std::memory_order_acq_rel,std::memory_order_acquire)) {
+					s = new_s.release();
+				}
+				// NOTE: if the exchange failed, s now points to the stripe created by another thread.
+			}
+			return *s;
+		}
+	public:
+		hs_node_pool()
+		{
+			for (auto &ptr: m_stripes) {
+				ptr.store(nullptr,std::memory_order_relaxed);
+			}
+		}
+		hs_node_pool(const hs_node_pool &) = delete;
+		hs_node_pool(hs_node_pool &&) = delete;
+		hs_node_pool &operator=(const hs_node_pool &) = delete;
+		hs_node_pool &operator=(hs_node_pool &&) = delete;
+		~hs_node_pool()
+		{
+			for (auto &ptr: m_stripes) {
+				::delete ptr.load();
+			}
+		}
+		// Make sure that at least n nodes are available to the calling thread without further allocations.
+		// The missing nodes are carved out of a single slab.
+		void reserve(std::size_t n)
+		{
+			auto &s = get_stripe();
+			atomic_lock_guard lock(s.m_lock);
+			std::size_t n_free = 0u;
+			for (auto fn = s.m_free; fn != nullptr && n_free < n; fn = fn->m_next) {
+				++n_free;
+			}
+			if (n_free < n) {
+				s.add_slab(n - n_free);
+			}
+		}
+		// Get raw storage for a node.
+		void *allocate()
+		{
+			auto &s = get_stripe();
+			atomic_lock_guard lock(s.m_lock);
+			if (unlikely(s.m_free == nullptr)) {
+				s.add_slab(s.m_slab_size);
+				if (s.m_slab_size < max_slab_size) {
+					s.m_slab_size *= 2u;
+				}
+			}
+			auto retval = s.m_free;
+			s.m_free = retval->m_next;
+			return static_cast<void *>(retval);
+		}
+		// Give back the storage of a node which has already been destroyed.
+		void deallocate(void *ptr)
+		{
+			auto &s = get_stripe();
+			atomic_lock_guard lock(s.m_lock);
+			auto fn = ::new (ptr) free_node;
+			fn->m_next = s.m_free;
+			s.m_free = fn;
+		}
+		// Total number of nodes managed by the pool (either free or in use).
+		std::size_t capacity()
+		{
+			std::size_t retval = 0u;
+			for (auto &ptr: m_stripes) {
+				auto s = ptr.load(std::memory_order_acquire);
+				if (s != nullptr) {
+					atomic_lock_guard lock(s->m_lock);
+					retval += s->m_capacity;
+				}
+			}
+			return retval;
+		}
+		// Number of stripes in use.
+		unsigned n_stripes_in_use() const
+		{
+			unsigned retval = 0u;
+			for (const auto &ptr: m_stripes) {
+				retval += static_cast<unsigned>(ptr.load(std::memory_order_acquire) != nullptr);
+			}
+			return retval;
+		}
+	private:
+		std::atomic<stripe *> m_stripes[n_stripes];
+};
+
+template <typename Node>
+const unsigned hs_node_pool<Node>::n_stripes;
+
+template <typename Node>
+const std::size_t hs_node_pool<Node>::min_slab_size;
+
+template <typename Node>
+const std::size_t hs_node_pool<Node>::max_slab_size;
+
+}
+
+}
+
+#endif
@@ -0,0 +1,104 @@
+/***************************************************************************
+ *   Copyright (C) 2009-2011 by Francesco Biscani                          *
+ *   bluescarni@gmail.com                                                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef PIRANHA_DETAIL_HLL_SKETCH_HPP
+#define PIRANHA_DETAIL_HLL_SKETCH_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// A HyperLogLog sketch for the estimation of the number of distinct elements in a stream of hash values:
+// Flajolet et al., "HyperLogLog: the analysis of a near-optimal cardinality estimation algorithm", 2007.
+// The sketch uses 2**12 registers, resulting in a typical relative error of about 1.6%. The hash values
+// are scrambled before use, as the hash functions in Piranha are not guaranteed to produce well-distributed bits
+// (e.g., the hash of a Kronecker monomial is its integer code).
+class hll_sketch
+{
+		static const unsigned p = 12u;
+		static const std::size_t m = std::size_t(1u) << p;
+		// The 64-bit finaliser of MurmurHash3.
+		static std::uint_least64_t mix(std::uint_least64_t h)
+		{
+			h ^= h >> 33u;
+			h *= 0xff51afd7ed558ccdULL;
+			h ^= h >> 33u;
+			h *= 0xc4ceb9fe1a85ec53ULL;
+			h ^= h >> 33u;
+			return h & 0xffffffffffffffffULL;
+		}
+	public:
+		hll_sketch()
+		{
+			m_registers.fill(0u);
+		}
+		void add(std::size_t h)
+		{
+			const auto x = mix(static_cast<std::uint_least64_t>(h));
+			// The first p bits select the register, the position of the first nonzero bit in the
+			// remaining 64 - p bits determines the rank.
+			const auto idx = static_cast<std::size_t>(x >> (64u - p));
+			unsigned char rank = 1u;
+			for (auto w = (x << p) & 0xffffffffffffffffULL; rank <= 64u - p && !(w & 0x8000000000000000ULL); w <<= 1u) {
+				++rank;
+			}
+			m_registers[idx] = std::max(m_registers[idx],rank);
+		}
+		// Merge the content of other into this.
+		void merge(const hll_sketch &other)
+		{
+			for (std::size_t i = 0u; i < m; ++i) {
+				m_registers[i] = std::max(m_registers[i],other.m_registers[i]);
+			}
+		}
+		// Estimated number of distinct elements added to the sketch.
+		double estimate() const
+		{
+			const double md = static_cast<double>(m), alpha = 0.7213 / (1. + 1.079 / md);
+			double sum = 0.;
+			std::size_t n_zeroes = 0u;
+			for (const auto &r: m_registers) {
+				sum += std::ldexp(1.,-static_cast<int>(r));
+				n_zeroes += static_cast<std::size_t>(r == 0u);
+			}
+			const double retval = alpha * md * md / sum;
+			// Small range correction via linear counting.
+			if (retval <= 2.5 * md && n_zeroes != 0u) {
+				return md * std::log(md / static_cast<double>(n_zeroes));
+			}
+			return retval;
+		}
+	private:
+		std::array<unsigned char,m> m_registers;
+};
+
+}
+
+}
+
+#endif
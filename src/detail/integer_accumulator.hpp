@@ -0,0 +1,130 @@
+/***************************************************************************
+ *   Copyright (C) 2009-2011 by Francesco Biscani                          *
+ *   bluescarni@gmail.com                                                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef PIRANHA_DETAIL_INTEGER_ACCUMULATOR_HPP
+#define PIRANHA_DETAIL_INTEGER_ACCUMULATOR_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <gmp.h>
+#include <limits>
+
+#include "../config.hpp"
+#include "../mp_integer.hpp"
+
+namespace piranha
+{
+
+namespace detail
+{
+
+#if defined(PIRANHA_UINT128_T)
+
+// Fixed-width accumulator for sums of products of integers whose absolute values fit in a single 64-bit limb.
+// The value is stored in 3 limbs in two's complement representation, and no overflow check is performed
+// during accumulation: each product is less than 2**128 in absolute value, so the sum is exact as long as the number
+// of accumulated products is less than 2**63. It is up to the user to guarantee this bound.
+class integer_accumulator
+{
+	public:
+		using limb_t = std::uint_least64_t;
+	private:
+		static_assert(std::numeric_limits<limb_t>::digits == 64,"Invalid limb type.");
+		using dlimb_t = PIRANHA_UINT128_T;
+	public:
+		integer_accumulator()
+		{
+			m_limbs.fill(0u);
+		}
+		// Extract the absolute value and the sign of an integer. Returns false if the absolute value does not fit in a limb.
+		template <int NBits, std::size_t NLimbs>
+		static bool split(const mp_integer<NBits,NLimbs> &n, limb_t &abs, bool &neg)
+		{
+			static_assert(GMP_NUMB_BITS <= 64 && GMP_NAIL_BITS == 0,"Invalid GMP limb type.");
+			const auto v = n.get_mpz_view();
+			const mpz_struct_t *p = v;
+			if (p->_mp_size > 1 || p->_mp_size < -1) {
+				return false;
+			}
+			abs = p->_mp_size ? static_cast<limb_t>(p->_mp_d[0]) : limb_t(0u);
+			neg = p->_mp_size < 0;
+			return true;
+		}
+		// Set to the product of a and b, whose signs are na and nb.
+		void set_product(const limb_t &a, bool na, const limb_t &b, bool nb)
+		{
+			m_limbs.fill(0u);
+			multiply_accumulate(a,na,b,nb);
+		}
+		// Add the product of a and b, whose signs are na and nb.
+		void multiply_accumulate(const limb_t &a, bool na, const limb_t &b, bool nb)
+		{
+			const dlimb_t prod = static_cast<dlimb_t>(static_cast<dlimb_t>(a) * b);
+			// All bits set if the product is negative, zero otherwise. A negative product is added
+			// in two's complement form, that is, by flipping the bits and adding one.
+			const limb_t mask = static_cast<limb_t>(limb_t(0u) - limb_t(na != nb));
+			dlimb_t s = static_cast<dlimb_t>(static_cast<dlimb_t>(m_limbs[0u]) + (static_cast<limb_t>(prod) ^ mask) + (mask & 1u));
+			m_limbs[0u] = static_cast<limb_t>(s);
+			s = static_cast<dlimb_t>(static_cast<dlimb_t>(m_limbs[1u]) + (static_cast<limb_t>(prod >> 64) ^ mask) +
+				static_cast<limb_t>(s >> 64));
+			m_limbs[1u] = static_cast<limb_t>(s);
+			m_limbs[2u] = static_cast<limb_t>(m_limbs[2u] + mask + static_cast<limb_t>(s >> 64));
+		}
+		bool is_zero() const
+		{
+			return !(m_limbs[0u] | m_limbs[1u] | m_limbs[2u]);
+		}
+		// Normalise into an mp_integer.
+		template <typename Int>
+		Int get() const
+		{
+			const bool neg = (m_limbs[2u] >> 63) != 0u;
+			std::array<limb_t,3u> abs(m_limbs);
+			if (neg) {
+				const bool c0 = abs[0u] == 0u, c1 = c0 && abs[1u] == 0u;
+				abs[0u] = static_cast<limb_t>(~abs[0u] + 1u);
+				abs[1u] = static_cast<limb_t>(~abs[1u] + c0);
+				abs[2u] = static_cast<limb_t>(~abs[2u] + c1);
+			}
+			Int retval;
+			if (likely(!abs[1u] && !abs[2u])) {
+				retval = Int(abs[0u]);
+			} else {
+				auto &tmp = mpz_scratch(0u);
+				::mpz_import(&tmp,3u,-1,sizeof(limb_t),0,0,abs.data());
+				retval = Int(&tmp);
+			}
+			if (neg) {
+				retval.negate();
+			}
+			return retval;
+		}
+	private:
+		std::array<limb_t,3u> m_limbs;
+};
+
+#endif
+
+}
+
+}
+
+#endif
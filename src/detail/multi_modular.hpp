@@ -0,0 +1,248 @@
+/***************************************************************************
+ *   Copyright (C) 2009-2011 by Francesco Biscani                          *
+ *   bluescarni@gmail.com                                                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef PIRANHA_DETAIL_MULTI_MODULAR_HPP
+#define PIRANHA_DETAIL_MULTI_MODULAR_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <gmp.h>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "../config.hpp"
+#include "../exceptions.hpp"
+#include "../mp_integer.hpp"
+
+namespace piranha
+{
+
+namespace detail
+{
+
+#if defined(PIRANHA_UINT128_T)
+
+// Arithmetic modulo a prime p with 2**61 < p < 2**62, using Montgomery reduction with R = 2**64.
+// mul(a,b) returns a*b/R mod p without any division. A sum of such products is brought back
+// to the sum of the plain products by a final mul_r(), that is, a multiplication by R**2 mod p.
+class mm_prime
+{
+		using duint_t = PIRANHA_UINT128_T;
+	public:
+		using uint_t = std::uint_least64_t;
+		static_assert(std::numeric_limits<uint_t>::digits == 64,"Invalid integer type.");
+		explicit mm_prime(const uint_t &p):m_p(p)
+		{
+			piranha_assert(p > (uint_t(1u) << 61u) && p < (uint_t(1u) << 62u) && (p & 1u));
+			// Inverse of p modulo 2**64 via Newton iteration, each step doubles the number of correct bits.
+			uint_t inv = p;
+			for (int i = 0; i < 5; ++i) {
+				inv = static_cast<uint_t>(inv * static_cast<uint_t>(uint_t(2u) - static_cast<uint_t>(p * inv)));
+			}
+			piranha_assert(static_cast<uint_t>(inv * p) == 1u);
+			m_pinv = static_cast<uint_t>(uint_t(0u) - inv);
+			const uint_t r = static_cast<uint_t>((duint_t(1u) << 64u) % p);
+			m_r2 = static_cast<uint_t>((static_cast<duint_t>(r) * r) % p);
+		}
+		const uint_t &get() const
+		{
+			return m_p;
+		}
+		// t/R mod p, for t < p*R.
+		uint_t redc(const duint_t &t) const
+		{
+			const uint_t m = static_cast<uint_t>(static_cast<uint_t>(t) * m_pinv);
+			const uint_t u = static_cast<uint_t>((t + static_cast<duint_t>(m) * m_p) >> 64u);
+			return static_cast<uint_t>(u >= m_p ? u - m_p : u);
+		}
+		uint_t mul(const uint_t &a, const uint_t &b) const
+		{
+			return redc(static_cast<duint_t>(a) * b);
+		}
+		// a*R mod p.
+		uint_t mul_r(const uint_t &a) const
+		{
+			return mul(a,m_r2);
+		}
+		uint_t add(const uint_t &a, const uint_t &b) const
+		{
+			// NOTE: no overflow is possible, as p < 2**62.
+			const uint_t s = static_cast<uint_t>(a + b);
+			return static_cast<uint_t>(s >= m_p ? s - m_p : s);
+		}
+		uint_t sub(const uint_t &a, const uint_t &b) const
+		{
+			return static_cast<uint_t>(a >= b ? a - b : a + (m_p - b));
+		}
+		// Inverse of a modulo p via Fermat's little theorem. a must not be a multiple of p.
+		uint_t inverse(const uint_t &a) const
+		{
+			piranha_assert(a % m_p != 0u);
+			// NOTE: the exponentiation is performed on the Montgomery representations (x*R).
+			uint_t base = mul_r(static_cast<uint_t>(a % m_p)), retval = mul_r(1u), e = static_cast<uint_t>(m_p - 2u);
+			for (; e; e >>= 1u) {
+				if (e & 1u) {
+					retval = mul(retval,base);
+				}
+				base = mul(base,base);
+			}
+			return redc(retval);
+		}
+		// Residue of an mp_integer modulo p.
+		template <typename Int>
+		uint_t residue(const Int &n) const
+		{
+			static_assert(GMP_NUMB_BITS <= 64 && GMP_NAIL_BITS == 0,"Invalid GMP limb type.");
+			const auto v = n.get_mpz_view();
+			const mpz_struct_t *ptr = v;
+			const auto size = ptr->_mp_size >= 0 ? ptr->_mp_size : -ptr->_mp_size;
+			uint_t r = 0u;
+			for (auto i = size; i > 0; --i) {
+				r = static_cast<uint_t>(((static_cast<duint_t>(r) << GMP_NUMB_BITS) +
+					static_cast<uint_t>(ptr->_mp_d[i - 1])) % m_p);
+			}
+			return static_cast<uint_t>((ptr->_mp_size < 0 && r) ? m_p - r : r);
+		}
+	private:
+		uint_t	m_p;
+		uint_t	m_pinv;
+		uint_t	m_r2;
+};
+
+template <typename = int>
+struct base_mm_primes
+{
+	static const std::size_t n_primes = 64u;
+	// The 64 largest primes below 2**62.
+	static const std::array<std::uint_least64_t,n_primes> s_primes;
+};
+
+template <typename T>
+const std::size_t base_mm_primes<T>::n_primes;
+
+template <typename T>
+const std::array<std::uint_least64_t,base_mm_primes<T>::n_primes> base_mm_primes<T>::s_primes = {{
+	4611686018427387847u, 4611686018427387817u, 4611686018427387787u, 4611686018427387761u,
+	4611686018427387751u, 4611686018427387737u, 4611686018427387733u, 4611686018427387709u,
+	4611686018427387701u, 4611686018427387631u, 4611686018427387617u, 4611686018427387587u,
+	4611686018427387461u, 4611686018427387421u, 4611686018427387409u, 4611686018427387329u,
+	4611686018427387323u, 4611686018427387301u, 4611686018427387271u, 4611686018427387241u,
+	4611686018427387139u, 4611686018427387131u, 4611686018427387127u, 4611686018427387113u,
+	4611686018427387091u, 4611686018427387073u, 4611686018427386981u, 4611686018427386923u,
+	4611686018427386911u, 4611686018427386903u, 4611686018427386897u, 4611686018427386887u,
+	4611686018427386707u, 4611686018427386663u, 4611686018427386611u, 4611686018427386551u,
+	4611686018427386471u, 4611686018427386389u, 4611686018427386351u, 4611686018427386329u,
+	4611686018427386323u, 4611686018427386309u, 4611686018427386287u, 4611686018427386231u,
+	4611686018427386207u, 4611686018427386203u, 4611686018427386201u, 4611686018427386081u,
+	4611686018427386023u, 4611686018427385993u, 4611686018427385981u, 4611686018427385861u,
+	4611686018427385831u, 4611686018427385801u, 4611686018427385763u, 4611686018427385717u,
+	4611686018427385687u, 4611686018427385657u, 4611686018427385619u, 4611686018427385553u,
+	4611686018427385537u, 4611686018427385529u, 4611686018427385507u, 4611686018427385483u
+}};
+
+// Reconstruction of signed integers from their residues modulo a set of primes via the Chinese remainder theorem,
+// using Garner's mixed-radix algorithm. If M is the product of the primes, the integers must lie in ]-M/2,M/2[.
+template <typename Int>
+class mm_crt: base_mm_primes<>
+{
+	public:
+		using uint_t = mm_prime::uint_t;
+		// Lower bound on the number of bits of each prime.
+		static const unsigned prime_bits = 61u;
+		// Maximum number of primes.
+		static const std::size_t max_primes = n_primes;
+		// Use the first n primes.
+		explicit mm_crt(const std::size_t &n):m_modulus(1)
+		{
+			if (unlikely(n == 0u || n > max_primes)) {
+				piranha_throw(std::invalid_argument,"invalid number of primes");
+			}
+			for (std::size_t i = 0u; i < n; ++i) {
+				m_primes.emplace_back(s_primes[i]);
+				m_int_primes.emplace_back(s_primes[i]);
+				m_modulus *= m_int_primes.back();
+			}
+			m_half_modulus = m_modulus;
+			m_half_modulus.div_2exp(1u);
+			// m_inv[i][j] is the inverse of the j-th prime modulo the i-th prime (j < i), in Montgomery representation.
+			m_inv.resize(n);
+			for (std::size_t i = 1u; i < n; ++i) {
+				for (std::size_t j = 0u; j < i; ++j) {
+					m_inv[i].push_back(m_primes[i].mul_r(m_primes[i].inverse(s_primes[j])));
+				}
+			}
+		}
+		std::size_t size() const
+		{
+			return m_primes.size();
+		}
+		const mm_prime &prime(const std::size_t &i) const
+		{
+			piranha_assert(i < size());
+			return m_primes[i];
+		}
+		// Reconstruct out from the residues in r, which are overwritten with the mixed-radix digits.
+		void reconstruct(Int &out, uint_t *r) const
+		{
+			const std::size_t n = size();
+			for (std::size_t i = 1u; i < n; ++i) {
+				const auto &p = m_primes[i];
+				uint_t t = r[i];
+				for (std::size_t j = 0u; j < i; ++j) {
+					// NOTE: all the primes are in ]2**61,2**62[, hence the j-th digit is less than twice the i-th prime.
+					const uint_t d = static_cast<uint_t>(r[j] >= p.get() ? r[j] - p.get() : r[j]);
+					t = p.mul(p.sub(t,d),m_inv[i][j]);
+				}
+				r[i] = t;
+			}
+			// Horner evaluation of the mixed-radix representation.
+			out = Int(r[n - 1u]);
+			for (std::size_t i = n - 1u; i > 0u; --i) {
+				out *= m_int_primes[i - 1u];
+				out += Int(r[i - 1u]);
+			}
+			if (out > m_half_modulus) {
+				out -= m_modulus;
+			}
+		}
+	private:
+		std::vector<mm_prime>			m_primes;
+		std::vector<Int>			m_int_primes;
+		std::vector<std::vector<uint_t>>	m_inv;
+		Int					m_modulus;
+		Int					m_half_modulus;
+};
+
+template <typename Int>
+const unsigned mm_crt<Int>::prime_bits;
+
+template <typename Int>
+const std::size_t mm_crt<Int>::max_primes;
+
+#endif
+
+}
+
+}
+
+#endif
@@ -46,26 +46,13 @@ inline void parallel_vector_transform(unsigned n_threads, const std::vector<T> &
 		return;
 	}
 	const auto block_size = ic.size() / n_threads;
-	auto local_transform = [&op](T const *b, T const *e, U *o) {
+	thread_pool::parallel_invoke(n_threads,[&op,&ic,&oc,block_size,n_threads](unsigned i) {
+		auto b = ic.data() + i * block_size;
+		auto e = (i == n_threads - 1u) ? (ic.data() + ic.size()) :
+			(ic.data() + (i + 1u) * block_size);
+		auto o = oc.data() + i * block_size;
 		std::transform(b,e,o,op);
-	};
-	future_list<decltype(thread_pool::enqueue(0u,local_transform,ic.data(),ic.data(),oc.data()))> ff_list;
-	try {
-		for (unsigned i = 0u; i < n_threads; ++i) {
-			auto b = ic.data() + i * block_size;
-			auto e = (i == n_threads - 1u) ? (ic.data() + ic.size()) :
-				(ic.data() + (i + 1u) * block_size);
-			auto o = oc.data() + i * block_size;
-			ff_list.push_back(thread_pool::enqueue(i,local_transform,b,e,o));
-		}
-		// First let's wait for everything to finish.
-		ff_list.wait_all();
-		// Then, let's handle the exceptions.
-		ff_list.get_all();
-	} catch (...) {
-		ff_list.wait_all();
-		throw;
-	}
+	});
 }
 
 }}
@@ -0,0 +1,432 @@
+/***************************************************************************
+ *   Copyright (C) 2009-2011 by Francesco Biscani                          *
+ *   bluescarni@gmail.com                                                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef PIRANHA_DETAIL_POW_CACHE_HPP
+#define PIRANHA_DETAIL_POW_CACHE_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <exception>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "../config.hpp"
+#include "../tuning.hpp"
+#include "series_fwd.hpp"
+
+namespace piranha
+{
+
+/// Statistics of a cache of natural powers.
+/**
+ * @see piranha::series::get_pow_cache_stats().
+ */
+struct pow_cache_stats
+{
+	/// Number of requests served by powers already in the cache (or being computed by another thread).
+	unsigned long long	hits;
+	/// Number of requests which needed the computation of new powers.
+	unsigned long long	misses;
+	/// Number of bases whose powers were evicted from the cache because of the memory limit.
+	unsigned long long	evictions;
+	/// Estimated memory footprint of the cached powers, in bytes.
+	unsigned long long	bytes;
+	/// Number of bases in the cache.
+	unsigned long long	entries;
+};
+
+namespace detail
+{
+
+// Estimate of the memory used by a series: the buckets and the terms of the container, and, recursively,
+// the memory used by series coefficients. Dynamic memory owned by other coefficient or key types is not accounted for.
+template <typename Series>
+inline unsigned long long series_footprint_impl(const Series &s)
+{
+	using term_type = typename Series::term_type;
+	const auto &c = s._container();
+	return static_cast<unsigned long long>(sizeof(Series)) + static_cast<unsigned long long>(std::max(c.bucket_count(),c.size())) *
+		static_cast<unsigned long long>(sizeof(term_type) + sizeof(void *));
+}
+
+template <typename Series, typename std::enable_if<!std::is_base_of<series_tag,typename Series::term_type::cf_type>::value,int>::type = 0>
+inline unsigned long long series_footprint(const Series &s)
+{
+	return series_footprint_impl(s);
+}
+
+template <typename Series, typename std::enable_if<std::is_base_of<series_tag,typename Series::term_type::cf_type>::value,int>::type = 0>
+inline unsigned long long series_footprint(const Series &s)
+{
+	using cf_type = typename Series::term_type::cf_type;
+	auto retval = series_footprint_impl(s);
+	for (const auto &t: s._container()) {
+		// NOTE: the footprint of a series always includes its size, which is already counted in the term.
+		retval += series_footprint(t.m_cf) - static_cast<unsigned long long>(sizeof(cf_type));
+	}
+	return retval;
+}
+
+// Cache of natural powers of series, used by series::pow().
+// - The bases are distributed among a fixed number of shards according to their hash. Each shard is protected by its own
+//   mutex, which is held only while the shard is looked up or modified, and never during the computation of the powers.
+// - The powers of a base are stored as shared futures. The thread that requests a power not yet in the cache appends the futures
+//   of the missing powers, releases the lock and computes the powers, fulfilling the promises as it goes. Other threads
+//   requesting the same powers wait on the futures, while the requests for other bases proceed in parallel.
+// - Each shard keeps its bases in LRU order, and the estimated memory footprint of all the shards is tracked in a global counter.
+//   When a writer makes the footprint exceed the memory limit (see tuning::get_pow_cache_memory_limit()), the least recently
+//   used bases of its own shard are evicted first, and then those of the other shards, one shard at a time, until the footprint
+//   is within the limit. Bases whose powers are being computed are never evicted. A single base can thus use the whole budget,
+//   and its powers are evicted on completion only if they alone exceed the limit.
+// - A thread never waits for the powers it is computing itself: each thread records the entries it is writing, and a request
+//   reaching an entry of the current thread (e.g., because the computation of a power ends up calling pow() on the same
+//   base) bypasses the pending powers, computing the result from the ready powers without storing it in the cache. The
+//   waiters in the thread pool run only the tasks of their own parallel region, so a thread cannot pick up an unrelated
+//   task requesting the powers it is computing while it waits.
+template <typename Series, typename Value, typename Hasher, typename Equal>
+class pow_cache
+{
+		static const std::size_t n_shards = 16u;
+		using f_type = std::shared_future<Value>;
+		using lru_type = std::list<const Series *>;
+		struct entry
+		{
+			std::vector<f_type>		m_powers;
+			typename lru_type::iterator	m_lru_it;
+			unsigned long long		m_bytes = 0u;
+			unsigned			m_n_writers = 0u;
+			bool				m_evicted = false;
+		};
+		using map_type = std::unordered_map<Series,std::shared_ptr<entry>,Hasher,Equal>;
+		struct shard
+		{
+			std::mutex		m_mutex;
+			map_type		m_map;
+			lru_type		m_lru;
+			unsigned long long	m_bytes = 0u;
+		};
+		shard &get_shard(const Series &base)
+		{
+			// NOTE: use the top bits of a scrambled hash, so that the selection of the shard is independent from the selection
+			// of the bucket in the maps.
+			const auto h = static_cast<unsigned long long>(Hasher{}(base)) * 11400714819323198485ull;
+			return m_shards[static_cast<std::size_t>((h & 0xffffffffffffffffull) >> 60u)];
+		}
+		// Evict LRU bases of the shard, except keep, until the global footprint is within the limit. Must be called with the lock held.
+		void evict(shard &sh, const unsigned long long &limit, const entry *keep = nullptr)
+		{
+			auto it = sh.m_lru.end();
+			while (m_bytes.load() > limit && it != sh.m_lru.begin()) {
+				--it;
+				const auto m_it = sh.m_map.find(**it);
+				piranha_assert(m_it != sh.m_map.end());
+				auto &e = *m_it->second;
+				if (e.m_n_writers || &e == keep) {
+					continue;
+				}
+				e.m_evicted = true;
+				sh.m_bytes -= e.m_bytes;
+				m_bytes.fetch_sub(e.m_bytes);
+				it = sh.m_lru.erase(it);
+				sh.m_map.erase(m_it);
+				++m_evictions;
+			}
+		}
+		// The entries whose powers are being computed by the current thread.
+		static std::vector<const entry *> &writing()
+		{
+			static thread_local std::vector<const entry *> s_writing;
+			return s_writing;
+		}
+		// RAII registration of an entry in writing().
+		struct writing_guard
+		{
+			explicit writing_guard(const entry *e):m_e(e)
+			{
+				if (m_e) {
+					writing().push_back(m_e);
+				}
+			}
+			~writing_guard()
+			{
+				if (m_e) {
+					piranha_assert(!writing().empty() && writing().back() == m_e);
+					writing().pop_back();
+				}
+			}
+			writing_guard(const writing_guard &) = delete;
+			writing_guard &operator=(const writing_guard &) = delete;
+			const entry *m_e;
+		};
+		// Account for the powers computed by a writer, and possibly evict.
+		void writer_done(shard &sh, entry &e, unsigned long long bytes)
+		{
+			const auto limit = tuning::get_pow_cache_memory_limit();
+			{
+				std::lock_guard<std::mutex> lock(sh.m_mutex);
+				piranha_assert(e.m_n_writers);
+				--e.m_n_writers;
+				if (e.m_evicted) {
+					return;
+				}
+				e.m_bytes += bytes;
+				sh.m_bytes += bytes;
+				m_bytes.fetch_add(bytes);
+				evict(sh,limit,&e);
+			}
+			// NOTE: the locks of the other shards are acquired one at a time, so that writers finishing concurrently
+			// in different shards cannot deadlock.
+			for (auto &other: m_shards) {
+				if (m_bytes.load() <= limit) {
+					return;
+				}
+				if (&other != &sh) {
+					std::lock_guard<std::mutex> lock(other.m_mutex);
+					evict(other,limit);
+				}
+			}
+			// The powers just computed exceed the limit on their own.
+			std::lock_guard<std::mutex> lock(sh.m_mutex);
+			evict(sh,limit);
+		}
+	public:
+		pow_cache() = default;
+		pow_cache(const pow_cache &) = delete;
+		pow_cache &operator=(const pow_cache &) = delete;
+		// Highest power of base not greater than n in the cache (or being computed), zero if there is none.
+		std::size_t highest_cached(const Series &base, const std::size_t &n)
+		{
+			auto &sh = get_shard(base);
+			std::lock_guard<std::mutex> lock(sh.m_mutex);
+			const auto it = sh.m_map.find(base);
+			if (it == sh.m_map.end()) {
+				return 0u;
+			}
+			const auto &v = it->second->m_powers;
+			for (auto i = std::min(n + 1u,v.size()); i > 0u; --i) {
+				if (v[i - 1u].valid()) {
+					return i - 1u;
+				}
+			}
+			return 0u;
+		}
+		// Get the n-th power of base, computing the missing powers with the given strategy (which must be either multiplication
+		// or squaring). init() must return the power 0, next(p) the product of the power p by base, square(p) the square of p.
+		// The intermediate powers computed by the strategy are stored in the cache as well. The vector of powers can thus
+		// have holes, represented by invalid futures. If the current thread is already computing powers of base, only the
+		// ready powers are used and the result is not stored.
+		template <typename Init, typename Next, typename Square>
+		f_type get(const Series &base, const std::size_t &n, pow_strategy strategy, const Init &init, const Next &next,
+			const Square &square)
+		{
+			piranha_assert(strategy == pow_strategy::multiplication || strategy == pow_strategy::squaring);
+			// The steps of the computation: index of the power and operation (0 for init, 1 for next, 2 for square).
+			using step = std::pair<std::size_t,unsigned>;
+			auto &sh = get_shard(base);
+			std::shared_ptr<entry> e;
+			std::vector<step> steps;
+			std::vector<std::promise<Value>> promises;
+			std::vector<f_type> futures;
+			f_type retval, prev;
+			bool bypass = false;
+			{
+				std::lock_guard<std::mutex> lock(sh.m_mutex);
+				auto it = sh.m_map.find(base);
+				if (it == sh.m_map.end()) {
+					auto new_e = std::make_shared<entry>();
+					sh.m_lru.push_front(nullptr);
+					try {
+						it = sh.m_map.emplace(base,std::move(new_e)).first;
+					} catch (...) {
+						sh.m_lru.pop_front();
+						throw;
+					}
+					sh.m_lru.front() = std::addressof(it->first);
+					it->second->m_lru_it = sh.m_lru.begin();
+				} else {
+					sh.m_lru.splice(sh.m_lru.begin(),sh.m_lru,it->second->m_lru_it);
+				}
+				e = it->second;
+				auto &v = e->m_powers;
+				const auto &w = writing();
+				bypass = std::find(w.begin(),w.end(),e.get()) != w.end();
+				auto cached = [&v,bypass](const std::size_t &i) {
+					return i < v.size() && v[i].valid() &&
+						(!bypass || v[i].wait_for(std::chrono::seconds(0)) == std::future_status::ready);
+				};
+				if (cached(n)) {
+					++m_hits;
+					return v[n];
+				}
+				++m_misses;
+				// Build the full chain of steps.
+				if (strategy == pow_strategy::multiplication) {
+					// Start from the highest cached power below n.
+					std::size_t k = n;
+					while (k > 0u && !cached(k - 1u)) {
+						--k;
+					}
+					if (k == 0u) {
+						steps.emplace_back(0u,0u);
+						++k;
+					} else {
+						prev = v[k - 1u];
+					}
+					for (; k <= n; ++k) {
+						steps.emplace_back(k,1u);
+					}
+				} else {
+					// Left-to-right binary method: the chain contains the powers corresponding to the leading
+					// bits of n, and their doubles.
+					std::vector<step> chain{step(0u,0u)};
+					if (n) {
+						chain.emplace_back(1u,1u);
+						unsigned n_bits = 0u;
+						for (auto m = n; m; m >>= 1u) {
+							++n_bits;
+						}
+						std::size_t p = 1u;
+						for (auto i = n_bits - 1u; i > 0u; --i) {
+							p *= 2u;
+							chain.emplace_back(p,2u);
+							if ((n >> (i - 1u)) & 1u) {
+								++p;
+								chain.emplace_back(p,1u);
+							}
+						}
+						piranha_assert(p == n);
+					}
+					// Start after the last cached power in the chain.
+					auto c_it = chain.end();
+					while (c_it != chain.begin() && !cached((c_it - 1)->first)) {
+						--c_it;
+					}
+					if (c_it != chain.begin()) {
+						prev = v[(c_it - 1)->first];
+					}
+					steps.assign(c_it,chain.end());
+				}
+				piranha_assert(!steps.empty() && steps.back().first == n);
+				promises.resize(steps.size());
+				for (auto &p: promises) {
+					futures.push_back(p.get_future().share());
+				}
+				retval = futures.back();
+				// NOTE: when bypassing, the pending powers belong to the current thread, which is not going to fulfil
+				// them before this request returns. The powers are computed outside the cache.
+				if (!bypass) {
+					if (v.size() <= n) {
+						v.resize(n + 1u);
+					}
+					// NOTE: after this point nothing can throw.
+					for (decltype(steps.size()) i = 0u; i < steps.size(); ++i) {
+						piranha_assert(!v[steps[i].first].valid());
+						v[steps[i].first] = futures[i];
+					}
+					++e->m_n_writers;
+				}
+			}
+			decltype(steps.size()) i = 0u;
+			unsigned long long bytes = 0u;
+			try {
+				writing_guard wg(bypass ? nullptr : e.get());
+				for (; i < steps.size(); ++i) {
+					auto tmp = (steps[i].second == 0u) ? init() : ((steps[i].second == 1u) ? next(prev.get()) : square(prev.get()));
+					bytes += series_footprint(tmp);
+					promises[i].set_value(std::move(tmp));
+					prev = futures[i];
+				}
+			} catch (...) {
+				for (auto j = i; j < steps.size(); ++j) {
+					promises[j].set_exception(std::current_exception());
+				}
+				if (bypass) {
+					throw;
+				}
+				{
+					// Remove the failed powers, so that they can be computed again by later requests.
+					std::lock_guard<std::mutex> lock(sh.m_mutex);
+					auto &v = e->m_powers;
+					for (auto j = i; j < steps.size(); ++j) {
+						if (steps[j].first < v.size()) {
+							v[steps[j].first] = f_type();
+						}
+					}
+					while (!v.empty() && !v.back().valid()) {
+						v.pop_back();
+					}
+				}
+				writer_done(sh,*e,bytes);
+				throw;
+			}
+			if (!bypass) {
+				writer_done(sh,*e,bytes);
+			}
+			return retval;
+		}
+		void clear()
+		{
+			for (auto &sh: m_shards) {
+				std::lock_guard<std::mutex> lock(sh.m_mutex);
+				for (auto &p: sh.m_map) {
+					p.second->m_evicted = true;
+				}
+				sh.m_map.clear();
+				sh.m_lru.clear();
+				m_bytes.fetch_sub(sh.m_bytes);
+				sh.m_bytes = 0u;
+			}
+			m_hits.store(0u);
+			m_misses.store(0u);
+			m_evictions.store(0u);
+		}
+		pow_cache_stats stats()
+		{
+			pow_cache_stats retval{m_hits.load(),m_misses.load(),m_evictions.load(),0u,0u};
+			for (auto &sh: m_shards) {
+				std::lock_guard<std::mutex> lock(sh.m_mutex);
+				retval.bytes += sh.m_bytes;
+				retval.entries += static_cast<unsigned long long>(sh.m_map.size());
+			}
+			return retval;
+		}
+	private:
+		std::array<shard,n_shards>	m_shards;
+		std::atomic_ullong		m_hits{0u};
+		std::atomic_ullong		m_misses{0u};
+		std::atomic_ullong		m_evictions{0u};
+		// Footprint of all the shards.
+		std::atomic_ullong		m_bytes{0u};
+};
+
+}
+
+}
+
+#endif
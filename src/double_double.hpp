@@ -0,0 +1,1200 @@
+/***************************************************************************
+ *   Copyright (C) 2009-2011 by Francesco Biscani                          *
+ *   bluescarni@gmail.com                                                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+
+#ifndef PIRANHA_DOUBLE_DOUBLE_HPP
+#define PIRANHA_DOUBLE_DOUBLE_HPP
+
+#include <cmath>
+#include <gmp.h>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <type_traits>
+
+#include "config.hpp"
+#include "exceptions.hpp"
+#include "is_cf.hpp"
+#include "math.hpp"
+#include "mp_integer.hpp"
+#include "mp_rational.hpp"
+#include "pow.hpp"
+#include "real.hpp"
+#include "safe_cast.hpp"
+#include "serialization.hpp"
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// Error-free transformations on doubles. See:
+// Hida, Li, Bailey - Library for double-double and quad-double arithmetic (2007).
+// NOTE: the inputs are passed by value, so that the outputs can alias them.
+
+// s + e == a + b exactly.
+inline void dd_two_sum(const double a, const double b, double &s, double &e)
+{
+	s = a + b;
+	const double bb = s - a;
+	e = (a - (s - bb)) + (b - bb);
+}
+
+// Same as above, requires |a| >= |b|.
+inline void dd_quick_two_sum(const double a, const double b, double &s, double &e)
+{
+	s = a + b;
+	e = b - (s - a);
+}
+
+// Split a into two non-overlapping 26-bit halves.
+inline void dd_split(const double &a, double &hi, double &lo)
+{
+	// 2**27 + 1.
+	const double splitter = 134217729.;
+	// NOTE: above this threshold splitter * a might overflow, scale the value down and up again by a power of two.
+	const double threshold = 6.69692879491417e+299;
+	if (unlikely(a > threshold || a < -threshold)) {
+		const double a_s = a * 3.7252902984619140625e-09, t = splitter * a_s;
+		hi = t - (t - a_s);
+		lo = a_s - hi;
+		hi *= 268435456.;
+		lo *= 268435456.;
+	} else {
+		const double t = splitter * a;
+		hi = t - (t - a);
+		lo = a - hi;
+	}
+}
+
+// p + e == a * b exactly.
+inline void dd_two_prod(const double a, const double b, double &p, double &e)
+{
+	p = a * b;
+#if defined(FP_FAST_FMA)
+	e = std::fma(a,b,-p);
+#else
+	double a_hi, a_lo, b_hi, b_lo;
+	dd_split(a,a_hi,a_lo);
+	dd_split(b,b_hi,b_lo);
+	e = ((a_hi * b_hi - p) + a_hi * b_lo + a_lo * b_hi) + a_lo * b_lo;
+#endif
+}
+
+}
+
+/// Double-double floating-point class.
+/**
+ * This class represents floating-point numbers as the unevaluated sum of two \p double values,
+ * \p hi and \p lo, with <tt>|lo| <= ulp(hi) / 2</tt>. The significand of the represented numbers consists of (at least) 106 bits,
+ * corresponding to about 32 decimal digits, whereas the exponent range is the same as the exponent range of \p double.
+ *
+ * The arithmetic operations are implemented via error-free transformations of hardware floating-point operations:
+ * they are much faster than the corresponding operations on piranha::real, and they never allocate memory. The addition
+ * and the multiplication are accurate to about 2**-106 in relative terms; the division is slightly less accurate. The elementary
+ * functions (e.g., sine and cosine) are computed via piranha::real, and they are not particularly fast.
+ *
+ * Non-finite values are not supported: the result of an operation producing a non-finite value is unspecified.
+ * Note also that this class relies on the IEEE 754 semantics of the \p double type: options such as GCC's <tt>-ffast-math</tt>
+ * will break the arithmetic operations.
+ *
+ * ## Interoperability with other types ##
+ *
+ * This class interoperates with the C++ arithmetic types, piranha::mp_integer and piranha::mp_rational. Arithmetic types with a
+ * significand not wider than the significand of \p double (e.g., \p int and \p double) are used directly in the arithmetic
+ * operations, the other types are first converted to piranha::double_double. The conversion from and to piranha::real
+ * is available via explicit constructor and conversion operator.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * This class provides the strong exception safety guarantee for all operations.
+ *
+ * ## Move semantics ##
+ *
+ * Move semantics is equivalent to copy semantics.
+ *
+ * ## Serialization ##
+ *
+ * This class supports serialization.
+ *
+ * @see http://crd-legacy.lbl.gov/~dhbailey/mpdist/
+ */
+class double_double
+{
+		static_assert(std::numeric_limits<double>::is_iec559 && std::numeric_limits<double>::radix == 2 &&
+			std::numeric_limits<double>::digits == 53,"Invalid double type.");
+		// Interoperable types.
+		template <typename T>
+		struct is_interoperable_type
+		{
+			static const bool value = (std::is_arithmetic<T>::value && !std::is_same<T,bool>::value) ||
+				detail::is_mp_integer<T>::value || detail::is_mp_rational<T>::value;
+		};
+		// Interoperable types which can be converted exactly to double.
+		template <typename T>
+		struct is_double_type
+		{
+			static const bool value = std::is_arithmetic<T>::value && !std::is_same<T,bool>::value &&
+				std::numeric_limits<T>::digits <= std::numeric_limits<double>::digits;
+		};
+		template <typename T>
+		using generic_enabler = typename std::enable_if<is_interoperable_type<T>::value,int>::type;
+		// Construction from the unevaluated sum a + b, with |a| >= |b|.
+		struct quick_two_sum_tag {};
+		explicit double_double(const double &a, const double &b, const quick_two_sum_tag &)
+		{
+			detail::dd_quick_two_sum(a,b,m_hi,m_lo);
+		}
+		// Construction from interoperable types.
+		template <typename T, typename std::enable_if<is_double_type<T>::value,int>::type = 0>
+		void construct_from_interoperable(const T &x)
+		{
+			m_hi = static_cast<double>(x);
+			m_lo = 0.;
+		}
+		template <typename T, typename std::enable_if<std::is_floating_point<T>::value &&
+			!is_double_type<T>::value,int>::type = 0>
+		void construct_from_interoperable(const T &x)
+		{
+			const double hi = static_cast<double>(x);
+			*this = double_double(hi,static_cast<double>(x - static_cast<T>(hi)),quick_two_sum_tag{});
+		}
+		template <typename T, typename std::enable_if<(std::is_integral<T>::value && !is_double_type<T>::value) ||
+			detail::is_mp_integer<T>::value || detail::is_mp_rational<T>::value,int>::type = 0>
+		void construct_from_interoperable(const T &x)
+		{
+			*this = double_double(real{x,real::default_prec});
+		}
+		// Conversion to interoperable types.
+		template <typename T, typename std::enable_if<std::is_floating_point<T>::value,int>::type = 0>
+		T convert_to_impl() const
+		{
+			return static_cast<T>(static_cast<T>(m_hi) + static_cast<T>(m_lo));
+		}
+		template <typename T, typename std::enable_if<!std::is_floating_point<T>::value &&
+			!detail::is_mp_rational<T>::value,int>::type = 0>
+		T convert_to_impl() const
+		{
+			return static_cast<T>(exact_real());
+		}
+		// NOTE: the conversion of a finite double to rational is exact, so hi + lo is represented exactly.
+		template <typename T, typename std::enable_if<detail::is_mp_rational<T>::value,int>::type = 0>
+		T convert_to_impl() const
+		{
+			T retval(m_hi);
+			retval += T(m_lo);
+			return retval;
+		}
+		// Exact conversion to real, using as many bits as needed to represent hi + lo.
+		real exact_real() const
+		{
+			::mpfr_prec_t prec = std::numeric_limits<double>::digits;
+			if (m_lo != 0.) {
+				prec = static_cast< ::mpfr_prec_t>(prec + std::ilogb(m_hi) - std::ilogb(m_lo));
+			}
+			real retval{m_hi,prec};
+			retval += m_lo;
+			return retval;
+		}
+		// Arithmetic kernels.
+		double_double &in_place_add(const double_double &other)
+		{
+			double s1, s2, t1, t2;
+			detail::dd_two_sum(m_hi,other.m_hi,s1,s2);
+			detail::dd_two_sum(m_lo,other.m_lo,t1,t2);
+			s2 += t1;
+			detail::dd_quick_two_sum(s1,s2,s1,s2);
+			s2 += t2;
+			detail::dd_quick_two_sum(s1,s2,m_hi,m_lo);
+			return *this;
+		}
+		template <typename T, typename std::enable_if<is_double_type<T>::value,int>::type = 0>
+		double_double &in_place_add(const T &x)
+		{
+			double s1, s2;
+			detail::dd_two_sum(m_hi,static_cast<double>(x),s1,s2);
+			s2 += m_lo;
+			detail::dd_quick_two_sum(s1,s2,m_hi,m_lo);
+			return *this;
+		}
+		template <typename T, typename std::enable_if<is_interoperable_type<T>::value && !is_double_type<T>::value,int>::type = 0>
+		double_double &in_place_add(const T &x)
+		{
+			return in_place_add(double_double(x));
+		}
+		double_double &in_place_mul(const double_double &other)
+		{
+			double p1, p2;
+			detail::dd_two_prod(m_hi,other.m_hi,p1,p2);
+			p2 += m_hi * other.m_lo + m_lo * other.m_hi;
+			detail::dd_quick_two_sum(p1,p2,m_hi,m_lo);
+			return *this;
+		}
+		template <typename T, typename std::enable_if<is_double_type<T>::value,int>::type = 0>
+		double_double &in_place_mul(const T &x)
+		{
+			const double y = static_cast<double>(x);
+			double p1, p2;
+			detail::dd_two_prod(m_hi,y,p1,p2);
+			p2 += m_lo * y;
+			detail::dd_quick_two_sum(p1,p2,m_hi,m_lo);
+			return *this;
+		}
+		template <typename T, typename std::enable_if<is_interoperable_type<T>::value && !is_double_type<T>::value,int>::type = 0>
+		double_double &in_place_mul(const T &x)
+		{
+			return in_place_mul(double_double(x));
+		}
+		double_double &in_place_div(const double_double &other)
+		{
+			if (unlikely(other.m_hi == 0.)) {
+				m_hi /= other.m_hi;
+				m_lo = 0.;
+				return *this;
+			}
+			// Long division: each step computes the next 53 bits of the quotient from the remainder.
+			const double q1 = m_hi / other.m_hi;
+			double_double r(*this);
+			r -= other * q1;
+			const double q2 = r.m_hi / other.m_hi;
+			r -= other * q2;
+			const double q3 = r.m_hi / other.m_hi;
+			*this = double_double(q1,q2,quick_two_sum_tag{});
+			return in_place_add(q3);
+		}
+		template <typename T, typename std::enable_if<is_double_type<T>::value,int>::type = 0>
+		double_double &in_place_div(const T &x)
+		{
+			const double y = static_cast<double>(x);
+			if (unlikely(y == 0.)) {
+				m_hi /= y;
+				m_lo = 0.;
+				return *this;
+			}
+			const double q1 = m_hi / y;
+			double p1, p2, s, e;
+			detail::dd_two_prod(q1,y,p1,p2);
+			detail::dd_two_sum(m_hi,-p1,s,e);
+			e -= p2;
+			e += m_lo;
+			const double q2 = (s + e) / y;
+			detail::dd_quick_two_sum(q1,q2,m_hi,m_lo);
+			return *this;
+		}
+		template <typename T, typename std::enable_if<is_interoperable_type<T>::value && !is_double_type<T>::value,int>::type = 0>
+		double_double &in_place_div(const T &x)
+		{
+			return in_place_div(double_double(x));
+		}
+		// Binary operations.
+		template <typename T>
+		using binary_enabler = typename std::enable_if<is_interoperable_type<T>::value ||
+			std::is_same<T,double_double>::value,int>::type;
+		static double_double binary_add(const double_double &x, const double_double &y)
+		{
+			double_double retval(x);
+			retval.in_place_add(y);
+			return retval;
+		}
+		template <typename T, typename std::enable_if<is_interoperable_type<T>::value,int>::type = 0>
+		static double_double binary_add(const double_double &x, const T &y)
+		{
+			double_double retval(x);
+			retval.in_place_add(y);
+			return retval;
+		}
+		template <typename T, typename std::enable_if<is_interoperable_type<T>::value,int>::type = 0>
+		static double_double binary_add(const T &x, const double_double &y)
+		{
+			return binary_add(y,x);
+		}
+		static double_double binary_mul(const double_double &x, const double_double &y)
+		{
+			double_double retval(x);
+			retval.in_place_mul(y);
+			return retval;
+		}
+		template <typename T, typename std::enable_if<is_interoperable_type<T>::value,int>::type = 0>
+		static double_double binary_mul(const double_double &x, const T &y)
+		{
+			double_double retval(x);
+			retval.in_place_mul(y);
+			return retval;
+		}
+		template <typename T, typename std::enable_if<is_interoperable_type<T>::value,int>::type = 0>
+		static double_double binary_mul(const T &x, const double_double &y)
+		{
+			return binary_mul(y,x);
+		}
+		template <typename T, binary_enabler<T> = 0>
+		static double_double binary_sub(const double_double &x, const T &y)
+		{
+			double_double retval(x);
+			retval -= y;
+			return retval;
+		}
+		template <typename T, typename std::enable_if<is_interoperable_type<T>::value,int>::type = 0>
+		static double_double binary_sub(const T &x, const double_double &y)
+		{
+			double_double retval(-y);
+			retval.in_place_add(x);
+			return retval;
+		}
+		template <typename T, binary_enabler<T> = 0>
+		static double_double binary_div(const double_double &x, const T &y)
+		{
+			double_double retval(x);
+			retval.in_place_div(y);
+			return retval;
+		}
+		template <typename T, typename std::enable_if<is_interoperable_type<T>::value,int>::type = 0>
+		static double_double binary_div(const T &x, const double_double &y)
+		{
+			double_double retval(x);
+			retval.in_place_div(y);
+			return retval;
+		}
+		// Comparisons.
+		static bool binary_equality(const double_double &x, const double_double &y)
+		{
+			return x.m_hi == y.m_hi && x.m_lo == y.m_lo;
+		}
+		template <typename T, typename std::enable_if<is_interoperable_type<T>::value,int>::type = 0>
+		static bool binary_equality(const double_double &x, const T &y)
+		{
+			return binary_equality(x,double_double(y));
+		}
+		template <typename T, typename std::enable_if<is_interoperable_type<T>::value,int>::type = 0>
+		static bool binary_equality(const T &x, const double_double &y)
+		{
+			return binary_equality(y,double_double(x));
+		}
+		static bool binary_less_than(const double_double &x, const double_double &y)
+		{
+			return x.m_hi < y.m_hi || (x.m_hi == y.m_hi && x.m_lo < y.m_lo);
+		}
+		template <typename T, typename std::enable_if<is_interoperable_type<T>::value,int>::type = 0>
+		static bool binary_less_than(const double_double &x, const T &y)
+		{
+			return binary_less_than(x,double_double(y));
+		}
+		template <typename T, typename std::enable_if<is_interoperable_type<T>::value,int>::type = 0>
+		static bool binary_less_than(const T &x, const double_double &y)
+		{
+			return binary_less_than(double_double(x),y);
+		}
+		// Serialization support.
+		friend class boost::serialization::access;
+		template <class Archive>
+		void serialize(Archive &ar, unsigned int)
+		{
+			ar & m_hi;
+			ar & m_lo;
+		}
+	public:
+		/// Default constructor.
+		/**
+		 * Will initialise the number to zero.
+		 */
+		double_double():m_hi(0.),m_lo(0.) {}
+		/// Defaulted copy constructor.
+		double_double(const double_double &) = default;
+		/// Defaulted move constructor.
+		double_double(double_double &&) = default;
+		/// Generic constructor.
+		/**
+		 * \note
+		 * This constructor is enabled only if \p T is an interoperable type.
+		 *
+		 * The value of \p x is rounded to the nearest piranha::double_double.
+		 *
+		 * @param[in] x object used to construct \p this.
+		 *
+		 * @throws unspecified any exception thrown by the constructor of piranha::real, if invoked.
+		 */
+		template <typename T, generic_enabler<T> = 0>
+		explicit double_double(const T &x)
+		{
+			construct_from_interoperable(x);
+		}
+		/// Constructor from piranha::real.
+		/**
+		 * The value of \p r is rounded to the nearest piranha::double_double.
+		 *
+		 * @param[in] r piranha::real used to construct \p this.
+		 *
+		 * @throws unspecified any exception thrown by the arithmetic operations of piranha::real.
+		 */
+		explicit double_double(const real &r)
+		{
+			const double hi = static_cast<double>(r);
+			real rem{r};
+			rem -= hi;
+			*this = double_double(hi,static_cast<double>(rem),quick_two_sum_tag{});
+		}
+		/// Constructor from C string.
+		/**
+		 * The string is parsed via piranha::real, using the default precision of piranha::real, and then converted to piranha::double_double.
+		 *
+		 * @param[in] str C string used for construction.
+		 *
+		 * @throws unspecified any exception thrown by the constructor of piranha::real from string.
+		 */
+		explicit double_double(const char *str):double_double(real{str,real::default_prec}) {}
+		/// Constructor from C++ string (equivalent to the constructor from C string).
+		/**
+		 * @param[in] str C++ string used for construction.
+		 *
+		 * @throws unspecified any exception thrown by the constructor from C string.
+		 */
+		explicit double_double(const std::string &str):double_double(str.c_str()) {}
+		/// Trivial destructor.
+		~double_double();
+		/// Defaulted copy assignment operator.
+		double_double &operator=(const double_double &) = default;
+		/// Defaulted move assignment operator.
+		double_double &operator=(double_double &&) = default;
+		/// Generic assignment operator.
+		/**
+		 * \note
+		 * This operator is enabled only if \p T is an interoperable type.
+		 *
+		 * @param[in] x assignment argument.
+		 *
+		 * @return reference to \p this.
+		 *
+		 * @throws unspecified any exception thrown by the generic constructor.
+		 */
+		template <typename T, generic_enabler<T> = 0>
+		double_double &operator=(const T &x)
+		{
+			return (*this = double_double(x));
+		}
+		/// Conversion operator.
+		/**
+		 * \note
+		 * This operator is enabled only if \p T is an interoperable type.
+		 *
+		 * Conversion to floating-point types rounds the value of \p this to the target type, and the conversion
+		 * to piranha::mp_rational is exact. The conversion to the other interoperable types goes through an exact
+		 * conversion to piranha::real, and it follows the semantics of the conversion operator of piranha::real.
+		 *
+		 * @return the value of \p this converted to \p T.
+		 *
+		 * @throws unspecified any exception thrown by the conversion operator of piranha::real, or by the
+		 * constructor of piranha::mp_rational from \p double.
+		 */
+		template <typename T, generic_enabler<T> = 0>
+		explicit operator T() const
+		{
+			return convert_to_impl<T>();
+		}
+		/// Conversion to piranha::real.
+		/**
+		 * The value of \p this is converted to a piranha::real with the default precision of piranha::real.
+		 *
+		 * @return the value of \p this converted to piranha::real.
+		 *
+		 * @throws unspecified any exception thrown by the arithmetic operations of piranha::real.
+		 */
+		explicit operator real() const
+		{
+			real retval{m_hi,real::default_prec};
+			retval += m_lo;
+			return retval;
+		}
+		/// High-order component.
+		/**
+		 * @return const reference to the high-order component of \p this.
+		 */
+		const double &hi() const
+		{
+			return m_hi;
+		}
+		/// Low-order component.
+		/**
+		 * @return const reference to the low-order component of \p this.
+		 */
+		const double &lo() const
+		{
+			return m_lo;
+		}
+		/// Sign.
+		/**
+		 * @return 1 if <tt>this > 0</tt>, 0 if <tt>this == 0</tt> and -1 if <tt>this < 0</tt>.
+		 */
+		int sign() const
+		{
+			return (m_hi > 0.) ? 1 : ((m_hi < 0.) ? -1 : 0);
+		}
+		/// Test for zero.
+		/**
+		 * @return \p true if \p this is zero, \p false otherwise.
+		 */
+		bool is_zero() const
+		{
+			return m_hi == 0.;
+		}
+		/// Negate in-place.
+		void negate()
+		{
+			m_hi = -m_hi;
+			m_lo = -m_lo;
+		}
+		/// Absolute value.
+		/**
+		 * @return absolute value of \p this.
+		 */
+		double_double abs() const
+		{
+			return (m_hi < 0.) ? -*this : *this;
+		}
+		/// Integral exponentiation.
+		/**
+		 * \note
+		 * This method is enabled only if \p T is an integral type or piranha::mp_integer.
+		 *
+		 * The result is computed via exponentiation by squaring. A negative exponent results in the computation
+		 * of the reciprocal of the result for the absolute value of the exponent.
+		 *
+		 * @param[in] n exponent.
+		 *
+		 * @return \p this raised to the power of \p n.
+		 *
+		 * @throws unspecified any exception thrown by the constructor of piranha::mp_integer.
+		 */
+		template <typename T, typename std::enable_if<std::is_integral<T>::value || detail::is_mp_integer<T>::value,int>::type = 0>
+		double_double pow(const T &n) const
+		{
+			integer e(n);
+			const bool neg = e.sign() < 0;
+			if (neg) {
+				e.negate();
+			}
+			double_double retval(1), base(*this);
+			const auto v = e.get_mpz_view();
+			const detail::mpz_struct_t *ptr = v;
+			const auto n_bits = (e.sign() == 0) ? ::mp_bitcnt_t(0u) : static_cast< ::mp_bitcnt_t>(::mpz_sizeinbase(ptr,2));
+			for (::mp_bitcnt_t i = 0u; i < n_bits; ++i) {
+				if (::mpz_tstbit(ptr,i)) {
+					retval *= base;
+				}
+				if (i + 1u != n_bits) {
+					base *= base;
+				}
+			}
+			return neg ? double_double(1) / retval : retval;
+		}
+		/// Real exponentiation.
+		/**
+		 * The result is computed via piranha::real.
+		 *
+		 * @param[in] x exponent.
+		 *
+		 * @return \p this raised to the power of \p x.
+		 *
+		 * @throws unspecified any exception thrown by piranha::real::pow().
+		 */
+		double_double pow(const double_double &x) const
+		{
+			return double_double(static_cast<real>(*this).pow(static_cast<real>(x)));
+		}
+		/// Sine.
+		/**
+		 * The result is computed via piranha::real.
+		 *
+		 * @return sine of \p this.
+		 *
+		 * @throws unspecified any exception thrown by piranha::real::sin().
+		 */
+		double_double sin() const
+		{
+			return double_double(static_cast<real>(*this).sin());
+		}
+		/// Cosine.
+		/**
+		 * The result is computed via piranha::real.
+		 *
+		 * @return cosine of \p this.
+		 *
+		 * @throws unspecified any exception thrown by piranha::real::cos().
+		 */
+		double_double cos() const
+		{
+			return double_double(static_cast<real>(*this).cos());
+		}
+		/// Multiply-accumulate.
+		/**
+		 * Sets \p this to <tt>this + y * z</tt>.
+		 *
+		 * @param[in] y first argument.
+		 * @param[in] z second argument.
+		 *
+		 * @return reference to \p this.
+		 */
+		double_double &multiply_accumulate(const double_double &y, const double_double &z)
+		{
+			double p1, p2;
+			detail::dd_two_prod(y.m_hi,z.m_hi,p1,p2);
+			p2 += y.m_hi * z.m_lo + y.m_lo * z.m_hi;
+			detail::dd_quick_two_sum(p1,p2,p1,p2);
+			return in_place_add(double_double(p1,p2,quick_two_sum_tag{}));
+		}
+		/// In-place addition.
+		/**
+		 * \note
+		 * This operator is enabled only if \p T is an interoperable type or piranha::double_double.
+		 *
+		 * @param[in] x argument for the addition.
+		 *
+		 * @return reference to \p this.
+		 *
+		 * @throws unspecified any exception thrown by the generic constructor, if invoked.
+		 */
+		template <typename T>
+		auto operator+=(const T &x) -> decltype(this->in_place_add(x))
+		{
+			return in_place_add(x);
+		}
+		/// Binary addition involving piranha::double_double.
+		/**
+		 * \note
+		 * This operator is enabled only if at least one argument is piranha::double_double, and the other argument
+		 * is either piranha::double_double or an interoperable type.
+		 *
+		 * @param[in] x first argument.
+		 * @param[in] y second argument.
+		 *
+		 * @return <tt>x + y</tt>.
+		 *
+		 * @throws unspecified any exception thrown by the generic constructor, if invoked.
+		 */
+		template <typename T, typename U>
+		friend auto operator+(const T &x, const U &y) -> decltype(double_double::binary_add(x,y))
+		{
+			return binary_add(x,y);
+		}
+		/// Identity operator.
+		/**
+		 * @return copy of \p this.
+		 */
+		double_double operator+() const
+		{
+			return *this;
+		}
+		/// In-place subtraction.
+		/**
+		 * \note
+		 * This operator is enabled only if \p T is an interoperable type or piranha::double_double.
+		 *
+		 * @param[in] x argument for the subtraction.
+		 *
+		 * @return reference to \p this.
+		 *
+		 * @throws unspecified any exception thrown by the generic constructor, if invoked.
+		 */
+		template <typename T>
+		auto operator-=(const T &x) -> decltype(this->in_place_add(x))
+		{
+			negate();
+			in_place_add(x);
+			negate();
+			return *this;
+		}
+		/// Binary subtraction involving piranha::double_double.
+		/**
+		 * \note
+		 * This operator is enabled only if at least one argument is piranha::double_double, and the other argument
+		 * is either piranha::double_double or an interoperable type.
+		 *
+		 * @param[in] x first argument.
+		 * @param[in] y second argument.
+		 *
+		 * @return <tt>x - y</tt>.
+		 *
+		 * @throws unspecified any exception thrown by the generic constructor, if invoked.
+		 */
+		template <typename T, typename U>
+		friend auto operator-(const T &x, const U &y) -> decltype(double_double::binary_sub(x,y))
+		{
+			return binary_sub(x,y);
+		}
+		/// Negated copy.
+		/**
+		 * @return copy of \p -this.
+		 */
+		double_double operator-() const
+		{
+			double_double retval(*this);
+			retval.negate();
+			return retval;
+		}
+		/// In-place multiplication.
+		/**
+		 * \note
+		 * This operator is enabled only if \p T is an interoperable type or piranha::double_double.
+		 *
+		 * @param[in] x argument for the multiplication.
+		 *
+		 * @return reference to \p this.
+		 *
+		 * @throws unspecified any exception thrown by the generic constructor, if invoked.
+		 */
+		template <typename T>
+		auto operator*=(const T &x) -> decltype(this->in_place_mul(x))
+		{
+			return in_place_mul(x);
+		}
+		/// Binary multiplication involving piranha::double_double.
+		/**
+		 * \note
+		 * This operator is enabled only if at least one argument is piranha::double_double, and the other argument
+		 * is either piranha::double_double or an interoperable type.
+		 *
+		 * @param[in] x first argument.
+		 * @param[in] y second argument.
+		 *
+		 * @return <tt>x * y</tt>.
+		 *
+		 * @throws unspecified any exception thrown by the generic constructor, if invoked.
+		 */
+		template <typename T, typename U>
+		friend auto operator*(const T &x, const U &y) -> decltype(double_double::binary_mul(x,y))
+		{
+			return binary_mul(x,y);
+		}
+		/// In-place division.
+		/**
+		 * \note
+		 * This operator is enabled only if \p T is an interoperable type or piranha::double_double.
+		 *
+		 * Division by zero results in a non-finite value.
+		 *
+		 * @param[in] x argument for the division.
+		 *
+		 * @return reference to \p this.
+		 *
+		 * @throws unspecified any exception thrown by the generic constructor, if invoked.
+		 */
+		template <typename T>
+		auto operator/=(const T &x) -> decltype(this->in_place_div(x))
+		{
+			return in_place_div(x);
+		}
+		/// Binary division involving piranha::double_double.
+		/**
+		 * \note
+		 * This operator is enabled only if at least one argument is piranha::double_double, and the other argument
+		 * is either piranha::double_double or an interoperable type.
+		 *
+		 * @param[in] x first argument.
+		 * @param[in] y second argument.
+		 *
+		 * @return <tt>x / y</tt>.
+		 *
+		 * @throws unspecified any exception thrown by the generic constructor, if invoked.
+		 */
+		template <typename T, typename U>
+		friend auto operator/(const T &x, const U &y) -> decltype(double_double::binary_div(x,y))
+		{
+			return binary_div(x,y);
+		}
+		/// Generic equality operator involving piranha::double_double.
+		/**
+		 * \note
+		 * This operator is enabled only if at least one argument is piranha::double_double, and the other argument
+		 * is either piranha::double_double or an interoperable type.
+		 *
+		 * @param[in] x first argument.
+		 * @param[in] y second argument.
+		 *
+		 * @return \p true if <tt>x == y</tt>, \p false otherwise.
+		 *
+		 * @throws unspecified any exception thrown by the generic constructor, if invoked.
+		 */
+		template <typename T, typename U>
+		friend auto operator==(const T &x, const U &y) -> decltype(double_double::binary_equality(x,y))
+		{
+			return binary_equality(x,y);
+		}
+		/// Generic inequality operator involving piranha::double_double.
+		/**
+		 * \note
+		 * This operator is enabled only if at least one argument is piranha::double_double, and the other argument
+		 * is either piranha::double_double or an interoperable type.
+		 *
+		 * @param[in] x first argument.
+		 * @param[in] y second argument.
+		 *
+		 * @return \p true if <tt>x != y</tt>, \p false otherwise.
+		 *
+		 * @throws unspecified any exception thrown by the generic constructor, if invoked.
+		 */
+		template <typename T, typename U>
+		friend auto operator!=(const T &x, const U &y) -> decltype(!double_double::binary_equality(x,y))
+		{
+			return !binary_equality(x,y);
+		}
+		/// Generic less-than operator involving piranha::double_double.
+		/**
+		 * \note
+		 * This operator is enabled only if at least one argument is piranha::double_double, and the other argument
+		 * is either piranha::double_double or an interoperable type.
+		 *
+		 * @param[in] x first argument.
+		 * @param[in] y second argument.
+		 *
+		 * @return \p true if <tt>x < y</tt>, \p false otherwise.
+		 *
+		 * @throws unspecified any exception thrown by the generic constructor, if invoked.
+		 */
+		template <typename T, typename U>
+		friend auto operator<(const T &x, const U &y) -> decltype(double_double::binary_less_than(x,y))
+		{
+			return binary_less_than(x,y);
+		}
+		/// Generic greater-than operator involving piranha::double_double.
+		/**
+		 * \note
+		 * This operator is enabled only if at least one argument is piranha::double_double, and the other argument
+		 * is either piranha::double_double or an interoperable type.
+		 *
+		 * @param[in] x first argument.
+		 * @param[in] y second argument.
+		 *
+		 * @return \p true if <tt>x > y</tt>, \p false otherwise.
+		 *
+		 * @throws unspecified any exception thrown by the generic constructor, if invoked.
+		 */
+		template <typename T, typename U>
+		friend auto operator>(const T &x, const U &y) -> decltype(double_double::binary_less_than(y,x))
+		{
+			return binary_less_than(y,x);
+		}
+		/// Generic less-than or equal operator involving piranha::double_double.
+		/**
+		 * \note
+		 * This operator is enabled only if at least one argument is piranha::double_double, and the other argument
+		 * is either piranha::double_double or an interoperable type.
+		 *
+		 * @param[in] x first argument.
+		 * @param[in] y second argument.
+		 *
+		 * @return \p true if <tt>x <= y</tt>, \p false otherwise.
+		 *
+		 * @throws unspecified any exception thrown by the generic constructor, if invoked.
+		 */
+		template <typename T, typename U>
+		friend auto operator<=(const T &x, const U &y) -> decltype(!double_double::binary_less_than(y,x))
+		{
+			return !binary_less_than(y,x);
+		}
+		/// Generic greater-than or equal operator involving piranha::double_double.
+		/**
+		 * \note
+		 * This operator is enabled only if at least one argument is piranha::double_double, and the other argument
+		 * is either piranha::double_double or an interoperable type.
+		 *
+		 * @param[in] x first argument.
+		 * @param[in] y second argument.
+		 *
+		 * @return \p true if <tt>x >= y</tt>, \p false otherwise.
+		 *
+		 * @throws unspecified any exception thrown by the generic constructor, if invoked.
+		 */
+		template <typename T, typename U>
+		friend auto operator>=(const T &x, const U &y) -> decltype(!double_double::binary_less_than(x,y))
+		{
+			return !binary_less_than(x,y);
+		}
+		/// Overload output stream operator for piranha::double_double.
+		/**
+		 * The value is printed via the conversion to piranha::real, in the same format.
+		 *
+		 * @param[in] os output stream.
+		 * @param[in] x piranha::double_double to be directed to stream.
+		 *
+		 * @return reference to \p os.
+		 *
+		 * @throws unspecified any exception thrown by the conversion to piranha::real or by the stream operator of piranha::real.
+		 */
+		friend std::ostream &operator<<(std::ostream &os, const double_double &x)
+		{
+			return os << static_cast<real>(x);
+		}
+		/// Overload input stream operator for piranha::double_double.
+		/**
+		 * Equivalent to extracting a line from the stream and then constructing a piranha::double_double from it.
+		 *
+		 * @param[in] is input stream.
+		 * @param[in,out] x piranha::double_double to which the contents of the stream will be assigned.
+		 *
+		 * @return reference to \p is.
+		 *
+		 * @throws unspecified any exception thrown by the constructor from string.
+		 */
+		friend std::istream &operator>>(std::istream &is, double_double &x)
+		{
+			std::string tmp_str;
+			std::getline(is,tmp_str);
+			x = double_double(tmp_str);
+			return is;
+		}
+	private:
+		double	m_hi;
+		double	m_lo;
+};
+
+namespace math
+{
+
+/// Specialisation of the piranha::math::negate() functor for piranha::double_double.
+template <typename T>
+struct negate_impl<T,typename std::enable_if<std::is_same<T,double_double>::value>::type>
+{
+	/// Call operator.
+	/**
+	 * @param[in,out] x piranha::double_double to be negated.
+	 */
+	void operator()(double_double &x) const
+	{
+		x.negate();
+	}
+};
+
+/// Specialisation of the piranha::math::is_zero() functor for piranha::double_double.
+template <typename T>
+struct is_zero_impl<T,typename std::enable_if<std::is_same<T,double_double>::value>::type>
+{
+	/// Call operator.
+	/**
+	 * @param[in] x piranha::double_double to be tested.
+	 *
+	 * @return \p true if \p x is zero, \p false otherwise.
+	 */
+	bool operator()(const T &x) const
+	{
+		return x.is_zero();
+	}
+};
+
+/// Specialisation of the piranha::math::pow() functor for piranha::double_double.
+/**
+ * This specialisation is activated when the base is piranha::double_double and the exponent is either
+ * piranha::double_double or an interoperable type for piranha::double_double.
+ *
+ * Integral exponents (including piranha::mp_integer) use piranha::double_double::pow() with integral argument,
+ * the other exponents are converted to piranha::double_double.
+ */
+template <typename T, typename U>
+struct pow_impl<T,U,typename std::enable_if<std::is_same<T,double_double>::value &&
+	(std::is_constructible<double_double,U>::value && !std::is_same<U,bool>::value)>::type>
+{
+	/// Call operator, integral exponent overload.
+	/**
+	 * @param[in] x base.
+	 * @param[in] n exponent.
+	 *
+	 * @return \p x to the power of \p n.
+	 *
+	 * @throws unspecified any exception thrown by piranha::double_double::pow().
+	 */
+	template <typename U2, typename std::enable_if<std::is_integral<U2>::value || detail::is_mp_integer<U2>::value,int>::type = 0>
+	double_double operator()(const double_double &x, const U2 &n) const
+	{
+		return x.pow(n);
+	}
+	/// Call operator, generic exponent overload.
+	/**
+	 * @param[in] x base.
+	 * @param[in] y exponent.
+	 *
+	 * @return \p x to the power of \p y.
+	 *
+	 * @throws unspecified any exception thrown by piranha::double_double::pow() or by the constructor of piranha::double_double.
+	 */
+	template <typename U2, typename std::enable_if<!std::is_integral<U2>::value && !detail::is_mp_integer<U2>::value,int>::type = 0>
+	double_double operator()(const double_double &x, const U2 &y) const
+	{
+		return x.pow(double_double(y));
+	}
+};
+
+/// Specialisation of the piranha::math::sin() functor for piranha::double_double.
+template <typename T>
+struct sin_impl<T,typename std::enable_if<std::is_same<T,double_double>::value>::type>
+{
+	/// Call operator.
+	/**
+	 * @param[in] x argument.
+	 *
+	 * @return sine of \p x.
+	 *
+	 * @throws unspecified any exception thrown by piranha::double_double::sin().
+	 */
+	double_double operator()(const T &x) const
+	{
+		return x.sin();
+	}
+};
+
+/// Specialisation of the piranha::math::cos() functor for piranha::double_double.
+template <typename T>
+struct cos_impl<T,typename std::enable_if<std::is_same<T,double_double>::value>::type>
+{
+	/// Call operator.
+	/**
+	 * @param[in] x argument.
+	 *
+	 * @return cosine of \p x.
+	 *
+	 * @throws unspecified any exception thrown by piranha::double_double::cos().
+	 */
+	double_double operator()(const T &x) const
+	{
+		return x.cos();
+	}
+};
+
+/// Specialisation of the piranha::math::abs() functor for piranha::double_double.
+template <typename T>
+struct abs_impl<T,typename std::enable_if<std::is_same<T,double_double>::value>::type>
+{
+	/// Call operator.
+	/**
+	 * @param[in] x input parameter.
+	 *
+	 * @return absolute value of \p x.
+	 */
+	T operator()(const T &x) const
+	{
+		return x.abs();
+	}
+};
+
+/// Specialisation of the piranha::math::partial() functor for piranha::double_double.
+template <typename T>
+struct partial_impl<T,typename std::enable_if<std::is_same<T,double_double>::value>::type>
+{
+	/// Call operator.
+	/**
+	 * @return an instance of piranha::double_double constructed from zero.
+	 */
+	double_double operator()(const double_double &, const std::string &) const
+	{
+		return double_double(0);
+	}
+};
+
+/// Specialisation of the implementation of piranha::math::multiply_accumulate() for piranha::double_double.
+template <typename T>
+struct multiply_accumulate_impl<T,T,T,typename std::enable_if<std::is_same<T,double_double>::value>::type>
+{
+	/// Call operator.
+	/**
+	 * This implementation will use piranha::double_double::multiply_accumulate().
+	 *
+	 * @param[in,out] x target value for accumulation.
+	 * @param[in] y first argument.
+	 * @param[in] z second argument.
+	 *
+	 * @return <tt>x.multiply_accumulate(y,z)</tt>.
+	 */
+	auto operator()(T &x, const T &y, const T &z) const -> decltype(x.multiply_accumulate(y,z))
+	{
+		return x.multiply_accumulate(y,z);
+	}
+};
+
+}
+
+namespace detail
+{
+
+template <typename To, typename From>
+using sc_double_double_enabler = typename std::enable_if<
+	(std::is_integral<To>::value || is_mp_integer<To>::value || is_mp_rational<To>::value) &&
+	std::is_same<From,double_double>::value
+	>::type;
+
+}
+
+/// Specialisation of piranha::safe_cast() for conversions involving piranha::double_double.
+/**
+ * This specialisation is enabled if \p To is an integral type, piranha::mp_integer or piranha::mp_rational, and \p From is
+ * piranha::double_double.
+ */
+template <typename To, typename From>
+struct safe_cast_impl<To,From,detail::sc_double_double_enabler<To,From>>
+{
+	private:
+		template <typename T>
+		using integral_enabler = typename std::enable_if<std::is_integral<T>::value || detail::is_mp_integer<T>::value,int>::type;
+		template <typename T>
+		using rational_enabler = typename std::enable_if<detail::is_mp_rational<T>::value,int>::type;
+	public:
+		/// Call operator, double_double to integral overload.
+		/**
+		 * The conversion will succeed if \p x is a finite integral value representable by
+		 * the target type.
+		 *
+		 * @param[in] x conversion argument.
+		 *
+		 * @return \p x converted to \p To.
+		 *
+		 * @throws std::invalid_argument if \p x is not a finite integral value.
+		 * @throws unspecified any exception thrown by the conversion operator of piranha::double_double.
+		 */
+		template <typename T = To, integral_enabler<T> = 0>
+		T operator()(const double_double &x) const
+		{
+			// NOTE: hi and lo do not overlap, x is integral if and only if both components are.
+			if (unlikely(!std::isfinite(x.hi()) || !std::isfinite(x.lo()) || std::trunc(x.hi()) != x.hi() ||
+				std::trunc(x.lo()) != x.lo()))
+			{
+				piranha_throw(std::invalid_argument,"the input double_double does not represent a finite integral value");
+			}
+			return static_cast<T>(x);
+		}
+		/// Call operator, double_double to rational overload.
+		/**
+		 * @param[in] x conversion argument.
+		 *
+		 * @return \p x converted to piranha::mp_rational.
+		 *
+		 * @throws unspecified any exception thrown by the conversion operator of piranha::double_double.
+		 */
+		template <typename T = To, rational_enabler<T> = 0>
+		T operator()(const double_double &x) const
+		{
+			return static_cast<T>(x);
+		}
+};
+
+inline double_double::~double_double()
+{
+	PIRANHA_TT_CHECK(is_cf,double_double);
+}
+
+}
+
+#endif
@@ -23,10 +23,12 @@
 
 #include <atomic>
 #include <cstdlib>
+#include <gmp.h>
 #include <iostream>
 #include <mutex>
 
 #include "config.hpp"
+#include "detail/gmp_allocator.hpp"
 #include "detail/mpfr.hpp"
 #include "environment.hpp"
 
@@ -63,6 +65,9 @@ std::atomic_bool base_environment<T>::m_shutdown(false);
  * 
  * It is allowed to construct multiple instances of this class even from multiple threads: after the first
  * instance has been created, additional instances will not perform any action.
+ *
+ * The class also allows to replace the memory allocation functions used by GMP (and, in turn, by MPFR) with
+ * an allocator tuned for the storage of multiprecision coefficients (see environment::install_gmp_allocator()).
  * 
  * @author Francesco Biscani (bluescarni@gmail.com)
  */
@@ -115,6 +120,73 @@ class environment: private detail::base_environment<>
 		{
 			return m_shutdown.load();
 		}
+		/// Install the piranha GMP allocator.
+		/**
+		 * This method will replace the memory allocation functions of GMP (which are used also by MPFR, and thus by
+		 * piranha::mp_integer, piranha::mp_rational and piranha::real) with an allocator designed for the multithreaded
+		 * manipulation of series with multiprecision coefficients. Each thread keeps a cache of freed blocks, organised in
+		 * size classes corresponding to the limb counts of small multiprecision values, from which subsequent allocations are
+		 * served without going through the global allocator of the C library. Memory blocks which are not in the size classes
+		 * are managed directly by the C library.
+		 *
+		 * Statistics about the memory allocated via the installed allocator can be queried via the methods of
+		 * piranha::runtime_info.
+		 *
+		 * The memory blocks handled by the allocator are compatible with the default GMP allocation functions,
+		 * so that the allocator can be installed and uninstalled at any time, even when GMP/MPFR objects are alive.
+		 * The allocation functions in use before the installation are assumed to be the default GMP ones.
+		 * If the allocator is already installed, this method has no effect.
+		 *
+		 * \note
+		 * As the GMP allocation functions are global, this method must not be called while other threads are using GMP or MPFR.
+		 *
+		 * @throws unspecified any exception thrown by threading primitives.
+		 */
+		static void install_gmp_allocator()
+		{
+			using gmp_base = detail::base_gmp_allocator<>;
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (gmp_base::s_installed) {
+				return;
+			}
+			::mp_get_memory_functions(&gmp_base::s_old_alloc,&gmp_base::s_old_realloc,&gmp_base::s_old_free);
+			::mp_set_memory_functions(detail::gmp_alloc_func,detail::gmp_realloc_func,detail::gmp_free_func);
+			gmp_base::s_installed = true;
+		}
+		/// Uninstall the piranha GMP allocator.
+		/**
+		 * This method will restore the GMP allocation functions which were in use before the call to
+		 * environment::install_gmp_allocator(), and it will release the memory blocks cached by the calling thread.
+		 * The blocks cached by other threads will be released on their exit. If the allocator is not installed,
+		 * this method has no effect.
+		 *
+		 * \note
+		 * As the GMP allocation functions are global, this method must not be called while other threads are using GMP or MPFR.
+		 *
+		 * @throws unspecified any exception thrown by threading primitives.
+		 */
+		static void uninstall_gmp_allocator()
+		{
+			using gmp_base = detail::base_gmp_allocator<>;
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!gmp_base::s_installed) {
+				return;
+			}
+			::mp_set_memory_functions(gmp_base::s_old_alloc,gmp_base::s_old_realloc,gmp_base::s_old_free);
+			gmp_base::s_installed = false;
+			detail::gmp_alloc_clear_cache(detail::get_gmp_thread_cache());
+		}
+		/// Query the status of the piranha GMP allocator.
+		/**
+		 * @return \p true if the piranha GMP allocator is installed, \p false otherwise.
+		 *
+		 * @throws unspecified any exception thrown by threading primitives.
+		 */
+		static bool gmp_allocator_installed()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			return detail::base_gmp_allocator<>::s_installed;
+		}
 	private:
 		static void cleanup_function()
 		{
@@ -0,0 +1,772 @@
+/***************************************************************************
+ *   Copyright (C) 2009-2011 by Francesco Biscani                          *
+ *   bluescarni@gmail.com                                                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef PIRANHA_EVALUATION_PLAN_HPP
+#define PIRANHA_EVALUATION_PLAN_HPP
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "config.hpp"
+#include "convert_to.hpp"
+#include "detail/sfinae_types.hpp"
+#include "exceptions.hpp"
+#include "kronecker_monomial.hpp"
+#include "math.hpp"
+#include "monomial.hpp"
+#include "mp_integer.hpp"
+#include "pow.hpp"
+#include "real_trigonometric_kronecker_monomial.hpp"
+#include "safe_cast.hpp"
+#include "series.hpp"
+#include "settings.hpp"
+#include "symbol.hpp"
+#include "symbol_set.hpp"
+#include "thread_pool.hpp"
+#include "type_traits.hpp"
+
+namespace piranha
+{
+
+namespace detail
+{
+
+// Extraction of the exponents (or trigonometric multipliers) of a key as a vector of machine integers.
+// Only keys with integral exponents are supported.
+template <typename Key, typename = void>
+struct eval_plan_key
+{
+	static const bool value = false;
+	static const bool trigonometric = false;
+};
+
+template <typename T>
+struct eval_plan_key<kronecker_monomial<T>>
+{
+	static const bool value = true;
+	static const bool trigonometric = false;
+	static void get(std::vector<long long> &out, const kronecker_monomial<T> &k, const symbol_set &args)
+	{
+		const auto v = k.unpack(args);
+		out.clear();
+		std::transform(v.begin(),v.end(),std::back_inserter(out),[](const T &n) {return static_cast<long long>(n);});
+	}
+};
+
+template <typename T, typename S>
+struct eval_plan_key<monomial<T,S>,typename std::enable_if<std::is_integral<T>::value || is_mp_integer<T>::value>::type>
+{
+	static const bool value = true;
+	static const bool trigonometric = false;
+	template <typename U, typename std::enable_if<std::is_integral<U>::value,int>::type = 0>
+	static long long cast(const U &n)
+	{
+		return safe_cast<long long>(n);
+	}
+	template <typename U, typename std::enable_if<!std::is_integral<U>::value,int>::type = 0>
+	static long long cast(const U &n)
+	{
+		return static_cast<long long>(n);
+	}
+	static void get(std::vector<long long> &out, const monomial<T,S> &k, const symbol_set &args)
+	{
+		if (unlikely(k.size() != args.size())) {
+			piranha_throw(std::invalid_argument,"invalid arguments set for evaluation plan");
+		}
+		out.clear();
+		std::transform(k.begin(),k.end(),std::back_inserter(out),[](const T &n) {return cast(n);});
+	}
+};
+
+template <typename T>
+struct eval_plan_key<real_trigonometric_kronecker_monomial<T>>
+{
+	static const bool value = true;
+	static const bool trigonometric = true;
+	static void get(std::vector<long long> &out, const real_trigonometric_kronecker_monomial<T> &k, const symbol_set &args)
+	{
+		const auto v = k.unpack(args);
+		out.clear();
+		std::transform(v.begin(),v.end(),std::back_inserter(out),[](const T &n) {return static_cast<long long>(n);});
+	}
+};
+
+// Requirements on the evaluation type.
+template <typename T>
+class eval_plan_type_reqs: sfinae_types
+{
+		template <typename U>
+		static auto test(const U &x) -> decltype(math::pow(x,std::declval<const long long &>()),void(),yes());
+		static no test(...);
+		template <typename U, typename = void>
+		struct pow_check
+		{
+			static const bool value = false;
+		};
+		template <typename U>
+		struct pow_check<U,typename std::enable_if<std::is_same<decltype(test(std::declval<const U &>())),yes>::value>::type>
+		{
+			static const bool value = std::is_convertible<decltype(math::pow(std::declval<const U &>(),
+				std::declval<const long long &>())),U>::value;
+		};
+	public:
+		static const bool value = std::is_constructible<T,int>::value && std::is_copy_assignable<T>::value &&
+			is_multipliable_in_place<T>::value && is_addable_in_place<T>::value && pow_check<T>::value;
+};
+
+// Additional requirements on the evaluation type for the evaluation of trigonometric keys.
+template <typename T, typename = void>
+struct eval_plan_trig_reqs
+{
+	static const bool value = false;
+};
+
+template <typename T>
+struct eval_plan_trig_reqs<T,typename std::enable_if<
+	std::is_convertible<decltype(math::cos(std::declval<const T &>())),T>::value &&
+	std::is_convertible<decltype(math::sin(std::declval<const T &>())),T>::value &&
+	std::is_constructible<T,const long long &>::value &&
+	std::is_convertible<decltype(std::declval<const T &>() * std::declval<const T &>()),T>::value &&
+	is_subtractable_in_place<T>::value>::type>
+{
+	static const bool value = true;
+};
+
+// Requirements on the series type: the key must be supported, and the coefficient must be either convertible
+// to T or a series satisfying the same requirements.
+template <typename Series, typename T, typename = void>
+struct eval_plan_series
+{
+	static const bool value = false;
+};
+
+template <typename Cf, typename T, typename = void>
+struct eval_plan_cf
+{
+	static const bool value = has_convert_to<T,Cf>::value;
+};
+
+template <typename Cf, typename T>
+struct eval_plan_cf<Cf,T,typename std::enable_if<is_series<Cf>::value>::type>
+{
+	static const bool value = eval_plan_series<Cf,T>::value;
+};
+
+template <typename Series, typename T>
+struct eval_plan_series<Series,T,typename std::enable_if<is_series<Series>::value>::type>
+{
+	using key_type = typename Series::term_type::key_type;
+	static const bool value = eval_plan_key<key_type>::value &&
+		(!eval_plan_key<key_type>::trigonometric || eval_plan_trig_reqs<T>::value) &&
+		eval_plan_cf<typename Series::term_type::cf_type,T>::value;
+};
+
+template <typename Series, typename T>
+using eval_plan_series_enabler = typename std::enable_if<eval_plan_series<Series,T>::value,int>::type;
+
+}
+
+/// Evaluation plan.
+/**
+ * \note
+ * The type \p T must be constructible from \p int, in-place multipliable and addable,
+ * copy-assignable, and piranha::math::pow() must be usable to raise \p T to a <tt>long long</tt> power,
+ * yielding a type convertible to \p T, otherwise a compile-time error will be generated.
+ *
+ * An evaluation plan is a representation of a series optimised for repeated numerical evaluation.
+ * The plan is compiled once from a series, and it stores:
+ * - the coefficients of the series converted to \p T,
+ * - for each symbol, the sorted list of the distinct exponents (and, for trigonometric keys, of the distinct
+ *   multipliers) appearing in the series,
+ * - for each symbol, the position of each term's exponent (or multiplier) in the list of distinct values
+ *   (that is, the exponents are stored in a structure-of-arrays layout),
+ * - the flavours of the trigonometric keys, if any.
+ *
+ * If the coefficients of the series are themselves series (e.g., a piranha::poisson_series with polynomial
+ * coefficients), the plan is built from the flattened list of the terms of the coefficients.
+ *
+ * At evaluation time, a table with the powers of each symbol is computed incrementally (one multiplication per
+ * distinct exponent in the case of consecutive exponents). For trigonometric keys, the cosines and sines of the
+ * multiples of each angle are computed in the same fashion via the angle-addition formulae, starting from a single
+ * call to piranha::math::cos() and piranha::math::sin() per angle. The trigonometric part of each term is then
+ * assembled by angle addition over the symbols. This avoids the creation of dictionaries, the unpacking of the keys
+ * and the calls to piranha::math::pow(), piranha::math::cos() and piranha::math::sin() for each term that take place
+ * in piranha::series::evaluate().
+ *
+ * Multi-point evaluation processes the points in blocks of size evaluation_plan::batch_size. The loops over the
+ * points of a block have a fixed trip count and contiguous operands, so that for floating-point types they can be
+ * vectorised by the compiler. The terms are split in ranges that are processed in parallel via piranha::thread_pool,
+ * if the amount of work (number of terms times number of points) is large enough. The number of threads is
+ * determined via piranha::thread_pool::use_threads() and piranha::settings::get_min_work_per_thread(). Note that
+ * with floating-point types the result may depend on the number of threads used, as the order of the summation
+ * of the terms changes.
+ *
+ * Symbols whose exponents (and multipliers) are zero in all terms are not part of the computation, but they must
+ * still be present in the evaluation dictionaries.
+ *
+ * ## Type requirements ##
+ *
+ * The series that can be used to construct an evaluation plan must have a key type with integral exponents
+ * (piranha::kronecker_monomial, piranha::monomial with integral exponent type, or
+ * piranha::real_trigonometric_kronecker_monomial), and a coefficient type which is either a non-series type convertible
+ * to \p T via piranha::convert_to(), or a series type satisfying the same requirements. If trigonometric keys are
+ * present, \p T must also support piranha::math::cos(), piranha::math::sin(), in-place subtraction and multiplication
+ * by <tt>long long</tt>, all yielding types convertible to \p T.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * This class provides the strong exception safety guarantee for all operations.
+ *
+ * ## Move semantics ##
+ *
+ * Move semantics is equivalent to the move semantics of \p std::vector.
+ */
+template <typename T>
+class evaluation_plan
+{
+		static_assert(detail::eval_plan_type_reqs<T>::value,"Invalid type for evaluation plan.");
+	public:
+		/// Size type.
+		using size_type = typename std::vector<T>::size_type;
+		/// Type of the evaluation dictionaries.
+		using dict_type = std::unordered_map<std::string,T>;
+		/// Number of points evaluated together in multi-point evaluation.
+		static const size_type batch_size = 8u;
+	private:
+		using exps_type = std::vector<long long>;
+		using idx_type = std::vector<size_type>;
+		// Scratch space used during evaluation.
+		struct scratch_type
+		{
+			std::vector<std::vector<T>>	m_powers;
+			std::vector<std::vector<T>>	m_cos;
+			std::vector<std::vector<T>>	m_sin;
+			std::vector<T>			m_acc;
+			std::vector<T>			m_re;
+			std::vector<T>			m_im;
+			std::vector<T>			m_tmp;
+		};
+		// Exponents and trigonometric multipliers accumulated while flattening the series.
+		struct flat_term
+		{
+			exps_type	m_exps;
+			exps_type	m_mults;
+			bool		m_trig;
+			bool		m_flavour;
+		};
+		// Raw (uncompressed) data built during construction: one column per symbol.
+		struct raw_data
+		{
+			std::vector<exps_type>	m_exps;
+			std::vector<exps_type>	m_mults;
+			std::vector<char>	m_flavours;
+		};
+	public:
+		/// Constructor from series.
+		/**
+		 * \note
+		 * This constructor is enabled only if \p Series satisfies the requirements outlined in the class description.
+		 *
+		 * @param[in] s series from which the plan will be compiled.
+		 *
+		 * @throws std::invalid_argument if the exponents of a key are not compatible with the arguments set of the series,
+		 * or if \p s contains nested trigonometric keys.
+		 * @throws unspecified any exception thrown by:
+		 * - memory allocation errors in standard containers,
+		 * - piranha::convert_to(),
+		 * - the unpacking of the keys, or the conversion of the exponents to <tt>long long</tt>,
+		 * - operations on piranha::symbol_set.
+		 */
+		template <typename Series, detail::eval_plan_series_enabler<Series,T> = 0>
+		explicit evaluation_plan(const Series &s)
+		{
+			gather_args(s);
+			raw_data raw;
+			flat_term ctx{exps_type(m_args.size(),0),exps_type(m_args.size(),0),false,true};
+			add_terms(s,ctx,raw);
+			compress(raw.m_exps,m_pow_positions,m_exps,m_pow_idx);
+			compress(raw.m_mults,m_trig_positions,m_mults,m_trig_idx);
+			m_flavours = std::move(raw.m_flavours);
+		}
+		/// Defaulted copy constructor.
+		evaluation_plan(const evaluation_plan &) = default;
+		/// Defaulted move constructor.
+		evaluation_plan(evaluation_plan &&) = default;
+		/// Defaulted copy assignment operator.
+		/**
+		 * @return reference to \p this.
+		 *
+		 * @throws unspecified any exception thrown by the copy constructor.
+		 */
+		evaluation_plan &operator=(const evaluation_plan &) = default;
+		/// Defaulted move assignment operator.
+		/**
+		 * @return reference to \p this.
+		 */
+		evaluation_plan &operator=(evaluation_plan &&) = default;
+		/// Number of terms.
+		/**
+		 * @return the number of terms in the plan (after the flattening of series coefficients).
+		 */
+		size_type size() const
+		{
+			return m_cfs.size();
+		}
+		/// Symbol set getter.
+		/**
+		 * @return a const reference to the set of symbols of the plan, including the symbols of series coefficients.
+		 */
+		const symbol_set &get_symbol_set() const
+		{
+			return m_args;
+		}
+		/// Single-point evaluation from values.
+		/**
+		 * The values in \p values are associated to the symbols of the plan in the order
+		 * given by get_symbol_set().
+		 *
+		 * @param[in] values values of the symbols.
+		 *
+		 * @return the evaluation of the plan.
+		 *
+		 * @throws std::invalid_argument if the size of \p values differs from the number of symbols of the plan.
+		 * @throws unspecified any exception thrown by:
+		 * - memory allocation errors in standard containers,
+		 * - piranha::thread_pool,
+		 * - piranha::math::pow(), piranha::math::cos(), piranha::math::sin(), the construction, assignment and
+		 *   arithmetic operations of \p T.
+		 */
+		T evaluate(const std::vector<T> &values) const
+		{
+			if (unlikely(values.size() != m_args.size())) {
+				piranha_throw(std::invalid_argument,"invalid number of values for evaluation");
+			}
+			return std::move(evaluate_blocks<1u>(values,1u)[0u]);
+		}
+		/// Single-point evaluation from dictionary.
+		/**
+		 * Equivalent to piranha::series::evaluate(). Symbols in \p dict which do not appear in the plan are ignored.
+		 *
+		 * @param[in] dict evaluation dictionary.
+		 *
+		 * @return the evaluation of the plan.
+		 *
+		 * @throws std::invalid_argument if a symbol of the plan does not appear in \p dict.
+		 * @throws unspecified any exception thrown by evaluate(const std::vector<T> &) const.
+		 */
+		T evaluate(const dict_type &dict) const
+		{
+			std::vector<T> values;
+			dict_to_values<1u>(values,dict,0u);
+			return std::move(evaluate_blocks<1u>(values,1u)[0u]);
+		}
+		/// Multi-point evaluation.
+		/**
+		 * The plan will be evaluated at each point in \p points. The points are processed in blocks of size
+		 * evaluation_plan::batch_size, as explained in the class description.
+		 *
+		 * @param[in] points evaluation dictionaries.
+		 *
+		 * @return a vector containing the evaluation of the plan at each point in \p points.
+		 *
+		 * @throws unspecified any exception thrown by evaluate(const dict_type &) const.
+		 */
+		std::vector<T> evaluate(const std::vector<dict_type> &points) const
+		{
+			if (points.empty()) {
+				return std::vector<T>{};
+			}
+			const auto n_blocks = (points.size() - 1u) / batch_size + 1u;
+			// The values are stored block by block, with the values of each symbol contiguous for all the
+			// points in a block. The last block is padded with the values of the last point.
+			std::vector<T> values;
+			for (decltype(points.size()) i = 0u; i < n_blocks * batch_size; ++i) {
+				dict_to_values<batch_size>(values,points[std::min(i,points.size() - 1u)],i % batch_size);
+			}
+			auto retval = evaluate_blocks<batch_size>(values,n_blocks);
+			retval.resize(points.size(),T(0));
+			return retval;
+		}
+	private:
+		// Collect the symbols of s and of its coefficients (recursively).
+		template <typename Series>
+		void gather_args(const Series &s)
+		{
+			m_args = m_args.merge(s.get_symbol_set());
+			gather_args_cf(s,std::integral_constant<bool,is_series<typename Series::term_type::cf_type>::value>());
+		}
+		template <typename Series>
+		void gather_args_cf(const Series &, std::false_type) {}
+		template <typename Series>
+		void gather_args_cf(const Series &s, std::true_type)
+		{
+			const auto it_f = s._container().end();
+			for (auto it = s._container().begin(); it != it_f; ++it) {
+				gather_args(it->m_cf);
+			}
+		}
+		// Flatten the terms of s into raw, given the exponents and multipliers accumulated in ctx.
+		template <typename Series>
+		void add_terms(const Series &s, const flat_term &ctx, raw_data &raw)
+		{
+			using term_type = typename Series::term_type;
+			using key_type = typename term_type::key_type;
+			// Positions of the symbols of s in m_args.
+			idx_type pos;
+			for (const auto &sym: s.get_symbol_set()) {
+				pos.push_back(static_cast<size_type>(m_args.index_of(sym)));
+			}
+			exps_type tmp;
+			flat_term new_ctx(ctx);
+			const auto it_f = s._container().end();
+			for (auto it = s._container().begin(); it != it_f; ++it) {
+				detail::eval_plan_key<key_type>::get(tmp,it->m_key,s.get_symbol_set());
+				piranha_assert(tmp.size() == pos.size());
+				new_ctx = ctx;
+				if (detail::eval_plan_key<key_type>::trigonometric) {
+					if (unlikely(ctx.m_trig)) {
+						piranha_throw(std::invalid_argument,"nested trigonometric keys are not supported in evaluation plans");
+					}
+					for (decltype(tmp.size()) i = 0u; i < tmp.size(); ++i) {
+						new_ctx.m_mults[static_cast<typename exps_type::size_type>(pos[i])] += tmp[i];
+					}
+					new_ctx.m_trig = true;
+					new_ctx.m_flavour = get_flavour(it->m_key);
+				} else {
+					for (decltype(tmp.size()) i = 0u; i < tmp.size(); ++i) {
+						new_ctx.m_exps[static_cast<typename exps_type::size_type>(pos[i])] += tmp[i];
+					}
+				}
+				add_cf(it->m_cf,new_ctx,raw,std::integral_constant<bool,is_series<typename term_type::cf_type>::value>());
+			}
+		}
+		template <typename Cf>
+		void add_cf(const Cf &cf, const flat_term &ctx, raw_data &raw, std::true_type)
+		{
+			add_terms(cf,ctx,raw);
+		}
+		template <typename Cf>
+		void add_cf(const Cf &cf, const flat_term &ctx, raw_data &raw, std::false_type)
+		{
+			m_cfs.push_back(convert_to<T>(cf));
+			append_column_values(raw.m_exps,ctx.m_exps);
+			append_column_values(raw.m_mults,ctx.m_mults);
+			if (ctx.m_trig && raw.m_flavours.empty()) {
+				raw.m_flavours.resize(m_cfs.size() - 1u,char(1));
+			}
+			if (!raw.m_flavours.empty()) {
+				raw.m_flavours.push_back(static_cast<char>(ctx.m_trig ? ctx.m_flavour : true));
+			}
+		}
+		// Append the values in v to the columns in cols. The columns are created lazily, the first time a
+		// nonzero value is found, so that no memory is used for the exponents of purely trigonometric series
+		// and vice versa.
+		void append_column_values(std::vector<exps_type> &cols, const exps_type &v) const
+		{
+			if (cols.empty()) {
+				if (std::all_of(v.begin(),v.end(),[](long long n) {return n == 0;})) {
+					return;
+				}
+				cols.resize(v.size(),exps_type(m_cfs.size() - 1u,0));
+			}
+			piranha_assert(cols.size() == v.size());
+			for (decltype(v.size()) i = 0u; i < v.size(); ++i) {
+				cols[i].push_back(v[i]);
+			}
+		}
+		template <typename Key, typename std::enable_if<detail::eval_plan_key<Key>::trigonometric,int>::type = 0>
+		static bool get_flavour(const Key &k)
+		{
+			return k.get_flavour();
+		}
+		template <typename Key, typename std::enable_if<!detail::eval_plan_key<Key>::trigonometric,int>::type = 0>
+		static bool get_flavour(const Key &)
+		{
+			return true;
+		}
+		// Build the tables of distinct values and the indices for the columns which are not identically zero.
+		static void compress(std::vector<exps_type> &cols, idx_type &positions, std::vector<exps_type> &distinct_values,
+			std::vector<idx_type> &indices)
+		{
+			for (decltype(cols.size()) i = 0u; i < cols.size(); ++i) {
+				exps_type distinct(cols[i]);
+				std::sort(distinct.begin(),distinct.end());
+				distinct.erase(std::unique(distinct.begin(),distinct.end()),distinct.end());
+				if (distinct.size() == 1u && distinct[0u] == 0) {
+					continue;
+				}
+				idx_type idx;
+				idx.reserve(cols[i].size());
+				for (const auto &n: cols[i]) {
+					idx.push_back(static_cast<size_type>(std::lower_bound(distinct.begin(),distinct.end(),n) - distinct.begin()));
+				}
+				// Free the raw column as soon as possible.
+				exps_type().swap(cols[i]);
+				positions.push_back(static_cast<size_type>(i));
+				distinct_values.push_back(std::move(distinct));
+				indices.push_back(std::move(idx));
+			}
+		}
+		// Write the values in dict at the lane-th position of the current block of values.
+		template <size_type L>
+		void dict_to_values(std::vector<T> &values, const dict_type &dict, size_type lane) const
+		{
+			if (lane == 0u) {
+				values.resize(values.size() + m_args.size() * L,T(0));
+			}
+			const auto offset = values.size() - m_args.size() * L;
+			size_type i = 0u;
+			for (const auto &sym: m_args) {
+				const auto it = dict.find(sym.get_name());
+				if (unlikely(it == dict.end())) {
+					piranha_throw(std::invalid_argument,"the symbol '" + sym.get_name() +
+						"' is missing from the evaluation dictionary");
+				}
+				values[offset + i * L + lane] = it->second;
+				++i;
+			}
+		}
+		// Fill the power and trigonometric tables for a block of L points. The values of the i-th symbol for
+		// the points in the block are vals[i * L],...,vals[i * L + L - 1]. The tables are laid out in the same way,
+		// with the L values for each distinct exponent stored contiguously.
+		template <size_type L>
+		void fill_tables(const T *vals, scratch_type &s) const
+		{
+			s.m_powers.resize(m_exps.size());
+			for (decltype(m_exps.size()) i = 0u; i < m_exps.size(); ++i) {
+				const T *x = vals + m_pow_positions[i] * L;
+				const auto &exps = m_exps[i];
+				auto &pw = s.m_powers[i];
+				pw.resize(exps.size() * L,T(0));
+				for (size_type l = 0u; l < L; ++l) {
+					pw[l] = math::pow(x[l],exps[0u]);
+				}
+				for (decltype(exps.size()) j = 1u; j < exps.size(); ++j) {
+					T *cur = &pw[j * L];
+					const T *prev = cur - L;
+					const auto delta = exps[j] - exps[j - 1u];
+					for (size_type l = 0u; l < L; ++l) {
+						cur[l] = prev[l];
+					}
+					if (delta == 1) {
+						for (size_type l = 0u; l < L; ++l) {
+							cur[l] *= x[l];
+						}
+					} else {
+						for (size_type l = 0u; l < L; ++l) {
+							cur[l] *= T(math::pow(x[l],delta));
+						}
+					}
+				}
+			}
+			fill_trig_tables<L>(vals,s);
+		}
+		template <size_type L, typename U = T, typename std::enable_if<detail::eval_plan_trig_reqs<U>::value,int>::type = 0>
+		void fill_trig_tables(const T *vals, scratch_type &s) const
+		{
+			s.m_cos.resize(m_mults.size());
+			s.m_sin.resize(m_mults.size());
+			s.m_tmp.resize(2u * L,T(0));
+			T *c1 = s.m_tmp.data(), *s1 = c1 + L;
+			for (decltype(m_mults.size()) i = 0u; i < m_mults.size(); ++i) {
+				const T *x = vals + m_trig_positions[i] * L;
+				const auto &mults = m_mults[i];
+				auto &ct = s.m_cos[i], &st = s.m_sin[i];
+				ct.resize(mults.size() * L,T(0));
+				st.resize(mults.size() * L,T(0));
+				for (size_type l = 0u; l < L; ++l) {
+					c1[l] = math::cos(x[l]);
+					s1[l] = math::sin(x[l]);
+					ct[l] = math::cos(T(x[l] * static_cast<T>(mults[0u])));
+					st[l] = math::sin(T(x[l] * static_cast<T>(mults[0u])));
+				}
+				for (decltype(mults.size()) j = 1u; j < mults.size(); ++j) {
+					T *cc = &ct[j * L], *sc = &st[j * L];
+					const T *cp = cc - L, *sp = sc - L;
+					if (mults[j] - mults[j - 1u] == 1) {
+						// Angle addition: cos((k+1)x) = cos(kx)cos(x) - sin(kx)sin(x),
+						// sin((k+1)x) = sin(kx)cos(x) + cos(kx)sin(x).
+						for (size_type l = 0u; l < L; ++l) {
+							cc[l] = cp[l];
+							cc[l] *= c1[l];
+							sc[l] = sp[l];
+							sc[l] *= s1[l];
+							cc[l] -= sc[l];
+							sc[l] = sp[l];
+							sc[l] *= c1[l];
+							sc[l] += T(cp[l] * s1[l]);
+						}
+					} else {
+						for (size_type l = 0u; l < L; ++l) {
+							cc[l] = math::cos(T(x[l] * static_cast<T>(mults[j])));
+							sc[l] = math::sin(T(x[l] * static_cast<T>(mults[j])));
+						}
+					}
+				}
+			}
+		}
+		template <size_type L, typename U = T, typename std::enable_if<!detail::eval_plan_trig_reqs<U>::value,int>::type = 0>
+		void fill_trig_tables(const T *, scratch_type &) const
+		{
+			// Plans with trigonometric parts cannot be built for this evaluation type.
+			piranha_assert(m_mults.empty());
+		}
+		// Accumulate in out the terms in the [begin,end) range for a block of L points.
+		template <size_type L>
+		void accumulate(size_type begin, size_type end, scratch_type &s, T *out) const
+		{
+			s.m_acc.resize(L,T(0));
+			T *acc = s.m_acc.data();
+			const bool trig = !m_flavours.empty();
+			if (trig) {
+				s.m_re.resize(L,T(0));
+				s.m_im.resize(L,T(0));
+				s.m_tmp.resize(2u * L,T(0));
+			}
+			for (size_type t = begin; t < end; ++t) {
+				for (size_type l = 0u; l < L; ++l) {
+					acc[l] = m_cfs[t];
+				}
+				for (decltype(m_pow_idx.size()) i = 0u; i < m_pow_idx.size(); ++i) {
+					const T *pw = s.m_powers[i].data() + m_pow_idx[i][t] * L;
+					for (size_type l = 0u; l < L; ++l) {
+						acc[l] *= pw[l];
+					}
+				}
+				if (trig) {
+					accumulate_trig<L>(t,s);
+				}
+				for (size_type l = 0u; l < L; ++l) {
+					out[l] += acc[l];
+				}
+			}
+		}
+		// Multiply the accumulators by the trigonometric part of the t-th term, computed via angle addition
+		// over the symbols.
+		template <size_type L, typename U = T, typename std::enable_if<detail::eval_plan_trig_reqs<U>::value,int>::type = 0>
+		void accumulate_trig(size_type t, scratch_type &s) const
+		{
+			T *acc = s.m_acc.data(), *re = s.m_re.data(), *im = s.m_im.data(), *tmp1 = s.m_tmp.data(), *tmp2 = tmp1 + L;
+			if (m_trig_idx.empty()) {
+				for (size_type l = 0u; l < L; ++l) {
+					re[l] = T(1);
+					im[l] = T(0);
+				}
+			} else {
+				const T *ct = s.m_cos[0u].data() + m_trig_idx[0u][t] * L, *st = s.m_sin[0u].data() + m_trig_idx[0u][t] * L;
+				for (size_type l = 0u; l < L; ++l) {
+					re[l] = ct[l];
+					im[l] = st[l];
+				}
+			}
+			for (decltype(m_trig_idx.size()) i = 1u; i < m_trig_idx.size(); ++i) {
+				const T *ct = s.m_cos[i].data() + m_trig_idx[i][t] * L, *st = s.m_sin[i].data() + m_trig_idx[i][t] * L;
+				for (size_type l = 0u; l < L; ++l) {
+					// re' = re * c - im * s, im' = im * c + re * s.
+					tmp1[l] = re[l];
+					tmp1[l] *= ct[l];
+					tmp2[l] = im[l];
+					tmp2[l] *= st[l];
+					tmp1[l] -= tmp2[l];
+					tmp2[l] = re[l];
+					tmp2[l] *= st[l];
+					im[l] *= ct[l];
+					im[l] += tmp2[l];
+					std::swap(re[l],tmp1[l]);
+				}
+			}
+			const T *f = m_flavours[t] ? re : im;
+			for (size_type l = 0u; l < L; ++l) {
+				acc[l] *= f[l];
+			}
+		}
+		template <size_type L, typename U = T, typename std::enable_if<!detail::eval_plan_trig_reqs<U>::value,int>::type = 0>
+		void accumulate_trig(size_type, scratch_type &) const
+		{
+			piranha_assert(false);
+		}
+		// Evaluate the plan on n_blocks blocks of L points each. The terms are split in ranges which are
+		// processed in parallel, each thread accumulating into a separate vector of partial results.
+		template <size_type L>
+		std::vector<T> evaluate_blocks(const std::vector<T> &values, size_type n_blocks) const
+		{
+			piranha_assert(values.size() == n_blocks * L * m_args.size());
+			std::vector<T> retval(n_blocks * L,T(0));
+			if (m_cfs.empty()) {
+				return retval;
+			}
+			const unsigned n_threads = thread_pool::use_threads(integer(m_cfs.size()) * n_blocks * L,
+				integer(settings::get_min_work_per_thread()));
+			std::vector<std::vector<T>> partials(safe_cast<typename std::vector<std::vector<T>>::size_type>(n_threads - 1u));
+			auto worker = [this,n_threads,n_blocks,&values,&retval,&partials](unsigned thread_idx) {
+				const auto tpt = m_cfs.size() / n_threads;
+				const auto begin = static_cast<size_type>(tpt * thread_idx),
+					end = (thread_idx == n_threads - 1u) ? m_cfs.size() : static_cast<size_type>(tpt * (thread_idx + 1u));
+				std::vector<T> *out = &retval;
+				if (thread_idx) {
+					out = &partials[thread_idx - 1u];
+					out->resize(n_blocks * L,T(0));
+				}
+				scratch_type s;
+				for (size_type b = 0u; b < n_blocks; ++b) {
+					fill_tables<L>(values.data() + b * L * m_args.size(),s);
+					accumulate<L>(begin,end,s,out->data() + b * L);
+				}
+			};
+			if (n_threads == 1u) {
+				worker(0u);
+			} else {
+				thread_pool::parallel_invoke(n_threads,worker);
+				for (const auto &p: partials) {
+					for (size_type i = 0u; i < retval.size(); ++i) {
+						retval[i] += p[i];
+					}
+				}
+			}
+			return retval;
+		}
+	private:
+		symbol_set		m_args;
+		std::vector<T>		m_cfs;
+		// Positions in m_args of the symbols appearing with nonzero exponents, distinct exponents
+		// and per-term indices into the distinct exponents for each of them.
+		idx_type		m_pow_positions;
+		std::vector<exps_type>	m_exps;
+		std::vector<idx_type>	m_pow_idx;
+		// Same as above, for the trigonometric multipliers.
+		idx_type		m_trig_positions;
+		std::vector<exps_type>	m_mults;
+		std::vector<idx_type>	m_trig_idx;
+		// Flavours of the trigonometric parts of the terms (empty if there are no trigonometric keys).
+		std::vector<char>	m_flavours;
+};
+
+template <typename T>
+const typename evaluation_plan<T>::size_type evaluation_plan<T>::batch_size;
+
+}
+
+#endif
@@ -0,0 +1,1215 @@
+/***************************************************************************
+ *   Copyright (C) 2009-2011 by Francesco Biscani                          *
+ *   bluescarni@gmail.com                                                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#ifndef PIRANHA_FLAT_HASH_SET_HPP
+#define PIRANHA_FLAT_HASH_SET_HPP
+
+#include <algorithm>
+#include <boost/iterator/iterator_facade.hpp>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <map>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "config.hpp"
+#include "debug_access.hpp"
+#include "detail/flat_hash_set_group.hpp"
+#include "environment.hpp"
+#include "exceptions.hpp"
+#include "serialization.hpp"
+#include "thread_pool.hpp"
+#include "type_traits.hpp"
+
+namespace piranha
+{
+
+/// Open-addressing hash set.
+/**
+ * Hash set class with the same interface as piranha::hash_set (including the low-level interface), implemented
+ * with open addressing instead of separate chaining. The elements are stored in a contiguous array of slots, and
+ * a parallel array of one-byte control values records whether each slot is empty, full or deleted.
+ * Lookups examine the control bytes in groups of 16 (with a single SSE2 comparison, if available), and they
+ * touch the slots only for the control bytes matching a 7-bit tag derived from the destination bucket of the element.
+ * This layout avoids the pointer chasing of the overflow chains of piranha::hash_set, at the price of a
+ * (slightly) lower maximum load factor.
+ *
+ * The main differences with respect to piranha::hash_set are the following:
+ *
+ * - a bucket is a single slot of the table: bucket() and _bucket() return the slot from which the probing for an
+ *   element starts, and _get_bucket_list() returns the (possibly empty) range of elements stored in a slot;
+ * - erasing an element leaves behind a tombstone in its slot. The tombstones are purged when the table is rehashed;
+ * - _unique_insert() will rehash the table if no more slots are available for the insertion. Because of this,
+ *   the low-level interface cannot be used concurrently from multiple threads, even if the threads operate on
+ *   different buckets;
+ * - iterators are invalidated only by rehash operations (including the ones triggered by insertions).
+ *   The end() iterator is never invalidated.
+ *
+ * Because of the limitations of the low-level interface, this class is not a replacement for piranha::hash_set
+ * as the container of the terms of a series: the series multipliers insert concurrently into disjoint ranges of buckets.
+ *
+ * Note that, as in piranha::hash_set, the destination bucket of an element is its hash value reduced modulo
+ * the (power-of-two) number of buckets.
+ *
+ * ## Type requirements ##
+ *
+ * - \p T must satisfy piranha::is_container_element,
+ * - \p Hash must satisfy piranha::is_hash_function_object,
+ * - \p Pred must satisfy piranha::is_equality_function_object.
+ *
+ * ## Exception safety guarantee ##
+ *
+ * This class provides the strong exception safety guarantee for all operations apart from methods involving insertion,
+ * which provide the basic guarantee (after a failed insertion, the set will be left in an unspecified but valid state).
+ *
+ * ## Move semantics ##
+ *
+ * Move construction and move assignment will leave the moved-from object equivalent to an empty set whose hasher and
+ * equality predicate have been moved-from.
+ *
+ * ## Serialization ##
+ *
+ * This class supports serialization if the contained type supports it. Note that the hasher and the comparator
+ * are not serialised and they are recreated from scratch upon deserialization.
+ *
+ * @author Francesco Biscani (bluescarni@gmail.com)
+ */
+template <typename T, typename Hash = std::hash<T>, typename Pred = std::equal_to<T>>
+class flat_hash_set
+{
+		PIRANHA_TT_CHECK(is_container_element,T);
+		PIRANHA_TT_CHECK(is_hash_function_object,Hash,T);
+		PIRANHA_TT_CHECK(is_equality_function_object,Pred,T);
+		// Make friend with debug access class.
+		template <typename U>
+		friend class debug_access;
+		using ctrl_t = detail::fhs_ctrl_t;
+		using group = detail::fhs_group;
+		// Storage for a single element.
+		using slot_type = typename std::aligned_storage<sizeof(T),alignof(T)>::type;
+		using slot_allocator_type = std::allocator<slot_type>;
+		using ctrl_allocator_type = std::allocator<ctrl_t>;
+	public:
+		/// Functor type for the calculation of hash values.
+		using hasher = Hash;
+		/// Functor type for comparing the items in the set.
+		using key_equal = Pred;
+		/// Key type.
+		using key_type = T;
+		/// Size type.
+		/**
+		 * Alias for \p std::size_t.
+		 */
+		using size_type = std::size_t;
+	private:
+		// Internal pack type, containing the pointer to the slots and the hash/equal functors.
+		// As in hash_set, in many cases the functors are stateless and the tuple can exploit EBCO.
+		using pack_type = std::tuple<slot_type *,hasher,key_equal>;
+		slot_type *&slots()
+		{
+			return std::get<0u>(m_pack);
+		}
+		slot_type *const &slots() const
+		{
+			return std::get<0u>(m_pack);
+		}
+		const hasher &hash() const
+		{
+			return std::get<1u>(m_pack);
+		}
+		const key_equal &k_equal() const
+		{
+			return std::get<2u>(m_pack);
+		}
+		// Index value signalling the end of the set in iterators.
+		static constexpr size_type end_idx()
+		{
+			return std::numeric_limits<size_type>::max();
+		}
+		// Access to the element stored in a slot. See the NOTEs in hash_set regarding the casts.
+		T *slot_ptr(const size_type &idx)
+		{
+			return static_cast<T *>(static_cast<void *>(&slots()[idx]));
+		}
+		const T *slot_ptr(const size_type &idx) const
+		{
+			return static_cast<const T *>(static_cast<const void *>(&slots()[idx]));
+		}
+		size_type mask() const
+		{
+			return (size_type(1u) << m_log2_size) - 1u;
+		}
+		// Number of control bytes for a table with cap slots: the first group_width - 1 control bytes are cloned
+		// at the end of the array, so that a group can be read starting from any slot without wrapping around.
+		static size_type n_ctrl(const size_type &cap)
+		{
+			return static_cast<size_type>(cap + (detail::fhs_group_width - 1u));
+		}
+		// Maximum number of non-empty slots in a table with cap slots.
+		static size_type max_growth(const size_type &cap)
+		{
+			return static_cast<size_type>(cap - cap / 8u);
+		}
+		// The 7-bit tag stored in the control byte of a full slot. The tag is computed from the destination
+		// bucket rather than from the full hash value, so that the low-level methods do not need to
+		// recompute the hash value of the element. Elements whose destination buckets coincide will need
+		// to be checked with the equality predicate anyway.
+		static ctrl_t tag(const size_type &bucket_idx)
+		{
+			return static_cast<ctrl_t>(static_cast<size_type>(bucket_idx * static_cast<size_type>(0x9E3779B97F4A7C15ull)) >>
+				(std::numeric_limits<size_type>::digits - 7));
+		}
+		// Set a control byte, taking care of the cloned bytes.
+		void set_ctrl(const size_type &idx, ctrl_t value)
+		{
+			piranha_assert(idx < bucket_count());
+			m_ctrl[idx] = value;
+			if (idx < detail::fhs_group_width - 1u) {
+				m_ctrl[bucket_count() + idx] = value;
+			}
+		}
+		// The probing sequence: groups are visited at triangular offsets from the destination bucket.
+		// As the number of slots is a power of two not less than the group width, the sequence eventually
+		// visits all the slots of the table.
+		struct probe_seq
+		{
+			explicit probe_seq(const size_type &pos, const size_type &mask):m_pos(pos),m_mask(mask),m_offset(0u) {}
+			void next()
+			{
+				m_offset = static_cast<size_type>(m_offset + detail::fhs_group_width);
+				m_pos = static_cast<size_type>((m_pos + m_offset) & m_mask);
+			}
+			size_type slot(unsigned i) const
+			{
+				return static_cast<size_type>((m_pos + i) & m_mask);
+			}
+			size_type	m_pos;
+			size_type	m_mask;
+			size_type	m_offset;
+		};
+		// Locate the first slot available for insertion in the probing sequence starting from bucket_idx.
+		size_type find_insert_slot(const size_type &bucket_idx) const
+		{
+			piranha_assert(bucket_idx < bucket_count());
+			probe_seq seq(bucket_idx,mask());
+			while (true) {
+				const auto m = group(m_ctrl + seq.m_pos).match_empty_or_deleted();
+				if (m) {
+					return seq.slot(detail::fhs_lowest_bit(m));
+				}
+				// NOTE: the growth limit guarantees that there is always at least one empty slot
+				// in the table.
+				seq.next();
+			}
+		}
+		// Index of the first full slot starting from idx, or end_idx() if there are no full slots left.
+		size_type next_full(size_type idx) const
+		{
+			const auto cap = bucket_count();
+			for (; idx < cap; idx = static_cast<size_type>(idx + detail::fhs_group_width)) {
+				const auto m = group(m_ctrl + idx).match_full();
+				if (m) {
+					// NOTE: the match could be in the cloned bytes, in which case
+					// there are no full slots left in [idx,cap[.
+					const auto retval = static_cast<size_type>(idx + detail::fhs_lowest_bit(m));
+					return (retval < cap) ? retval : end_idx();
+				}
+			}
+			return end_idx();
+		}
+		// Definition of the iterator type for the set.
+		template <typename Key>
+		class iterator_impl: public boost::iterator_facade<iterator_impl<Key>,Key,boost::forward_traversal_tag>
+		{
+				friend class flat_hash_set;
+				typedef typename std::conditional<std::is_const<Key>::value,flat_hash_set const,flat_hash_set>::type set_type;
+			public:
+				iterator_impl():m_set(nullptr),m_idx(end_idx()) {}
+				explicit iterator_impl(set_type *set, const size_type &idx):m_set(set),m_idx(idx) {}
+			private:
+				friend class boost::iterator_core_access;
+				void increment()
+				{
+					piranha_assert(m_set && m_idx < m_set->bucket_count());
+					m_idx = m_set->next_full(static_cast<size_type>(m_idx + 1u));
+				}
+				bool equal(const iterator_impl &other) const
+				{
+					// NOTE: comparing iterators from different containers is UB
+					// in the standard.
+					piranha_assert(m_set && other.m_set);
+					return m_idx == other.m_idx;
+				}
+				Key &dereference() const
+				{
+					piranha_assert(m_set && m_idx < m_set->bucket_count() && m_set->m_ctrl[m_idx] >= 0);
+					return *m_set->slot_ptr(m_idx);
+				}
+			private:
+				set_type	*m_set;
+				size_type	m_idx;
+		};
+		// Range of the elements stored in a slot.
+		class slot_range
+		{
+			public:
+				explicit slot_range(const T *begin, bool full):m_begin(begin),m_end(begin + (full ? 1 : 0)) {}
+				const T *begin() const
+				{
+					return m_begin;
+				}
+				const T *end() const
+				{
+					return m_end;
+				}
+				bool empty() const
+				{
+					return m_begin == m_end;
+				}
+			private:
+				const T	*m_begin;
+				const T	*m_end;
+		};
+		// Get log2 of set size at least equal to hint. To be used only when hint is not zero.
+		static size_type get_log2_from_hint(const size_type &hint)
+		{
+			piranha_assert(hint);
+			// NOTE: tables have at least as many slots as the group width.
+			for (size_type i = 4u; i < static_cast<size_type>(std::numeric_limits<size_type>::digits); ++i) {
+				if ((size_type(1u) << i) >= hint) {
+					return i;
+				}
+			}
+			piranha_throw(std::bad_alloc,);
+		}
+		// Fill the control bytes of a new table with the empty value. If n_threads is not 1, the bytes will be
+		// written by multiple threads, each one writing a contiguous range (so that the memory pages are
+		// first touched by the threads that are going to use them, as in hash_set).
+		static void init_ctrl(ctrl_t *ctrl, const size_type &cap, unsigned n_threads)
+		{
+			const auto n = n_ctrl(cap);
+			if (n_threads == 1u) {
+				std::fill(ctrl,ctrl + n,detail::fhs_empty);
+				return;
+			}
+			const auto wpt = static_cast<size_type>(cap / n_threads);
+			thread_pool::parallel_invoke(n_threads,[ctrl,n,wpt,n_threads](unsigned i) {
+				const auto start = static_cast<size_type>(wpt * i),
+					end = static_cast<size_type>((i == n_threads - 1u) ? n : wpt * (i + 1u));
+				std::fill(ctrl + start,ctrl + end,detail::fhs_empty);
+			});
+		}
+		// Allocate an empty table with 2**log2_size slots.
+		void init_from_log2_size(const size_type &log2_size, unsigned n_threads)
+		{
+			piranha_assert(!slots() && !m_ctrl && !m_log2_size && !m_n_elements && !m_growth_left);
+			const size_type cap = size_type(1u) << log2_size;
+			std::unique_ptr<slot_type,slot_deleter> new_slots(slot_allocator_type{}.allocate(cap),slot_deleter{cap});
+			std::unique_ptr<ctrl_t,ctrl_deleter> new_ctrl(ctrl_allocator_type{}.allocate(n_ctrl(cap)),ctrl_deleter{n_ctrl(cap)});
+			init_ctrl(new_ctrl.get(),cap,n_threads);
+			slots() = new_slots.release();
+			m_ctrl = new_ctrl.release();
+			m_log2_size = log2_size;
+			m_growth_left = max_growth(cap);
+		}
+		void init_from_n_buckets(const size_type &n_buckets, unsigned n_threads)
+		{
+			if (unlikely(!n_threads)) {
+				piranha_throw(std::invalid_argument,"the number of threads must be strictly positive");
+			}
+			// Proceed to actual construction only if the requested number of buckets is nonzero.
+			if (!n_buckets) {
+				return;
+			}
+			init_from_log2_size(get_log2_from_hint(n_buckets),n_threads);
+		}
+		// Deleters for the arrays.
+		struct slot_deleter
+		{
+			void operator()(slot_type *p) const
+			{
+				slot_allocator_type{}.deallocate(p,m_size);
+			}
+			size_type m_size;
+		};
+		struct ctrl_deleter
+		{
+			void operator()(ctrl_t *p) const
+			{
+				ctrl_allocator_type{}.deallocate(p,m_size);
+			}
+			size_type m_size;
+		};
+		// Destroy all elements and deallocate the arrays.
+		void destroy_and_deallocate()
+		{
+			if (slots()) {
+				const auto cap = bucket_count();
+				for (size_type i = 0u; i < cap; ++i) {
+					if (m_ctrl[i] >= 0) {
+						slot_ptr(i)->~T();
+					}
+				}
+				slot_allocator_type{}.deallocate(slots(),cap);
+				ctrl_allocator_type{}.deallocate(m_ctrl,n_ctrl(cap));
+			} else {
+				piranha_assert(!m_ctrl && !m_log2_size && !m_n_elements && !m_growth_left);
+			}
+		}
+		// Reset the members to the state of an empty set.
+		void reset()
+		{
+			slots() = nullptr;
+			m_ctrl = nullptr;
+			m_log2_size = 0u;
+			m_n_elements = 0u;
+			m_growth_left = 0u;
+		}
+		// Move all the elements into a new table with 2**new_log2_size slots, purging the tombstones.
+		// The number of elements is not changed.
+		void rehash_impl(const size_type &new_log2_size, unsigned n_threads)
+		{
+			flat_hash_set new_set(hash(),k_equal());
+			new_set.init_from_log2_size(new_log2_size,n_threads);
+			const auto cap = bucket_count();
+			try {
+				for (size_type i = 0u; i < cap; ++i) {
+					if (m_ctrl[i] < 0) {
+						continue;
+					}
+					if (unlikely(!new_set.m_growth_left)) {
+						// NOTE: this can happen only if the size of this was inconsistent, or if the
+						// requested size was too small.
+						piranha_throw(std::bad_alloc,);
+					}
+					auto p = slot_ptr(i);
+					const auto new_bucket = new_set._bucket(*p);
+					const auto new_idx = new_set.find_insert_slot(new_bucket);
+					::new (static_cast<void *>(&new_set.slots()[new_idx])) T(std::move(*p));
+					new_set.set_ctrl(new_idx,tag(new_bucket));
+					--new_set.m_growth_left;
+					p->~T();
+					set_ctrl(i,detail::fhs_deleted);
+				}
+			} catch (...) {
+				// Clear up both this and the new set upon any kind of error.
+				clear();
+				new_set.clear();
+				throw;
+			}
+			new_set.m_n_elements = m_n_elements;
+			// All the elements have been moved out, just deallocate the old arrays.
+			if (slots()) {
+				slot_allocator_type{}.deallocate(slots(),cap);
+				ctrl_allocator_type{}.deallocate(m_ctrl,n_ctrl(cap));
+			}
+			reset();
+			*this = std::move(new_set);
+		}
+		// Make room for at least one more insertion, called when the growth limit has been reached.
+		// If the table is clogged by tombstones, it will be rehashed in place, otherwise its size will be doubled.
+		void grow()
+		{
+			if (!slots()) {
+				rehash_impl(get_log2_from_hint(detail::fhs_group_width),1u);
+				return;
+			}
+			const auto cap = bucket_count();
+			size_type n_full = 0u;
+			for (size_type i = 0u; i < cap; ++i) {
+				n_full = static_cast<size_type>(n_full + (m_ctrl[i] >= 0));
+			}
+			if (n_full <= max_growth(cap) / 2u) {
+				rehash_impl(m_log2_size,1u);
+			} else {
+				if (unlikely(m_log2_size >= static_cast<size_type>(std::numeric_limits<size_type>::digits - 1))) {
+					piranha_throw(std::bad_alloc,);
+				}
+				rehash_impl(static_cast<size_type>(m_log2_size + 1u),1u);
+			}
+		}
+		// Serialization support.
+		friend class boost::serialization::access;
+		template <class Archive>
+		void save(Archive &ar, unsigned int) const
+		{
+			// Save the number of elements first.
+			ar & m_n_elements;
+			// Save the elements one by one.
+			const auto it_f = end();
+			for (auto it = begin(); it != it_f; ++it) {
+				ar & (*it);
+			}
+		}
+		template <class Archive>
+		void load(Archive &ar, unsigned int)
+		{
+			// Erase this and work on an empty one (see the notes in hash_set).
+			*this = flat_hash_set();
+			// Recover the number of elements.
+			size_type n_elements;
+			ar & n_elements;
+			// Recover the elements one by one.
+			for (size_type i = 0u; i < n_elements; ++i) {
+				key_type k;
+				ar & k;
+				insert(std::move(k));
+			}
+		}
+		BOOST_SERIALIZATION_SPLIT_MEMBER()
+		// Enabler for insert().
+		template <typename U>
+		using insert_enabler = typename std::enable_if<std::is_same<key_type,typename std::decay<U>::type>::value,int>::type;
+		// Run a consistency check on the set, will return false if something is wrong.
+		bool sanity_check() const
+		{
+			// Ignore sanity checks on shutdown.
+			if (environment::shutdown()) {
+				return true;
+			}
+			if (!slots()) {
+				return !m_ctrl && !m_log2_size && !m_n_elements && !m_growth_left;
+			}
+			const auto cap = bucket_count();
+			size_type count = 0u, used = 0u;
+			for (size_type i = 0u; i < cap; ++i) {
+				if (m_ctrl[i] != detail::fhs_empty) {
+					++used;
+				}
+				if (m_ctrl[i] < 0) {
+					continue;
+				}
+				const auto b_idx = _bucket(*slot_ptr(i));
+				// The tag must be consistent and the element must be reachable from its bucket.
+				if (m_ctrl[i] != tag(b_idx) || _find(*slot_ptr(i),b_idx).m_idx != i) {
+					return false;
+				}
+				++count;
+			}
+			// Check the cloned control bytes.
+			for (size_type i = 0u; i < detail::fhs_group_width - 1u; ++i) {
+				if (m_ctrl[cap + i] != m_ctrl[i & mask()]) {
+					return false;
+				}
+			}
+			if (count != m_n_elements || used + m_growth_left != max_growth(cap)) {
+				return false;
+			}
+			// Check size is consistent with number of iterator traversals.
+			count = 0u;
+			for (auto it = begin(); it != end(); ++it, ++count) {}
+			return count == m_n_elements;
+		}
+	public:
+		/// Iterator type.
+		/**
+		 * A read-only forward iterator.
+		 */
+		using iterator = iterator_impl<key_type const>;
+	private:
+		// Static checks on the iterator type.
+		PIRANHA_TT_CHECK(is_forward_iterator,iterator);
+	public:
+		/// Const iterator type.
+		/**
+		 * Equivalent to the iterator type.
+		 */
+		using const_iterator = iterator;
+		/// Local iterator.
+		/**
+		 * Const iterator that can be used to iterate through a single bucket.
+		 */
+		using local_iterator = key_type const *;
+		/// Default constructor.
+		/**
+		 * If not specified, it will default-initialise the hasher and the equality predicate. The resulting
+		 * hash set will be empty.
+		 *
+		 * @param[in] h hasher functor.
+		 * @param[in] k equality predicate.
+		 *
+		 * @throws unspecified any exception thrown by the copy constructors of <tt>Hash</tt> or <tt>Pred</tt>.
+		 */
+		flat_hash_set(const hasher &h = hasher{}, const key_equal &k = key_equal{}):
+			m_pack(nullptr,h,k),m_ctrl(nullptr),m_log2_size(0u),m_n_elements(0u),m_growth_left(0u) {}
+		/// Constructor from number of buckets.
+		/**
+		 * Will construct a set whose number of buckets is at least equal to \p n_buckets. If \p n_threads is not 1,
+		 * then the first \p n_threads threads from piranha::thread_pool will be used concurrently for the initialisation
+		 * of the set.
+		 *
+		 * @param[in] n_buckets desired number of buckets.
+		 * @param[in] h hasher functor.
+		 * @param[in] k equality predicate.
+		 * @param[in] n_threads number of threads to use during initialisation.
+		 *
+		 * @throws std::bad_alloc if the desired number of buckets is greater than an implementation-defined maximum, or in case
+		 * of memory errors.
+		 * @throws std::invalid_argument if \p n_threads is zero.
+		 * @throws unspecified any exception thrown by:
+		 * - the copy constructors of <tt>Hash</tt> or <tt>Pred</tt>,
+		 * - piranha::thread_pool::parallel_invoke(), if \p n_threads is not 1.
+		 */
+		explicit flat_hash_set(const size_type &n_buckets, const hasher &h = hasher{}, const key_equal &k = key_equal{}, unsigned n_threads = 1u):
+			m_pack(nullptr,h,k),m_ctrl(nullptr),m_log2_size(0u),m_n_elements(0u),m_growth_left(0u)
+		{
+			init_from_n_buckets(n_buckets,n_threads);
+		}
+		/// Copy constructor.
+		/**
+		 * The hasher and the equality comparator will also be copied.
+		 *
+		 * @param[in] other piranha::flat_hash_set that will be copied into \p this.
+		 *
+		 * @throws unspecified any exception thrown by memory allocation errors,
+		 * the copy constructor of the stored type, <tt>Hash</tt> or <tt>Pred</tt>.
+		 */
+		flat_hash_set(const flat_hash_set &other):
+			m_pack(nullptr,other.hash(),other.k_equal()),m_ctrl(nullptr),m_log2_size(0u),m_n_elements(0u),m_growth_left(0u)
+		{
+			// Proceed to actual copy only if other has some content.
+			if (!other.slots()) {
+				return;
+			}
+			const auto cap = other.bucket_count();
+			std::unique_ptr<slot_type,slot_deleter> new_slots(slot_allocator_type{}.allocate(cap),slot_deleter{cap});
+			std::unique_ptr<ctrl_t,ctrl_deleter> new_ctrl(ctrl_allocator_type{}.allocate(n_ctrl(cap)),ctrl_deleter{n_ctrl(cap)});
+			// NOTE: the slots are copied as they are, including the tombstones.
+			std::copy(other.m_ctrl,other.m_ctrl + n_ctrl(cap),new_ctrl.get());
+			size_type i = 0u;
+			try {
+				for (; i < cap; ++i) {
+					if (other.m_ctrl[i] >= 0) {
+						::new (static_cast<void *>(&new_slots.get()[i])) T(*other.slot_ptr(i));
+					}
+				}
+			} catch (...) {
+				// Unwind the construction before re-throwing.
+				for (size_type j = 0u; j < i; ++j) {
+					if (other.m_ctrl[j] >= 0) {
+						static_cast<T *>(static_cast<void *>(&new_slots.get()[j]))->~T();
+					}
+				}
+				throw;
+			}
+			slots() = new_slots.release();
+			m_ctrl = new_ctrl.release();
+			m_log2_size = other.m_log2_size;
+			m_n_elements = other.m_n_elements;
+			m_growth_left = other.m_growth_left;
+		}
+		/// Move constructor.
+		/**
+		 * After the move, \p other will have zero buckets and zero elements, and its hasher and equality predicate
+		 * will have been used to move-construct their counterparts in \p this.
+		 *
+		 * @param[in] other set to be moved.
+		 */
+		flat_hash_set(flat_hash_set &&other) noexcept : m_pack(std::move(other.m_pack)),m_ctrl(other.m_ctrl),
+			m_log2_size(other.m_log2_size),m_n_elements(other.m_n_elements),m_growth_left(other.m_growth_left)
+		{
+			// Clear out the other one.
+			other.reset();
+		}
+		/// Constructor from range.
+		/**
+		 * Create a set with a copy of a range.
+		 *
+		 * @param[in] begin begin of range.
+		 * @param[in] end end of range.
+		 * @param[in] n_buckets number of initial buckets.
+		 * @param[in] h hash functor.
+		 * @param[in] k key equality predicate.
+		 *
+		 * @throws std::bad_alloc if the desired number of buckets is greater than an implementation-defined maximum.
+		 * @throws unspecified any exception thrown by the copy constructors of <tt>Hash</tt> or <tt>Pred</tt>, or arising from
+		 * calling insert() on the elements of the range.
+		 */
+		template <typename InputIterator>
+		explicit flat_hash_set(const InputIterator &begin, const InputIterator &end, const size_type &n_buckets = 0u,
+			const hasher &h = hasher{}, const key_equal &k = key_equal{}):
+			m_pack(nullptr,h,k),m_ctrl(nullptr),m_log2_size(0u),m_n_elements(0u),m_growth_left(0u)
+		{
+			init_from_n_buckets(n_buckets,1u);
+			for (auto it = begin; it != end; ++it) {
+				insert(*it);
+			}
+		}
+		/// Constructor from initializer list.
+		/**
+		 * Will insert() all the elements of the initializer list, ignoring the return value of the operation.
+		 * Hash functor and equality predicate will be default-constructed.
+		 *
+		 * @param[in] list initializer list of elements to be inserted.
+		 *
+		 * @throws std::bad_alloc if the desired number of buckets is greater than an implementation-defined maximum.
+		 * @throws unspecified any exception thrown by either insert() or of the default constructor of <tt>Hash</tt> or <tt>Pred</tt>.
+		 */
+		template <typename U>
+		explicit flat_hash_set(std::initializer_list<U> list):
+			m_pack(nullptr,hasher{},key_equal{}),m_ctrl(nullptr),m_log2_size(0u),m_n_elements(0u),m_growth_left(0u)
+		{
+			// We do not care here for possible truncation of list.size(), as this is only an optimization.
+			init_from_n_buckets(static_cast<size_type>(static_cast<double>(list.size()) / max_load_factor()) + 1u,1u);
+			for (const auto &x: list) {
+				insert(x);
+			}
+		}
+		/// Destructor.
+		/**
+		 * No side effects.
+		 */
+		~flat_hash_set()
+		{
+			piranha_assert(sanity_check());
+			destroy_and_deallocate();
+		}
+		/// Copy assignment operator.
+		/**
+		 * @param[in] other assignment argument.
+		 *
+		 * @return reference to \p this.
+		 *
+		 * @throws unspecified any exception thrown by the copy constructor.
+		 */
+		flat_hash_set &operator=(const flat_hash_set &other)
+		{
+			if (likely(this != &other)) {
+				flat_hash_set tmp(other);
+				*this = std::move(tmp);
+			}
+			return *this;
+		}
+		/// Move assignment operator.
+		/**
+		 * @param[in] other set to be moved into \p this.
+		 *
+		 * @return reference to \p this.
+		 */
+		flat_hash_set &operator=(flat_hash_set &&other) noexcept
+		{
+			if (likely(this != &other)) {
+				destroy_and_deallocate();
+				m_pack = std::move(other.m_pack);
+				m_ctrl = other.m_ctrl;
+				m_log2_size = other.m_log2_size;
+				m_n_elements = other.m_n_elements;
+				m_growth_left = other.m_growth_left;
+				// Zero out other.
+				other.reset();
+			}
+			return *this;
+		}
+		/// Const begin iterator.
+		/**
+		 * @return flat_hash_set::const_iterator to the first element of the set, or end() if the set is empty.
+		 */
+		const_iterator begin() const
+		{
+			return const_iterator(this,next_full(0u));
+		}
+		/// Const end iterator.
+		/**
+		 * @return flat_hash_set::const_iterator to the position past the last element of the set.
+		 */
+		const_iterator end() const
+		{
+			return const_iterator(this,end_idx());
+		}
+		/// Begin iterator.
+		/**
+		 * @return flat_hash_set::iterator to the first element of the set, or end() if the set is empty.
+		 */
+		iterator begin()
+		{
+			return static_cast<flat_hash_set const *>(this)->begin();
+		}
+		/// End iterator.
+		/**
+		 * @return flat_hash_set::iterator to the position past the last element of the set.
+		 */
+		iterator end()
+		{
+			return static_cast<flat_hash_set const *>(this)->end();
+		}
+		/// Number of elements contained in the set.
+		/**
+		 * @return number of elements in the set.
+		 */
+		size_type size() const
+		{
+			return m_n_elements;
+		}
+		/// Test for empty set.
+		/**
+		 * @return \p true if size() returns 0, \p false otherwise.
+		 */
+		bool empty() const
+		{
+			return !size();
+		}
+		/// Number of buckets.
+		/**
+		 * @return number of buckets (i.e., slots) in the set.
+		 */
+		size_type bucket_count() const
+		{
+			return (slots()) ? (size_type(1u) << m_log2_size) : size_type(0u);
+		}
+		/// Load factor.
+		/**
+		 * @return <tt>(double)size() / bucket_count()</tt>, or 0 if the set is empty.
+		 */
+		double load_factor() const
+		{
+			const auto b_count = bucket_count();
+			return (b_count) ? static_cast<double>(size()) / static_cast<double>(b_count) : 0.;
+		}
+		/// Index of destination bucket.
+		/**
+		 * Index of the slot from which the search for \p k starts. The index of the
+		 * destination bucket is the hash value reduced modulo the bucket count.
+		 *
+		 * @param[in] k input argument.
+		 *
+		 * @return index of the destination bucket for \p k.
+		 *
+		 * @throws piranha::zero_division_error if bucket_count() returns zero.
+		 * @throws unspecified any exception thrown by _bucket().
+		 */
+		size_type bucket(const key_type &k) const
+		{
+			if (unlikely(!bucket_count())) {
+				piranha_throw(zero_division_error,"cannot calculate bucket index in an empty set");
+			}
+			return _bucket(k);
+		}
+		/// Find element.
+		/**
+		 * @param[in] k element to be located.
+		 *
+		 * @return flat_hash_set::const_iterator to <tt>k</tt>'s position in the set, or end() if \p k is not in the set.
+		 *
+		 * @throws unspecified any exception thrown by _find() or by _bucket().
+		 */
+		const_iterator find(const key_type &k) const
+		{
+			if (unlikely(!bucket_count())) {
+				return end();
+			}
+			return _find(k,_bucket(k));
+		}
+		/// Find element.
+		/**
+		 * @param[in] k element to be located.
+		 *
+		 * @return flat_hash_set::iterator to <tt>k</tt>'s position in the set, or end() if \p k is not in the set.
+		 *
+		 * @throws unspecified any exception thrown by _find().
+		 */
+		iterator find(const key_type &k)
+		{
+			return static_cast<const flat_hash_set *>(this)->find(k);
+		}
+		/// Maximum load factor.
+		/**
+		 * @return the maximum load factor allowed before a resize.
+		 */
+		double max_load_factor() const
+		{
+			// NOTE: this must be consistent with max_growth().
+			return .875;
+		}
+		/// Insert element.
+		/**
+		 * \note
+		 * This template method is activated only if \p T and \p U are the same type, aside from cv qualifications and references.
+		 *
+		 * If no other key equivalent to \p k exists in the set, the insertion is successful and returns the <tt>(it,true)</tt>
+		 * pair - where \p it is the position in the set into which the object has been inserted. Otherwise, the return value
+		 * will be <tt>(it,false)</tt> - where \p it is the position of the existing equivalent object.
+		 *
+		 * @param[in] k object that will be inserted into the set.
+		 *
+		 * @return <tt>(flat_hash_set::iterator,bool)</tt> pair containing an iterator to the newly-inserted object (or its existing
+		 * equivalent) and the result of the operation.
+		 *
+		 * @throws unspecified any exception thrown by:
+		 * - flat_hash_set::key_type's copy constructor,
+		 * - _find(),
+		 * - _bucket(),
+		 * - _unique_insert().
+		 * @throws std::overflow_error if a successful insertion would result in size() exceeding the maximum
+		 * value representable by type piranha::flat_hash_set::size_type.
+		 * @throws std::bad_alloc if the operation results in a resize of the set past an implementation-defined
+		 * maximum number of buckets.
+		 */
+		template <typename U, insert_enabler<U> = 0>
+		std::pair<iterator,bool> insert(U &&k)
+		{
+			// Handle the case of a set with no buckets.
+			if (unlikely(!bucket_count())) {
+				_increase_size();
+			}
+			// Try to locate the element.
+			auto bucket_idx = _bucket(k);
+			const auto it = _find(k,bucket_idx);
+			if (it != end()) {
+				// Item already present, exit.
+				return std::make_pair(it,false);
+			}
+			if (unlikely(m_n_elements == std::numeric_limits<size_type>::max())) {
+				piranha_throw(std::overflow_error,"maximum number of elements reached");
+			}
+			// Item is new. Handle the case in which we need to rehash because of load factor.
+			if (unlikely(static_cast<double>(m_n_elements + size_type(1u)) / static_cast<double>(bucket_count()) > max_load_factor())) {
+				_increase_size();
+				// We need a new bucket index in case of a rehash.
+				bucket_idx = _bucket(k);
+			}
+			const auto it_retval = _unique_insert(std::forward<U>(k),bucket_idx);
+			++m_n_elements;
+			return std::make_pair(it_retval,true);
+		}
+		/// Erase element.
+		/**
+		 * Erase the element to which \p it points. \p it must be a valid iterator
+		 * pointing to an element of the set.
+		 *
+		 * Erasing an element does not invalidate iterators pointing to other elements.
+		 *
+		 * After the operation has taken place, the size() of the set will be decreased by one.
+		 *
+		 * @param[in] it iterator to the element of the set to be removed.
+		 *
+		 * @return iterator pointing to the element following \p it prior to the element being erased, or end() if
+		 * no such element exists.
+		 */
+		iterator erase(const_iterator it)
+		{
+			piranha_assert(!empty());
+			_erase(it);
+			piranha_assert(m_n_elements);
+			// Update the number of elements.
+			m_n_elements = static_cast<size_type>(m_n_elements - 1u);
+			return iterator(this,next_full(static_cast<size_type>(it.m_idx + 1u)));
+		}
+		/// Remove all elements.
+		/**
+		 * After this call, size() and bucket_count() will both return zero.
+		 */
+		void clear()
+		{
+			destroy_and_deallocate();
+			reset();
+		}
+		/// Swap content.
+		/**
+		 * Will use \p std::swap to swap hasher and equality predicate.
+		 *
+		 * @param[in] other swap argument.
+		 *
+		 * @throws unspecified any exception thrown by swapping hasher or equality predicate via \p std::swap.
+		 */
+		void swap(flat_hash_set &other)
+		{
+			std::swap(m_pack,other.m_pack);
+			std::swap(m_ctrl,other.m_ctrl);
+			std::swap(m_log2_size,other.m_log2_size);
+			std::swap(m_n_elements,other.m_n_elements);
+			std::swap(m_growth_left,other.m_growth_left);
+		}
+		/// Rehash set.
+		/**
+		 * Change the number of buckets in the set to at least \p new_size. No rehash is performed
+		 * if rehashing would lead to exceeding the maximum load factor. If \p n_threads is not 1,
+		 * then the first \p n_threads threads from piranha::thread_pool will be used concurrently
+		 * for the initialisation of the new table.
+		 *
+		 * @param[in] new_size new desired number of buckets.
+		 * @param[in] n_threads number of threads to use.
+		 *
+		 * @throws std::invalid_argument if \p n_threads is zero.
+		 * @throws std::bad_alloc if the desired number of buckets is greater than an implementation-defined maximum, or in case
+		 * of memory errors.
+		 * @throws unspecified any exception thrown by the move constructor of the stored type, _bucket() or
+		 * piranha::thread_pool::parallel_invoke().
+		 */
+		void rehash(const size_type &new_size, unsigned n_threads = 1u)
+		{
+			if (unlikely(!n_threads)) {
+				piranha_throw(std::invalid_argument,"the number of threads must be strictly positive");
+			}
+			// If rehash is requested to zero, do something only if there are no items stored in the set.
+			if (!new_size) {
+				if (!size()) {
+					clear();
+				}
+				return;
+			}
+			// Do nothing if rehashing to the new size would lead to exceeding the max load factor.
+			if (static_cast<double>(size()) / static_cast<double>(new_size) > max_load_factor()) {
+				return;
+			}
+			rehash_impl(get_log2_from_hint(new_size),n_threads);
+		}
+		/// Get information on the sparsity of the set.
+		/**
+		 * @return an <tt>std::map<size_type,size_type></tt> in which the key is the number of groups of slots
+		 * that must be skipped before finding an element during the probing, and the mapped type the
+		 * number of elements requiring those many skips.
+		 *
+		 * @throws unspecified any exception thrown by memory errors in standard containers or by _bucket().
+		 */
+		std::map<size_type,size_type> evaluate_sparsity() const
+		{
+			std::map<size_type,size_type> retval;
+			const auto cap = bucket_count();
+			for (size_type i = 0u; i < cap; ++i) {
+				if (m_ctrl[i] < 0) {
+					continue;
+				}
+				probe_seq seq(_bucket(*slot_ptr(i)),mask());
+				size_type counter = 0u;
+				while (((i - seq.m_pos) & mask()) >= detail::fhs_group_width) {
+					seq.next();
+					++counter;
+				}
+				++retval[counter];
+			}
+			return retval;
+		}
+		/** @name Low-level interface
+		 * Low-level methods and types.
+		 */
+		//@{
+		/// Mutable iterator.
+		/**
+		 * This iterator type provides non-const access to the elements of the set. Please note that modifications
+		 * to an existing element of the set might invalidate the relation between the element and its position in the set.
+		 * After such modifications of one or more elements, the only valid operation is flat_hash_set::clear() (destruction of the
+		 * set before calling flat_hash_set::clear() will lead to assertion failures in debug mode).
+		 */
+		using _m_iterator = iterator_impl<key_type>;
+		/// Mutable begin iterator.
+		/**
+		 * @return flat_hash_set::_m_iterator to the beginning of the set.
+		 */
+		_m_iterator _m_begin()
+		{
+			return _m_iterator(this,next_full(0u));
+		}
+		/// Mutable end iterator.
+		/**
+		 * @return flat_hash_set::_m_iterator to the end of the set.
+		 */
+		_m_iterator _m_end()
+		{
+			return _m_iterator(this,end_idx());
+		}
+		/// Insert unique element (low-level).
+		/**
+		 * \note
+		 * This template method is activated only if \p T and \p U are the same type, aside from cv qualifications and references.
+		 *
+		 * The parameter \p bucket_idx is the index of the destination bucket for \p k and, for a
+		 * set with a nonzero number of buckets, must be equal to the output
+		 * of bucket() before the insertion.
+		 *
+		 * This method will not check if a key equivalent to \p k already exists in the set, it will not
+		 * update the number of elements present in the set after the insertion, nor it will check
+		 * if the value of \p bucket_idx is correct. If there are no slots left for the insertion, the set will be
+		 * rehashed, thus invalidating all the iterators apart from end().
+		 *
+		 * @param[in] k object that will be inserted into the set.
+		 * @param[in] bucket_idx destination bucket for \p k.
+		 *
+		 * @return iterator pointing to the newly-inserted element.
+		 *
+		 * @throws std::bad_alloc if the operation results in a resize of the set past an implementation-defined
+		 * maximum number of buckets.
+		 * @throws unspecified any exception thrown by the copy constructor of flat_hash_set::key_type, by _bucket() or by memory
+		 * allocation errors.
+		 */
+		template <typename U, insert_enabler<U> = 0>
+		iterator _unique_insert(U &&k, size_type bucket_idx)
+		{
+			// Assert that key is not present already in the set.
+			piranha_assert(find(k) == end());
+			// Assert bucket index is correct.
+			piranha_assert(!bucket_count() || bucket_idx == _bucket(k));
+			if (unlikely(!m_growth_left)) {
+				grow();
+				bucket_idx = _bucket(k);
+			}
+			const auto idx = find_insert_slot(bucket_idx);
+			::new (static_cast<void *>(&slots()[idx])) T(std::forward<U>(k));
+			// NOTE: reusing a tombstone does not consume the growth budget.
+			if (m_ctrl[idx] == detail::fhs_empty) {
+				--m_growth_left;
+			}
+			set_ctrl(idx,tag(bucket_idx));
+			return iterator(this,idx);
+		}
+		/// Find element (low-level).
+		/**
+		 * Locate element in the set. The parameter \p bucket_idx is the index of the destination bucket for \p k and, for
+		 * a set with a nonzero number of buckets, must be equal to the output
+		 * of bucket() before the insertion. This method will not check if the value of \p bucket_idx is correct.
+		 *
+		 * @param[in] k element to be located.
+		 * @param[in] bucket_idx index of the destination bucket for \p k.
+		 *
+		 * @return flat_hash_set::iterator to <tt>k</tt>'s position in the set, or end() if \p k is not in the set.
+		 *
+		 * @throws unspecified any exception thrown by calling the equality predicate.
+		 */
+		const_iterator _find(const key_type &k, const size_type &bucket_idx) const
+		{
+			// Assert bucket index is correct.
+			piranha_assert(bucket_idx == _bucket(k) && bucket_idx < bucket_count());
+			const auto t = tag(bucket_idx);
+			probe_seq seq(bucket_idx,mask());
+			while (true) {
+				const group g(m_ctrl + seq.m_pos);
+				for (auto m = g.match(t); m; m &= m - 1u) {
+					const auto idx = seq.slot(detail::fhs_lowest_bit(m));
+					if (k_equal()(*slot_ptr(idx),k)) {
+						return const_iterator(this,idx);
+					}
+				}
+				// An empty slot terminates the probing sequence.
+				if (likely(g.match_empty())) {
+					return end();
+				}
+				seq.next();
+			}
+		}
+		/// Index of destination bucket from hash value.
+		/**
+		 * Note that this method will not check if the number of buckets is zero.
+		 *
+		 * @param[in] hash input hash value.
+		 *
+		 * @return index of the destination bucket for an object with hash value \p hash.
+		 */
+		size_type _bucket_from_hash(const std::size_t &hash) const
+		{
+			piranha_assert(bucket_count());
+			return hash & mask();
+		}
+		/// Index of destination bucket (low-level).
+		/**
+		 * Equivalent to bucket(), with the exception that this method will not check
+		 * if the number of buckets is zero.
+		 *
+		 * @param[in] k input argument.
+		 *
+		 * @return index of the destination bucket for \p k.
+		 *
+		 * @throws unspecified any exception thrown by the call operator of the hasher.
+		 */
+		size_type _bucket(const key_type &k) const
+		{
+			return _bucket_from_hash(hash()(k));
+		}
+		/// Force update of the number of elements.
+		/**
+		 * After this call, size() will return \p new_size regardless of the true number of elements in the set.
+		 *
+		 * @param[in] new_size new set size.
+		 */
+		void _update_size(const size_type &new_size)
+		{
+			m_n_elements = new_size;
+		}
+		/// Increase bucket count.
+		/**
+		 * Increase the number of buckets to the next implementation-defined value.
+		 *
+		 * @throws std::bad_alloc if the operation results in a resize of the set past an implementation-defined
+		 * maximum number of buckets.
+		 * @throws unspecified any exception thrown by the move constructor of the stored type or by _bucket().
+		 */
+		void _increase_size()
+		{
+			if (!slots()) {
+				rehash_impl(get_log2_from_hint(detail::fhs_group_width),1u);
+				return;
+			}
+			if (unlikely(m_log2_size >= static_cast<size_type>(std::numeric_limits<size_type>::digits - 1))) {
+				piranha_throw(std::bad_alloc,);
+			}
+			rehash_impl(static_cast<size_type>(m_log2_size + 1u),1u);
+		}
+		/// Elements in a bucket.
+		/**
+		 * @param[in] idx index of a bucket.
+		 *
+		 * @return a range (with <tt>begin()</tt> and <tt>end()</tt> methods returning flat_hash_set::local_iterator)
+		 * containing the element stored in the slot at index \p idx, or an empty range if the slot does not
+		 * contain any element. Note that the element is not necessarily one whose destination bucket is \p idx.
+		 */
+		slot_range _get_bucket_list(const size_type &idx) const
+		{
+			piranha_assert(idx < bucket_count());
+			return slot_range(slot_ptr(idx),m_ctrl[idx] >= 0);
+		}
+		/// Erase element.
+		/**
+		 * Erase the element to which \p it points. \p it must be a valid iterator
+		 * pointing to an element of the set.
+		 *
+		 * This method will not update the number of elements in the set, and it will modify only
+		 * the slot to which \p it refers (which will be marked as deleted).
+		 *
+		 * @param[in] it iterator to the element of the set to be removed.
+		 *
+		 * @return the local end iterator of the slot to which \p it refers.
+		 */
+		local_iterator _erase(const_iterator it)
+		{
+			// Verify the iterator is valid.
+			piranha_assert(it.m_set == this);
+			piranha_assert(it.m_idx < bucket_count());
+			piranha_assert(m_ctrl[it.m_idx] >= 0);
+			slot_ptr(it.m_idx)->~T();
+			set_ctrl(it.m_idx,detail::fhs_deleted);
+			return slot_ptr(it.m_idx);
+		}
+		//@}
+	private:
+		pack_type	m_pack;
+		ctrl_t		*m_ctrl;
+		size_type	m_log2_size;
+		size_type	m_n_elements;
+		// Number of empty slots that can still be filled before the table needs to grow.
+		size_type	m_growth_left;
+};
+
+}
+
+#endif
@@ -21,6 +21,8 @@
 #ifndef PIRANHA_HASH_SET_HPP
 #define PIRANHA_HASH_SET_HPP
 
+#include <algorithm>
+#include <atomic>
 #include <boost/iterator/iterator_facade.hpp>
 #include <cstddef>
 #include <functional>
@@ -37,6 +39,7 @@
 
 #include "config.hpp"
 #include "debug_access.hpp"
+#include "detail/hash_set_node_pool.hpp"
 #include "environment.hpp"
 #include "exceptions.hpp"
 #include "serialization.hpp"
@@ -57,7 +60,9 @@ namespace piranha
  *   and references to the elements in the destination bucket will be invalid.
  * 
  * The implementation employs a separate chaining strategy consisting of an array of buckets, each one a singly linked list with the first node
- * stored directly within the array (so that the first insertion in a bucket does not require any heap allocation).
+ * stored directly within the array (so that the first insertion in a bucket does not require any heap allocation). The other nodes
+ * are drawn from a pool owned by the set: the nodes are recycled after erasure, clear() and rehash(), and they are released in
+ * bulk when the set is destroyed.
  * 
  * An additional set of low-level methods is provided: such methods are suitable for use in high-performance and multi-threaded contexts,
  * and, if misused, could lead to data corruption and other unpredictable errors.
@@ -90,7 +95,6 @@ namespace piranha
  */
  /* Some improvement NOTEs:
  * - tests for low-level methods
- * - better increase_size with recycling of dynamically-allocated nodes
  * - see if we can reduce the number of branches in the find algorithm (e.g., when traversing the list) -> this should be a general review of the internal linked list
  * implementation.
  * - memory handling: the usage of the allocator object should be more standard, i.e., use the pointer and reference typedefs defined within, replace
@@ -158,6 +162,8 @@ class hash_set
 			storage_type	m_storage;
 			node		*m_next;
 		};
+		// Pool of nodes.
+		using node_pool = detail::hs_node_pool<node>;
 		// List constituting the bucket.
 		// NOTE: in this list implementation the m_next pointer is used as a flag to signal if the current node
 		// stores an item: the pointer is not null if it does contain something. The value of m_next pointer in a node is set to a constant
@@ -212,8 +218,13 @@ class hash_set
 			{
 				steal_from_rvalue(std::move(other));
 			}
-			list(const list &other):m_node()
+			list(const list &) = delete;
+			list &operator=(list &&) = delete;
+			list &operator=(const list &) = delete;
+			// Copy the content of other, which must be empty, into this, using pool for the allocation of the nodes.
+			void copy_from(const list &other, node_pool &pool)
 			{
+				piranha_assert(empty());
 				try {
 					auto cur = &m_node;
 					auto other_cur = &other.m_node;
@@ -224,11 +235,16 @@ class hash_set
 							piranha_assert(cur->m_next == &terminator);
 							// Create a new node with content equal to other_cur
 							// and linking forward to the terminator.
-							std::unique_ptr<node> new_node(::new node());
-							::new (static_cast<void *>(&new_node->m_storage)) T(*other_cur->ptr());
+							node *new_node = ::new (pool.allocate()) node();
+							try {
+								::new (static_cast<void *>(&new_node->m_storage)) T(*other_cur->ptr());
+							} catch (...) {
+								free_node(new_node,pool);
+								throw;
+							}
 							new_node->m_next = &terminator;
 							// Link the new node.
-							cur->m_next = new_node.release();
+							cur->m_next = new_node;
 							cur = cur->m_next;
 						} else {
 							// This means this is the first node.
@@ -238,30 +254,21 @@ class hash_set
 						other_cur = other_cur->m_next;
 					}
 				} catch (...) {
-					destroy();
+					destroy(&pool);
 					throw;
 				}
 			}
-			list &operator=(list &&other)
+			// Give back the storage of a node to the pool.
+			static void free_node(node *n, node_pool &pool)
 			{
-				if (likely(this != &other)) {
-					// Destroy the content of this.
-					destroy();
-					steal_from_rvalue(std::move(other));
-				}
-				return *this;
-			}
-			list &operator=(const list &other)
-			{
-				if (likely(this != &other)) {
-					auto tmp = other;
-					*this = std::move(tmp);
-				}
-				return *this;
+				n->~node();
+				pool.deallocate(static_cast<void *>(n));
 			}
+			// NOTE: the nodes are not given back to the pool here, the pool will release
+			// them in bulk.
 			~list()
 			{
-				destroy();
+				destroy(nullptr);
 			}
 			void steal_from_rvalue(list &&other)
 			{
@@ -279,16 +286,21 @@ class hash_set
 				piranha_assert(other.empty());
 			}
 			template <typename U>
-			node *insert(U &&item, typename std::enable_if<std::is_same<T,typename std::decay<U>::type>::value>::type * = nullptr)
+			node *insert(U &&item, node_pool &pool, typename std::enable_if<std::is_same<T,typename std::decay<U>::type>::value>::type * = nullptr)
 			{
 				// NOTE: optimize with likely/unlikely?
 				if (m_node.m_next) {
 					// Create the new node and forward-link it to the second node.
-					std::unique_ptr<node> new_node(::new node());
-					::new (static_cast<void *>(&new_node->m_storage)) T(std::forward<U>(item));
+					node *new_node = ::new (pool.allocate()) node();
+					try {
+						::new (static_cast<void *>(&new_node->m_storage)) T(std::forward<U>(item));
+					} catch (...) {
+						free_node(new_node,pool);
+						throw;
+					}
 					new_node->m_next = m_node.m_next;
 					// Link first node to the new node.
-					m_node.m_next = new_node.release();
+					m_node.m_next = new_node;
 					return m_node.m_next;
 				} else {
 					::new (static_cast<void *>(&m_node.m_storage)) T(std::forward<U>(item));
@@ -316,7 +328,8 @@ class hash_set
 			{
 				return !m_node.m_next;
 			}
-			void destroy()
+			// Destroy the content of the list. If pool is not null, the nodes will be given back to it.
+			void destroy(node_pool *pool)
 			{
 				node *cur = &m_node;
 				while (cur->m_next) {
@@ -327,9 +340,9 @@ class hash_set
 					// Destroy the old payload and erase connections.
 					old->ptr()->~T();
 					old->m_next = nullptr;
-					// If the old node was not the initial one, delete it.
-					if (old != &m_node) {
-						::delete old;
+					// If the old node was not the initial one, recycle it.
+					if (old != &m_node && pool != nullptr) {
+						free_node(old,*pool);
 					}
 				}
 				// After destruction, the list should be equivalent to a default-constructed one.
@@ -388,6 +401,25 @@ class hash_set
 		{
 			return std::get<3u>(m_pack);
 		}
+		// Get the node pool, creating it if necessary. This can be called concurrently from multiple threads.
+		node_pool &get_pool()
+		{
+			auto p = m_pool.load(std::memory_order_acquire);
+			if (unlikely(p == nullptr)) {
+				std::unique_ptr<node_pool> new_pool(::new node_pool);
+				if (m_pool.compare_exchange_strong(p,new_pool.get(),std::memory_order_acq_rel,std::memory_order_acquire)) {
+					p = new_pool.release();
+				}
+				// NOTE: if the exchange failed, p now points to the pool created by another thread.
+			}
+			return *p;
+		}
+		// Delete the node pool. All the nodes must have been destroyed beforehand.
+		void delete_pool()
+		{
+			::delete m_pool.load();
+			m_pool.store(nullptr);
+		}
 		// Definition of the iterator type for the set.
 		template <typename Key>
 		class iterator_impl: public boost::iterator_facade<iterator_impl<Key>,Key,boost::forward_traversal_tag>
@@ -485,7 +517,7 @@ class hash_set
 					for (unsigned i = 0u; i < n_threads; ++i) {
 						const auto start = static_cast<size_type>(wpt * i),
 							end = static_cast<size_type>((i == n_threads - 1u) ? size : wpt * (i + 1u));
-						f_list.push_back(thread_pool::enqueue(i,thread_function,start,end,i));
+						f_list.push_back(thread_pool::enqueue_task(i,thread_function,start,end,i));
 					}
 					f_list.wait_all();
 					// NOTE: no need to get_all() here, as we know no exceptions will be generated inside thread_func.
@@ -508,13 +540,15 @@ class hash_set
 			ptr() = new_ptr;
 			m_log2_size = log2_size;
 		}
-		// Destroy all elements and deallocate ptr().
-		void destroy_and_deallocate()
+		// Destroy all elements and deallocate ptr(). If pool is not null, the nodes will be given back to it,
+		// otherwise they will be released in bulk when the pool is deleted.
+		void destroy_and_deallocate(node_pool *pool = nullptr)
 		{
 			// Proceed to destroy all elements and deallocate only if the set is actually storing something.
 			if (ptr()) {
 				const size_type size = size_type(1u) << m_log2_size;
 				for (size_type i = 0u; i < size; ++i) {
+					ptr()[i].destroy(pool);
 					allocator().destroy(&ptr()[i]);
 				}
 				allocator().deallocate(ptr(),size);
@@ -522,6 +556,36 @@ class hash_set
 				piranha_assert(!m_log2_size && !m_n_elements);
 			}
 		}
+		// Move the elements of this into new_set using multiple threads. Since the bucket counts are powers of two,
+		// if 2**k is the smaller bucket count between this and new_set then all the elements in the buckets
+		// of this whose index is congruent to r modulo 2**k will end up in buckets of new_set whose index is also
+		// congruent to r modulo 2**k. The residues are split in contiguous ranges among the threads, so that
+		// each thread reads and writes a disjoint set of buckets and no locking is needed. The lists of this are
+		// emptied as they are processed, giving back their nodes to the pool.
+		void parallel_move(hash_set &new_set, unsigned n_threads)
+		{
+			piranha_assert(ptr() && new_set.ptr() && n_threads > 1u);
+			const auto old_size = bucket_count(), new_size = new_set.bucket_count();
+			const auto min_size = std::min(old_size,new_size);
+			// NOTE: there cannot be more threads than residues.
+			const unsigned nt = static_cast<unsigned>(std::min(static_cast<size_type>(n_threads),min_size));
+			const auto rpt = static_cast<size_type>(min_size / nt);
+			auto &pool = new_set.get_pool();
+			thread_pool::parallel_invoke(nt,[this,&new_set,&pool,old_size,min_size,nt,rpt](unsigned i) {
+				const auto start = static_cast<size_type>(rpt * i),
+					end = static_cast<size_type>((i == nt - 1u) ? min_size : rpt * (i + 1u));
+				for (size_type r = start; r != end; ++r) {
+					for (size_type idx = r; idx < old_size; idx = static_cast<size_type>(idx + min_size)) {
+						auto &l = this->ptr()[idx];
+						for (auto &x: l) {
+							const auto new_idx = new_set._bucket(x);
+							new_set._unique_insert(std::move(x),new_idx);
+						}
+						l.destroy(&pool);
+					}
+				}
+			});
+		}
 		// Serialization support.
 		friend class boost::serialization::access;
 		template <class Archive>
@@ -640,7 +704,7 @@ class hash_set
 		 * @throws unspecified any exception thrown by the copy constructors of <tt>Hash</tt> or <tt>Pred</tt>.
 		 */
 		hash_set(const hasher &h = hasher{}, const key_equal &k = key_equal{}):
-			m_pack(nullptr,h,k,allocator_type{}),m_log2_size(0u),m_n_elements(0u) {}
+			m_pack(nullptr,h,k,allocator_type{}),m_log2_size(0u),m_n_elements(0u),m_pool(nullptr) {}
 		/// Constructor from number of buckets.
 		/**
 		 * Will construct a set whose number of buckets is at least equal to \p n_buckets. If \p n_threads is not 1,
@@ -660,7 +724,7 @@ class hash_set
 		 * - piranha::thread_pool::enqueue() or piranha::future_list::push_back(), if \p n_threads is not 1.
 		 */
 		explicit hash_set(const size_type &n_buckets, const hasher &h = hasher{}, const key_equal &k = key_equal{}, unsigned n_threads = 1u):
-			m_pack(nullptr,h,k,allocator_type{}),m_log2_size(0u),m_n_elements(0u)
+			m_pack(nullptr,h,k,allocator_type{}),m_log2_size(0u),m_n_elements(0u),m_pool(nullptr)
 		{
 			init_from_n_buckets(n_buckets,n_threads);
 		}
@@ -675,7 +739,7 @@ class hash_set
 		 */
 		hash_set(const hash_set &other):
 			m_pack(nullptr,other.hash(),other.k_equal(),other.allocator()),m_log2_size(0u),
-			m_n_elements(0u)
+			m_n_elements(0u),m_pool(nullptr)
 		{
 			// Proceed to actual copy only if other has some content.
 			if (other.ptr()) {
@@ -686,16 +750,29 @@ class hash_set
 				}
 				size_type i = 0u;
 				try {
+					// Allocate in one go the nodes for the overflow chains: their number is the number of elements
+					// minus the number of non-empty buckets.
+					size_type n_nodes = other.m_n_elements;
+					for (size_type j = 0u; j < size && n_nodes; ++j) {
+						if (!other.ptr()[j].empty()) {
+							--n_nodes;
+						}
+					}
+					auto &pool = get_pool();
+					pool.reserve(n_nodes);
 					// Copy-construct the elements of the array.
 					for (; i < size; ++i) {
-						allocator().construct(&new_ptr[i],other.ptr()[i]);
+						allocator().construct(&new_ptr[i]);
+						new_ptr[i].copy_from(other.ptr()[i],pool);
 					}
 				} catch (...) {
 					// Unwind the construction and deallocate, before re-throwing.
 					for (size_type j = 0u; j < i; ++j) {
 						allocator().destroy(&new_ptr[j]);
 					}
+					// NOTE: the i-th list is empty, if it was constructed at all.
 					allocator().deallocate(new_ptr,size);
+					delete_pool();
 					throw;
 				}
 				// Assign the members.
@@ -714,12 +791,13 @@ class hash_set
 		 * @param[in] other set to be moved.
 		 */
 		hash_set(hash_set &&other) noexcept : m_pack(std::move(other.m_pack)),m_log2_size(other.m_log2_size),
-			m_n_elements(other.m_n_elements)
+			m_n_elements(other.m_n_elements),m_pool(other.m_pool.load())
 		{
 			// Clear out the other one.
 			other.ptr() = nullptr;
 			other.m_log2_size = 0u;
 			other.m_n_elements = 0u;
+			other.m_pool.store(nullptr);
 		}
 		/// Constructor from range.
 		/**
@@ -738,7 +816,7 @@ class hash_set
 		template <typename InputIterator>
 		explicit hash_set(const InputIterator &begin, const InputIterator &end, const size_type &n_buckets = 0u,
 			const hasher &h = hasher{}, const key_equal &k = key_equal{}):
-			m_pack(nullptr,h,k,allocator_type{}),m_log2_size(0u),m_n_elements(0u)
+			m_pack(nullptr,h,k,allocator_type{}),m_log2_size(0u),m_n_elements(0u),m_pool(nullptr)
 		{
 			init_from_n_buckets(n_buckets,1u);
 			for (auto it = begin; it != end; ++it) {
@@ -757,7 +835,7 @@ class hash_set
 		 */
 		template <typename U>
 		explicit hash_set(std::initializer_list<U> list):
-			m_pack(nullptr,hasher{},key_equal{},allocator_type{}),m_log2_size(0u),m_n_elements(0u)
+			m_pack(nullptr,hasher{},key_equal{},allocator_type{}),m_log2_size(0u),m_n_elements(0u),m_pool(nullptr)
 		{
 			// We do not care here for possible truncation of list.size(), as this is only an optimization.
 			init_from_n_buckets(static_cast<size_type>(list.size()),1u);
@@ -773,6 +851,7 @@ class hash_set
 		{
 			piranha_assert(sanity_check());
 			destroy_and_deallocate();
+			delete_pool();
 		}
 		/// Copy assignment operator.
 		/**
@@ -800,13 +879,16 @@ class hash_set
 		{
 			if (likely(this != &other)) {
 				destroy_and_deallocate();
+				delete_pool();
 				m_pack = std::move(other.m_pack);
 				m_log2_size = other.m_log2_size;
 				m_n_elements = other.m_n_elements;
+				m_pool.store(other.m_pool.load());
 				// Zero out other.
 				other.ptr() = nullptr;
 				other.m_log2_size = 0u;
 				other.m_n_elements = 0u;
+				other.m_pool.store(nullptr);
 			}
 			return *this;
 		}
@@ -1054,11 +1136,13 @@ class hash_set
 		}
 		/// Remove all elements.
 		/**
-		 * After this call, size() and bucket_count() will both return zero.
+		 * After this call, size() and bucket_count() will both return zero. The memory of the dynamically-allocated
+		 * nodes will be released.
 		 */
 		void clear()
 		{
 			destroy_and_deallocate();
+			delete_pool();
 			// Reset the members.
 			ptr() = nullptr;
 			m_log2_size = 0u;
@@ -1077,20 +1161,24 @@ class hash_set
 			std::swap(m_pack,other.m_pack);
 			std::swap(m_log2_size,other.m_log2_size);
 			std::swap(m_n_elements,other.m_n_elements);
+			auto tmp = m_pool.load();
+			m_pool.store(other.m_pool.load());
+			other.m_pool.store(tmp);
 		}
 		/// Rehash set.
 		/**
 		 * Change the number of buckets in the set to at least \p new_size. No rehash is performed
 		 * if rehashing would lead to exceeding the maximum load factor. If \p n_threads is not 1,
 		 * then the first \p n_threads threads from piranha::thread_pool will be used concurrently during
-		 * the rehash operation.
+		 * the rehash operation, both for the initialisation of the new buckets and for the redistribution
+		 * of the elements.
 		 * 
 		 * @param[in] new_size new desired number of buckets.
 		 * @param[in] n_threads number of threads to use.
 		 * 
 		 * @throws std::invalid_argument if \p n_threads is zero.
 		 * @throws unspecified any exception thrown by the constructor from number of buckets,
-		 * _unique_insert() or _bucket().
+		 * _unique_insert(), _bucket() or piranha::thread_pool::parallel_invoke().
 		 */
 		void rehash(const size_type &new_size, unsigned n_threads = 1u)
 		{
@@ -1110,11 +1198,18 @@ class hash_set
 			}
 			// Create a new set with needed amount of buckets.
 			hash_set new_set(new_size,hash(),k_equal(),n_threads);
+			// The new set takes over the node pool, so that the nodes of this can be recycled.
+			new_set.m_pool.store(m_pool.load());
+			m_pool.store(nullptr);
 			try {
-				const auto it_f = _m_end();
-				for (auto it = _m_begin(); it != it_f; ++it) {
-					const auto new_idx = new_set._bucket(*it);
-					new_set._unique_insert(std::move(*it),new_idx);
+				if (n_threads == 1u || !ptr()) {
+					const auto it_f = _m_end();
+					for (auto it = _m_begin(); it != it_f; ++it) {
+						const auto new_idx = new_set._bucket(*it);
+						new_set._unique_insert(std::move(*it),new_idx);
+					}
+				} else {
+					parallel_move(new_set,n_threads);
 				}
 			} catch (...) {
 				// Clear up both this and the new set upon any kind of error.
@@ -1124,8 +1219,11 @@ class hash_set
 			}
 			// Retain the number of elements.
 			new_set.m_n_elements = m_n_elements;
-			// Clear the old set.
-			clear();
+			// Clear the old set, giving back its nodes to the pool.
+			destroy_and_deallocate(new_set.m_pool.load());
+			ptr() = nullptr;
+			m_log2_size = 0u;
+			m_n_elements = 0u;
 			// Assign the new set.
 			*this = std::move(new_set);
 		}
@@ -1223,7 +1321,7 @@ class hash_set
 			piranha_assert(find(std::forward<U>(k)) == end());
 			// Assert bucket index is correct.
 			piranha_assert(bucket_idx == _bucket(k));
-			auto p = ptr()[bucket_idx].insert(std::forward<U>(k));
+			auto p = ptr()[bucket_idx].insert(std::forward<U>(k),get_pool());
 			return iterator(this,bucket_idx,local_iterator(p));
 		}
 		/// Find element (low-level).
@@ -1363,7 +1461,7 @@ class hash_set
 					// Move-construct from the second element, and then destroy it.
 					::new (static_cast<void *>(&bucket.m_node.m_storage)) T(std::move(*bucket.m_node.m_next->ptr()));
 					bucket.m_node.m_next->ptr()->~T();
-					::delete bucket.m_node.m_next;
+					list::free_node(bucket.m_node.m_next,get_pool());
 					// Establish the new link.
 					bucket.m_node.m_next = tmp;
 					return bucket.begin();
@@ -1379,7 +1477,7 @@ class hash_set
 						prev_b_it.m_ptr->m_next = b_it.m_ptr->m_next;
 						// Delete the current one.
 						b_it.m_ptr->ptr()->~T();
-						::delete b_it.m_ptr;
+						list::free_node(b_it.m_ptr,get_pool());
 						break;
 					};
 				}
@@ -1394,9 +1492,10 @@ class hash_set
 		}
 		//@}
 	private:
-		pack_type	m_pack;
-		size_type	m_log2_size;
-		size_type	m_n_elements;
+		pack_type			m_pack;
+		size_type			m_log2_size;
+		size_type			m_n_elements;
+		std::atomic<node_pool *>	m_pool;
 };
 
 template <typename T, typename Hash, typename Pred>
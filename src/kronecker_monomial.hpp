@@ -900,6 +900,41 @@ class kronecker_monomial
 			retval.push_back(std::make_pair(std::move(retval_s),kronecker_monomial(ka::encode(new_v))));
 			return retval;
 		}
+		/// Extract exponent.
+		/**
+		 * This method will split \p this into the exponent of the symbol called \p s and a monomial
+		 * in which such exponent has been set to zero. If \p s is not in \p args, the exponent will be zero
+		 * and the monomial will be equal to \p this. The output of subs() is equivalent to the
+		 * power of the substituted quantity with the returned exponent, paired with the returned monomial.
+		 *
+		 * This method is used by piranha::substitutable_series to group terms by the exponent of the substituted symbol.
+		 *
+		 * @param[in] s name of the symbol whose exponent will be extracted.
+		 * @param[in] args reference set of piranha::symbol.
+		 *
+		 * @return the exponent of \p s and the monomial without \p s.
+		 *
+		 * @throws unspecified any exception thrown by:
+		 * - unpack(),
+		 * - piranha::static_vector::push_back(),
+		 * - piranha::kronecker_array::encode().
+		 */
+		std::pair<value_type,kronecker_monomial> extract_exponent(const std::string &s, const symbol_set &args) const
+		{
+			const auto v = unpack(args);
+			v_type new_v;
+			value_type retval_e(0);
+			for (min_int<typename v_type::size_type,decltype(args.size())> i = 0u; i < args.size(); ++i) {
+				if (args[i].get_name() == s) {
+					retval_e = v[i];
+					new_v.push_back(value_type(0));
+				} else {
+					new_v.push_back(v[i]);
+				}
+			}
+			piranha_assert(new_v.size() == v.size());
+			return std::make_pair(retval_e,kronecker_monomial(ka::encode(new_v)));
+		}
 		/// Substitution of integral power.
 		/**
 		 * \note
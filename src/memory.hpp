@@ -299,16 +299,12 @@ inline void parallel_value_init(T *ptr, const std::size_t &size, const unsigned
 		}
 		// Work per thread.
 		const auto wpt = static_cast<std::size_t>(size / n_threads);
-		future_list<decltype(thread_pool::enqueue(0u,init_function,ptr,ptr,0u,&inited_ranges))> f_list;
 		try {
-			for (auto i = 0u; i < n_threads; ++i) {
+			thread_pool::parallel_invoke(n_threads,[&init_function,&inited_ranges,ptr,size,wpt,n_threads](unsigned i) {
 				auto start = ptr + i * wpt, end = (i == n_threads - 1u) ? ptr + size : ptr + (i + 1u) * wpt;
-				f_list.push_back(thread_pool::enqueue(i,init_function,start,end,i,&inited_ranges));
-			}
-			f_list.wait_all();
-			f_list.get_all();
+				init_function(start,end,i,&inited_ranges);
+			});
 		} catch (...) {
-			f_list.wait_all();
 			// Rollback the ranges that were inited.
 			for (const auto &p: inited_ranges) {
 				for (auto start = p.first; start != p.second; ++start) {
@@ -384,7 +380,7 @@ inline void parallel_destroy(T *ptr, const std::size_t &size, const unsigned &n_
 			// Perform the actual destruction and update the d_ranges vector.
 			for (auto i = 0u; i < n_threads; ++i) {
 				auto start = d_ranges[static_cast<rv_size_type>(i)].first, end = d_ranges[static_cast<rv_size_type>(i)].second;
-				f_list.push_back(thread_pool::enqueue(i,destroy_function,start,end));
+				f_list.push_back(thread_pool::enqueue_task(i,destroy_function,start,end));
 				// The range needs not to be destroyed anymore, as the enqueue/push_back was successful. Replace
 				// with an empty range.
 				d_ranges[static_cast<rv_size_type>(i)].first = ptr;
@@ -787,6 +787,43 @@ class monomial: public array_key<T,monomial<T,S>,S>
 			retval.push_back(std::make_pair(std::move(retval_s),std::move(retval_key)));
 			return retval;
 		}
+		/// Extract exponent.
+		/**
+		 * This method will split \p this into the exponent of the symbol called \p s and a monomial
+		 * in which such exponent has been set to zero. If \p s is not in \p args, the return value will be
+		 * <tt>(0,this)</tt>. The output of subs() is equivalent to the power of the substituted quantity with
+		 * the returned exponent, paired with the returned monomial.
+		 *
+		 * This method is used by piranha::substitutable_series to group terms by the exponent of the substituted symbol.
+		 *
+		 * @param[in] s name of the symbol whose exponent will be extracted.
+		 * @param[in] args reference set of piranha::symbol.
+		 *
+		 * @return the exponent of \p s and the monomial without \p s.
+		 *
+		 * @throws std::invalid_argument if the sizes of \p args and \p this differ.
+		 * @throws unspecified any exception thrown by:
+		 * - construction and assignment of exponents,
+		 * - piranha::array_key::push_back().
+		 */
+		std::pair<T,monomial> extract_exponent(const std::string &s, const symbol_set &args) const
+		{
+			if (unlikely(args.size() != this->size())) {
+				piranha_throw(std::invalid_argument,"invalid size of arguments set");
+			}
+			T retval_e(0);
+			monomial retval_key;
+			for (typename base::size_type i = 0u; i < this->size(); ++i) {
+				if (args[i].get_name() == s) {
+					retval_e = (*this)[i];
+					retval_key.push_back(T(0));
+				} else {
+					retval_key.push_back((*this)[i]);
+				}
+			}
+			piranha_assert(retval_key.size() == this->size());
+			return std::make_pair(std::move(retval_e),std::move(retval_key));
+		}
 		/// Substitution of integral power.
 		/**
 		 * \note
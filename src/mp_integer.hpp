@@ -256,6 +256,18 @@ struct mpz_raii
 	mpz_struct_t m_mpz;
 };
 
+// Thread-local pool of GMP integers, used as scratch space in place of short-lived mpz_raii objects.
+// The integers are initialised once per thread and they keep their limbs across uses, so that the conversion
+// routines below do not go through the GMP allocation functions for every temporary value. The value of a
+// scratch integer is unspecified when it is requested, and a slot must not be held across calls that might
+// request the same slot.
+inline mpz_struct_t &mpz_scratch(std::size_t idx)
+{
+	static thread_local std::array<mpz_raii,4u> pool;
+	piranha_assert(idx < pool.size());
+	return pool[idx].m_mpz;
+}
+
 inline std::ostream &stream_mpz(std::ostream &os, const mpz_struct_t &mpz)
 {
 	const std::size_t size_base10 = ::mpz_sizeinbase(&mpz,10);
@@ -271,7 +283,7 @@ inline std::ostream &stream_mpz(std::ostream &os, const mpz_struct_t &mpz)
 	return os;
 }
 
-template <int NBits>
+template <int NBits, std::size_t NLimbs = 2u>
 struct static_integer
 {
 	using dlimb_t = typename si_limb_types<NBits>::dlimb_t;
@@ -281,10 +293,16 @@ struct static_integer
 	// Total number of bits in the limb type, >= limb_bits.
 	static const unsigned total_bits = static_cast<unsigned>(std::numeric_limits<limb_t>::digits);
 	static_assert(total_bits >= limb_bits,"Invalid limb_t type.");
-	using limbs_type = std::array<limb_t,std::size_t(2)>;
-	// Check: we need to be able to address all bits in the 2 limbs using limb_t.
-	static_assert(limb_bits < std::numeric_limits<limb_t>::max() / 2u,"Overflow error.");
-	// NOTE: init everything otherwise zero is gonna be represented by undefined values in lo/hi.
+	// Number of limbs of static storage.
+	static const std::size_t n_limbs = NLimbs;
+	static_assert(n_limbs >= 1u && n_limbs <= 4u,"Invalid number of limbs.");
+	using limbs_type = std::array<limb_t,n_limbs>;
+	using size_type = typename limbs_type::size_type;
+	// Check: we need to be able to address all bits in the limbs using limb_t.
+	static_assert(limb_bits < std::numeric_limits<limb_t>::max() / n_limbs,"Overflow error.");
+	// Total number of bits of static storage.
+	static const limb_t max_bits = static_cast<limb_t>(limb_bits * n_limbs);
+	// NOTE: init everything otherwise zero is gonna be represented by undefined values in the limbs.
 	static_integer():_mp_alloc(0),_mp_size(0),m_limbs() {}
 	template <typename T, typename std::enable_if<std::is_signed<T>::value && std::is_integral<T>::value,int>::type = 0>
 	bool attempt_direct_construction(T n)
@@ -340,11 +358,10 @@ struct static_integer
 		const auto orig_n = n;
 		limb_t bit_idx = 0;
 		while (n != Integer(0)) {
-			if (bit_idx == limb_bits * 2u) {
+			if (bit_idx == max_bits) {
 				// Clear out before throwing, as this is used in mp_integer as well.
 				_mp_size = 0;
-				m_limbs[0u] = 0u;
-				m_limbs[1u] = 0u;
+				m_limbs.fill(0u);
 				piranha_throw(std::overflow_error,"insufficient bit width");
 			}
 			// NOTE: in C++11 division will round to zero always (for negative numbers as well).
@@ -383,13 +400,17 @@ struct static_integer
 	static_integer &operator=(static_integer &&) = default;
 	void negate()
 	{
-		// NOTE: this is 2 at most, no danger in taking the negative.
+		// NOTE: this is n_limbs at most, no danger in taking the negative.
 		_mp_size = -_mp_size;
 	}
+	// The lower limb_bits bits of n.
+	static limb_t low_bits(const dlimb_t &n)
+	{
+		return static_cast<limb_t>(n & static_cast<dlimb_t>((dlimb_t(1) << limb_bits) - 1u));
+	}
 	void set_bit(const limb_t &idx)
 	{
-		using size_type = typename limbs_type::size_type;
-		piranha_assert(idx < limb_bits * 2u);
+		piranha_assert(idx < max_bits);
 		// Crossing fingers for compiler optimising this out.
 		const auto quot = static_cast<limb_t>(idx / limb_bits), rem = static_cast<limb_t>(idx % limb_bits);
 		m_limbs[static_cast<size_type>(quot)] = static_cast<limb_t>(m_limbs[static_cast<size_type>(quot)] | static_cast<limb_t>(limb_t(1) << rem));
@@ -406,22 +427,27 @@ struct static_integer
 			}
 		}
 	}
-	mpz_size_t calculate_n_limbs() const
+	static mpz_size_t calculate_n_limbs(const limbs_type &limbs)
 	{
-		if (m_limbs[1u] != 0u) {
-			return 2;
-		}
-		if (m_limbs[0u] != 0u) {
-			return 1;
+		size_type i = n_limbs;
+		while (i != 0u && limbs[static_cast<size_type>(i - 1u)] == 0u) {
+			--i;
 		}
-		return 0;
+		return static_cast<mpz_size_t>(i);
+	}
+	mpz_size_t calculate_n_limbs() const
+	{
+		return calculate_n_limbs(m_limbs);
 	}
 	bool consistency_checks() const
 	{
-		return _mp_alloc == 0 && _mp_size <= 2 && _mp_size >= -2 &&
-			// Excess bits must be zero for consistency.
-			!(static_cast<dlimb_t>(m_limbs[0u]) >> limb_bits) &&
-			!(static_cast<dlimb_t>(m_limbs[1u]) >> limb_bits) &&
+		// Excess bits must be zero for consistency.
+		for (const auto &l: m_limbs) {
+			if (static_cast<dlimb_t>(l) >> limb_bits) {
+				return false;
+			}
+		}
+		return _mp_alloc == 0 && _mp_size <= mpz_size_t(n_limbs) && _mp_size >= -mpz_size_t(n_limbs) &&
 			(calculate_n_limbs() == _mp_size || -calculate_n_limbs() == _mp_size);
 	}
 	mpz_size_t abs_size() const
@@ -436,7 +462,7 @@ struct static_integer
 	{
 		public:
 			// Safe, checked above.
-			static const auto max_tot_nbits = 2u * T::limb_bits;
+			static const auto max_tot_nbits = T::max_bits;
 			// Check the conversion below.
 			static_assert(max_tot_nbits / unsigned(GMP_NUMB_BITS) + 1u <= std::numeric_limits<std::size_t>::max(),
 				"Overflow error.");
@@ -458,7 +484,7 @@ struct static_integer
 					sign = true;
 					asize = static_cast<std::size_t>(n._mp_size);
 				}
-				piranha_assert(asize <= 2u);
+				piranha_assert(asize <= n_limbs);
 				const auto tot_nbits = asize * T::limb_bits;
 				const std::size_t n_gmp_limbs = static_cast<std::size_t>(
 					tot_nbits % unsigned(GMP_NUMB_BITS) == 0u ?
@@ -514,7 +540,7 @@ struct static_integer
 			static_mpz_view(): m_mpz() {}
 			// NOTE: we use the const_cast to cast away the constness from the pointer to the limbs
 			// in n. This is valid as we are never going to use this pointer for writing.
-			explicit static_mpz_view(const static_integer &n):m_mpz{static_cast<mpz_alloc_t>(2),
+			explicit static_mpz_view(const static_integer &n):m_mpz{static_cast<mpz_alloc_t>(n_limbs),
 				n._mp_size,const_cast< ::mp_limb_t *>(n.m_limbs.data())}
 			{}
 			static_mpz_view(const static_mpz_view &) = delete;
@@ -553,24 +579,28 @@ struct static_integer
 	{
 		return _mp_size == 1 && m_limbs[0u] == 1u;
 	}
-	// Compare absolute values of two integers whose sizes are the same in absolute value.
-	static int compare(const static_integer &a, const static_integer &b, const mpz_size_t &size)
+	// Compare the first size limbs of two arrays of limbs.
+	static int compare(const limbs_type &a, const limbs_type &b, const mpz_size_t &size)
 	{
-		using size_type = typename limbs_type::size_type;
-		piranha_assert(size >= 0 && size <= 2);
-		piranha_assert(a._mp_size == size || -a._mp_size == size);
-		piranha_assert(a._mp_size == b._mp_size || a._mp_size == -b._mp_size);
+		piranha_assert(size >= 0 && size <= mpz_size_t(n_limbs));
 		auto limb_idx = static_cast<size_type>(size);
 		while (limb_idx != 0u) {
 			--limb_idx;
-			if (a.m_limbs[limb_idx] > b.m_limbs[limb_idx]) {
+			if (a[limb_idx] > b[limb_idx]) {
 				return 1;
-			} else if (a.m_limbs[limb_idx] < b.m_limbs[limb_idx]) {
+			} else if (a[limb_idx] < b[limb_idx]) {
 				return -1;
 			}
 		}
 		return 0;
 	}
+	// Compare absolute values of two integers whose sizes are the same in absolute value.
+	static int compare(const static_integer &a, const static_integer &b, const mpz_size_t &size)
+	{
+		piranha_assert(a._mp_size == size || -a._mp_size == size);
+		piranha_assert(a._mp_size == b._mp_size || a._mp_size == -b._mp_size);
+		return compare(a.m_limbs,b.m_limbs,size);
+	}
 	bool operator<(const static_integer &other) const
 	{
 		const auto size0 = _mp_size, size1 = other._mp_size;
@@ -613,35 +643,46 @@ struct static_integer
 	void clear_extra_bits(typename std::enable_if<T::limb_bits != T::total_bits>::type * = nullptr)
 	{
 		const auto delta_bits = total_bits - limb_bits;
-		m_limbs[0u] = clear_top_bits(m_limbs[0u],delta_bits);
-		m_limbs[1u] = clear_top_bits(m_limbs[1u],delta_bits);
+		for (auto &l: m_limbs) {
+			l = clear_top_bits(l,delta_bits);
+		}
 	}
 	template <typename T = static_integer>
 	void clear_extra_bits(typename std::enable_if<T::limb_bits == T::total_bits>::type * = nullptr) {}
+	// NOTE: the kernels below are written as loops over the limbs. The number of limbs is a compile-time
+	// constant, and the loops are fully unrolled by the compiler.
 	static int raw_add(static_integer &res, const static_integer &x, const static_integer &y)
 	{
-		piranha_assert(x.abs_size() <= 2 && y.abs_size() <= 2);
-		const dlimb_t lo = static_cast<dlimb_t>(static_cast<dlimb_t>(x.m_limbs[0u]) + y.m_limbs[0u]);
-		const dlimb_t hi = static_cast<dlimb_t>((static_cast<dlimb_t>(x.m_limbs[1u]) + y.m_limbs[1u]) + (lo >> limb_bits));
+		piranha_assert(x.abs_size() <= mpz_size_t(n_limbs) && y.abs_size() <= mpz_size_t(n_limbs));
+		limbs_type tmp;
+		dlimb_t cy = 0u;
+		for (size_type i = 0u; i < n_limbs; ++i) {
+			cy = static_cast<dlimb_t>(static_cast<dlimb_t>(static_cast<dlimb_t>(x.m_limbs[i]) + y.m_limbs[i]) + cy);
+			tmp[i] = static_cast<limb_t>(cy);
+			cy = static_cast<dlimb_t>(cy >> limb_bits);
+		}
 		// NOTE: exit before modifying anything here, so that res is not modified.
-		if (unlikely(static_cast<limb_t>(hi >> limb_bits) != 0u)) {
+		if (unlikely(cy != 0u)) {
 			return 1;
 		}
-		res.m_limbs[0u] = static_cast<limb_t>(lo);
-		res.m_limbs[1u] = static_cast<limb_t>(hi);
+		res.m_limbs = tmp;
 		res._mp_size = res.calculate_n_limbs();
 		res.clear_extra_bits();
 		return 0;
 	}
 	static void raw_sub(static_integer &res, const static_integer &x, const static_integer &y)
 	{
-		piranha_assert(x.abs_size() <= 2 && y.abs_size() <= 2);
+		piranha_assert(x.abs_size() <= mpz_size_t(n_limbs) && y.abs_size() <= mpz_size_t(n_limbs));
 		piranha_assert(x.abs_size() >= y.abs_size());
-		piranha_assert(x.m_limbs[1u] >= y.m_limbs[1u]);
-		const bool has_borrow = x.m_limbs[0u] < y.m_limbs[0u];
-		piranha_assert(x.m_limbs[1u] > y.m_limbs[1u] || !has_borrow);
-		res.m_limbs[0u] = static_cast<limb_t>(x.m_limbs[0u] - y.m_limbs[0u]);
-		res.m_limbs[1u] = static_cast<limb_t>((x.m_limbs[1u] - y.m_limbs[1u]) - limb_t(has_borrow));
+		piranha_assert(compare(x.m_limbs,y.m_limbs,mpz_size_t(n_limbs)) >= 0);
+		bool has_borrow = false;
+		for (size_type i = 0u; i < n_limbs; ++i) {
+			// NOTE: read both operands before writing, as res might overlap with x or y.
+			const limb_t xl = x.m_limbs[i], yl = y.m_limbs[i];
+			res.m_limbs[i] = static_cast<limb_t>(static_cast<limb_t>(xl - yl) - limb_t(has_borrow));
+			has_borrow = xl < yl || (xl == yl && has_borrow);
+		}
+		piranha_assert(!has_borrow);
 		res._mp_size = res.calculate_n_limbs();
 		res.clear_extra_bits();
 	}
@@ -658,7 +699,7 @@ struct static_integer
 			asizey = -asizey;
 			signy = false;
 		}
-		piranha_assert(asizex <= 2 && asizey <= 2);
+		piranha_assert(asizex <= mpz_size_t(n_limbs) && asizey <= mpz_size_t(n_limbs));
 		if (signx == signy) {
 			if (unlikely(raw_add(res,x,y))) {
 				return 1;
@@ -689,16 +730,28 @@ struct static_integer
 	{
 		return add_or_sub<false>(res,x,y);
 	}
+	// Schoolbook multiplication of the absolute values of x and y. The result must fit in the static storage,
+	// that is, asizex + asizey must not be greater than n_limbs.
 	static void raw_mul(static_integer &res, const static_integer &x, const static_integer &y, const mpz_size_t &asizex,
 		const mpz_size_t &asizey)
 	{
 		piranha_assert(asizex > 0 && asizey > 0);
-		const dlimb_t lo = static_cast<dlimb_t>(static_cast<dlimb_t>(x.m_limbs[0u]) * y.m_limbs[0u]);
-		res.m_limbs[0u] = static_cast<limb_t>(lo);
-		const limb_t cy_limb = static_cast<limb_t>(lo >> limb_bits);
-		res.m_limbs[1u] = cy_limb;
-		res._mp_size = static_cast<mpz_size_t>((asizex + asizey) - mpz_size_t(cy_limb == 0u));
-		res.clear_extra_bits();
+		piranha_assert(asizex + asizey <= mpz_size_t(n_limbs));
+		// NOTE: the result is computed in a temporary, as res might overlap with x or y.
+		limbs_type tmp = limbs_type();
+		for (size_type i = 0u; i < static_cast<size_type>(asizex); ++i) {
+			limb_t cy_limb = 0u;
+			for (size_type j = 0u; j < static_cast<size_type>(asizey); ++j) {
+				const dlimb_t t = static_cast<dlimb_t>(static_cast<dlimb_t>(static_cast<dlimb_t>(x.m_limbs[i]) * y.m_limbs[j]) +
+					static_cast<dlimb_t>(static_cast<dlimb_t>(tmp[i + j]) + cy_limb));
+				tmp[i + j] = low_bits(t);
+				cy_limb = static_cast<limb_t>(t >> limb_bits);
+			}
+			tmp[static_cast<size_type>(i + static_cast<size_type>(asizey))] = cy_limb;
+		}
+		res.m_limbs = tmp;
+		res._mp_size = static_cast<mpz_size_t>((asizex + asizey) -
+			mpz_size_t(tmp[static_cast<size_type>(asizex + asizey - 1)] == 0u));
 		piranha_assert(res._mp_size > 0);
 	}
 	static int mul(static_integer &res, const static_integer &x, const static_integer &y)
@@ -706,8 +759,7 @@ struct static_integer
 		mpz_size_t asizex = x._mp_size, asizey = y._mp_size;
 		if (unlikely(asizex == 0 || asizey == 0)) {
 			res._mp_size = 0;
-			res.m_limbs[0u] = 0u;
-			res.m_limbs[1u] = 0u;
+			res.m_limbs.fill(0u);
 			return 0;
 		}
 		bool signx = true, signy = true;
@@ -719,7 +771,7 @@ struct static_integer
 			asizey = -asizey;
 			signy = false;
 		}
-		if (unlikely(asizex > 1 || asizey > 1)) {
+		if (unlikely(asizex + asizey > mpz_size_t(n_limbs))) {
 			return 1;
 		}
 		raw_mul(res,x,y,asizex,asizey);
@@ -787,18 +839,48 @@ struct static_integer
 			asizec = -asizec;
 			signc = false;
 		}
-		piranha_assert(asizea <= 2);
-		if (unlikely(asizeb > 1 || asizec > 1)) {
+		piranha_assert(asizea <= mpz_size_t(n_limbs));
+		if (unlikely(asizeb + asizec > mpz_size_t(n_limbs))) {
 			return 1;
 		}
 		if (unlikely(asizeb == 0 || asizec == 0)) {
 			return 0;
 		}
+		const bool signtmp = (signb == signc);
+		if (asizea == 0 || signa == signtmp) {
+			// Same signs: accumulate the partial products directly into a copy of the limbs of this,
+			// without forming the full product first.
+			limbs_type acc = m_limbs;
+			for (size_type i = 0u; i < static_cast<size_type>(asizeb); ++i) {
+				dlimb_t cy = 0u;
+				size_type k = i;
+				for (size_type j = 0u; j < static_cast<size_type>(asizec); ++j, ++k) {
+					cy = static_cast<dlimb_t>(static_cast<dlimb_t>(static_cast<dlimb_t>(b.m_limbs[i]) * c.m_limbs[j]) +
+						static_cast<dlimb_t>(static_cast<dlimb_t>(acc[k]) + cy));
+					acc[k] = low_bits(cy);
+					cy = static_cast<dlimb_t>(cy >> limb_bits);
+				}
+				for (; cy != 0u && k < n_limbs; ++k) {
+					cy = static_cast<dlimb_t>(static_cast<dlimb_t>(acc[k]) + cy);
+					acc[k] = low_bits(cy);
+					cy = static_cast<dlimb_t>(cy >> limb_bits);
+				}
+				// NOTE: exit before modifying anything here, so that this is not modified.
+				if (unlikely(cy != 0u)) {
+					return 1;
+				}
+			}
+			m_limbs = acc;
+			_mp_size = calculate_n_limbs();
+			if (!signtmp) {
+				negate();
+			}
+			return 0;
+		}
 		static_integer tmp;
 		raw_mul(tmp,b,c,asizeb,asizec);
 		const mpz_size_t asizetmp = tmp._mp_size;
-		const bool signtmp = (signb == signc);
-		piranha_assert(asizetmp <= 2 && asizetmp > 0);
+		piranha_assert(asizetmp <= mpz_size_t(n_limbs) && asizetmp > 0);
 		if (signa == signtmp) {
 			if (unlikely(raw_add(*this,*this,tmp))) {
 				return 1;
@@ -821,30 +903,54 @@ struct static_integer
 		}
 		return 0;
 	}
+	// Right-shift the absolute value by s bits, that is, truncated division by 2**s.
+	void rshift(const size_type &s)
+	{
+		const bool sign = _mp_size >= 0;
+		const size_type limb_shift = static_cast<size_type>(s / limb_bits), bit_shift = static_cast<size_type>(s % limb_bits);
+		if (limb_shift >= n_limbs) {
+			_mp_size = 0;
+			m_limbs.fill(0u);
+			return;
+		}
+		// NOTE: the limbs are read at indices not smaller than the index being written, so
+		// the shift can be done in-place.
+		for (size_type i = 0u; i < n_limbs; ++i) {
+			const size_type src = static_cast<size_type>(i + limb_shift);
+			const limb_t lo = (src < n_limbs) ? m_limbs[src] : limb_t(0u),
+				hi = (src + 1u < n_limbs) ? m_limbs[static_cast<size_type>(src + 1u)] : limb_t(0u);
+			m_limbs[i] = bit_shift ? low_bits(static_cast<dlimb_t>((static_cast<dlimb_t>(lo) >> bit_shift) +
+				(static_cast<dlimb_t>(hi) << (limb_bits - bit_shift)))) : lo;
+		}
+		_mp_size = calculate_n_limbs();
+		if (!sign) {
+			negate();
+		}
+	}
 	// Left-shift by one.
 	void lshift1()
 	{
-		piranha_assert(m_limbs[1u] < (limb_t(1) << (limb_bits - 1u)));
-		using size_type = typename limbs_type::size_type;
-		// Shift both limbs.
-		dlimb_t lo = static_cast<dlimb_t>(static_cast<dlimb_t>(m_limbs[0u]) << dlimb_t(1));
-		dlimb_t hi = static_cast<dlimb_t>(static_cast<dlimb_t>(m_limbs[1u]) << dlimb_t(1));
-		m_limbs[0u] = static_cast<limb_t>(lo);
-		m_limbs[1u] = static_cast<limb_t>(hi + (lo >> limb_bits));
-		piranha_assert((hi >> limb_bits) != 1u);
+		piranha_assert(m_limbs[n_limbs - 1u] < (limb_t(1) << (limb_bits - 1u)));
+		// Shift all limbs, starting from the top one.
+		for (size_type i = n_limbs - 1u; i != 0u; --i) {
+			m_limbs[i] = low_bits(static_cast<dlimb_t>((static_cast<dlimb_t>(m_limbs[i]) << 1u) +
+				(m_limbs[i - 1u] >> (limb_bits - 1u))));
+		}
+		m_limbs[0u] = low_bits(static_cast<dlimb_t>(static_cast<dlimb_t>(m_limbs[0u]) << 1u));
 		mpz_size_t asize = _mp_size;
 		bool sign = true;
 		if (asize < 0) {
 			asize = -asize;
 			sign = false;
 		}
-		if (asize < 2) {
+		if (asize < mpz_size_t(n_limbs)) {
 			asize = static_cast<mpz_size_t>(asize + (m_limbs[static_cast<size_type>(asize)] != 0u));
 			_mp_size = static_cast<mpz_size_t>(sign ? asize : -asize);
 		}
-		clear_extra_bits();
 	}
 	// Division.
+	// NOTE: with up to two limbs, the computation is done directly in dlimb_t.
+	template <typename T = static_integer, typename std::enable_if<T::n_limbs <= 2u,int>::type = 0>
 	static void div(static_integer &q, static_integer &r, const static_integer &a, const static_integer &b)
 	{
 		piranha_assert(!b.is_zero());
@@ -853,18 +959,74 @@ struct static_integer
 		// Store the signs.
 		const bool signa = a._mp_size >= 0, signb = b._mp_size >= 0;
 		// Compute the result in dlimb_t.
-		const dlimb_t ad = static_cast<dlimb_t>(a.m_limbs[0u] + (static_cast<dlimb_t>(a.m_limbs[1u]) << limb_bits)),
-			bd = static_cast<dlimb_t>(b.m_limbs[0u] + (static_cast<dlimb_t>(b.m_limbs[1u]) << limb_bits));
-		const dlimb_t qd = static_cast<dlimb_t>(ad / bd), rd = static_cast<dlimb_t>(ad % bd);
+		dlimb_t ad = 0u, bd = 0u;
+		for (size_type i = n_limbs; i != 0u; --i) {
+			ad = static_cast<dlimb_t>((ad << limb_bits) + a.m_limbs[i - 1u]);
+			bd = static_cast<dlimb_t>((bd << limb_bits) + b.m_limbs[i - 1u]);
+		}
+		dlimb_t qd = static_cast<dlimb_t>(ad / bd), rd = static_cast<dlimb_t>(ad % bd);
 		// Convert back to array of limb_t.
-		q.m_limbs[0u] = static_cast<limb_t>(qd);
-		q.m_limbs[1u] = static_cast<limb_t>(qd >> limb_bits);
-		q.clear_extra_bits();
+		for (size_type i = 0u; i < n_limbs; ++i) {
+			q.m_limbs[i] = low_bits(qd);
+			r.m_limbs[i] = low_bits(rd);
+			qd = static_cast<dlimb_t>(qd >> limb_bits);
+			rd = static_cast<dlimb_t>(rd >> limb_bits);
+		}
 		q._mp_size = q.calculate_n_limbs();
-		r.m_limbs[0u] = static_cast<limb_t>(rd);
-		r.m_limbs[1u] = static_cast<limb_t>(rd >> limb_bits);
-		r.clear_extra_bits();
 		r._mp_size = r.calculate_n_limbs();
+		div_fix_signs(q,r,signa,signb);
+	}
+	// NOTE: with more than two limbs, division by a single limb is done limb by limb in dlimb_t, otherwise
+	// via bitwise long division.
+	template <typename T = static_integer, typename std::enable_if<(T::n_limbs > 2u),int>::type = 0>
+	static void div(static_integer &q, static_integer &r, const static_integer &a, const static_integer &b)
+	{
+		piranha_assert(!b.is_zero());
+		const bool signa = a._mp_size >= 0, signb = b._mp_size >= 0;
+		const mpz_size_t asizeb = b.abs_size();
+		limbs_type ql = limbs_type(), rl = limbs_type();
+		if (asizeb == 1) {
+			const dlimb_t bd = b.m_limbs[0u];
+			dlimb_t rd = 0u;
+			for (size_type i = n_limbs; i != 0u; --i) {
+				const dlimb_t cur = static_cast<dlimb_t>((rd << limb_bits) + a.m_limbs[i - 1u]);
+				ql[i - 1u] = static_cast<limb_t>(cur / bd);
+				rd = static_cast<dlimb_t>(cur % bd);
+			}
+			rl[0u] = static_cast<limb_t>(rd);
+		} else {
+			const limbs_type bl = b.m_limbs;
+			const limb_t nbits = a.bits_size();
+			for (limb_t i = nbits; i != 0u; --i) {
+				// Shift the remainder by one, keeping track of the bit shifted out of the top limb, and
+				// bring down the next bit of a.
+				const bool top = (rl[n_limbs - 1u] >> (limb_bits - 1u)) != 0u;
+				for (size_type j = n_limbs - 1u; j != 0u; --j) {
+					rl[j] = low_bits(static_cast<dlimb_t>((static_cast<dlimb_t>(rl[j]) << 1u) + (rl[j - 1u] >> (limb_bits - 1u))));
+				}
+				rl[0u] = low_bits(static_cast<dlimb_t>((static_cast<dlimb_t>(rl[0u]) << 1u) + a.test_bit(static_cast<limb_t>(i - 1u))));
+				if (top || compare(rl,bl,mpz_size_t(n_limbs)) >= 0) {
+					// NOTE: if top is set the subtraction wraps around, yielding the correct remainder.
+					bool has_borrow = false;
+					for (size_type j = 0u; j < n_limbs; ++j) {
+						const limb_t xl = rl[j], yl = bl[j];
+						rl[j] = low_bits(static_cast<dlimb_t>(static_cast<dlimb_t>(static_cast<dlimb_t>(xl) - yl) - has_borrow));
+						has_borrow = xl < yl || (xl == yl && has_borrow);
+					}
+					const auto bit = static_cast<limb_t>(i - 1u);
+					ql[static_cast<size_type>(bit / limb_bits)] = static_cast<limb_t>(ql[static_cast<size_type>(bit / limb_bits)] |
+						static_cast<limb_t>(limb_t(1) << (bit % limb_bits)));
+				}
+			}
+		}
+		q.m_limbs = ql;
+		r.m_limbs = rl;
+		q._mp_size = q.calculate_n_limbs();
+		r._mp_size = r.calculate_n_limbs();
+		div_fix_signs(q,r,signa,signb);
+	}
+	static void div_fix_signs(static_integer &q, static_integer &r, bool signa, bool signb)
+	{
 		// The sign of the remainder is the same as the numerator.
 		if (!signa) {
 			r.negate();
@@ -877,7 +1039,6 @@ struct static_integer
 	// Compute the number of bits used in the representation of the integer.
 	limb_t bits_size() const
 	{
-		using size_type = typename limbs_type::size_type;
 		const auto asize = abs_size();
 		if (asize == 0) {
 			return 0u;
@@ -892,8 +1053,7 @@ struct static_integer
 	}
 	limb_t test_bit(const limb_t &idx) const
 	{
-		using size_type = typename limbs_type::size_type;
-		piranha_assert(idx < limb_bits * 2u);
+		piranha_assert(idx < max_bits);
 		const auto quot = static_cast<limb_t>(idx / limb_bits), rem = static_cast<limb_t>(idx % limb_bits);
 		return (static_cast<limb_t>(m_limbs[static_cast<size_type>(quot)] & static_cast<limb_t>(limb_t(1u) << rem)) != 0u);
 	}
@@ -901,7 +1061,7 @@ struct static_integer
 	struct hash_checks
 	{
 		// Total number of bits that can be stored. We know already this operation is safe.
-		static const limb_t tot_bits = static_cast<limb_t>(limb_bits * 2u);
+		static const limb_t tot_bits = max_bits;
 		static const unsigned nbits_size_t = static_cast<unsigned>(std::numeric_limits<std::size_t>::digits);
 		static const limb_t q = static_cast<limb_t>(tot_bits / nbits_size_t);
 		static const limb_t r = static_cast<limb_t>(tot_bits % nbits_size_t);
@@ -936,7 +1096,7 @@ struct static_integer
 			q = tot_nbits / nbits_size_t, r = tot_nbits % nbits_size_t,
 			n_size_t = q + unsigned(r != 0u);
 		for (unsigned i = 0u; i < n_size_t; ++i) {
-			boost::hash_combine(retval,read_uint<std::size_t,total_bits - limb_bits>(&m_limbs[0u],2u,static_cast<std::size_t>(i)));
+			boost::hash_combine(retval,read_uint<std::size_t,total_bits - limb_bits>(&m_limbs[0u],n_limbs,static_cast<std::size_t>(i)));
 		}
 		return retval;
 	}
@@ -946,15 +1106,21 @@ struct static_integer
 };
 
 // Static init.
-template <int NBits>
-const typename static_integer<NBits>::limb_t static_integer<NBits>::limb_bits;
+template <int NBits, std::size_t NLimbs>
+const typename static_integer<NBits,NLimbs>::limb_t static_integer<NBits,NLimbs>::limb_bits;
+
+template <int NBits, std::size_t NLimbs>
+const std::size_t static_integer<NBits,NLimbs>::n_limbs;
+
+template <int NBits, std::size_t NLimbs>
+const typename static_integer<NBits,NLimbs>::limb_t static_integer<NBits,NLimbs>::max_bits;
 
 // Integer union.
-template <int NBits>
+template <int NBits, std::size_t NLimbs = 2u>
 union integer_union
 {
 	public:
-		using s_storage = static_integer<NBits>;
+		using s_storage = static_integer<NBits,NLimbs>;
 		using d_storage = mpz_struct_t;
 		static void move_ctor_mpz(mpz_struct_t &to, mpz_struct_t &from)
 		{
@@ -1053,7 +1219,7 @@ union integer_union
 		static bool fits_in_static(const mpz_struct_t &mpz)
 		{
 			// NOTE: sizeinbase returns the index of the highest bit *counting from 1* (like a logarithm).
-			return (::mpz_sizeinbase(&mpz,2) <= s_storage::limb_bits * 2u);
+			return (::mpz_sizeinbase(&mpz,2) <= s_storage::max_bits);
 		}
 		void destroy_dynamic()
 		{
@@ -1120,10 +1286,15 @@ struct is_mp_integer_interoperable_type
  * (i.e., the range is limited only by the available memory).
  *
  * As an optimisation, this class will store in static internal storage a fixed number of digits before resorting to dynamic
- * memory allocation. The internal storage consists of two limbs of size \p NBits bits, for a total of <tt>2*NBits</tt> bits
+ * memory allocation. The internal storage consists of \p NLimbs limbs of size \p NBits bits, for a total of <tt>NLimbs*NBits</tt> bits
  * of static storage. The possible values for \p NBits, supported on all platforms, are 8, 16, and 32.
  * A value of 64 is supported on some platforms. The special
  * default value of 0 is used to automatically select the optimal \p NBits value on the current platform.
+ * The possible values for \p NLimbs are 1, 2, 3 and 4. Additions, subtractions and multiplications of numbers stored
+ * in static storage do not allocate memory as long as the result fits in static storage (in particular,
+ * the product of a number of \p n limbs by a number of \p m limbs is computed in static storage if <tt>n + m <= NLimbs</tt>).
+ * Larger values of \p NLimbs are thus useful when dealing with numbers that routinely exceed <tt>2*NBits</tt> bits
+ * (e.g., <tt>mp_integer<64,4></tt> can represent in static storage numbers of up to 256 bits).
  * 
  * ## Interoperability with other types ##
  * 
@@ -1194,7 +1365,7 @@ struct is_mp_integer_interoperable_type
  *   for interaction with long doubles? This might need a thread local mpz_t/real/mpfr_t in order to avoid having to allocate at each
  *   construction, but for thread local we have the usual issue on OSX.
  */
-template <int NBits = 0>
+template <int NBits = 0, std::size_t NLimbs = 2u>
 class mp_integer
 {
 		// Make friend with debugging class, mp_rational and real.
@@ -1230,11 +1401,12 @@ class mp_integer
 			}
 			Float abs_x = std::abs(x);
 			const unsigned radix = static_cast<unsigned>(std::numeric_limits<Float>::radix);
-			detail::mpz_raii m, tmp;
+			auto &m = detail::mpz_scratch(0u), &tmp = detail::mpz_scratch(1u);
+			::mpz_set_ui(&m,0u);
 			int exp = std::ilogb(abs_x);
 			while (exp >= 0) {
-				::mpz_ui_pow_ui(&tmp.m_mpz,radix,static_cast<unsigned>(exp));
-				::mpz_add(&m.m_mpz,&m.m_mpz,&tmp.m_mpz);
+				::mpz_ui_pow_ui(&tmp,radix,static_cast<unsigned>(exp));
+				::mpz_add(&m,&m,&tmp);
 				const Float ftmp = std::scalbn(Float(1),exp);
 				if (unlikely(ftmp == HUGE_VAL)) {
 					piranha_throw(std::invalid_argument,"output of std::scalbn is HUGE_VAL");
@@ -1253,11 +1425,11 @@ class mp_integer
 					piranha_throw(std::invalid_argument,"error calling std::ilogb");
 				}
 			}
-			if (m_int.fits_in_static(m.m_mpz)) {
-				using limb_t = typename detail::integer_union<NBits>::s_storage::limb_t;
-				const auto size2 = ::mpz_sizeinbase(&m.m_mpz,2);
+			if (m_int.fits_in_static(m)) {
+				using limb_t = typename detail::integer_union<NBits,NLimbs>::s_storage::limb_t;
+				const auto size2 = ::mpz_sizeinbase(&m,2);
 				for (::mp_bitcnt_t i = 0u; i < size2; ++i) {
-					if (::mpz_tstbit(&m.m_mpz,i)) {
+					if (::mpz_tstbit(&m,i)) {
 						m_int.g_st().set_bit(static_cast<limb_t>(i));
 					}
 				}
@@ -1266,7 +1438,9 @@ class mp_integer
 				}
 			} else {
 				m_int.promote();
-				::mpz_swap(&m.m_mpz,&m_int.g_dy());
+				// NOTE: after the swap the scratch slot holds the limbs allocated by promote(),
+				// and it remains a valid initialised integer.
+				::mpz_swap(&m,&m_int.g_dy());
 				if (x < Float(0)) {
 					::mpz_neg(&m_int.g_dy(),&m_int.g_dy());
 				}
@@ -1289,12 +1463,13 @@ class mp_integer
 			}
 			// Go through a temp mpz for the construction.
 			Integer n = n_orig;
-			detail::mpz_raii m;
+			auto &m = detail::mpz_scratch(0u);
+			::mpz_set_ui(&m,0u);
 			::mp_bitcnt_t bit_idx = 0;
 			while (n != Integer(0)) {
 				Integer div = static_cast<Integer>(n / Integer(2)), rem = static_cast<Integer>(n % Integer(2));
 				if (rem != Integer(0)) {
-					::mpz_setbit(&m.m_mpz,bit_idx);
+					::mpz_setbit(&m,bit_idx);
 				}
 				if (unlikely(bit_idx == std::numeric_limits< ::mp_bitcnt_t>::max())) {
 					piranha_throw(std::invalid_argument,"overflow in the construction from integral type");
@@ -1305,7 +1480,7 @@ class mp_integer
 			// Promote the current static to dynamic storage.
 			m_int.promote();
 			// Swap in the temp mpz.
-			::mpz_swap(&m.m_mpz,&m_int.g_dy());
+			::mpz_swap(&m,&m_int.g_dy());
 			// Fix the sign as needed.
 			if (n_orig <= Integer(0)) {
 				::mpz_neg(&m_int.g_dy(),&m_int.g_dy());
@@ -1346,22 +1521,22 @@ class mp_integer
 			// to be NULL terminated, and if the string is empty, this will still work (21.4.7 and around).
 			validate_string(str,std::strlen(str));
 			// String is OK.
-			detail::mpz_raii m;
+			auto &m = detail::mpz_scratch(0u);
 			// Use set() as m is already inited.
-			const int retval = ::mpz_set_str(&m.m_mpz,str,10);
+			const int retval = ::mpz_set_str(&m,str,10);
 			if (retval == -1) {
 				piranha_throw(std::invalid_argument,"invalid string input for integer type");
 			}
 			piranha_assert(retval == 0);
-			const bool negate = (mpz_sgn(&m.m_mpz) == -1);
+			const bool negate = (mpz_sgn(&m) == -1);
 			if (negate) {
-				::mpz_neg(&m.m_mpz,&m.m_mpz);
+				::mpz_neg(&m,&m);
 			}
-			if (m_int.fits_in_static(m.m_mpz)) {
-				using limb_t = typename detail::integer_union<NBits>::s_storage::limb_t;
-				const auto size2 = ::mpz_sizeinbase(&m.m_mpz,2);
+			if (m_int.fits_in_static(m)) {
+				using limb_t = typename detail::integer_union<NBits,NLimbs>::s_storage::limb_t;
+				const auto size2 = ::mpz_sizeinbase(&m,2);
 				for (::mp_bitcnt_t i = 0u; i < size2; ++i) {
-					if (::mpz_tstbit(&m.m_mpz,i)) {
+					if (::mpz_tstbit(&m,i)) {
 						m_int.g_st().set_bit(static_cast<limb_t>(i));
 					}
 				}
@@ -1370,7 +1545,7 @@ class mp_integer
 				}
 			} else {
 				m_int.promote();
-				::mpz_swap(&m.m_mpz,&m_int.g_dy());
+				::mpz_swap(&m,&m_int.g_dy());
 				if (negate) {
 					::mpz_neg(&m_int.g_dy(),&m_int.g_dy());
 				}
@@ -1460,7 +1635,7 @@ class mp_integer
 			}
 			T retval(0), tmp(static_cast<T>(negative ? -1 : 1));
 			if (m_int.is_static()) {
-				using limb_t = typename detail::integer_union<NBits>::s_storage::limb_t;
+				using limb_t = typename detail::integer_union<NBits,NLimbs>::s_storage::limb_t;
 				const limb_t bits_size = m_int.g_st().bits_size();
 				piranha_assert(bits_size != 0u);
 				for (limb_t i = 0u; i < bits_size; ++i) {
@@ -1479,13 +1654,13 @@ class mp_integer
 				}
 			} else {
 				// NOTE: copy here, it's not the fastest way but it should be safer.
-				detail::mpz_raii tmp_mpz;
-				::mpz_set(&tmp_mpz.m_mpz,&m_int.g_dy());
+				auto &tmp_mpz = detail::mpz_scratch(0u);
+				::mpz_set(&tmp_mpz,&m_int.g_dy());
 				// Adjust the sign as needed, in order to use the test bit function below.
-				if (mpz_sgn(&tmp_mpz.m_mpz) == -1) {
-					::mpz_neg(&tmp_mpz.m_mpz,&tmp_mpz.m_mpz);
+				if (mpz_sgn(&tmp_mpz) == -1) {
+					::mpz_neg(&tmp_mpz,&tmp_mpz);
 				}
-				const std::size_t bits_size = ::mpz_sizeinbase(&tmp_mpz.m_mpz,2);
+				const std::size_t bits_size = ::mpz_sizeinbase(&tmp_mpz,2);
 				piranha_assert(bits_size != 0u);
 				for (std::size_t i = 0u; i < bits_size; ++i) {
 					if (i != 0u) {
@@ -1498,7 +1673,7 @@ class mp_integer
 					} catch (...) {
 						piranha_throw(std::overflow_error,"overflow in conversion to integral type");
 					}
-					if (::mpz_tstbit(&tmp_mpz.m_mpz,bit_idx)) {
+					if (::mpz_tstbit(&tmp_mpz,bit_idx)) {
 						if (negative && retval < std::numeric_limits<T>::min() - tmp) {
 							piranha_throw(std::overflow_error,"overflow in conversion to integral type");
 						} else if (!negative && retval > std::numeric_limits<T>::max() - tmp) {
@@ -1526,16 +1701,16 @@ class mp_integer
 				return T(0);
 			}
 			// Extract a GMP mpz to work with.
-			detail::mpz_raii tmp;
+			auto &tmp = detail::mpz_scratch(0u);
 			if (m_int.is_static()) {
 				auto v = m_int.g_st().get_mpz_view();
-				::mpz_set(&tmp.m_mpz,v);
+				::mpz_set(&tmp,v);
 			} else {
-				::mpz_set(&tmp.m_mpz,&m_int.g_dy());
+				::mpz_set(&tmp,&m_int.g_dy());
 			}
 			// Work on absolute value.
 			if (s < 0) {
-				::mpz_neg(&tmp.m_mpz,&tmp.m_mpz);
+				::mpz_neg(&tmp,&tmp);
 			}
 			const unsigned radix = static_cast<unsigned>(std::numeric_limits<T>::radix);
 			// NOTE: radix must be between 2 and 62 for GMP functions to work.
@@ -1544,7 +1719,7 @@ class mp_integer
 			}
 			unsigned long r_size;
 			try {
-				r_size = boost::numeric_cast<unsigned long>(::mpz_sizeinbase(&tmp.m_mpz,static_cast<int>(radix)));
+				r_size = boost::numeric_cast<unsigned long>(::mpz_sizeinbase(&tmp,static_cast<int>(radix)));
 			} catch (...) {
 				piranha_throw(std::overflow_error,"overflow in conversion to floating-point type");
 			}
@@ -1552,17 +1727,17 @@ class mp_integer
 			// which one is which.
 			// https://gmplib.org/manual/Miscellaneous-Integer-Functions.html#Miscellaneous-Integer-Functions
 			piranha_assert(r_size >= 1u);
-			detail::mpz_raii tmp2, tmp3;
-			::mpz_ui_pow_ui(&tmp2.m_mpz,static_cast<unsigned long>(radix),r_size - 1ul);
-			::mpz_sub_ui(&tmp2.m_mpz,&tmp2.m_mpz,1ul);
-			if (::mpz_cmp(&tmp2.m_mpz,&tmp.m_mpz) > 0) {
+			auto &tmp2 = detail::mpz_scratch(1u);
+			::mpz_ui_pow_ui(&tmp2,static_cast<unsigned long>(radix),r_size - 1ul);
+			::mpz_sub_ui(&tmp2,&tmp2,1ul);
+			if (::mpz_cmp(&tmp2,&tmp) > 0) {
 				--r_size;
 			}
 			// Init return value.
 			T retval(0);
 			int exp = 0;
 			for (unsigned long i = 0u; i < r_size; ++i) {
-				const auto rem = ::mpz_fdiv_q_ui(&tmp.m_mpz,&tmp.m_mpz,static_cast<unsigned long>(radix));
+				const auto rem = ::mpz_fdiv_q_ui(&tmp,&tmp,static_cast<unsigned long>(radix));
 				const auto exp_val = std::scalbn(static_cast<T>(rem),exp);
 				if (unlikely(exp_val == HUGE_VAL)) {
 					// Return infinity if possible.
@@ -2061,7 +2236,7 @@ class mp_integer
 		// mpz view class.
 		class mpz_view
 		{
-				using static_mpz_view = typename detail::integer_union<NBits>::s_storage::template static_mpz_view<>;
+				using static_mpz_view = typename detail::integer_union<NBits,NLimbs>::s_storage::template static_mpz_view<>;
 			public:
 				explicit mpz_view(const mp_integer &n):
 					m_static_view(n.is_static() ? n.m_int.g_st().get_mpz_view() : static_mpz_view{}),
@@ -2180,7 +2355,7 @@ class mp_integer
 			// in later GMP versions for this.
 			const ::mp_limb_t *l_ptr = z->_mp_d;
 			// Effective number of bits used per limb in static storage.
-			const auto limb_bits = detail::integer_union<NBits>::s_storage::limb_bits;
+			const auto limb_bits = detail::integer_union<NBits,NLimbs>::s_storage::limb_bits;
 			// Here we are checking roughly if we need static or dynamic
 			// storage, based on the number of limbs used in z and the available
 			// bits in static storage. It is a conservative check, meaning there
@@ -2190,14 +2365,14 @@ class mp_integer
 			// has 16 bit limb.
 			// We could replace with mpz sizeinbase() but performance would be worse
 			// probably. Need to invesitgate.
-			if (unsigned(GMP_NUMB_BITS) > (limb_bits * 2u) / size) {
+			if (unsigned(GMP_NUMB_BITS) > detail::integer_union<NBits,NLimbs>::s_storage::max_bits / size) {
 				promote();
 				::mpz_set(&m_int.g_dy(),z);
 			} else {
 				// Limb type in static storage.
-				using limb_t = typename detail::integer_union<NBits>::s_storage::limb_t;
+				using limb_t = typename detail::integer_union<NBits,NLimbs>::s_storage::limb_t;
 				// Number of total bits per limb in static storage (>= limb_bits).
-				const auto total_bits = detail::integer_union<NBits>::s_storage::total_bits;
+				const auto total_bits = detail::integer_union<NBits,NLimbs>::s_storage::total_bits;
 				// The total number of bits we will need to extract from z. We know we can compute this
 				// because we know z fits static, and we can always represent the total number of bits
 				// in static.
@@ -2205,9 +2380,9 @@ class mp_integer
 					q = static_cast<limb_t>(tot_nbits / limb_bits),
 					r = static_cast<limb_t>(tot_nbits % limb_bits),
 					n_limbs = static_cast<limb_t>(q + static_cast<limb_t>(r != 0u));
-				piranha_assert(n_limbs <= 2u && n_limbs > 0u);
-				// NOTE: if here the number of static limbs used will be only 1, the second
-				// limb has already been zeroed out by the intial construction.
+				piranha_assert(n_limbs <= NLimbs && n_limbs > 0u);
+				// NOTE: the static limbs which are not used here have already been zeroed out
+				// by the intial construction.
 				for (std::size_t i = 0u; i < n_limbs; ++i) {
 					m_int.g_st().m_limbs[i] = detail::read_uint<limb_t,unsigned(GMP_LIMB_BITS - GMP_NUMB_BITS),
 						total_bits-limb_bits>(l_ptr,size,i);
@@ -2382,6 +2557,29 @@ class mp_integer
 				::mpz_neg(&m_int.g_dy(),&m_int.g_dy());
 			}
 		}
+		/// In-place truncated division by a power of two.
+		/**
+		 * This method will divide \p this by <tt>2**s</tt>, rounding towards zero. The result is the same
+		 * as the one of <tt>*this /= 2**s</tt>, but the operation is implemented as a bit shift.
+		 *
+		 * @param[in] s the exponent of the power of two.
+		 *
+		 * @return reference to \p this.
+		 */
+		mp_integer &div_2exp(const ::mp_bitcnt_t &s)
+		{
+			if (is_static()) {
+				using size_type = typename detail::integer_union<NBits,NLimbs>::s_storage::size_type;
+				if (s >= detail::integer_union<NBits,NLimbs>::s_storage::max_bits) {
+					m_int.g_st() = typename detail::integer_union<NBits,NLimbs>::s_storage();
+				} else {
+					m_int.g_st().rshift(static_cast<size_type>(s));
+				}
+			} else {
+				::mpz_tdiv_q_2exp(&m_int.g_dy(),&m_int.g_dy(),s);
+			}
+			return *this;
+		}
 		/// Sign.
 		/**
 		 * @return 1 if <tt>this > 0</tt>, 0 if <tt>this == 0</tt> and -1 if <tt>this < 0</tt>.
@@ -3060,7 +3258,7 @@ class mp_integer
 		struct hash_checks
 		{
 			static const unsigned nbits_size_t = static_cast<unsigned>(std::numeric_limits<std::size_t>::digits);
-			using s_storage = typename detail::integer_union<NBits>::s_storage;
+			using s_storage = typename detail::integer_union<NBits,NLimbs>::s_storage;
 			// Check that the computation of the total number of bits does not overflow when the number
 			// of size_t to extract is no more than the corresponding quantity for the static int.
 			// This protects again both the computation of tot_nbits, but also the multiplication inside
@@ -3273,7 +3471,7 @@ class mp_integer
 			return mpz_cmp_ui(&m_int.g_dy(),1ul) == 0;
 		}
 	private:
-		detail::integer_union<NBits> m_int;
+		detail::integer_union<NBits,NLimbs> m_int;
 };
 
 /// Alias for piranha::mp_integer with default bit size.
@@ -3289,8 +3487,8 @@ namespace detail
 template <typename T>
 struct is_mp_integer: std::false_type {};
 
-template <int NBits>
-struct is_mp_integer<mp_integer<NBits>>: std::true_type {};
+template <int NBits, std::size_t NLimbs>
+struct is_mp_integer<mp_integer<NBits,NLimbs>>: std::true_type {};
 
 }
 
@@ -3473,8 +3671,8 @@ struct partial_impl<T,typename std::enable_if<detail::is_mp_integer<T>::value>::
  *
  * @throws unspecified any exception thrown by piranha::mp_integer::factorial().
  */
-template <int NBits>
-inline mp_integer<NBits> factorial(const mp_integer<NBits> &n)
+template <int NBits, std::size_t NLimbs>
+inline mp_integer<NBits,NLimbs> factorial(const mp_integer<NBits,NLimbs> &n)
 {
 	return n.factorial();
 }
@@ -3634,13 +3832,13 @@ namespace std
 {
 
 /// Specialisation of \p std::hash for piranha::mp_integer.
-template <int NBits>
-struct hash<piranha::mp_integer<NBits>>
+template <int NBits, std::size_t NLimbs>
+struct hash<piranha::mp_integer<NBits,NLimbs>>
 {
 	/// Result type.
 	typedef size_t result_type;
 	/// Argument type.
-	typedef piranha::mp_integer<NBits> argument_type;
+	typedef piranha::mp_integer<NBits,NLimbs> argument_type;
 	/// Hash operator.
 	/**
 	 * @param[in] n piranha::mp_integer whose hash value will be returned.
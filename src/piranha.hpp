@@ -192,9 +192,12 @@ inline namespace literals {}
 #include "debug_access.hpp"
 #include "divisor.hpp"
 #include "divisor_series.hpp"
+#include "double_double.hpp"
 #include "dynamic_aligning_allocator.hpp"
 #include "environment.hpp"
+#include "evaluation_plan.hpp"
 #include "exceptions.hpp"
+#include "flat_hash_set.hpp"
 #include "hash_set.hpp"
 #include "invert.hpp"
 #include "ipow_substitutable_series.hpp"
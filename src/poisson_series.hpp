@@ -32,6 +32,7 @@
 
 #include "base_series_multiplier.hpp"
 #include "config.hpp"
+#include "detail/cf_kernels.hpp"
 #include "detail/gcd.hpp"
 #include "detail/divisor_series_fwd.hpp"
 #include "detail/poisson_series_fwd.hpp"
@@ -645,6 +646,18 @@ namespace detail
 template <typename Series>
 using ps_series_multiplier_enabler = typename std::enable_if<std::is_base_of<poisson_series_tag,Series>::value>::type;
 
+template <typename T>
+struct is_rtk_monomial
+{
+	static const bool value = false;
+};
+
+template <typename T>
+struct is_rtk_monomial<real_trigonometric_kronecker_monomial<T>>
+{
+	static const bool value = true;
+};
+
 }
 
 /// Specialisation of piranha::series_multiplier for piranha::poisson_series.
@@ -655,6 +668,55 @@ class series_multiplier<Series,detail::ps_series_multiplier_enabler<Series>> : p
 		template <typename T>
 		using call_enabler = typename std::enable_if<key_is_multipliable<typename T::term_type::cf_type,
 			typename T::term_type::key_type>::value,int>::type;
+		// Check if the multiplication can be performed on the codified values of the trigonometric keys, that is,
+		// if the multipliers of the result are guaranteed to be within the limits of the Kronecker codification.
+		template <typename T = Series, typename std::enable_if<detail::is_rtk_monomial<typename T::term_type::key_type>::value,int>::type = 0>
+		void check_bounds()
+		{
+			using key_type = typename Series::term_type::key_type;
+			using value_type = typename key_type::value_type;
+			using v_type = typename key_type::v_type;
+			const auto size = this->m_ss.size();
+			// Maximum absolute values of the multipliers in a series.
+			auto max_mults = [this,size](const typename base::v_ptr &v) -> v_type {
+				v_type retval(static_cast<typename v_type::size_type>(size),value_type(0));
+				for (const auto &p: v) {
+					const auto tmp = p->m_key.unpack(this->m_ss);
+					for (decltype(tmp.size()) i = 0u; i < tmp.size(); ++i) {
+						// NOTE: the range of the components in kronecker_array is symmetric, so the negation is safe.
+						const auto a = (tmp[i] < value_type(0)) ? static_cast<value_type>(-tmp[i]) : tmp[i];
+						if (a > retval[i]) {
+							retval[i] = a;
+						}
+					}
+				}
+				return retval;
+			};
+			m_packed = key_type::check_multiply_packed(max_mults(this->m_v1),max_mults(this->m_v2));
+		}
+		template <typename T = Series, typename std::enable_if<!detail::is_rtk_monomial<typename T::term_type::key_type>::value,int>::type = 0>
+		void check_bounds() {}
+		// Key multiplication functor operating on the codified values of the trigonometric keys.
+		struct packed_key_multiplier
+		{
+			template <typename ResArray, typename Term>
+			void operator()(ResArray &res, const Term &t1, const Term &t2, const symbol_set &args) const
+			{
+				Term::key_type::multiply_packed(res,t1,t2,args);
+			}
+		};
+		template <typename T = Series, typename std::enable_if<detail::is_rtk_monomial<typename T::term_type::key_type>::value,int>::type = 0>
+		Series packed_multiplication() const
+		{
+			const auto size2 = this->m_v2.size();
+			return this->plain_multiplication([size2](const typename base::size_type &) {return size2;},packed_key_multiplier{});
+		}
+		template <typename T = Series, typename std::enable_if<!detail::is_rtk_monomial<typename T::term_type::key_type>::value,int>::type = 0>
+		Series packed_multiplication() const
+		{
+			piranha_assert(false);
+			return this->plain_multiplication();
+		}
 		void divide_by_two(Series &s) const
 		{
 			// NOTE: if we ever implement multi-threaded series division we most likely need
@@ -669,7 +731,8 @@ class series_multiplier<Series,detail::ps_series_multiplier_enabler<Series>> : p
 				using term_type = typename Series::term_type;
 				auto &container = s._container();
 				std::atomic<bucket_size_type> total_erase_count(0u);
-				auto divider = [&container,&total_erase_count,this](bucket_size_type start_idx, bucket_size_type end_idx) {
+				const detail::cf_div_kernel<typename term_type::cf_type,int> div2(2);
+				auto divider = [&container,&total_erase_count,&div2,this](bucket_size_type start_idx, bucket_size_type end_idx) {
 					// A vector of terms to be erased at each bucket iteration.
 					std::vector<term_type> term_list;
 					// Total number of terms erased by this thread.
@@ -679,7 +742,7 @@ class series_multiplier<Series,detail::ps_series_multiplier_enabler<Series>> : p
 						term_list.clear();
 						const auto &list = container._get_bucket_list(start_idx);
 						for (const auto &t: list) {
-							t.m_cf /= 2;
+							div2(t.m_cf);
 							if (unlikely(t.is_ignorable(this->m_ss))) {
 								term_list.push_back(t);
 							}
@@ -702,7 +765,7 @@ class series_multiplier<Series,detail::ps_series_multiplier_enabler<Series>> : p
 						// Special casing for the last thread.
 						const auto end_idx = (i == this->m_n_threads - 1u) ? container.bucket_count() :
 							static_cast<bucket_size_type>(bpt * (i + 1u));
-						ff_list.push_back(thread_pool::enqueue(i,divider,start_idx,end_idx));
+						ff_list.push_back(thread_pool::enqueue_task(i,divider,start_idx,end_idx));
 					}
 					// First let's wait for everything to finish.
 					ff_list.wait_all();
@@ -721,27 +784,56 @@ class series_multiplier<Series,detail::ps_series_multiplier_enabler<Series>> : p
 			}
 		}
 	public:
-		/// Inherit base constructors.
-		using base::base;
+		/// Constructor.
+		/**
+		 * The constructor will call the base constructor. If the key type is piranha::real_trigonometric_kronecker_monomial,
+		 * it will then check if the multipliers of the result of the multiplication are guaranteed to be within the limits
+		 * of the Kronecker codification (see piranha::real_trigonometric_kronecker_monomial::check_multiply_packed()).
+		 *
+		 * @param[in] s1 first series operand.
+		 * @param[in] s2 second series operand.
+		 *
+		 * @throws unspecified any exception thrown by:
+		 * - the base constructor,
+		 * - the unpacking of the keys,
+		 * - memory errors in standard containers.
+		 */
+		explicit series_multiplier(const Series &s1, const Series &s2):base(s1,s2),m_packed(false)
+		{
+			if (unlikely(this->m_v1.empty() || this->m_v2.empty())) {
+				return;
+			}
+			check_bounds();
+		}
 		/// Call operator.
 		/**
 		 * \note
 		 * This operator is enabled only if the coefficient and key types of \p Series satisfy
 		 * piranha::key_is_multipliable.
 		 *
-		 * The call operator will use base_series_multiplier::plain_multiplication().
+		 * If the bounds check performed in the constructor was successful, the term-by-term multiplications will be performed via
+		 * piranha::real_trigonometric_kronecker_monomial::multiply_packed(), operating directly on the codified values of the keys.
+		 * In both cases, the call operator will use base_series_multiplier::plain_multiplication().
 		 *
 		 * @return the result of the multiplication.
 		 *
-		 * @throws unspecified any exception thrown by base_series_multiplier::plain_multiplication().
+		 * @throws unspecified any exception thrown by:
+		 * - base_series_multiplier::plain_multiplication(),
+		 * - piranha::real_trigonometric_kronecker_monomial::multiply_packed(),
+		 * - the public interface of piranha::hash_set,
+		 * - thread_pool::enqueue(),
+		 * - future_list::push_back(),
+		 * - arithmetic operations on the coefficient type.
 		 */
 		template <typename T = Series, call_enabler<T> = 0>
 		Series operator()() const
 		{
-			auto retval(this->plain_multiplication());
+			auto retval(m_packed ? packed_multiplication() : this->plain_multiplication());
 			divide_by_two(retval);
 			return retval;
 		}
+	private:
+		bool m_packed;
 };
 
 }
@@ -22,19 +22,26 @@
 #define PIRANHA_POLYNOMIAL_HPP
 
 #include <algorithm>
+#include <atomic>
 #include <boost/numeric/conversion/cast.hpp>
+#include <chrono>
 #include <cmath> // For std::ceil.
 #include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <functional>
 #include <future>
+#include <gmp.h>
 #include <initializer_list>
 #include <iterator>
 #include <limits>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <numeric>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -46,6 +53,8 @@
 #include "detail/atomic_utils.hpp"
 #include "detail/cf_mult_impl.hpp"
 #include "detail/divisor_series_fwd.hpp"
+#include "detail/integer_accumulator.hpp"
+#include "detail/multi_modular.hpp"
 #include "detail/parallel_vector_transform.hpp"
 #include "detail/poisson_series_fwd.hpp"
 #include "detail/polynomial_fwd.hpp"
@@ -805,6 +814,44 @@ class has_get_auto_truncate_degree: sfinae_types
 template <typename S>
 const bool has_get_auto_truncate_degree<S>::value;
 
+// Deque of zone indices used by the work-stealing scheduler in the Kronecker multiplication. The owner
+// thread pops from the front, other threads steal from the back.
+template <typename T>
+struct zone_deque
+{
+	bool pop_front(T &out)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_zones.empty()) {
+			return false;
+		}
+		out = m_zones.front();
+		m_zones.pop_front();
+		return true;
+	}
+	bool pop_back(T &out)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_zones.empty()) {
+			return false;
+		}
+		out = m_zones.back();
+		m_zones.pop_back();
+		return true;
+	}
+	std::mutex	m_mutex;
+	std::deque<T>	m_zones;
+};
+
+// Per-thread statistics of the last multithreaded Kronecker multiplication of Series performed
+// by the calling thread.
+template <typename Series>
+inline std::vector<std::tuple<double,double,unsigned,unsigned>> &poly_mult_stats()
+{
+	static thread_local std::vector<std::tuple<double,double,unsigned,unsigned>> stats;
+	return stats;
+}
+
 // Global enabler for the polynomial multiplier.
 template <typename Series>
 using poly_multiplier_enabler = typename std::enable_if<std::is_base_of<detail::polynomial_tag,Series>::value>::type;
@@ -949,7 +996,7 @@ class series_multiplier<Series,detail::poly_multiplier_enabler<Series>>:
 			}
 		}
 		template <typename T = Series, typename std::enable_if<detail::is_kronecker_monomial<key_t<T>>::value,int>::type = 0>
-		void check_bounds() const
+		void check_bounds()
 		{
 			using value_type = typename key_t<Series>::value_type;
 			using ka = kronecker_array<value_type>;
@@ -1021,6 +1068,13 @@ class series_multiplier<Series,detail::poly_multiplier_enabler<Series>>:
 					piranha_throw(std::overflow_error,"Kronecker monomial components are out of bounds");
 				}
 			}
+			// Store the bounds of the operands, they will be used to establish the layout of the
+			// dense multiplication.
+			auto int_pair = [](const std::pair<value_type,value_type> &p) {
+				return std::make_pair(integer(p.first),integer(p.second));
+			};
+			std::transform(minmax_values1.begin(),minmax_values1.end(),std::back_inserter(m_minmax1),int_pair);
+			std::transform(minmax_values2.begin(),minmax_values2.end(),std::back_inserter(m_minmax2),int_pair);
 		}
 		// Implementation detail of the bound checking logic. This is common enough to be shared.
 		template <typename MmVec, typename Func>
@@ -1030,38 +1084,12 @@ class series_multiplier<Series,detail::poly_multiplier_enabler<Series>>:
 				thread_func(0u,&(this->m_v1),&minmax_values1);
 				thread_func(0u,&(this->m_v2),&minmax_values2);
 			} else {
-				// Series 1.
-				{
-				future_list<std::future<void>> ff_list;
-				try {
-					for (unsigned i = 0u; i < this->m_n_threads; ++i) {
-						ff_list.push_back(thread_pool::enqueue(i,thread_func,i,&(this->m_v1),&minmax_values1));
-					}
-					// First let's wait for everything to finish.
-					ff_list.wait_all();
-					// Then, let's handle the exceptions.
-					ff_list.get_all();
-				} catch (...) {
-					ff_list.wait_all();
-					throw;
-				}
-				}
-				// Series 2.
-				{
-				future_list<std::future<void>> ff_list;
-				try {
-					for (unsigned i = 0u; i < this->m_n_threads; ++i) {
-						ff_list.push_back(thread_pool::enqueue(i,thread_func,i,&(this->m_v2),&minmax_values2));
-					}
-					// First let's wait for everything to finish.
-					ff_list.wait_all();
-					// Then, let's handle the exceptions.
-					ff_list.get_all();
-				} catch (...) {
-					ff_list.wait_all();
-					throw;
-				}
-				}
+				thread_pool::parallel_invoke(this->m_n_threads,[&thread_func,&minmax_values1,this](unsigned i) {
+					thread_func(i,&(this->m_v1),&minmax_values1);
+				});
+				thread_pool::parallel_invoke(this->m_n_threads,[&thread_func,&minmax_values2,this](unsigned i) {
+					thread_func(i,&(this->m_v2),&minmax_values2);
+				});
 			}
 		}
 		// Enabler for the call operator.
@@ -1121,7 +1149,9 @@ class series_multiplier<Series,detail::poly_multiplier_enabler<Series>>:
 		 *
 		 * This method will perform the multiplication of the series operands passed to the constructor. Depending on
 		 * the key type of \p Series, the implementation will use either base_series_multiplier::plain_multiplication()
-		 * with base_series_multiplier::plain_multiplier or a different algorithm.
+		 * with base_series_multiplier::plain_multiplier or a different algorithm. If a polynomial truncation threshold is defined,
+		 * the multiplication of polynomials with Kronecker monomials will skip the term-by-term products exceeding the threshold
+		 * without resorting to truncated_multiplication().
 		 *
 		 * If a polynomial truncation threshold is defined and the degree type of the polynomial is a C++ integral type,
 		 * the integral arithmetic operations involved in the truncation logic will be checked for overflow.
@@ -1150,6 +1180,27 @@ class series_multiplier<Series,detail::poly_multiplier_enabler<Series>>:
 		{
 			return execute();
 		}
+		/// Estimate the size of the result of the multiplication.
+		/**
+		 * \note
+		 * This method is enabled only if the call operator is enabled.
+		 *
+		 * This method hides piranha::base_series_multiplier::estimate_result_size(). If a polynomial truncation threshold is defined,
+		 * the estimate will skip the term-by-term products exceeding the threshold.
+		 *
+		 * @return the estimated size of the result of the multiplication.
+		 *
+		 * @throws unspecified any exception thrown by:
+		 * - piranha::base_series_multiplier::estimate_final_series_size(),
+		 * - polynomial::get_auto_truncate_degree(),
+		 * - the computation of the degrees of the terms,
+		 * - memory errors in standard containers.
+		 */
+		template <typename T = Series, call_enabler<T> = 0>
+		typename base::bucket_size_type estimate_result_size() const
+		{
+			return estimate_result_size_impl();
+		}
 		/// Truncated multiplication.
 		/**
 		 * \note
@@ -1182,41 +1233,8 @@ class series_multiplier<Series,detail::poly_multiplier_enabler<Series>>:
 			// NOTE: a possible optimisation here is the following: if the sum degrees of the arguments is less than
 			// or equal to the max truncation degree, just do the normal multiplication - which can also then take advantage
 			// of faster Kronecker multiplication, if the series are suitable.
-			using term_type = typename Series::term_type;
-			// NOTE: degree type is the same in total and partial.
-			using degree_type = decltype(detail::ps_get_degree(term_type{},this->m_ss));
 			using size_type = typename base::size_type;
-			namespace sph = std::placeholders;
-			static_assert(std::is_same<T,degree_type>::value,"Invalid degree type");
-			static_assert(detail::has_get_auto_truncate_degree<Series>::value,"Invalid series type");
-			// First let's create two vectors with the degrees of the terms in the two series.
-			using d_size_type = typename std::vector<degree_type>::size_type;
-			std::vector<degree_type> v_d1(safe_cast<d_size_type>(this->m_v1.size())), v_d2(safe_cast<d_size_type>(this->m_v2.size()));
-			detail::parallel_vector_transform(this->m_n_threads,this->m_v1,v_d1,std::bind(term_degree_getter{},sph::_1,
-				std::cref(this->m_ss),std::cref(args)...));
-			detail::parallel_vector_transform(this->m_n_threads,this->m_v2,v_d2,std::bind(term_degree_getter{},sph::_1,
-				std::cref(this->m_ss),std::cref(args)...));
-			// Next we need to order the terms in the second series, and also the corresponding degree vector.
-			// First we create a vector of indices and we fill it.
-			std::vector<size_type> idx_vector(safe_cast<typename std::vector<size_type>::size_type>(this->m_v2.size()));
-			std::iota(idx_vector.begin(),idx_vector.end(),size_type(0u));
-			// Second, we sort the vector of indices according to the degrees in the second series.
-			std::stable_sort(idx_vector.begin(),idx_vector.end(),[&v_d2](const size_type &i1, const size_type &i2) {
-				return v_d2[static_cast<d_size_type>(i1)] < v_d2[static_cast<d_size_type>(i2)];
-			});
-			// Finally, we apply the permutation to v_d2 and m_v2.
-			decltype(this->m_v2) v2_copy(this->m_v2.size());
-			decltype(v_d2) v_d2_copy(v_d2.size());
-			std::transform(idx_vector.begin(),idx_vector.end(),v2_copy.begin(),[this](const size_type &i) {
-				return this->m_v2[i];
-			});
-			std::transform(idx_vector.begin(),idx_vector.end(),v_d2_copy.begin(),[&v_d2](const size_type &i) {
-				return v_d2[static_cast<d_size_type>(i)];
-			});
-			this->m_v2 = std::move(v2_copy);
-			v_d2 = std::move(v_d2_copy);
-			// Now get the skip limits and we build the limits functor.
-			const auto sl = get_skip_limits(v_d1,v_d2,max_degree);
+			const auto sl = degree_sorted_skip_limits(max_degree,args...);
 			auto lf = [&sl](const size_type &idx1) {
 				return sl[static_cast<typename std::vector<size_type>::size_type>(idx1)];
 			};
@@ -1300,6 +1318,26 @@ class series_multiplier<Series,detail::poly_multiplier_enabler<Series>>:
 			piranha_assert(retval_checker());
 			return retval;
 		}
+		/// Thread statistics.
+		/**
+		 * The multithreaded multiplication of polynomials with Kronecker monomials distributes the work among the threads
+		 * in zones of the output table. Each thread consumes first the zones initially assigned to it, and then it will steal
+		 * zones from the other threads. This method will return a vector of per-thread statistics for the last
+		 * multithreaded Kronecker multiplication of \p Series that was performed by the calling thread. Each element
+		 * of the vector is a tuple containing:
+		 * - the time (in seconds) spent by the thread computing term-by-term multiplications,
+		 * - the time (in seconds) the thread was idle while other threads were still working,
+		 * - the number of zones consumed by the thread,
+		 * - the number of zones stolen by the thread from other threads.
+		 *
+		 * @return a vector of thread statistics for the last multithreaded Kronecker multiplication.
+		 *
+		 * @throws unspecified any exception thrown by memory allocation errors in standard containers.
+		 */
+		static std::vector<std::tuple<double,double,unsigned,unsigned>> get_thread_stats()
+		{
+			return detail::poly_mult_stats<Series>();
+		}
 	private:
 		// NOTE: wrapper to multadd that treats specially rational coefficients. We need to decide in the future
 		// if this stays here or if it is better to generalise it.
@@ -1339,6 +1377,79 @@ class series_multiplier<Series,detail::poly_multiplier_enabler<Series>>:
 			const symbol_set::positions pos(this->m_ss,symbol_set(std::get<2u>(t).begin(),std::get<2u>(t).end()));
 			return truncated_multiplication(std::get<1u>(t),std::get<2u>(t),pos);
 		}
+		// Implementation of estimate_result_size().
+		// Case 1: no auto truncation available.
+		template <typename T = Series, typename std::enable_if<!detail::has_get_auto_truncate_degree<T>::value,int>::type = 0>
+		typename base::bucket_size_type estimate_result_size_impl() const
+		{
+			return this->template estimate_final_series_size<1u,typename base::template plain_multiplier<false>>();
+		}
+		// Case 2: auto-truncation available.
+		template <typename T = Series, typename std::enable_if<detail::has_get_auto_truncate_degree<T>::value,int>::type = 0>
+		typename base::bucket_size_type estimate_result_size_impl() const
+		{
+			const auto t = T::get_auto_truncate_degree();
+			if (std::get<0u>(t) == 0) {
+				return this->template estimate_final_series_size<1u,typename base::template plain_multiplier<false>>();
+			}
+			if (std::get<0u>(t) == 1) {
+				return truncated_size_estimate(std::get<1u>(t));
+			}
+			piranha_assert(std::get<0u>(t) == 2);
+			const symbol_set::positions pos(this->m_ss,symbol_set(std::get<2u>(t).begin(),std::get<2u>(t).end()));
+			return truncated_size_estimate(std::get<1u>(t),std::get<2u>(t),pos);
+		}
+		template <typename T, typename ... Args>
+		typename base::bucket_size_type truncated_size_estimate(const T &max_degree, const Args & ... args) const
+		{
+			using size_type = typename base::size_type;
+			const auto sl = degree_sorted_skip_limits(max_degree,args...);
+			auto lf = [&sl](const size_type &idx1) {
+				return sl[static_cast<typename std::vector<size_type>::size_type>(idx1)];
+			};
+			return this->template estimate_final_series_size<1u,typename base::template plain_multiplier<false>>(lf);
+		}
+		// Sort the terms of the second series by ascending degree, and return the skip limits for the truncated
+		// multiplication (see get_skip_limits()).
+		template <typename T, typename ... Args>
+		std::vector<typename base::size_type> degree_sorted_skip_limits(const T &max_degree, const Args & ... args) const
+		{
+			using term_type = typename Series::term_type;
+			// NOTE: degree type is the same in total and partial.
+			using degree_type = decltype(detail::ps_get_degree(term_type{},this->m_ss));
+			using size_type = typename base::size_type;
+			namespace sph = std::placeholders;
+			static_assert(std::is_same<T,degree_type>::value,"Invalid degree type");
+			static_assert(detail::has_get_auto_truncate_degree<Series>::value,"Invalid series type");
+			// First let's create two vectors with the degrees of the terms in the two series.
+			using d_size_type = typename std::vector<degree_type>::size_type;
+			std::vector<degree_type> v_d1(safe_cast<d_size_type>(this->m_v1.size())), v_d2(safe_cast<d_size_type>(this->m_v2.size()));
+			detail::parallel_vector_transform(this->m_n_threads,this->m_v1,v_d1,std::bind(term_degree_getter{},sph::_1,
+				std::cref(this->m_ss),std::cref(args)...));
+			detail::parallel_vector_transform(this->m_n_threads,this->m_v2,v_d2,std::bind(term_degree_getter{},sph::_1,
+				std::cref(this->m_ss),std::cref(args)...));
+			// Next we need to order the terms in the second series, and also the corresponding degree vector.
+			// First we create a vector of indices and we fill it.
+			std::vector<size_type> idx_vector(safe_cast<typename std::vector<size_type>::size_type>(this->m_v2.size()));
+			std::iota(idx_vector.begin(),idx_vector.end(),size_type(0u));
+			// Second, we sort the vector of indices according to the degrees in the second series.
+			std::stable_sort(idx_vector.begin(),idx_vector.end(),[&v_d2](const size_type &i1, const size_type &i2) {
+				return v_d2[static_cast<d_size_type>(i1)] < v_d2[static_cast<d_size_type>(i2)];
+			});
+			// Finally, we apply the permutation to v_d2 and m_v2.
+			decltype(this->m_v2) v2_copy(this->m_v2.size());
+			decltype(v_d2) v_d2_copy(v_d2.size());
+			std::transform(idx_vector.begin(),idx_vector.end(),v2_copy.begin(),[this](const size_type &i) {
+				return this->m_v2[i];
+			});
+			std::transform(idx_vector.begin(),idx_vector.end(),v_d2_copy.begin(),[&v_d2](const size_type &i) {
+				return v_d2[static_cast<d_size_type>(i)];
+			});
+			this->m_v2 = std::move(v2_copy);
+			v_d2 = std::move(v_d2_copy);
+			// Now get the skip limits.
+			return get_skip_limits(v_d1,v_d2,max_degree);
+		}
 		// NOTE: the existence of these functors is because GCC 4.8 has troubles capturing variadic arguments in lambdas
 		// in truncated_multiplication, and we need to use std::bind instead. Once we switch to 4.9, we can revert
 		// to lambdas and drop the <functional> header.
@@ -1367,25 +1478,98 @@ class series_multiplier<Series,detail::poly_multiplier_enabler<Series>>:
 		{
 			return plain_multiplication_wrapper();
 		}
-		// Checking for active truncation.
-		template <typename T = Series, typename std::enable_if<detail::has_get_auto_truncate_degree<T>::value,int>::type = 0>
-		bool check_truncation() const
+		// Setup function for the truncation of the sparse Kronecker multiplication. It is called after the
+		// terms of the operands have been sorted, and it fills the two vectors of degree ranks described in
+		// kronecker_degree_ranks(). An empty function means that no truncation is active.
+		using rank_setup_type = std::function<void(std::vector<typename base::size_type> &,
+			std::vector<typename base::size_type> &)>;
+		// Case 2: Kronecker mult, do the special multiplication, possibly truncated.
+		template <typename T = Series, typename std::enable_if<detail::is_kronecker_monomial<typename T::term_type::key_type>::value,int>::type = 0>
+		Series execute() const
 		{
-			const auto t = T::get_auto_truncate_degree();
-			return std::get<0u>(t) != 0;
+			return kronecker_truncation_wrapper();
 		}
+		// Wrapper for the Kronecker multiplication routine.
+		// Case 1: no auto truncation available.
 		template <typename T = Series, typename std::enable_if<!detail::has_get_auto_truncate_degree<T>::value,int>::type = 0>
-		bool check_truncation() const
+		Series kronecker_truncation_wrapper() const
 		{
-			return false;
+			return kronecker_multiplication(this->template estimate_final_series_size<1u,typename base::template plain_multiplier<false>>(),
+				rank_setup_type{});
 		}
-		// Case 2: Kronecker mult, do the special multiplication unless a truncation is active. In that case, run the plain mult.
-		template <typename T = Series, typename std::enable_if<detail::is_kronecker_monomial<typename T::term_type::key_type>::value,int>::type = 0>
-		Series execute() const
+		// Case 2: auto-truncation available. Check if auto truncation is active.
+		template <typename T = Series, typename std::enable_if<detail::has_get_auto_truncate_degree<T>::value,int>::type = 0>
+		Series kronecker_truncation_wrapper() const
 		{
-			if (check_truncation()) {
-				return plain_multiplication_wrapper();
+			const auto t = T::get_auto_truncate_degree();
+			if (std::get<0u>(t) == 0) {
+				return kronecker_multiplication(this->template estimate_final_series_size<1u,
+					typename base::template plain_multiplier<false>>(),rank_setup_type{});
+			}
+			if (std::get<0u>(t) == 1) {
+				return truncated_kronecker_multiplication(std::get<1u>(t));
 			}
+			piranha_assert(std::get<0u>(t) == 2);
+			const symbol_set::positions pos(this->m_ss,symbol_set(std::get<2u>(t).begin(),std::get<2u>(t).end()));
+			return truncated_kronecker_multiplication(std::get<1u>(t),std::get<2u>(t),pos);
+		}
+		// Truncated Kronecker multiplication. The size of the result is estimated taking into account the truncation,
+		// and the truncation is then enforced in the sparse multiplication via the degree ranks of the terms.
+		template <typename T, typename ... Args>
+		Series truncated_kronecker_multiplication(const T &max_degree, const Args & ... args) const
+		{
+			using size_type = typename base::size_type;
+			namespace sph = std::placeholders;
+			// NOTE: this sorts the second series by degree, but the order of the terms is irrelevant
+			// for the Kronecker multiplication.
+			const auto sl = degree_sorted_skip_limits(max_degree,args...);
+			auto lf = [&sl](const size_type &idx1) {
+				return sl[static_cast<typename std::vector<size_type>::size_type>(idx1)];
+			};
+			const auto estimate = this->template estimate_final_series_size<1u,typename base::template plain_multiplier<false>>(lf);
+			return kronecker_multiplication(estimate,std::bind(&series_multiplier::template kronecker_degree_ranks<T,Args...>,
+				this,sph::_1,sph::_2,std::cref(max_degree),std::cref(args)...));
+		}
+		// Compute the degree ranks for the truncated sparse Kronecker multiplication. Given the sorted
+		// vector of the distinct degrees of the terms in the second series:
+		// - r2[j] is the index in such vector of the degree of the j-th term in the second series,
+		// - r1[i] is the number of elements in such vector which are not greater than max_degree minus the degree
+		//   of the i-th term in the first series.
+		// The product of the i-th term of the first series by the j-th term of the second series is then
+		// within the truncation limit if and only if r2[j] < r1[i].
+		template <typename T, typename ... Args>
+		void kronecker_degree_ranks(std::vector<typename base::size_type> &r1, std::vector<typename base::size_type> &r2,
+			const T &max_degree, const Args & ... args) const
+		{
+			using term_type = typename Series::term_type;
+			using degree_type = decltype(detail::ps_get_degree(term_type{},this->m_ss));
+			using size_type = typename base::size_type;
+			using d_size_type = typename std::vector<degree_type>::size_type;
+			namespace sph = std::placeholders;
+			static_assert(std::is_same<T,degree_type>::value,"Invalid degree type");
+			std::vector<degree_type> v_d1(safe_cast<d_size_type>(this->m_v1.size())), v_d2(safe_cast<d_size_type>(this->m_v2.size()));
+			detail::parallel_vector_transform(this->m_n_threads,this->m_v1,v_d1,std::bind(term_degree_getter{},sph::_1,
+				std::cref(this->m_ss),std::cref(args)...));
+			detail::parallel_vector_transform(this->m_n_threads,this->m_v2,v_d2,std::bind(term_degree_getter{},sph::_1,
+				std::cref(this->m_ss),std::cref(args)...));
+			// The distinct degrees in the second series.
+			std::vector<degree_type> ud(v_d2);
+			std::sort(ud.begin(),ud.end());
+			ud.erase(std::unique(ud.begin(),ud.end()),ud.end());
+			r2.resize(safe_cast<typename std::vector<size_type>::size_type>(v_d2.size()));
+			std::transform(v_d2.begin(),v_d2.end(),r2.begin(),[&ud](const degree_type &d) {
+				return static_cast<size_type>(std::lower_bound(ud.begin(),ud.end(),d) - ud.begin());
+			});
+			r1.resize(safe_cast<typename std::vector<size_type>::size_type>(v_d1.size()));
+			// NOTE: as in get_skip_limits(), use max_degree - d1 instead of d1 + d2 to avoid spurious overflows.
+			std::transform(v_d1.begin(),v_d1.end(),r1.begin(),[&ud,&max_degree](const degree_type &d) {
+				return static_cast<size_type>(std::upper_bound(ud.begin(),ud.end(),degree_sub(max_degree,d)) - ud.begin());
+			});
+		}
+		// Kronecker multiplication, given the estimate of the size of the result. If rs is not empty, the
+		// multiplication is truncated (see rank_setup_type).
+		Series kronecker_multiplication(typename base::bucket_size_type estimate, const rank_setup_type &rs) const
+		{
 			// Setup the return value.
 			Series retval;
 			retval.set_symbol_set(this->m_ss);
@@ -1400,20 +1584,620 @@ class series_multiplier<Series,detail::poly_multiplier_enabler<Series>>:
 			// NOTE: it is important here that we use the same n_threads for multiplication and memset as
 			// we tie together pinned threads with potentially different NUMA regions.
 			const unsigned n_threads_rehash = tuning::get_parallel_memory_set() ? this->m_n_threads : 1u;
-			// Use the plain functor in normal mode for the estimation.
-			const auto estimate = this->template estimate_final_series_size<1u,typename base::template plain_multiplier<false>>();
+			// Refine the upper bound estimate via the exponent ranges.
+			this->limit_size_estimate(estimate,exponent_range_size());
+			const auto n_buckets = boost::numeric_cast<typename Series::size_type>(std::ceil(static_cast<double>(estimate) /
+				retval._container().max_load_factor()));
+			// Multi-modular arithmetic for large integer coefficients, if selected.
+			if (multi_modular_kronecker_multiplication(retval,n_buckets,n_threads_rehash,rs)) {
+				return retval;
+			}
+			// If the result is dense enough in the space of exponents, accumulate into a flat array.
+			// NOTE: the dense multiplication does not support truncation.
+			std::vector<typename base::size_type> weights;
+			if (!rs && dense_layout(weights,estimate)) {
+				dense_kronecker_multiplication(retval,weights,n_threads_rehash);
+				return retval;
+			}
+			// Integer coefficients can be accumulated in fixed-width accumulators.
+			if (accumulated_kronecker_multiplication(retval,n_buckets,n_threads_rehash,rs)) {
+				return retval;
+			}
 			// NOTE: if something goes wrong here, no big deal as retval is still empty.
-			retval._container().rehash(boost::numeric_cast<typename Series::size_type>(std::ceil(static_cast<double>(estimate) /
-				retval._container().max_load_factor())),n_threads_rehash);
+			retval._container().rehash(n_buckets,n_threads_rehash);
 			piranha_assert(retval._container().bucket_count());
-			sparse_kronecker_multiplication(retval);
+			sparse_kronecker_multiplication(retval,rs);
 			return retval;
 		}
-		void sparse_kronecker_multiplication(Series &retval) const
+		// Number of distinct monomials in the box spanned by the exponents of the product, as computed from the
+		// bounds established by check_bounds(). This is an upper bound on the number of terms in the result.
+		// If the bounds are not available, the product of the sizes of the operands is returned.
+		integer exponent_range_size() const
+		{
+			if (m_minmax1.empty() || m_minmax1.size() != this->m_ss.size()) {
+				return integer(this->m_v1.size()) * this->m_v2.size();
+			}
+			piranha_assert(m_minmax1.size() == m_minmax2.size());
+			integer retval(1);
+			for (decltype(m_minmax1.size()) i = 0u; i < m_minmax1.size(); ++i) {
+				retval *= (m_minmax1[i].second + m_minmax2[i].second) - (m_minmax1[i].first + m_minmax2[i].first) + 1;
+			}
+			return retval;
+		}
+		// Establish the layout of the dense multiplication. The product of two terms is mapped to the index
+		// d1 + d2 in a flat array, where d1 and d2 are the mixed-radix codifications of the exponents of the
+		// terms, offset by the minimum exponents in each operand (as computed by check_bounds()). If the resulting array
+		// is not too sparse with respect to the estimated size of the result, the radices of the codification are
+		// written into weights and true is returned. Otherwise, false is returned.
+		template <typename T = Series, typename std::enable_if<!is_series<cf_t<T>>::value,int>::type = 0>
+		bool dense_layout(std::vector<typename base::size_type> &weights, const typename base::bucket_size_type &estimate) const
+		{
+			using size_type = typename base::size_type;
+			// NOTE: the bounds are not available if the constructor returned early.
+			if (m_minmax1.empty() || m_minmax1.size() != this->m_ss.size()) {
+				return false;
+			}
+			piranha_assert(m_minmax1.size() == m_minmax2.size());
+			// NOTE: fill ratio tuning parameter. The dense array is allowed to be at most this many times
+			// larger than the estimated number of terms in the result. Each slot of the array stores just a
+			// coefficient, whereas the hash set stores a term per bucket at a max load factor of 1, so the memory
+			// usage of the two methods is comparable in the worst case.
+			const unsigned max_fill_ratio = 4u;
+			std::vector<integer> tmp;
+			integer size(1);
+			for (decltype(m_minmax1.size()) i = 0u; i < m_minmax1.size(); ++i) {
+				tmp.push_back(size);
+				size *= (m_minmax1[i].second + m_minmax2[i].second) - (m_minmax1[i].first + m_minmax2[i].first) + 1;
+				if (size > integer(estimate) * max_fill_ratio) {
+					return false;
+				}
+			}
+			try {
+				// Make sure the index of the last slot is representable.
+				(void)static_cast<size_type>(size);
+				std::transform(tmp.begin(),tmp.end(),std::back_inserter(weights),[](const integer &n) {
+					return static_cast<size_type>(n);
+				});
+			} catch (const std::overflow_error &) {
+				weights.clear();
+				return false;
+			}
+			// The last weight is the total size of the array.
+			weights.push_back(static_cast<size_type>(size));
+			return true;
+		}
+		template <typename T = Series, typename std::enable_if<is_series<cf_t<T>>::value,int>::type = 0>
+		bool dense_layout(std::vector<typename base::size_type> &, const typename base::bucket_size_type &) const
+		{
+			// NOTE: coefficient series are not suitable for accumulation in a flat array.
+			return false;
+		}
+		// Dense multiplication: the terms are accumulated into a flat array of coefficients, split into
+		// disjoint ranges per thread, and the result is built into retval only at the end.
+		void dense_kronecker_multiplication(Series &retval, const std::vector<typename base::size_type> &weights,
+			unsigned n_threads_rehash) const
+		{
+			using size_type = typename base::size_type;
+			using bucket_size_type = typename base::bucket_size_type;
+			using term_type = typename Series::term_type;
+			using cf_type = typename term_type::cf_type;
+			using key_type = typename term_type::key_type;
+			using value_type = typename key_type::value_type;
+			using v_type = typename key_type::v_type;
+			using d_pair = std::pair<size_type,term_type const *>;
+			using d_vector = std::vector<cf_type>;
+			using t_size_type = typename std::vector<d_vector>::size_type;
+			piranha_assert(weights.size() == this->m_ss.size() + 1u);
+			const size_type n_args = static_cast<size_type>(this->m_ss.size());
+			// The total size of the dense array.
+			const size_type d_size = weights.back();
+			piranha_assert(d_size > 0u);
+			// Minimum exponents in the two operands and in the result.
+			std::vector<value_type> lo1, lo2, lo;
+			for (size_type i = 0u; i < n_args; ++i) {
+				lo1.push_back(static_cast<value_type>(m_minmax1[i].first));
+				lo2.push_back(static_cast<value_type>(m_minmax2[i].first));
+				lo.push_back(static_cast<value_type>(m_minmax1[i].first + m_minmax2[i].first));
+			}
+			// Compute the dense offsets of the terms in the two operands.
+			auto offset_getter = [this,&weights,n_args](term_type const *p, const std::vector<value_type> &l) {
+				const auto tmp = p->m_key.unpack(this->m_ss);
+				size_type retval = 0u;
+				for (size_type i = 0u; i < n_args; ++i) {
+					retval = static_cast<size_type>(retval + static_cast<size_type>(tmp[static_cast<typename v_type::size_type>(i)] -
+						l[i]) * weights[i]);
+				}
+				piranha_assert(retval < weights.back());
+				return std::make_pair(retval,p);
+			};
+			std::vector<d_pair> d1(this->m_v1.size()), d2(this->m_v2.size());
+			detail::parallel_vector_transform(this->m_n_threads,this->m_v1,d1,[&offset_getter,&lo1](term_type const *p) {
+				return offset_getter(p,lo1);
+			});
+			detail::parallel_vector_transform(this->m_n_threads,this->m_v2,d2,[&offset_getter,&lo2](term_type const *p) {
+				return offset_getter(p,lo2);
+			});
+			auto d_cmp = [](const d_pair &p1, const d_pair &p2) {
+				return p1.first < p2.first;
+			};
+			std::stable_sort(d1.begin(),d1.end(),d_cmp);
+			std::stable_sort(d2.begin(),d2.end(),d_cmp);
+			// The dense array, one range per thread.
+			const unsigned n_threads = this->m_n_threads;
+			std::vector<d_vector> slices(safe_cast<t_size_type>(n_threads));
+			std::vector<bucket_size_type> counts(safe_cast<typename std::vector<bucket_size_type>::size_type>(n_threads));
+			const size_type spt = static_cast<size_type>(d_size / n_threads);
+			auto slice_start = [spt](unsigned t_idx) {
+				return static_cast<size_type>(spt * t_idx);
+			};
+			auto slice_end = [spt,n_threads,d_size](unsigned t_idx) {
+				return (t_idx == n_threads - 1u) ? d_size : static_cast<size_type>(spt * (t_idx + 1u));
+			};
+			// Accumulate all the term-by-term products falling in the range of the thread.
+			auto accumulator = [&slices,&counts,&d1,&d2,&d_cmp,&slice_start,&slice_end](const unsigned &t_idx) {
+				const size_type a = slice_start(t_idx), b = slice_end(t_idx);
+				// NOTE: the slice is value-initialised by the thread that will write into it.
+				auto &slice = slices[static_cast<t_size_type>(t_idx)];
+				slice.resize(static_cast<typename d_vector::size_type>(b - a));
+				for (const auto &p1: d1) {
+					// d1 is sorted, no other term will write into this range.
+					if (p1.first >= b) {
+						break;
+					}
+					// Locate the terms in the second series whose products end up in [a,b[.
+					auto it2 = std::lower_bound(d2.begin(),d2.end(),d_pair(static_cast<size_type>(a > p1.first ? a - p1.first : 0u),nullptr),d_cmp);
+					const auto it2_f = std::lower_bound(it2,d2.end(),d_pair(static_cast<size_type>(b - p1.first),nullptr),d_cmp);
+					const auto &cf1 = p1.second->m_cf;
+					for (; it2 != it2_f; ++it2) {
+						fma_wrap(slice[static_cast<typename d_vector::size_type>(p1.first + it2->first - a)],cf1,it2->second->m_cf);
+					}
+				}
+				counts[static_cast<t_size_type>(t_idx)] = static_cast<bucket_size_type>(std::count_if(slice.begin(),slice.end(),
+					[](const cf_type &c) {return !math::is_zero(c);}));
+			};
+			// Move the non-zero coefficients of a range into retval.
+			auto &container = retval._container();
+			std::unique_ptr<detail::atomic_flag_array> sl_array;
+			auto inserter = [&slices,&slice_start,&container,&sl_array,&weights,&lo,n_args](const unsigned &t_idx) {
+				auto &slice = slices[static_cast<t_size_type>(t_idx)];
+				const size_type a = slice_start(t_idx);
+				v_type tmp_v(static_cast<typename v_type::size_type>(n_args),value_type(0));
+				for (typename d_vector::size_type k = 0u; k < slice.size(); ++k) {
+					if (math::is_zero(slice[k])) {
+						continue;
+					}
+					// Decode the dense index into the exponents of the result.
+					size_type idx = static_cast<size_type>(a + k);
+					for (size_type i = n_args; i > 0u; --i) {
+						tmp_v[static_cast<typename v_type::size_type>(i - 1u)] = static_cast<value_type>(lo[i - 1u] +
+							static_cast<value_type>(idx / weights[i - 1u]));
+						idx = static_cast<size_type>(idx % weights[i - 1u]);
+					}
+					term_type tmp_term(std::move(slice[k]),key_type(tmp_v.begin(),tmp_v.end()));
+					const auto bucket_idx = container._bucket(tmp_term);
+					if (sl_array) {
+						detail::atomic_lock_guard alg((*sl_array)[static_cast<std::size_t>(bucket_idx)]);
+						container._unique_insert(std::move(tmp_term),bucket_idx);
+					} else {
+						container._unique_insert(std::move(tmp_term),bucket_idx);
+					}
+				}
+				// Free the memory as soon as possible.
+				d_vector().swap(slice);
+			};
+			// Run f in all threads.
+			auto run = [n_threads](const std::function<void(const unsigned &)> &f) {
+				if (n_threads == 1u) {
+					f(0u);
+					return;
+				}
+				future_list<std::future<void>> ff_list;
+				try {
+					for (unsigned i = 0u; i < n_threads; ++i) {
+						ff_list.push_back(thread_pool::enqueue_task(i,f,i));
+					}
+					// First let's wait for everything to finish.
+					ff_list.wait_all();
+					// Then, let's handle the exceptions.
+					ff_list.get_all();
+				} catch (...) {
+					ff_list.wait_all();
+					throw;
+				}
+			};
+			try {
+				run(accumulator);
+				const integer n_terms = std::accumulate(counts.begin(),counts.end(),integer(0));
+				if (n_terms.sign() == 0) {
+					return;
+				}
+				container.rehash(boost::numeric_cast<bucket_size_type>(std::ceil(static_cast<double>(n_terms) /
+					container.max_load_factor())),n_threads_rehash);
+				if (n_threads > 1u) {
+					sl_array.reset(::new detail::atomic_flag_array(safe_cast<std::size_t>(container.bucket_count())));
+				}
+				run(inserter);
+				this->sanitise_series(retval,n_threads);
+				this->finalise_series(retval);
+			} catch (...) {
+				retval._container().clear();
+				throw;
+			}
+		}
+		// Coefficient arithmetic for the sparse Kronecker multiplication, in terms of the indices of
+		// the multiplied terms in the two operands. This is the default implementation, operating directly
+		// on the coefficients of the series.
+		struct plain_cf_ops
+		{
+			using size_type = typename base::size_type;
+			using cf_type = typename Series::term_type::cf_type;
+			using v_ptr = typename base::v_ptr;
+			explicit plain_cf_ops(const v_ptr &v1, const v_ptr &v2):m_v1(v1),m_v2(v2) {}
+			// Called after the terms of the operands have been sorted.
+			void prepare() {}
+			void mult(cf_type &out, const size_type &i, const size_type &j) const
+			{
+				detail::cf_mult_impl(out,m_v1[i]->m_cf,m_v2[j]->m_cf);
+			}
+			void fma(cf_type &out, const size_type &i, const size_type &j) const
+			{
+				// NOTE: here we need to decide if we want to give the same treatment to fmp as we did with cf_mult_impl.
+				// For the moment it is an implementation detail of this class.
+				fma_wrap(out,m_v1[i]->m_cf,m_v2[j]->m_cf);
+			}
+			const v_ptr &m_v1;
+			const v_ptr &m_v2;
+		};
+		void sparse_kronecker_multiplication(Series &retval, const rank_setup_type &rs) const
+		{
+			plain_cf_ops ops(this->m_v1,this->m_v2);
+			sparse_kronecker_impl(retval._container(),ops,rs);
+			try {
+				this->sanitise_series(retval,this->m_n_threads);
+				this->finalise_series(retval);
+			} catch (...) {
+				retval._container().clear();
+				throw;
+			}
+		}
+#if defined(PIRANHA_UINT128_T)
+		// Accumulation of integer coefficients whose absolute values fit in one limb. The products are accumulated
+		// in fixed-width accumulators without any overflow check, and they are normalised into mp_integer only
+		// once at the end of the multiplication. Each coefficient of the result is the sum of at most
+		// min(size1,size2) products, each one less than 2**128 in absolute value: the 3-limb accumulators
+		// cannot overflow as long as the smaller operand has less than 2**63 terms.
+		// Rational coefficients are supported as well: the base multiplier renormalises them to unitary denominators,
+		// so that the numerators can be accumulated directly. The denominators are then restored by finalise_series().
+		template <typename T>
+		using acc_enabler = typename std::enable_if<detail::is_mp_integer<cf_t<T>>::value ||
+			detail::is_mp_rational<cf_t<T>>::value,int>::type;
+		// The integral type of the accumulated values.
+		template <typename Cf, typename = void>
+		struct acc_int
+		{
+			using type = Cf;
+		};
+		template <typename Cf>
+		struct acc_int<Cf,typename std::enable_if<detail::is_mp_rational<Cf>::value>::type>
+		{
+			using type = typename std::decay<decltype(std::declval<const Cf &>().num())>::type;
+		};
+		// Term type used during the accumulation. It has the same hash as the terms of the series.
+		struct acc_term
+		{
+			using key_type = typename Series::term_type::key_type;
+			std::size_t hash() const
+			{
+				return std::hash<key_type>()(m_key);
+			}
+			bool operator==(const acc_term &other) const
+			{
+				return m_key == other.m_key;
+			}
+			mutable detail::integer_accumulator	m_cf;
+			key_type				m_key;
+		};
+		struct acc_cf_ops
+		{
+			using size_type = typename base::size_type;
+			using limb_t = detail::integer_accumulator::limb_t;
+			using v_ptr = typename base::v_ptr;
+			using c_vector = std::vector<std::pair<limb_t,bool>>;
+			explicit acc_cf_ops(const v_ptr &v1, const v_ptr &v2):m_v1(v1),m_v2(v2) {}
+			template <typename Cf, typename std::enable_if<detail::is_mp_integer<Cf>::value,int>::type = 0>
+			static bool split(const Cf &c, limb_t &abs, bool &neg)
+			{
+				return detail::integer_accumulator::split(c,abs,neg);
+			}
+			template <typename Cf, typename std::enable_if<detail::is_mp_rational<Cf>::value,int>::type = 0>
+			static bool split(const Cf &c, limb_t &abs, bool &neg)
+			{
+				return math::is_unitary(c.den()) && detail::integer_accumulator::split(c.num(),abs,neg);
+			}
+			// Check that all the coefficients in v fit in one limb.
+			static bool check(const v_ptr &v)
+			{
+				limb_t abs;
+				bool neg;
+				return std::all_of(v.begin(),v.end(),[&abs,&neg](typename v_ptr::value_type p) {
+					return split(p->m_cf,abs,neg);
+				});
+			}
+			// Cache the absolute values and signs of the coefficients, in the order of the sorted operands.
+			void prepare()
+			{
+				auto fill = [](const v_ptr &v, c_vector &c) {
+					c.resize(safe_cast<typename c_vector::size_type>(v.size()));
+					for (decltype(v.size()) i = 0u; i < v.size(); ++i) {
+						const bool status = split(v[i]->m_cf,c[i].first,c[i].second);
+						(void)status;
+						piranha_assert(status);
+					}
+				};
+				fill(m_v1,m_c1);
+				fill(m_v2,m_c2);
+			}
+			void mult(detail::integer_accumulator &out, const size_type &i, const size_type &j) const
+			{
+				out.set_product(m_c1[i].first,m_c1[i].second,m_c2[j].first,m_c2[j].second);
+			}
+			void fma(detail::integer_accumulator &out, const size_type &i, const size_type &j) const
+			{
+				out.multiply_accumulate(m_c1[i].first,m_c1[i].second,m_c2[j].first,m_c2[j].second);
+			}
+			const v_ptr	&m_v1;
+			const v_ptr	&m_v2;
+			c_vector	m_c1;
+			c_vector	m_c2;
+		};
+		// Returns false if the accumulation is not possible, in which case retval is left untouched.
+		template <typename T = Series, acc_enabler<T> = 0>
+		bool accumulated_kronecker_multiplication(Series &retval, const typename Series::size_type &n_buckets,
+			unsigned n_threads_rehash, const rank_setup_type &rs) const
 		{
 			using bucket_size_type = typename base::bucket_size_type;
+			using term_type = typename Series::term_type;
+			using cf_type = typename term_type::cf_type;
+			using int_type = typename acc_int<cf_type>::type;
+			using acc_container_type = hash_set<acc_term,detail::term_hasher<acc_term>>;
+			if (std::min(this->m_v1.size(),this->m_v2.size()) >= (std::uint_least64_t(1u) << 63u) ||
+				!acc_cf_ops::check(this->m_v1) || !acc_cf_ops::check(this->m_v2))
+			{
+				return false;
+			}
+			acc_cf_ops ops(this->m_v1,this->m_v2);
+			auto &container = retval._container();
+			const unsigned n_threads = this->m_n_threads;
+			// Normalise the accumulators of acc into retval. Using the same number of buckets, the terms
+			// keep their bucket indices, and each thread fills a separate range of buckets.
+			acc_container_type acc;
+			auto normaliser = [&acc,&container,n_threads](const unsigned &t_idx) {
+				const bucket_size_type bucket_count = acc.bucket_count(),
+					bpt = static_cast<bucket_size_type>(bucket_count / n_threads),
+					a = static_cast<bucket_size_type>(bpt * t_idx),
+					b = (t_idx == n_threads - 1u) ? bucket_count : static_cast<bucket_size_type>(bpt * (t_idx + 1u));
+				for (bucket_size_type i = a; i < b; ++i) {
+					for (const auto &t: acc._get_bucket_list(i)) {
+						if (t.m_cf.is_zero()) {
+							continue;
+						}
+						term_type tmp_term(cf_type(t.m_cf.template get<int_type>()),t.m_key);
+						// NOTE: with hash_set this is always i, but other containers might
+						// use a different mapping.
+						const auto bucket_idx = container._bucket(tmp_term);
+						container._unique_insert(std::move(tmp_term),bucket_idx);
+					}
+				}
+			};
+			try {
+				acc.rehash(n_buckets,n_threads_rehash);
+				sparse_kronecker_impl(acc,ops,rs);
+				container.rehash(acc.bucket_count(),n_threads_rehash);
+				piranha_assert(container.bucket_count() == acc.bucket_count());
+				if (n_threads == 1u) {
+					normaliser(0u);
+				} else {
+					thread_pool::parallel_invoke(n_threads,normaliser);
+				}
+				// NOTE: the number of elements in acc is not tracked during the multiplication,
+				// clear it before destruction.
+				acc.clear();
+				this->sanitise_series(retval,this->m_n_threads);
+				this->finalise_series(retval);
+			} catch (...) {
+				acc.clear();
+				container.clear();
+				throw;
+			}
+			return true;
+		}
+		template <typename T = Series, typename std::enable_if<!detail::is_mp_integer<cf_t<T>>::value &&
+			!detail::is_mp_rational<cf_t<T>>::value,int>::type = 0>
+#else
+		template <typename T = Series>
+#endif
+		bool accumulated_kronecker_multiplication(Series &, const typename Series::size_type &, unsigned, const rank_setup_type &) const
+		{
+			return false;
+		}
+#if defined(PIRANHA_UINT128_T)
+		// Multi-modular multiplication of mp_integer coefficients. The coefficients of the result are bounded in absolute value
+		// by min(size1,size2) * max|c1| * max|c2|, where c1 and c2 are the coefficients of the operands. The multiplication is
+		// performed modulo a number of word-sized primes whose product is large enough to represent any coefficient within
+		// this bound, and the coefficients are then reconstructed via the Chinese remainder theorem. Each term of the
+		// intermediate container stores the residues of its coefficient modulo all the primes.
+		template <typename T>
+		using mm_enabler = typename std::enable_if<detail::is_mp_integer<cf_t<T>>::value,int>::type;
+		using mm_residues = std::vector<std::uint_least64_t>;
+		struct mm_term
+		{
+			using key_type = typename Series::term_type::key_type;
+			std::size_t hash() const
+			{
+				return std::hash<key_type>()(m_key);
+			}
+			bool operator==(const mm_term &other) const
+			{
+				return m_key == other.m_key;
+			}
+			mutable mm_residues	m_cf;
+			key_type		m_key;
+		};
+		// The accumulated residues are in the form a*b/R (see detail::mm_prime), they are converted
+		// during the reconstruction.
+		template <typename Crt>
+		struct mm_cf_ops
+		{
 			using size_type = typename base::size_type;
+			using v_ptr = typename base::v_ptr;
+			using r_size_type = typename mm_residues::size_type;
+			explicit mm_cf_ops(const v_ptr &v1, const v_ptr &v2, const Crt &crt):
+				m_v1(v1),m_v2(v2),m_crt(crt),m_n(safe_cast<r_size_type>(crt.size())) {}
+			// Cache the residues of the coefficients, in the order of the sorted operands.
+			void prepare()
+			{
+				auto fill = [this](const v_ptr &v, mm_residues &r) {
+					r.resize(safe_cast<r_size_type>(integer(v.size()) * m_n));
+					for (decltype(v.size()) i = 0u; i < v.size(); ++i) {
+						for (r_size_type k = 0u; k < m_n; ++k) {
+							r[static_cast<r_size_type>(i * m_n + k)] = m_crt.prime(k).residue(v[i]->m_cf);
+						}
+					}
+				};
+				fill(m_v1,m_r1);
+				fill(m_v2,m_r2);
+			}
+			void mult(mm_residues &out, const size_type &i, const size_type &j) const
+			{
+				out.resize(m_n);
+				const auto r1 = &m_r1[static_cast<r_size_type>(i * m_n)], r2 = &m_r2[static_cast<r_size_type>(j * m_n)];
+				for (r_size_type k = 0u; k < m_n; ++k) {
+					out[k] = m_crt.prime(k).mul(r1[k],r2[k]);
+				}
+			}
+			void fma(mm_residues &out, const size_type &i, const size_type &j) const
+			{
+				piranha_assert(out.size() == m_n);
+				const auto r1 = &m_r1[static_cast<r_size_type>(i * m_n)], r2 = &m_r2[static_cast<r_size_type>(j * m_n)];
+				for (r_size_type k = 0u; k < m_n; ++k) {
+					const auto &p = m_crt.prime(k);
+					out[k] = p.add(out[k],p.mul(r1[k],r2[k]));
+				}
+			}
+			const v_ptr		&m_v1;
+			const v_ptr		&m_v2;
+			const Crt		&m_crt;
+			const r_size_type	m_n;
+			mm_residues		m_r1;
+			mm_residues		m_r2;
+		};
+		// Returns false if the multi-modular multiplication is not selected or not possible, in which case retval is left untouched.
+		template <typename T = Series, mm_enabler<T> = 0>
+		bool multi_modular_kronecker_multiplication(Series &retval, const typename Series::size_type &n_buckets,
+			unsigned n_threads_rehash, const rank_setup_type &rs) const
+		{
+			using bucket_size_type = typename base::bucket_size_type;
 			using term_type = typename Series::term_type;
+			using cf_type = typename term_type::cf_type;
+			using crt_type = detail::mm_crt<cf_type>;
+			using mm_container_type = hash_set<mm_term,detail::term_hasher<mm_term>>;
+			if (tuning::get_integer_multiplication() != integer_multiplication::multi_modular) {
+				return false;
+			}
+			// Bound on the number of bits of the coefficients of the result, including the sign bit.
+			auto max_bits = [](const typename base::v_ptr &v) {
+				std::size_t retval = 0u;
+				for (const auto &p: v) {
+					const auto m = p->m_cf.get_mpz_view();
+					const detail::mpz_struct_t *ptr = m;
+					retval = std::max<std::size_t>(retval,::mpz_sizeinbase(ptr,2));
+				}
+				return retval;
+			};
+			std::size_t n_bits = 1u;
+			for (auto n = std::min(this->m_v1.size(),this->m_v2.size()); n; n >>= 1u) {
+				++n_bits;
+			}
+			n_bits += max_bits(this->m_v1) + max_bits(this->m_v2);
+			// NOTE: the product M of the primes is greater than 2**(prime_bits * n_primes), and the coefficients
+			// need to be in the ]-M/2,M/2[ range.
+			const std::size_t n_primes = (n_bits + crt_type::prime_bits - 1u) / crt_type::prime_bits;
+			if (unlikely(n_primes > crt_type::max_primes)) {
+				return false;
+			}
+			const crt_type crt(n_primes);
+			mm_cf_ops<crt_type> ops(this->m_v1,this->m_v2,crt);
+			auto &container = retval._container();
+			const unsigned n_threads = this->m_n_threads;
+			// Reconstruct the coefficients from the residues into retval. Using the same number of buckets, the terms
+			// keep their bucket indices, and each thread fills a separate range of buckets.
+			mm_container_type mm;
+			auto reconstructor = [&mm,&container,&crt,n_threads](const unsigned &t_idx) {
+				const bucket_size_type bucket_count = mm.bucket_count(),
+					bpt = static_cast<bucket_size_type>(bucket_count / n_threads),
+					a = static_cast<bucket_size_type>(bpt * t_idx),
+					b = (t_idx == n_threads - 1u) ? bucket_count : static_cast<bucket_size_type>(bpt * (t_idx + 1u));
+				cf_type tmp_cf;
+				for (bucket_size_type i = a; i < b; ++i) {
+					for (const auto &t: mm._get_bucket_list(i)) {
+						bool zero = true;
+						for (std::size_t k = 0u; k < crt.size(); ++k) {
+							t.m_cf[k] = crt.prime(k).mul_r(t.m_cf[k]);
+							zero = zero && !t.m_cf[k];
+						}
+						if (zero) {
+							continue;
+						}
+						crt.reconstruct(tmp_cf,t.m_cf.data());
+						term_type tmp_term(std::move(tmp_cf),t.m_key);
+						// NOTE: with hash_set this is always i, but other containers might
+						// use a different mapping.
+						const auto bucket_idx = container._bucket(tmp_term);
+						container._unique_insert(std::move(tmp_term),bucket_idx);
+					}
+				}
+			};
+			try {
+				mm.rehash(n_buckets,n_threads_rehash);
+				sparse_kronecker_impl(mm,ops,rs);
+				container.rehash(mm.bucket_count(),n_threads_rehash);
+				piranha_assert(container.bucket_count() == mm.bucket_count());
+				if (n_threads == 1u) {
+					reconstructor(0u);
+				} else {
+					thread_pool::parallel_invoke(n_threads,reconstructor);
+				}
+				// NOTE: the number of elements in mm is not tracked during the multiplication,
+				// clear it before destruction.
+				mm.clear();
+				this->sanitise_series(retval,this->m_n_threads);
+				this->finalise_series(retval);
+			} catch (...) {
+				mm.clear();
+				container.clear();
+				throw;
+			}
+			return true;
+		}
+		template <typename T = Series, typename std::enable_if<!detail::is_mp_integer<cf_t<T>>::value,int>::type = 0>
+#else
+		template <typename T = Series>
+#endif
+		bool multi_modular_kronecker_multiplication(Series &, const typename Series::size_type &, unsigned, const rank_setup_type &) const
+		{
+			return false;
+		}
+		// Sparse Kronecker multiplication into container, whose terms have the same keys and hashes as
+		// the terms of the series. The coefficients are computed via cf_ops (see plain_cf_ops). If rs is not
+		// empty, the term-by-term products exceeding the truncation limit are skipped.
+		// In case of errors, container is cleared.
+		template <typename Container, typename CfOps>
+		void sparse_kronecker_impl(Container &container, CfOps &cf_ops, const rank_setup_type &rs) const
+		{
+			using bucket_size_type = typename base::bucket_size_type;
+			using size_type = typename base::size_type;
+			using term_type = typename Container::key_type;
+			using in_term_type = typename Series::term_type;
 			// Type representing multiplication tasks:
 			// - the current term index from s1,
 			// - the first term index in s2,
@@ -1424,19 +2208,51 @@ class series_multiplier<Series,detail::poly_multiplier_enabler<Series>>:
 			auto &v2 = this->m_v2;
 			const auto size1 = v1.size();
 			const auto size2 = v2.size();
-			auto &container = retval._container();
 			// A convenience functor to compute the destination bucket
 			// of a term into retval.
-			auto r_bucket = [&container](term_type const *p) {
+			auto r_bucket = [&container](in_term_type const *p) {
 				return container._bucket_from_hash(p->hash());
 			};
 			// Sort input terms according to bucket positions in retval.
-			auto term_cmp = [&r_bucket](term_type const *p1, term_type const *p2)
+			auto term_cmp = [&r_bucket](in_term_type const *p1, in_term_type const *p2)
 			{
 				return r_bucket(p1) < r_bucket(p2);
 			};
 			std::stable_sort(v1.begin(),v1.end(),term_cmp);
 			std::stable_sort(v2.begin(),v2.end(),term_cmp);
+			cf_ops.prepare();
+			// Task block size.
+			const size_type block_size = safe_cast<size_type>(tuning::get_multiplication_block_size());
+			// Truncation data: r1 and r2 are the degree ranks of the terms in the two series (see kronecker_degree_ranks()).
+			// The second series is divided in aligned blocks of block_size terms. Within each block, s2 contains
+			// the indices of the terms sorted by degree rank, and sr2 the corresponding ranks.
+			const bool trunc = static_cast<bool>(rs);
+			std::vector<size_type> r1, r2, s2, sr2;
+			if (trunc) {
+				rs(r1,r2);
+				piranha_assert(r1.size() == size1 && r2.size() == size2);
+				s2.resize(r2.size());
+				std::iota(s2.begin(),s2.end(),size_type(0u));
+				for (size_type bs = 0u; bs < size2; bs = static_cast<size_type>(bs + std::min<size_type>(block_size,
+					static_cast<size_type>(size2 - bs))))
+				{
+					const auto be = static_cast<size_type>(bs + std::min<size_type>(block_size,static_cast<size_type>(size2 - bs)));
+					std::stable_sort(s2.begin() + bs,s2.begin() + be,[&r2](const size_type &i, const size_type &j) {
+						return r2[i] < r2[j];
+					});
+				}
+				sr2.resize(r2.size());
+				std::transform(s2.begin(),s2.end(),sr2.begin(),[&r2](const size_type &i) {
+					return r2[i];
+				});
+			}
+			// Number of terms in the block of the second series containing the index i2 whose product by the i1-th
+			// term of the first series is within the truncation limit. These are the first terms of the block in s2.
+			auto block_prefix = [&r1,&sr2,block_size,size2] (const size_type &i1, const size_type &i2) -> size_type {
+				const auto bs = static_cast<size_type>(i2 - i2 % block_size),
+					be = static_cast<size_type>(bs + std::min<size_type>(block_size,static_cast<size_type>(size2 - bs)));
+				return static_cast<size_type>(std::lower_bound(sr2.begin() + bs,sr2.begin() + be,r1[i1]) - (sr2.begin() + bs));
+			};
 			// Task comparator. It will compare the bucket index of the terms resulting from
 			// the multiplication of the term in the first series by the first term in the block
 			// of the second series. This is essentially the first bucket index of retval in which the task
@@ -1447,11 +2263,28 @@ class series_multiplier<Series,detail::poly_multiplier_enabler<Series>>:
 				return r_bucket(v1[std::get<0u>(t1)]) + r_bucket(v2[std::get<1u>(t1)]) <
 					r_bucket(v1[std::get<0u>(t2)]) + r_bucket(v2[std::get<1u>(t2)]);
 			};
-			// Task block size.
-			const size_type block_size = safe_cast<size_type>(tuning::get_multiplication_block_size());
-			// Task splitter: split a task in block_size sized tasks and append them to out.
-			auto task_split = [block_size] (const task_type &t, std::vector<task_type> &out) {
+			// Task splitter: split a task in block_size sized tasks and append them to out. If the multiplication
+			// is truncated, the tasks are split at the boundaries of the blocks of the second series, and the tasks
+			// in which all the products exceed the truncation limit are discarded.
+			auto task_split = [block_size,trunc,&r1,&sr2] (const task_type &t, std::vector<task_type> &out) {
 				size_type start = std::get<1u>(t), end = std::get<2u>(t);
+				if (trunc) {
+					const size_type lim = r1[std::get<0u>(t)];
+					// NOTE: the lowest rank is zero, if lim is zero all the products exceed the limit.
+					if (lim == 0u) {
+						return;
+					}
+					while (start != end) {
+						const auto rem = static_cast<size_type>(block_size - start % block_size);
+						const auto stop = (static_cast<size_type>(end - start) > rem) ? static_cast<size_type>(start + rem) : end;
+						// The first element of the block in sr2 is the lowest rank in the block.
+						if (sr2[static_cast<size_type>(start - start % block_size)] < lim) {
+							out.emplace_back(std::get<0u>(t),start,stop);
+						}
+						start = stop;
+					}
+					return;
+				}
 				while (static_cast<size_type>(end - start) > block_size) {
 					out.emplace_back(std::get<0u>(t),start,static_cast<size_type>(start + block_size));
 					start = static_cast<size_type>(start + block_size);
@@ -1460,27 +2293,27 @@ class series_multiplier<Series,detail::poly_multiplier_enabler<Series>>:
 					out.emplace_back(std::get<0u>(t),start,end);
 				}
 			};
-			// End of the container, always the same value.
-			const auto it_end = container.end();
 			// Function to perform all the term-by-term multiplications in a task, using tmp_term
-			// as a temporary value for the computation of the result.
-			auto task_consume = [&v1,&v2,&container,it_end,this] (const task_type &task, term_type &tmp_term) {
-				// Get the term in the first series.
-				term_type const *t1 = v1[std::get<0u>(task)];
-				// Get pointers to the second series.
-				term_type const **start2 = &(v2[std::get<1u>(task)]), **end2 = &(v2[std::get<2u>(task)]);
+			// as a temporary value for the computation of the result. It returns the number of terms
+			// inserted into retval.
+			auto task_consume = [&v1,&v2,&container,&cf_ops,trunc,&r1,&r2,&s2,&block_prefix,block_size,size2]
+				(const task_type &task, term_type &tmp_term) -> bucket_size_type
+			{
+				// End of the container. NOTE: this needs to be re-read for every task, as the container
+				// might have been rehashed in the meantime.
+				const auto it_end = container.end();
+				bucket_size_type n_inserted = 0u;
+				// Get the index of the term in the first series.
+				const size_type i1 = std::get<0u>(task);
 				// NOTE: these will have to be adapted for kd_monomial.
-				using int_type = decltype(t1->m_key.get_int());
-				// Get shortcuts to cf and key in t1.
-				const auto &cf1 = t1->m_cf;
-				const int_type key1 = t1->m_key.get_int();
-				// Iterate over the task.
-				for (; start2 != end2; ++start2) {
-					// Const ref to the current term in the second series.
-					const auto &cur = **start2;
+				using int_type = decltype(v1[i1]->m_key.get_int());
+				// Get a shortcut to the key in t1.
+				const int_type key1 = v1[i1]->m_key.get_int();
+				// Multiply the term in the first series by the i2-th term in the second series.
+				auto term_mult = [&] (const size_type &i2) {
 					// Add the keys.
 					// NOTE: this will have to be adapted for kd_monomial.
-					tmp_term.m_key.set_int(static_cast<int_type>(key1 + cur.m_key.get_int()));
+					tmp_term.m_key.set_int(static_cast<int_type>(key1 + v2[i2]->m_key.get_int()));
 					// Try to locate the term into retval.
 					auto bucket_idx = container._bucket(tmp_term);
 					const auto it = container._find(tmp_term,bucket_idx);
@@ -1493,14 +2326,66 @@ class series_multiplier<Series,detail::poly_multiplier_enabler<Series>>:
 						// as we are not going to re-use the allocated resources in tmp.m_cf -> in other words, optimize this
 						// as much as possible.
 						// Take care of multiplying the coefficient.
-						detail::cf_mult_impl(tmp_term.m_cf,cf1,cur.m_cf);
+						cf_ops.mult(tmp_term.m_cf,i1,i2);
 						container._unique_insert(tmp_term,bucket_idx);
+						++n_inserted;
 					} else {
-						// NOTE: here we need to decide if we want to give the same treatment to fmp as we did with cf_mult_impl.
-						// For the moment it is an implementation detail of this class.
-						this->fma_wrap(it->m_cf,cf1,cur.m_cf);
+						cf_ops.fma(it->m_cf,i1,i2);
+					}
+				};
+				const size_type start2 = std::get<1u>(task), end2 = std::get<2u>(task);
+				if (trunc) {
+					// NOTE: the task is contained in a single block (see task_split).
+					const auto bs = static_cast<size_type>(start2 - start2 % block_size);
+					const auto p = block_prefix(i1,start2);
+					if (p != std::min<size_type>(block_size,static_cast<size_type>(size2 - bs))) {
+						if (p < static_cast<size_type>(end2 - start2) / 2u) {
+							// Few terms within the limit: iterate only over them, in ascending degree order.
+							for (auto k = bs; k != static_cast<size_type>(bs + p); ++k) {
+								if (s2[k] >= start2 && s2[k] < end2) {
+									term_mult(s2[k]);
+								}
+							}
+						} else {
+							const size_type lim = r1[i1];
+							for (size_type i2 = start2; i2 != end2; ++i2) {
+								if (r2[i2] < lim) {
+									term_mult(i2);
+								}
+							}
+						}
+						return n_inserted;
 					}
 				}
+				// Iterate over the task.
+				for (size_type i2 = start2; i2 != end2; ++i2) {
+					term_mult(i2);
+				}
+				return n_inserted;
+			};
+			// The initial size of retval comes from a statistical estimate, which can be off by a large
+			// factor. The actual number of terms inserted is monitored during the multiplication, and
+			// the number of buckets is doubled whenever the max load factor is exceeded.
+			// NOTE: growing by doubling preserves the zone structure of the multi-threaded
+			// multiplication: all the elements of a bucket with index b end up in buckets whose index
+			// is congruent to b modulo the old number of buckets, so the zones keep on writing in
+			// disjoint sets of buckets after the rehash.
+			const unsigned n_threads_rehash = tuning::get_parallel_memory_set() ? this->m_n_threads : 1u;
+			// Max number of terms that can be stored in retval without exceeding the max load factor.
+			auto load_limit = [&container] () -> bucket_size_type {
+				return static_cast<bucket_size_type>(static_cast<double>(container.bucket_count()) *
+					container.max_load_factor());
+			};
+			// Double the number of buckets in retval, given its current number of terms n. Returns the new load limit.
+			auto grow_table = [&container,&load_limit,n_threads_rehash] (const bucket_size_type &n) -> bucket_size_type {
+				const auto bc = container.bucket_count();
+				// If we cannot double any more, just keep on going with a higher load factor.
+				if (bc > std::numeric_limits<bucket_size_type>::max() / 4u) {
+					return std::numeric_limits<bucket_size_type>::max();
+				}
+				container._update_size(n);
+				container.rehash(static_cast<bucket_size_type>(bc * 2u),n_threads_rehash);
+				return load_limit();
 			};
 			if (this->m_n_threads == 1u) {
 				try {
@@ -1512,31 +2397,26 @@ class series_multiplier<Series,detail::poly_multiplier_enabler<Series>>:
 					}
 					// Sort the tasks.
 					std::stable_sort(tasks.begin(),tasks.end(),task_cmp);
-					// Iterate over the tasks and run the multiplication.
+					// Iterate over the tasks and run the multiplication, growing retval as needed.
 					term_type tmp_term;
+					bucket_size_type n_terms = 0u, limit = load_limit();
 					for (const auto &t: tasks) {
-						task_consume(t,tmp_term);
+						n_terms = static_cast<bucket_size_type>(n_terms + task_consume(t,tmp_term));
+						if (unlikely(n_terms > limit)) {
+							limit = grow_table(n_terms);
+						}
 					}
-					this->sanitise_series(retval,this->m_n_threads);
-					this->finalise_series(retval);
 				} catch (...) {
-					retval._container().clear();
+					container.clear();
 					throw;
 				}
 				return;
 			}
 			// Number of buckets in retval.
 			const bucket_size_type bucket_count = container.bucket_count();
-			// Compute the number of zones in which the output container will be subdivided,
-			// a multiple of the number of threads.
-			// NOTE: zm is a tuning parameter.
-			const unsigned zm = 10u;
-			const bucket_size_type n_zones = static_cast<bucket_size_type>(integer(this->m_n_threads) * zm);
-			// Number of buckets per zone (can be zero).
-			const bucket_size_type bpz = static_cast<bucket_size_type>(bucket_count / n_zones);
 			// For each zone, we need to define a vector of tasks that will write only into that zone.
 			std::vector<std::vector<task_type>> task_table;
-			task_table.resize(safe_cast<decltype(task_table.size())>(n_zones));
+			using t_size_type = decltype(task_table.size());
 			// Lower bound implementation. Adapted from:
 			// http://en.cppreference.com/w/cpp/algorithm/lower_bound
 			// Given the [first,last[ index range in v2, find the first index idx in the v2 range such that the i-th term in v1
@@ -1567,8 +2447,12 @@ class series_multiplier<Series,detail::poly_multiplier_enabler<Series>>:
 				}
 				return first;
 			};
-			// Fill the task table.
-			auto table_filler = [&task_table,bpz,zm,this,bucket_count,size1,size2,&l_bound,&task_split,&task_cmp] (const unsigned &thread_idx) {
+			// Number of term-by-term multiplications in each zone.
+			std::vector<integer> zone_work;
+			// Fill the task table with zm zones per thread, each one spanning bpz buckets.
+			auto table_filler = [&task_table,&zone_work,this,bucket_count,size1,size2,&l_bound,&task_split,&task_cmp,trunc,&block_prefix]
+				(const unsigned &thread_idx, const unsigned &zm, const bucket_size_type &bpz)
+			{
 				for (unsigned n = 0u; n < zm; ++n) {
 					std::vector<task_type> cur_tasks;
 					// [a,b[ is the container zone.
@@ -1603,28 +2487,62 @@ class series_multiplier<Series,detail::poly_multiplier_enabler<Series>>:
 					}
 					// Sort the task vector.
 					std::stable_sort(cur_tasks.begin(),cur_tasks.end(),task_cmp);
+					// Count the work.
+					integer work(0);
+					for (const auto &t: cur_tasks) {
+						const auto n = static_cast<size_type>(std::get<2u>(t) - std::get<1u>(t));
+						// NOTE: in truncated mode, this is an upper bound for the work of the task.
+						work += trunc ? std::min(n,block_prefix(std::get<0u>(t),std::get<1u>(t))) : n;
+					}
 					// Move the vector of tasks in the table.
-					task_table[static_cast<decltype(task_table.size())>(thread_idx * zm + n)] = std::move(cur_tasks);
+					const auto z_idx = static_cast<t_size_type>(t_size_type(thread_idx) * zm + n);
+					task_table[z_idx] = std::move(cur_tasks);
+					zone_work[z_idx] = std::move(work);
 				}
 			};
-			// Go with the threads to fill the task table.
-			future_list<decltype(thread_pool::enqueue(0u,table_filler,0u))> ff_list;
-			try {
-				for (unsigned i = 0u; i < this->m_n_threads; ++i) {
-					ff_list.push_back(thread_pool::enqueue(i,table_filler,i));
+			// Compute the number of zones in which the output container will be subdivided,
+			// a multiple of the number of threads. The number of zones per thread is doubled until
+			// no single zone holds a large fraction of the work of a thread, or the zones become too small.
+			// NOTE: these are tuning parameters.
+			const unsigned zm_min = 8u, zm_max = 32u, imbalance_factor = 4u;
+			unsigned zm = zm_min;
+			// Number of buckets per zone (can be zero).
+			bucket_size_type bpz;
+			while (true) {
+				const bucket_size_type n_zones = static_cast<bucket_size_type>(integer(this->m_n_threads) * zm);
+				bpz = static_cast<bucket_size_type>(bucket_count / n_zones);
+				task_table.clear();
+				task_table.resize(safe_cast<t_size_type>(n_zones));
+				zone_work.clear();
+				zone_work.resize(safe_cast<t_size_type>(n_zones));
+				// Go with the threads to fill the task table.
+				future_list<decltype(thread_pool::enqueue(0u,table_filler,0u,zm,bpz))> ff_list;
+				try {
+					for (unsigned i = 0u; i < this->m_n_threads; ++i) {
+						ff_list.push_back(thread_pool::enqueue_task(i,table_filler,i,zm,bpz));
+					}
+					// First let's wait for everything to finish.
+					ff_list.wait_all();
+					// Then, let's handle the exceptions.
+					ff_list.get_all();
+				} catch (...) {
+					ff_list.wait_all();
+					throw;
 				}
-				// First let's wait for everything to finish.
-				ff_list.wait_all();
-				// Then, let's handle the exceptions.
-				ff_list.get_all();
-			} catch (...) {
-				ff_list.wait_all();
-				throw;
+				const auto max_work = *std::max_element(zone_work.begin(),zone_work.end());
+				const auto total_work = std::accumulate(zone_work.begin(),zone_work.end(),integer(0));
+				if (zm >= zm_max || bucket_count / (n_zones * 2u) == 0u ||
+					max_work * this->m_n_threads * imbalance_factor <= total_work)
+				{
+					break;
+				}
+				zm *= 2u;
 			}
 			// Check the consistency of the table for debug purposes.
-			auto table_checker = [&task_table,size1,size2,&r_bucket,bpz,bucket_count,&v1,&v2] () -> bool {
+			auto table_checker = [&task_table,size1,size2,&container,bpz,bucket_count,&v1,&v2,trunc,&r1,&r2,block_size] () -> bool {
 				// Total number of term-by-term multiplications. Needs to be equal
-				// to size1 * size2 at the end.
+				// to size1 * size2 at the end, or to the number of products within the limit
+				// in truncated mode.
 				integer tot_n(0);
 				// Tmp term for multiplications.
 				term_type tmp_term;
@@ -1642,70 +2560,241 @@ class series_multiplier<Series,detail::poly_multiplier_enabler<Series>>:
 						auto idx1 = std::get<0u>(t), start2 = std::get<1u>(t), end2 = std::get<2u>(t);
 						using int_type = decltype(v1[idx1]->m_key.get_int());
 						piranha_assert(start2 <= end2);
-						tot_n += end2 - start2;
+						if (trunc && (start2 == end2 || start2 / block_size != (end2 - 1u) / block_size)) {
+							return false;
+						}
 						for (; start2 != end2; ++start2) {
+							if (trunc && r2[start2] >= r1[idx1]) {
+								continue;
+							}
+							++tot_n;
 							tmp_term.m_key.set_int(static_cast<int_type>(v1[idx1]->m_key.get_int() + v2[start2]->m_key.get_int()));
-							auto b_idx = r_bucket(&tmp_term);
+							auto b_idx = container._bucket(tmp_term);
 							if (b_idx < a || b_idx >= b) {
 								return false;
 							}
 						}
 					}
 				}
-				return tot_n == integer(size1) * size2;
+				if (!trunc) {
+					return tot_n == integer(size1) * size2;
+				}
+				integer n_within(0);
+				for (const auto &l: r1) {
+					n_within += std::count_if(r2.begin(),r2.end(),[&l](const size_type &r) {return r < l;});
+				}
+				return tot_n == n_within;
 			};
 			(void)table_checker;
 			piranha_assert(table_checker());
-			// Init the vector of atomic flags.
-			detail::atomic_flag_array af(safe_cast<std::size_t>(task_table.size()));
+			// Distribute the zones among the threads. If the buckets of retval were initialised in parallel, the
+			// memory of each zone is local to the NUMA node of the thread that first touched it: the zones
+			// are then grouped by NUMA node, and distributed only among the threads of that node. Within
+			// each group, each thread gets a contiguous range of zones holding roughly the same amount of work.
+			const unsigned n_threads = this->m_n_threads;
+			std::vector<unsigned> t_nodes(n_threads,0u);
+			if (tuning::get_parallel_memory_set()) {
+				for (unsigned i = 0u; i < n_threads; ++i) {
+					t_nodes[i] = detail::thread_numa_node(i);
+				}
+			}
+			// Thread which initialised the first bucket of the zone z_idx (see hash_set::init_from_n_buckets()).
+			const bucket_size_type wpt = static_cast<bucket_size_type>(bucket_count / n_threads);
+			auto zone_owner = [wpt,bpz,n_threads](t_size_type z_idx) -> unsigned {
+				if (wpt == 0u) {
+					return n_threads - 1u;
+				}
+				const auto t = static_cast<bucket_size_type>(bpz * z_idx) / wpt;
+				return (t >= n_threads) ? (n_threads - 1u) : static_cast<unsigned>(t);
+			};
+			std::vector<detail::zone_deque<t_size_type>> deques(n_threads);
+			std::vector<unsigned> group_threads;
+			std::vector<t_size_type> group_zones;
+			std::vector<bool> done(n_threads,false);
+			for (unsigned i = 0u; i < n_threads; ++i) {
+				if (done[i]) {
+					continue;
+				}
+				// Threads and zones belonging to the NUMA node of thread i.
+				group_threads.clear();
+				group_zones.clear();
+				for (unsigned j = i; j < n_threads; ++j) {
+					if (t_nodes[j] == t_nodes[i]) {
+						group_threads.push_back(j);
+						done[j] = true;
+					}
+				}
+				integer group_work(0);
+				for (t_size_type z = 0u; z < task_table.size(); ++z) {
+					if (t_nodes[zone_owner(z)] == t_nodes[i]) {
+						group_zones.push_back(z);
+						group_work += zone_work[z];
+					}
+				}
+				const auto n_gt = static_cast<unsigned>(group_threads.size());
+				integer acc(0);
+				unsigned t_idx = 0u;
+				for (const auto &z: group_zones) {
+					// Move to the next thread when the current one has got its share of the work.
+					while (t_idx < n_gt - 1u && acc * n_gt >= group_work * (t_idx + 1u)) {
+						++t_idx;
+					}
+					acc += zone_work[z];
+					deques[group_threads[t_idx]].m_zones.push_back(z);
+				}
+			}
+			// Order in which each thread will try to steal from the other threads: first the threads
+			// on the same NUMA node, then the others.
+			std::vector<std::vector<unsigned>> victims(n_threads);
+			for (unsigned i = 0u; i < n_threads; ++i) {
+				for (unsigned j = 1u; j < n_threads; ++j) {
+					const unsigned v = (i + j) % n_threads;
+					if (t_nodes[v] == t_nodes[i]) {
+						victims[i].push_back(v);
+					}
+				}
+				for (unsigned j = 1u; j < n_threads; ++j) {
+					const unsigned v = (i + j) % n_threads;
+					if (t_nodes[v] != t_nodes[i]) {
+						victims[i].push_back(v);
+					}
+				}
+			}
+			// Timing data for the threads: busy time, time of completion, number of zones consumed
+			// and number of zones stolen.
+			using clock_type = std::chrono::steady_clock;
+			std::vector<std::tuple<clock_type::duration,clock_type::time_point,unsigned,unsigned>> timings(this->m_n_threads);
+			// Growth of retval. The threads register themselves in n_active while consuming a zone.
+			// When the number of terms inserted exceeds the load limit, the first thread noticing it raises
+			// the growing flag, waits for the other threads to leave their zones and rehashes retval.
+			// NOTE: the tasks of the parallel rehash which are assigned to the waiting threads are run by
+			// the growing thread itself (see thread_pool_::parallel_invoke()).
+			std::atomic<bucket_size_type> n_terms(0u), limit(load_limit());
+			std::atomic<unsigned> n_active(0u);
+			std::atomic<bool> growing(false), failed(false);
+			auto wait_while = [] (const std::function<bool()> &cond) {
+				while (cond()) {
+					std::this_thread::yield();
+				}
+			};
+			// Enter a zone. Returns false if the multiplication was aborted because of an error in another thread.
+			auto zone_enter = [&n_active,&growing,&failed,&wait_while] () -> bool {
+				while (true) {
+					wait_while([&growing]() {return growing.load();});
+					++n_active;
+					if (!growing.load()) {
+						break;
+					}
+					--n_active;
+				}
+				if (unlikely(failed.load())) {
+					--n_active;
+					return false;
+				}
+				return true;
+			};
+			// Leave a zone in which n terms were inserted, growing retval if needed.
+			auto zone_leave = [&n_terms,&limit,&n_active,&growing,&failed,&wait_while,&grow_table]
+				(const bucket_size_type &n)
+			{
+				const auto tot = static_cast<bucket_size_type>(n_terms += n);
+				--n_active;
+				bool expected = false;
+				if (likely(tot <= limit.load()) || !growing.compare_exchange_strong(expected,true)) {
+					return;
+				}
+				wait_while([&n_active]() {return n_active.load() != 0u;});
+				try {
+					// NOTE: all the threads are out of their zones now, n_terms is exact.
+					const auto cur = n_terms.load();
+					if (cur > limit.load()) {
+						limit.store(grow_table(cur));
+					}
+				} catch (...) {
+					failed.store(true);
+					growing.store(false);
+					throw;
+				}
+				growing.store(false);
+			};
+			const auto t_start = clock_type::now();
 			// Thread functor.
-			auto thread_functor = [zm,&task_table,&af,&v1,&v2,&container,&task_consume] (const unsigned &thread_idx) {
-				using t_size_type = decltype(task_table.size());
+			auto thread_functor = [&task_table,&deques,&victims,&timings,&task_consume,&zone_enter,&zone_leave,&n_active,
+				&failed] (const unsigned &thread_idx)
+			{
 				// Temporary term_type for caching.
 				term_type tmp_term;
-				// The starting index in the task table.
-				auto t_idx = static_cast<t_size_type>(t_size_type(thread_idx) * zm);
-				const auto start_t_idx = t_idx;
+				auto &timing = timings[thread_idx];
+				t_size_type z_idx;
 				while (true) {
-					// If this returns false, it means that the tasks still need to be consumed;
-					if (!af[static_cast<std::size_t>(t_idx)].test_and_set()) {
-						// Current vector of tasks.
-						const auto &cur_tasks = task_table[t_idx];
-						for (const auto &t: cur_tasks) {
-							task_consume(t,tmp_term);
+					// Pick the next zone from the front of our own deque. If there is no work left,
+					// steal a zone from the back of the deque of another thread, preferring the threads
+					// on the same NUMA node. Each zone is consumed by a single thread, and zones never
+					// overlap: no locking is needed on retval.
+					if (!deques[thread_idx].pop_front(z_idx)) {
+						bool stolen = false;
+						for (auto it = victims[thread_idx].begin(); it != victims[thread_idx].end() && !stolen; ++it) {
+							stolen = deques[*it].pop_back(z_idx);
 						}
+						if (!stolen) {
+							break;
+						}
+						++std::get<3u>(timing);
 					}
-					// Update the index, wrapping around if necessary.
-					t_idx = static_cast<t_size_type>(t_idx + 1u);
-					if (t_idx == task_table.size()) {
-						t_idx = 0u;
-					}
-					// If we got back to the original index, get out.
-					if (t_idx == start_t_idx) {
+					if (!zone_enter()) {
 						break;
 					}
+					const auto z_start = clock_type::now();
+					bucket_size_type n_inserted = 0u;
+					try {
+						for (const auto &t: task_table[z_idx]) {
+							n_inserted = static_cast<bucket_size_type>(n_inserted + task_consume(t,tmp_term));
+						}
+					} catch (...) {
+						failed.store(true);
+						--n_active;
+						throw;
+					}
+					std::get<0u>(timing) += clock_type::now() - z_start;
+					zone_leave(n_inserted);
+					++std::get<2u>(timing);
 				}
+				std::get<1u>(timing) = clock_type::now();
 			};
 			// Go with the multiplication threads.
 			future_list<decltype(thread_pool::enqueue(0u,thread_functor,0u))> ft_list;
 			try {
 				for (unsigned i = 0u; i < this->m_n_threads; ++i) {
-					ft_list.push_back(thread_pool::enqueue(i,thread_functor,i));
+					ft_list.push_back(thread_pool::enqueue_task(i,thread_functor,i));
 				}
 				// First let's wait for everything to finish.
 				ft_list.wait_all();
 				// Then, let's handle the exceptions.
 				ft_list.get_all();
-				// Finally, fix and finalise the series.
-				this->sanitise_series(retval,this->m_n_threads);
-				this->finalise_series(retval);
+				// Record the thread statistics. A thread is considered idle from the moment it starts
+				// until the last thread finishes, unless it is consuming zones.
+				auto t_end = t_start;
+				for (const auto &t: timings) {
+					t_end = std::max(t_end,std::get<1u>(t));
+				}
+				std::vector<std::tuple<double,double,unsigned,unsigned>> stats;
+				for (const auto &t: timings) {
+					const auto busy = std::chrono::duration<double>(std::get<0u>(t)).count();
+					stats.emplace_back(busy,std::max(std::chrono::duration<double>(t_end - t_start).count() - busy,0.),
+						std::get<2u>(t),std::get<3u>(t));
+				}
+				detail::poly_mult_stats<Series>() = std::move(stats);
 			} catch (...) {
 				ft_list.wait_all();
 				// Clean up and re-throw.
-				retval._container().clear();
+				container.clear();
 				throw;
 			}
 		}
+	private:
+		// Bounds of the exponents in the two operands (only for Kronecker monomials).
+		std::vector<std::pair<integer,integer>>	m_minmax1;
+		std::vector<std::pair<integer,integer>>	m_minmax2;
 };
 
 }
@@ -151,8 +151,8 @@ struct pow_impl<T,U,detail::integer_pow_enabler<T,U>>
 	 * @throws unspecified any exception thrown by piranha::mp_integer::pow()
 	 * or by the constructor of piranha::mp_integer from integral type.
 	 */
-	template <int NBits>
-	mp_integer<NBits> operator()(const mp_integer<NBits> &b, const mp_integer<NBits> &e) const
+	template <int NBits, std::size_t NLimbs>
+	mp_integer<NBits,NLimbs> operator()(const mp_integer<NBits,NLimbs> &b, const mp_integer<NBits,NLimbs> &e) const
 	{
 		return b.pow(e);
 	}
@@ -165,8 +165,8 @@ struct pow_impl<T,U,detail::integer_pow_enabler<T,U>>
 	 *
 	 * @throws unspecified any exception thrown by piranha::mp_integer::pow().
 	 */
-	template <int NBits, typename T2, typename std::enable_if<std::is_integral<T2>::value,int>::type = 0>
-	mp_integer<NBits> operator()(const mp_integer<NBits> &b, const T2 &e) const
+	template <int NBits, std::size_t NLimbs, typename T2, typename std::enable_if<std::is_integral<T2>::value,int>::type = 0>
+	mp_integer<NBits,NLimbs> operator()(const mp_integer<NBits,NLimbs> &b, const T2 &e) const
 	{
 		return b.pow(e);
 	}
@@ -179,8 +179,8 @@ struct pow_impl<T,U,detail::integer_pow_enabler<T,U>>
 	 *
 	 * @throws unspecified any exception thrown by converting piranha::mp_integer to a floating-point type.
 	 */
-	template <int NBits, typename T2, typename std::enable_if<std::is_floating_point<T2>::value,int>::type = 0>
-	T2 operator()(const mp_integer<NBits> &b, const T2 &e) const
+	template <int NBits, std::size_t NLimbs, typename T2, typename std::enable_if<std::is_floating_point<T2>::value,int>::type = 0>
+	T2 operator()(const mp_integer<NBits,NLimbs> &b, const T2 &e) const
 	{
 		return math::pow(static_cast<T2>(b),e);
 	}
@@ -193,10 +193,10 @@ struct pow_impl<T,U,detail::integer_pow_enabler<T,U>>
 	 *
 	 * @throws unspecified any exception thrown by piranha::mp_integer::pow().
 	 */
-	template <int NBits, typename T2, typename std::enable_if<std::is_integral<T2>::value,int>::type = 0>
-	mp_integer<NBits> operator()(const T2 &b, const mp_integer<NBits> &e) const
+	template <int NBits, std::size_t NLimbs, typename T2, typename std::enable_if<std::is_integral<T2>::value,int>::type = 0>
+	mp_integer<NBits,NLimbs> operator()(const T2 &b, const mp_integer<NBits,NLimbs> &e) const
 	{
-		return mp_integer<NBits>(b).pow(e);
+		return mp_integer<NBits,NLimbs>(b).pow(e);
 	}
 	/// Call operator, floating-point--integer overload.
 	/**
@@ -207,8 +207,8 @@ struct pow_impl<T,U,detail::integer_pow_enabler<T,U>>
 	 *
 	 * @throws unspecified any exception thrown by converting piranha::mp_integer to a floating-point type.
 	 */
-	template <int NBits, typename T2, typename std::enable_if<std::is_floating_point<T2>::value,int>::type = 0>
-	T2 operator()(const T2 &b, const mp_integer<NBits> &e) const
+	template <int NBits, std::size_t NLimbs, typename T2, typename std::enable_if<std::is_floating_point<T2>::value,int>::type = 0>
+	T2 operator()(const T2 &b, const mp_integer<NBits,NLimbs> &e) const
 	{
 		return math::pow(b,static_cast<T2>(e));
 	}
@@ -22,6 +22,7 @@
 #define PIRANHA_REAL_HPP
 
 #include <algorithm>
+#include <array>
 #include <boost/lexical_cast.hpp>
 #include <cmath>
 #include <cstddef>
@@ -72,6 +73,43 @@ const ::mpfr_rnd_t real_base<T>::default_rnd;
 template <typename T>
 const ::mpfr_prec_t real_base<T>::default_prec;
 
+// The MPFR structure type.
+using mpfr_struct_t = std::remove_extent< ::mpfr_t>::type;
+
+// Simple RAII holder for MPFR floats.
+struct mpfr_raii
+{
+	mpfr_raii()
+	{
+		::mpfr_init2(&m_mpfr,real_base<>::default_prec);
+	}
+	mpfr_raii(const mpfr_raii &) = delete;
+	mpfr_raii(mpfr_raii &&) = delete;
+	mpfr_raii &operator=(const mpfr_raii &) = delete;
+	mpfr_raii &operator=(mpfr_raii &&) = delete;
+	~mpfr_raii()
+	{
+		::mpfr_clear(&m_mpfr);
+	}
+	mpfr_struct_t m_mpfr;
+};
+
+// Thread-local pool of MPFR floats, used as scratch space for the temporary values in the implementation of real.
+// The floats are initialised once per thread and reused across operations. Their precision is changed only when
+// it differs from the requested one, and MPFR reallocates the significand only if it needs to grow, so in the
+// common case of a uniform working precision no allocation takes place. The value of a scratch float is
+// unspecified when it is requested, and a slot must not be held across calls that might request the same slot.
+inline mpfr_struct_t &mpfr_scratch(std::size_t idx, ::mpfr_prec_t prec)
+{
+	static thread_local std::array<mpfr_raii,8u> pool;
+	piranha_assert(idx < pool.size());
+	auto &retval = pool[idx].m_mpfr;
+	if (::mpfr_get_prec(&retval) != prec) {
+		::mpfr_set_prec(&retval,prec);
+	}
+	return retval;
+}
+
 // Types interoperable with real.
 template <typename T>
 struct is_real_interoperable_type
@@ -290,14 +328,20 @@ class real: public detail::real_base<>
 				piranha_throw(std::overflow_error,"error in conversion of real to rational: exponent is too large");
 			}
 		}
+		// Increase the precision of this to prec, preserving the value. MPFR reallocates the significand
+		// in place, without the construction of a temporary.
+		void promote_prec(const ::mpfr_prec_t &prec)
+		{
+			piranha_assert(prec > get_prec());
+			::mpfr_prec_round(m_value,prec,default_rnd);
+		}
 		// In-place addition.
 		// NOTE: all sorts of optimisations, here and in binary add, are possible (e.g., steal from rvalue ref, 
 		// avoid setting precision twice in binary operators, etc.). For the moment we keep it basic.
 		real &in_place_add(const real &r)
 		{
 			if (r.get_prec() > get_prec()) {
-				// Re-init this with the prec of r.
-				*this = real{*this,r.get_prec()};
+				promote_prec(r.get_prec());
 			}
 			::mpfr_add(m_value,m_value,r.m_value,default_rnd);
 			return *this;
@@ -326,8 +370,11 @@ class real: public detail::real_base<>
 		template <typename T, typename std::enable_if<std::is_floating_point<T>::value,int>::type = 0>
 		real &in_place_add(const T &x)
 		{
-			// Construct real with the same precision as this, then add.
-			return in_place_add(real{x,get_prec()});
+			// Convert x to a scratch float with the same precision as this, then operate.
+			auto &tmp = detail::mpfr_scratch(0u,get_prec());
+			::mpfr_set_ld(&tmp,static_cast<long double>(x),default_rnd);
+			::mpfr_add(m_value,m_value,&tmp,default_rnd);
+			return *this;
 		}
 		// Binary add.
 		static real binary_add(const real &a, const real &b)
@@ -353,7 +400,7 @@ class real: public detail::real_base<>
 		real &in_place_sub(const real &r)
 		{
 			if (r.get_prec() > get_prec()) {
-				*this = real{*this,r.get_prec()};
+				promote_prec(r.get_prec());
 			}
 			::mpfr_sub(m_value,m_value,r.m_value,default_rnd);
 			return *this;
@@ -380,7 +427,11 @@ class real: public detail::real_base<>
 		template <typename T, typename std::enable_if<std::is_floating_point<T>::value,int>::type = 0>
 		real &in_place_sub(const T &x)
 		{
-			return in_place_sub(real{x,get_prec()});
+			// Convert x to a scratch float with the same precision as this, then operate.
+			auto &tmp = detail::mpfr_scratch(0u,get_prec());
+			::mpfr_set_ld(&tmp,static_cast<long double>(x),default_rnd);
+			::mpfr_sub(m_value,m_value,&tmp,default_rnd);
+			return *this;
 		}
 		// Binary sub.
 		static real binary_sub(const real &a, const real &b)
@@ -407,7 +458,7 @@ class real: public detail::real_base<>
 		real &in_place_mul(const real &r)
 		{
 			if (r.get_prec() > get_prec()) {
-				*this = real{*this,r.get_prec()};
+				promote_prec(r.get_prec());
 			}
 			::mpfr_mul(m_value,m_value,r.m_value,default_rnd);
 			return *this;
@@ -434,7 +485,11 @@ class real: public detail::real_base<>
 		template <typename T, typename std::enable_if<std::is_floating_point<T>::value,int>::type = 0>
 		real &in_place_mul(const T &x)
 		{
-			return in_place_mul(real{x,get_prec()});
+			// Convert x to a scratch float with the same precision as this, then operate.
+			auto &tmp = detail::mpfr_scratch(0u,get_prec());
+			::mpfr_set_ld(&tmp,static_cast<long double>(x),default_rnd);
+			::mpfr_mul(m_value,m_value,&tmp,default_rnd);
+			return *this;
 		}
 		// Binary mul.
 		static real binary_mul(const real &a, const real &b)
@@ -459,7 +514,7 @@ class real: public detail::real_base<>
 		real &in_place_div(const real &r)
 		{
 			if (r.get_prec() > get_prec()) {
-				*this = real{*this,r.get_prec()};
+				promote_prec(r.get_prec());
 			}
 			::mpfr_div(m_value,m_value,r.m_value,default_rnd);
 			return *this;
@@ -486,7 +541,11 @@ class real: public detail::real_base<>
 		template <typename T, typename std::enable_if<std::is_floating_point<T>::value,int>::type = 0>
 		real &in_place_div(const T &x)
 		{
-			return in_place_div(real{x,get_prec()});
+			// Convert x to a scratch float with the same precision as this, then operate.
+			auto &tmp = detail::mpfr_scratch(0u,get_prec());
+			::mpfr_set_ld(&tmp,static_cast<long double>(x),default_rnd);
+			::mpfr_div(m_value,m_value,&tmp,default_rnd);
+			return *this;
 		}
 		// Binary div.
 		static real binary_div(const real &a, const real &b)
@@ -1326,21 +1385,19 @@ class real: public detail::real_base<>
 		{
 			const auto prec1 = std::max< ::mpfr_prec_t>(r1.get_prec(),r2.get_prec());
 			if (prec1 > get_prec()) {
-				*this = real{*this,prec1};
+				promote_prec(prec1);
 			}
 			// So the story here is that mpfr_fma has been reported to be slower than the two separate
 			// operations. Benchmarks on fateman1 indicate this is indeed the case (3.6 vs 2.7 secs
 			// on 4 threads). Hopefully it will be fixed in the future, for now adopt the workaround.
 			// http://www.loria.fr/~zimmerma/mpfr-mpc-2014.html
 			//::mpfr_fma(m_value,r1.m_value,r2.m_value,m_value,default_rnd);
-			// NOTE: the tmp var needs to be thread local.
-			static thread_local real tmp;
-			// NOTE: set the same precision as this, which is now the max precision of the 3 operands.
-			// If we do not do this, then tmp has an undeterminate precision. Use the raw MPFR function
-			// in order to avoid the checks in get_prec(), as we know the precision has a sane value.
-			::mpfr_set_prec(tmp.m_value,mpfr_get_prec(m_value));
-			::mpfr_mul(tmp.m_value,r1.m_value,r2.m_value,MPFR_RNDN);
-			::mpfr_add(m_value,m_value,tmp.m_value,MPFR_RNDN);
+			// NOTE: the temporary is a thread-local scratch float with the same precision as this, which is
+			// now the max precision of the 3 operands. Use the raw MPFR function in order to avoid the checks
+			// in get_prec(), as we know the precision has a sane value.
+			auto &tmp = detail::mpfr_scratch(0u,::mpfr_get_prec(m_value));
+			::mpfr_mul(&tmp,r1.m_value,r2.m_value,MPFR_RNDN);
+			::mpfr_add(m_value,m_value,&tmp,MPFR_RNDN);
 			return *this;
 		}
 		/// Generic equality operator involving piranha::real.
@@ -1938,34 +1995,57 @@ namespace detail
 {
 
 // Compute gamma(a)/(gamma(b) * gamma(c)), assuming a, b and c are not negative ints. The logarithm
-// of the gamma function is used internally.
-inline real real_compute_3_gamma(const real &a, const real &b, const real &c, const ::mpfr_prec_t &prec)
+// of the gamma function is used internally. The computation is performed with precision prec on the
+// thread-local scratch floats from slot 3 onwards (so that a, b and c can be stored in the lower slots),
+// and the result is written into retval.
+inline void real_compute_3_gamma(mpfr_struct_t &retval, const mpfr_struct_t &a, const mpfr_struct_t &b,
+	const mpfr_struct_t &c, const ::mpfr_prec_t &prec)
 {
+	const auto rnd = real_base<>::default_rnd;
 	// Here we should never enter with negative ints.
-	piranha_assert(a.sign() >= 0 || a.truncated() != a);
-	piranha_assert(b.sign() >= 0 || b.truncated() != b);
-	piranha_assert(c.sign() >= 0 || c.truncated() != c);
-	const real pi = real{0,prec}.pi();
-	real tmp0(0), tmp1(1);
-	if (a.sign() < 0) {
-		tmp0 -= (1 - a).lgamma();
-		tmp1 *= pi / (a * pi).sin();
-	} else {
-		tmp0 += a.lgamma();
-	}
-	if (b.sign() < 0) {
-		tmp0 += (1 - b).lgamma();
-		tmp1 *= (b * pi).sin() / pi;
-	} else {
-		tmp0 -= b.lgamma();
-	}
-	if (c.sign() < 0) {
-		tmp0 += (1 - c).lgamma();
-		tmp1 *= (c * pi).sin() / pi;
-	} else {
-		tmp0 -= c.lgamma();
-	}
-	return tmp0.exp() * tmp1;
+	piranha_assert(::mpfr_sgn(&a) >= 0 || !::mpfr_integer_p(&a));
+	piranha_assert(::mpfr_sgn(&b) >= 0 || !::mpfr_integer_p(&b));
+	piranha_assert(::mpfr_sgn(&c) >= 0 || !::mpfr_integer_p(&c));
+	auto &pi = mpfr_scratch(3u,prec), &tmp0 = mpfr_scratch(4u,prec), &tmp1 = mpfr_scratch(5u,prec),
+		&tmp2 = mpfr_scratch(6u,prec);
+	::mpfr_const_pi(&pi,rnd);
+	::mpfr_set_ui(&tmp0,0u,rnd);
+	::mpfr_set_ui(&tmp1,1u,rnd);
+	// This is the sign of the gamma function. We don't use this.
+	int sign;
+	// Accumulate the contribution of the gamma of x, in the numerator or in the denominator. Negative
+	// arguments go through the reflection formula.
+	auto acc = [&](const mpfr_struct_t &x, bool num) {
+		if (::mpfr_sgn(&x) < 0) {
+			::mpfr_ui_sub(&tmp2,1u,&x,rnd);
+			::mpfr_lgamma(&tmp2,&sign,&tmp2,rnd);
+			if (num) {
+				::mpfr_sub(&tmp0,&tmp0,&tmp2,rnd);
+			} else {
+				::mpfr_add(&tmp0,&tmp0,&tmp2,rnd);
+			}
+			::mpfr_mul(&tmp2,&x,&pi,rnd);
+			::mpfr_sin(&tmp2,&tmp2,rnd);
+			if (num) {
+				::mpfr_div(&tmp2,&pi,&tmp2,rnd);
+			} else {
+				::mpfr_div(&tmp2,&tmp2,&pi,rnd);
+			}
+			::mpfr_mul(&tmp1,&tmp1,&tmp2,rnd);
+		} else {
+			::mpfr_lgamma(&tmp2,&sign,&x,rnd);
+			if (num) {
+				::mpfr_add(&tmp0,&tmp0,&tmp2,rnd);
+			} else {
+				::mpfr_sub(&tmp0,&tmp0,&tmp2,rnd);
+			}
+		}
+	};
+	acc(a,true);
+	acc(b,false);
+	acc(c,false);
+	::mpfr_exp(&tmp0,&tmp0,rnd);
+	::mpfr_mul(&retval,&tmp0,&tmp1,rnd);
 }
 
 }
@@ -1992,14 +2072,28 @@ inline real real::binomial(const real &y) const
 	}
 	// Work with the max precision.
 	const ::mpfr_prec_t max_prec = std::max< ::mpfr_prec_t>(get_prec(),y.get_prec());
-	const bool neg_int_x = truncated() == (*this) && sign() < 0,
-		neg_int_y = y.truncated() == y && y.sign() < 0,
-		neg_int_x_y = ((*this) - y).truncated() == ((*this) - y) && ((*this) - y).sign() < 0;
+	// The intermediate computations of the gamma functions are performed with at least the default precision.
+	const ::mpfr_prec_t w_prec = std::max< ::mpfr_prec_t>(max_prec,default_prec);
+	// NOTE: the arguments of the gamma functions are computed into the thread-local scratch floats,
+	// slots 0 to 2.
+	auto &x_y = detail::mpfr_scratch(0u,max_prec);
+	::mpfr_sub(&x_y,m_value,y.m_value,default_rnd);
+	const bool neg_int_x = ::mpfr_integer_p(m_value) && sign() < 0,
+		neg_int_y = ::mpfr_integer_p(y.m_value) && y.sign() < 0,
+		neg_int_x_y = ::mpfr_integer_p(&x_y) && ::mpfr_sgn(&x_y) < 0;
 	const unsigned mask = unsigned(neg_int_x) + (unsigned(neg_int_y) << 1u) + (unsigned(neg_int_x_y) << 2u);
 	switch (mask) {
 		case 0u:
+		{
 			// Case 0 is the non-special one, use the default implementation.
-			return detail::real_compute_3_gamma((*this) + 1,y + 1,(*this) - y + 1,max_prec);
+			auto &a = detail::mpfr_scratch(1u,w_prec), &b = detail::mpfr_scratch(2u,w_prec);
+			::mpfr_add_ui(&a,m_value,1u,default_rnd);
+			::mpfr_add_ui(&b,y.m_value,1u,default_rnd);
+			::mpfr_add_ui(&x_y,&x_y,1u,default_rnd);
+			real retval{0,w_prec};
+			detail::real_compute_3_gamma(*retval.m_value,a,b,x_y,w_prec);
+			return retval;
+		}
 		// NOTE: case 1 is not possible: x < 0, y > 0 implies x - y < 0 always.
 		case 2u:
 		case 4u:
@@ -2014,12 +2108,24 @@ inline real real::binomial(const real &y) const
 			// due to potential rounding errors. We are attempting to err on the safe side by using pow()
 			// here.
 			const auto phase = math::pow(-1,(*this) + 1) / math::pow(-1,y + 1);
-			return detail::real_compute_3_gamma(-y,-(*this),(*this) - y + 1,max_prec) * phase;
+			auto &a = detail::mpfr_scratch(1u,w_prec), &b = detail::mpfr_scratch(2u,w_prec);
+			::mpfr_neg(&a,y.m_value,default_rnd);
+			::mpfr_neg(&b,m_value,default_rnd);
+			::mpfr_add_ui(&x_y,&x_y,1u,default_rnd);
+			real retval{0,w_prec};
+			detail::real_compute_3_gamma(*retval.m_value,a,b,x_y,w_prec);
+			return retval * phase;
 		}
 		case 5u:
 		{
 			const auto phase = math::pow(-1,(*this) - y + 1) / math::pow(-1,(*this) + 1);
-			return detail::real_compute_3_gamma(-((*this) - y),y + 1,-(*this),max_prec) * phase;
+			auto &b = detail::mpfr_scratch(1u,w_prec), &c = detail::mpfr_scratch(2u,w_prec);
+			::mpfr_neg(&x_y,&x_y,default_rnd);
+			::mpfr_add_ui(&b,y.m_value,1u,default_rnd);
+			::mpfr_neg(&c,m_value,default_rnd);
+			real retval{0,w_prec};
+			detail::real_compute_3_gamma(*retval.m_value,x_y,b,c,w_prec);
+			return retval * phase;
 		}
 	}
 	// Case 7 returns zero -> from inf / (inf * inf) it becomes a / (b * inf) after the transform.
@@ -31,6 +31,7 @@
 #include <limits>
 #include <stdexcept>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <utility>
@@ -105,9 +106,9 @@ namespace piranha
 //   the first element of the array. This should be quite fast, and it will provide enough information for the canon/compatibility.
 // - related to the above: we can embed the flavour as the first element of the kronecker array - at that point checking
 //   the flavour is just determining if the int value is even or odd.
-// - need to do some reasoning on the impact of the codification in a specialised fast poisson series multiplier: how do we deal
-//   with the canonical form without going through code/decode? if we require the last multiplier to be always positive (instead
-//   of the first), can we just check/flip the sign of the coded value?
+// - in the specialised Poisson series multiplier the canonical form is established directly on the coded values (see
+//   canonicalise_code()). If we required the last multiplier to be always positive (instead of the first), we could just
+//   check/flip the sign of the coded value.
 template <typename T = std::make_signed<std::size_t>::type>
 class real_trigonometric_kronecker_monomial
 {
@@ -194,6 +195,79 @@ class real_trigonometric_kronecker_monomial
 			}
 			return sign_change;
 		}
+		// Canonicalisation of a codified value, given the vector of component limits of the codification
+		// for the number of variables in the monomial (see kronecker_array::get_limits()).
+		// NOTE: the codification is a balanced mixed-radix representation in which the code of the null vector is zero. The
+		// components can then be extracted one at a time from the lowest one, and we can stop at the first nonzero component.
+		// Changing the sign of all the components amounts to changing the sign of the code.
+		static bool canonicalise_code(value_type &n, const std::vector<value_type> &minmax)
+		{
+			value_type rem = n;
+			for (const auto &m: minmax) {
+				if (rem == value_type(0)) {
+					break;
+				}
+				const auto radix = static_cast<value_type>(2 * m + 1);
+				// Balanced remainder: the value of the current component.
+				auto r = static_cast<value_type>(rem % radix);
+				if (r > m) {
+					r = static_cast<value_type>(r - radix);
+				} else if (r < -m) {
+					r = static_cast<value_type>(r + radix);
+				}
+				if (r > value_type(0)) {
+					return false;
+				}
+				if (r < value_type(0)) {
+					n = static_cast<value_type>(-n);
+					return true;
+				}
+				rem = static_cast<value_type>(rem / radix);
+			}
+			return false;
+		}
+		// Coefficient part of the multiplication of two terms, common to multiply() and multiply_packed().
+		template <typename Cf>
+		static void multiply_cfs(std::array<term<Cf,real_trigonometric_kronecker_monomial>,multiply_arity> &res,
+			const term<Cf,real_trigonometric_kronecker_monomial> &t1, const term<Cf,real_trigonometric_kronecker_monomial> &t2)
+		{
+			detail::cf_mult_impl(res[0u].m_cf,t1.m_cf,t2.m_cf);
+			res[1u].m_cf = res[0u].m_cf;
+			const bool f1 = t1.m_key.get_flavour(), f2 = t2.m_key.get_flavour();
+			if (f1 && f2) {
+				// cos, cos: no change.
+			} else if (!f1 && !f2) {
+				// sin, sin: negate the plus.
+				math::negate(res[0u].m_cf);
+			} else if (!f1 && f2) {
+				// sin, cos: no change.
+			} else {
+				// cos, sin: negate the minus.
+				math::negate(res[1u].m_cf);
+			}
+		}
+		// Assign the codified values of the keys of the multiplication of two terms, taking care of the sign changes
+		// due to canonicalisation.
+		template <typename Cf>
+		static void multiply_keys(std::array<term<Cf,real_trigonometric_kronecker_monomial>,multiply_arity> &res,
+			const term<Cf,real_trigonometric_kronecker_monomial> &t1, const term<Cf,real_trigonometric_kronecker_monomial> &t2,
+			const value_type &re_plus, const value_type &re_minus, bool sign_plus, bool sign_minus)
+		{
+			auto &retval_plus = res[0u].m_key;
+			auto &retval_minus = res[1u].m_key;
+			retval_plus.m_value = re_plus;
+			retval_minus.m_value = re_minus;
+			const bool f = (t1.m_key.get_flavour() == t2.m_key.get_flavour());
+			retval_plus.m_flavour = f;
+			retval_minus.m_flavour = f;
+			// If multiplier sign was changed and the result is a sine, negate the coefficient.
+			if (sign_plus && !f) {
+				math::negate(res[0u].m_cf);
+			}
+			if (sign_minus && !f) {
+				math::negate(res[1u].m_cf);
+			}
+		}
 		// Couple of helper functions for Vieta's formulae.
 		static value_type cos_phase(const value_type &n)
 		{
@@ -242,6 +316,18 @@ class real_trigonometric_kronecker_monomial
 		using degree_type = decltype(std::declval<const T &>() + std::declval<const T &>());
 		// Order utils.
 		using order_type = decltype(math::abs(std::declval<const T &>()) + math::abs(std::declval<const T &>()));
+		// Multipliers in evaluate(): convert them explicitly to floating-point evaluation types, so that the
+		// conversion is not left implicit in the multiplication.
+		template <typename U, typename std::enable_if<std::is_floating_point<U>::value,int>::type = 0>
+		static U eval_mult(const value_type &n)
+		{
+			return static_cast<U>(n);
+		}
+		template <typename U, typename std::enable_if<!std::is_floating_point<U>::value,int>::type = 0>
+		static const value_type &eval_mult(const value_type &n)
+		{
+			return n;
+		}
 #endif
 	public:
 		/// Default constructor.
@@ -681,23 +767,8 @@ class real_trigonometric_kronecker_monomial
 			const symbol_set &args)
 		{
 			// Coefficients first.
-			detail::cf_mult_impl(res[0u].m_cf,t1.m_cf,t2.m_cf);
-			res[1u].m_cf = res[0u].m_cf;
-			const bool f1 = t1.m_key.get_flavour(), f2 = t2.m_key.get_flavour();
-			if (f1 && f2) {
-				// cos, cos: no change.
-			} else if (!f1 && !f2) {
-				// sin, sin: negate the plus.
-				math::negate(res[0u].m_cf);
-			} else if (!f1 && f2) {
-				// sin, cos: no change.
-			} else {
-				// cos, sin: negate the minus.
-				math::negate(res[1u].m_cf);
-			}
+			multiply_cfs(res,t1,t2);
 			// Now the keys.
-			auto &retval_plus = res[0u].m_key;
-			auto &retval_minus = res[1u].m_key;
 			// Flags to signal if a sign change in the multipliers was needed as part of the canonicalization.
 			bool sign_plus = false, sign_minus = false;
 			const auto size = args.size();
@@ -718,18 +789,67 @@ class real_trigonometric_kronecker_monomial
 			sign_minus = canonicalise_impl(result_minus);
 			// Compute them before assigning, so in case of exceptions we do not touch the return values.
 			const auto re_plus = ka::encode(result_plus), re_minus = ka::encode(result_minus);
-			retval_plus.m_value = re_plus;
-			retval_minus.m_value = re_minus;
-			const bool f = (t1.m_key.get_flavour() == t2.m_key.get_flavour());
-			retval_plus.m_flavour = f;
-			retval_minus.m_flavour = f;
-			// If multiplier sign was changed and the result is a sine, negate the coefficient.
-			if (sign_plus && !res[0u].m_key.get_flavour()) {
-				math::negate(res[0u].m_cf);
+			multiply_keys(res,t1,t2,re_plus,re_minus,sign_plus,sign_minus);
+		}
+		/// Multiply terms with a trigonometric monomial, operating on the codified values.
+		/**
+		 * \note
+		 * This method is enabled only if the same conditions of multiply() hold.
+		 *
+		 * This method will compute the same result as multiply(), but without unpacking the keys of \p t1 and \p t2:
+		 * the codified values of the keys of the result are computed as the sum and difference of the codified values of
+		 * the keys of \p t1 and \p t2, and the canonical form is established by inspecting the codified values directly.
+		 * This is possible because the Kronecker codification is linear, as long as the multipliers of the results
+		 * are within the limits reported by piranha::kronecker_array::get_limits(). This method does not check
+		 * this condition, which must be verified by the caller (e.g., via check_multiply_packed()).
+		 *
+		 * @param[out] res result of the multiplication.
+		 * @param[in] t1 first argument.
+		 * @param[in] t2 second argument.
+		 * @param[in] args reference set of piranha::symbol.
+		 *
+		 * @throws unspecified any exception thrown by arithmetic operations and copy-assignment on the coefficient type,
+		 * or by piranha::math::negate().
+		 */
+		template <typename Cf, multiply_enabler<Cf> = 0>
+		static void multiply_packed(std::array<term<Cf,real_trigonometric_kronecker_monomial>,multiply_arity> &res,
+			const term<Cf,real_trigonometric_kronecker_monomial> &t1, const term<Cf,real_trigonometric_kronecker_monomial> &t2,
+			const symbol_set &args)
+		{
+			piranha_assert(args.size() < ka::get_limits().size());
+			const auto &minmax = std::get<0u>(ka::get_limits()[static_cast<size_type>(args.size())]);
+			multiply_cfs(res,t1,t2);
+			auto re_plus = static_cast<value_type>(t1.m_key.m_value + t2.m_key.m_value),
+				re_minus = static_cast<value_type>(t1.m_key.m_value - t2.m_key.m_value);
+			const bool sign_plus = canonicalise_code(re_plus,minmax), sign_minus = canonicalise_code(re_minus,minmax);
+			multiply_keys(res,t1,t2,re_plus,re_minus,sign_plus,sign_minus);
+		}
+		/// Check if the multiplication of two sets of monomials can be performed via multiply_packed().
+		/**
+		 * The multiplication of the monomials with multipliers bounded in absolute value by the elements of \p max1 by
+		 * the monomials with multipliers bounded in absolute value by the elements of \p max2 can be performed
+		 * via multiply_packed() if the sums of the bounds are within the limits of the Kronecker codification.
+		 *
+		 * @param[in] max1 the maximum absolute values of the multipliers in the first set of monomials.
+		 * @param[in] max2 the maximum absolute values of the multipliers in the second set of monomials.
+		 *
+		 * @return \p true if the multiplication can be performed via multiply_packed(), \p false otherwise.
+		 */
+		static bool check_multiply_packed(const v_type &max1, const v_type &max2)
+		{
+			const auto size = max1.size();
+			if (size != max2.size() || size >= ka::get_limits().size()) {
+				return false;
 			}
-			if (sign_minus && !res[1u].m_key.get_flavour()) {
-				math::negate(res[1u].m_cf);
+			const auto &minmax = std::get<0u>(ka::get_limits()[size]);
+			for (decltype(max1.size()) i = 0u; i < size; ++i) {
+				piranha_assert(max1[i] >= value_type(0) && max2[i] >= value_type(0));
+				// NOTE: the keys are valid, hence max1[i] is within the limits and minmax[i] - max1[i] does not overflow.
+				if (max1[i] > minmax[i] || max2[i] > static_cast<value_type>(minmax[i] - max1[i])) {
+					return false;
+				}
 			}
+			return true;
 		}
 		/// Hash value.
 		/**
@@ -1000,7 +1120,7 @@ class real_trigonometric_kronecker_monomial
 				// NOTE: here it might make sense to use multiply_accumulate. There might be a perf gain
 				// for things like real. Maybe fast FMA on Haswell too. Remember to adapt the type requirements
 				// in case we implement this.
-				tmp += it->second * v[i];
+				tmp += it->second * eval_mult<U>(v[i]);
 			}
 			piranha_assert(it == pmap.end());
 			if (get_flavour()) {
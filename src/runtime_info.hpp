@@ -23,6 +23,7 @@
 
 #if defined(__linux__)
 
+#include <algorithm>
 #include <boost/lexical_cast.hpp>
 #include <fstream>
 #include <iostream>
@@ -68,8 +69,10 @@ extern "C"
 #include <boost/numeric/conversion/cast.hpp>
 #include <memory>
 #include <thread>
+#include <vector>
 
 #include "config.hpp"
+#include "detail/gmp_allocator.hpp"
 #include "exceptions.hpp"
 #include "runtime_info.hpp"
 
@@ -79,15 +82,96 @@ namespace piranha
 namespace detail
 {
 
+#if defined(__linux__)
+
+// Parse a list of integers in the format used by the /sys filesystem (e.g., "0-3,8,10-11").
+// Will return an empty vector in case of parsing errors.
+inline std::vector<unsigned> parse_sys_list(const std::string &str)
+{
+	std::vector<unsigned> retval;
+	try {
+		std::string::size_type start = 0u;
+		while (start < str.size()) {
+			auto end = str.find(',',start);
+			if (end == std::string::npos) {
+				end = str.size();
+			}
+			const std::string item = str.substr(start,end - start);
+			const auto dash = item.find('-');
+			if (dash == std::string::npos) {
+				retval.push_back(boost::lexical_cast<unsigned>(item));
+			} else {
+				const auto a = boost::lexical_cast<unsigned>(item.substr(0u,dash)),
+					b = boost::lexical_cast<unsigned>(item.substr(dash + 1u));
+				for (auto i = a; i <= b; ++i) {
+					retval.push_back(i);
+					// NOTE: avoid wrapping around if b is the maximum unsigned.
+					if (i == b) {
+						break;
+					}
+				}
+			}
+			start = end + 1u;
+		}
+	} catch (...) {
+		return std::vector<unsigned>{};
+	}
+	return retval;
+}
+
+// Read the first line of a file in the /sys filesystem, stripped of whitespace at the end.
+inline std::string read_sys_line(const std::string &name)
+{
+	std::ifstream sys_file(name);
+	std::string line;
+	if (sys_file.is_open() && sys_file.good()) {
+		std::getline(sys_file,line);
+	}
+	while (!line.empty() && (line.back() == '\n' || line.back() == ' ')) {
+		line.pop_back();
+	}
+	return line;
+}
+
+#endif
+
+// Map logical processors to NUMA nodes.
+inline std::vector<unsigned> get_initial_numa_nodes()
+{
+	std::vector<unsigned> retval;
+#if defined(__linux__)
+	try {
+		const auto nodes = parse_sys_list(read_sys_line("/sys/devices/system/node/online"));
+		for (const auto &n: nodes) {
+			const auto cpus = parse_sys_list(read_sys_line("/sys/devices/system/node/node" +
+				boost::lexical_cast<std::string>(n) + "/cpulist"));
+			for (const auto &c: cpus) {
+				if (c >= retval.size()) {
+					retval.resize(c + 1u,0u);
+				}
+				retval[c] = n;
+			}
+		}
+	} catch (...) {
+		retval.clear();
+	}
+#endif
+	return retval;
+}
+
 template <typename = int>
 struct base_runtime_info
 {
-	static const std::thread::id m_main_thread_id;
+	static const std::thread::id		m_main_thread_id;
+	static const std::vector<unsigned>	m_numa_nodes;
 };
 
 template <typename T>
 const std::thread::id base_runtime_info<T>::m_main_thread_id = std::this_thread::get_id();
 
+template <typename T>
+const std::vector<unsigned> base_runtime_info<T>::m_numa_nodes = get_initial_numa_nodes();
+
 }
 
 /// Runtime information.
@@ -147,6 +231,61 @@ class runtime_info: private detail::base_runtime_info<>
 			return std::thread::hardware_concurrency();
 #endif
 		}
+		/// NUMA topology.
+		/**
+		 * The topology is determined once at program startup. On Linux, it is read from the <tt>/sys</tt> filesystem.
+		 * On other platforms, or if the detection fails, the returned vector will be empty.
+		 *
+		 * @return const reference to a vector whose <tt>i</tt>-th element is the index of the NUMA node to which the
+		 * <tt>i</tt>-th logical processor belongs.
+		 */
+		static const std::vector<unsigned> &get_numa_nodes()
+		{
+			return m_numa_nodes;
+		}
+		/// Number of GMP allocations.
+		/**
+		 * The statistics about GMP memory refer to the memory handled by the allocator installed via
+		 * piranha::environment::install_gmp_allocator(), and they are collected only while the allocator is installed.
+		 * In order to keep the overhead of bookkeeping low in multithreaded contexts, each thread accumulates its
+		 * statistics locally and adds them to the global values periodically (every few hundred operations, or whenever
+		 * the local balance of allocated memory exceeds 64 KB). The values returned by these methods are thus exact
+		 * only for the operations performed by the calling thread, which are always accounted for before the query.
+		 *
+		 * @return the total number of allocations and reallocations performed by the piranha GMP allocator.
+		 */
+		static unsigned long long get_gmp_allocations()
+		{
+			detail::gmp_alloc_flush_stats(detail::get_gmp_thread_cache());
+			return detail::base_gmp_allocator<>::s_n_allocs.load();
+		}
+		/// GMP memory in use.
+		/**
+		 * Memory allocated before the installation of the allocator and freed afterwards is subtracted from the total,
+		 * which is clamped to zero.
+		 *
+		 * @return the number of bytes currently allocated via the piranha GMP allocator.
+		 *
+		 * @see runtime_info::get_gmp_allocations() for a discussion of the accuracy of the statistics.
+		 */
+		static unsigned long long get_gmp_bytes()
+		{
+			detail::gmp_alloc_flush_stats(detail::get_gmp_thread_cache());
+			const auto retval = detail::base_gmp_allocator<>::s_bytes.load();
+			return retval < 0 ? 0u : static_cast<unsigned long long>(retval);
+		}
+		/// Peak GMP memory.
+		/**
+		 * @return the maximum value reached by runtime_info::get_gmp_bytes().
+		 *
+		 * @see runtime_info::get_gmp_allocations() for a discussion of the accuracy of the statistics.
+		 */
+		static unsigned long long get_gmp_peak_bytes()
+		{
+			detail::gmp_alloc_flush_stats(detail::get_gmp_thread_cache());
+			const auto retval = detail::base_gmp_allocator<>::s_peak.load();
+			return retval < 0 ? 0u : static_cast<unsigned long long>(retval);
+		}
 		/// Size of the data cache line.
 		/**
 		 * @return data cache line size (in bytes), or 0 if the value cannot be determined.
@@ -50,6 +50,8 @@
 #include "config.hpp"
 #include "convert_to.hpp"
 #include "debug_access.hpp"
+#include "detail/cf_kernels.hpp"
+#include "detail/pow_cache.hpp"
 #include "detail/sfinae_types.hpp"
 #include "detail/series_fwd.hpp"
 #include "environment.hpp"
@@ -795,27 +797,14 @@ class series_operators
 			// Create a copy of x and work on it. This is always possible.
 			ret_type retval(std::forward<T>(x));
 			// NOTE: x is not used any more.
-			const auto it_f = retval.m_container.end();
-			try {
-				for (auto it = retval.m_container.begin(); it != it_f;) {
-					// NOTE: here the original requirement is that cf / y is defined, but we know
-					// that cf / y results in another cf, and we assume always that cf /= y is exactly equivalent
-					// to cf = cf / y. And cf must be move-assignable. So this should be possible.
-					it->m_cf /= y;
-					// NOTE: no need to check for compatibility, as it depends only on the key type and here
-					// we are only acting on the coefficient.
-					if (unlikely(it->is_ignorable(retval.m_symbol_set))) {
-						// Erase will return the next iterator.
-						it = retval.m_container.erase(it);
-					} else {
-						++it;
-					}
-				}
-			} catch (...) {
-				// In case of errors clear out the series.
-				retval.m_container.clear();
-				throw;
-			}
+			// NOTE: here the original requirement is that cf / y is defined, but we know
+			// that cf / y results in another cf, and we assume always that cf /= y is exactly equivalent
+			// to cf = cf / y. And cf must be move-assignable. So this should be possible.
+			// NOTE: no need to check for compatibility, as it depends only on the key type and here
+			// we are only acting on the coefficient.
+			// In case of errors, the series will be cleared out.
+			detail::apply_cf_kernel(retval.m_container,detail::cf_div_kernel<typename ret_type::term_type::cf_type,
+				typename std::decay<U>::type>(y),retval.m_symbol_set);
 			return retval;
 		}
 		// NOTE: the trailing decltype() syntax is used here to make sure we can actually call the other overload of the function
@@ -1404,16 +1393,7 @@ class series: detail::series_tag, series_operators
 				// If we swapped the operands and a negative merge was performed, we need to change
 				// the signs of all coefficients.
 				if (swap && !Sign) {
-					const auto it_f2 = m_container.end();
-					for (auto it = m_container.begin(); it != it_f2;) {
-						math::negate(it->m_cf);
-						if (unlikely(it->is_ignorable(m_symbol_set))) {
-							// Erase the invalid term.
-							it = m_container.erase(it);
-						} else {
-							++it;
-						}
-					}
+					detail::apply_cf_kernel(m_container,detail::cf_negate_kernel<Cf>{},m_symbol_set);
 				}
 			} catch (...) {
 				// In case of any insertion error, zero out both series.
@@ -1804,17 +1784,111 @@ class series: detail::series_tag, series_operators
 			}
 		};
 		template <typename Series>
-		using pow_map_type = std::unordered_map<Series,std::vector<pow_m_type<Series>>,series_hasher,series_equal_to>;
+		using pow_cache_type = detail::pow_cache<Series,pow_m_type<Series>,series_hasher,series_equal_to>;
 		// NOTE: here, as in the custom derivative machinery, we need to pass through a static function
 		// to get the cache because Derived is an incomplete type and we cannot thus use a static data member
 		// involving Derived in series. Also, we need the Series template argument to inhibit the instantiation
 		// of the function for series types that do not support exponentiation.
 		template <typename Series = Derived>
-		static pow_map_type<Series> &get_pow_cache()
+		static pow_cache_type<Series> &get_pow_cache()
 		{
-			static pow_map_type<Series> s_pow_cache;
+			static pow_cache_type<Series> s_pow_cache;
 			return s_pow_cache;
 		}
+		// Exponentiation by squaring is available only if the product of two powers has the same type as the powers.
+		template <typename M, typename = void>
+		struct pow_can_square
+		{
+			static const bool value = false;
+		};
+		template <typename M>
+		struct pow_can_square<M,typename std::enable_if<std::is_same<decltype(std::declval<const M &>() * std::declval<const M &>()),M>::value>::type>
+		{
+			static const bool value = true;
+		};
+		template <typename M, typename std::enable_if<pow_can_square<M>::value,int>::type = 0>
+		static M pow_square(const M &p)
+		{
+			return p * p;
+		}
+		template <typename M, typename std::enable_if<!pow_can_square<M>::value,int>::type = 0>
+		static M pow_square(const M &)
+		{
+			piranha_assert(false);
+			return M{};
+		}
+		// Estimated size of the square of a series, via the size estimation of the series multiplier. A negative value
+		// is returned if the estimation is not available.
+		template <typename S, typename = void>
+		struct pow_has_size_estimate
+		{
+			static const bool value = false;
+		};
+		template <typename S>
+		struct pow_has_size_estimate<S,typename std::enable_if<std::is_constructible<series_multiplier<S>,const S &,const S &>::value &&
+			detail::true_tt<decltype(std::declval<const series_multiplier<S> &>().estimate_result_size())>::value>::type>
+		{
+			static const bool value = true;
+		};
+		template <typename S, typename std::enable_if<pow_has_size_estimate<S>::value,int>::type = 0>
+		static double pow_square_size_estimate(const S &s)
+		{
+			const series_multiplier<S> m(s,s);
+			return static_cast<double>(m.estimate_result_size());
+		}
+		template <typename S, typename std::enable_if<!pow_has_size_estimate<S>::value,int>::type = 0>
+		static double pow_square_size_estimate(const S &)
+		{
+			return -1.;
+		}
+		// Selection of the exponentiation strategy for the computation of the n-th power, when the highest cached power
+		// not greater than n is k0 (see tuning::get_pow_strategy()).
+		// NOTE: the size of the k-th power is modelled as s1 * k**a, where s1 is the size of the base and a is determined
+		// from the estimated size of the square. The cost of a multiplication is modelled as the product of the sizes of
+		// the operands, and the strategy with the lowest total cost is selected.
+		template <typename U = Derived>
+		pow_strategy select_pow_strategy_impl(const std::size_t &n, const std::size_t &k0) const
+		{
+			using m_type = pow_m_type<U>;
+			const auto s = tuning::get_pow_strategy();
+			if (!pow_can_square<m_type>::value || s == pow_strategy::multiplication) {
+				return pow_strategy::multiplication;
+			}
+			if (s == pow_strategy::squaring) {
+				return pow_strategy::squaring;
+			}
+			// NOTE: for exponents less than 4, the two strategies perform the same multiplications.
+			if (n < 4u || k0 + 1u >= n) {
+				return pow_strategy::multiplication;
+			}
+			const auto s1 = static_cast<double>(size()), s2 = pow_square_size_estimate(*static_cast<Derived const *>(this));
+			if (s1 <= 0. || s2 <= 0.) {
+				return pow_strategy::multiplication;
+			}
+			const double a = std::max(0.,std::log2(s2 / s1));
+			auto size_k = [s1,a](std::size_t k) {
+				return s1 * std::pow(static_cast<double>(k),a);
+			};
+			double c_sq = 0.;
+			unsigned n_bits = 0u;
+			for (auto m = n; m; m >>= 1u) {
+				++n_bits;
+			}
+			std::size_t p = 1u;
+			for (auto i = n_bits - 1u; i > 0u; --i) {
+				c_sq += size_k(p) * size_k(p);
+				p *= 2u;
+				if ((n >> (i - 1u)) & 1u) {
+					c_sq += size_k(p) * s1;
+					++p;
+				}
+			}
+			double c_mult = 0.;
+			for (auto k = std::max(k0,std::size_t(1u)); k < n && c_mult <= c_sq; ++k) {
+				c_mult += size_k(k) * s1;
+			}
+			return (c_sq < c_mult) ? pow_strategy::squaring : pow_strategy::multiplication;
+		}
 		// Empty for sfinae.
 		template <typename T, typename U, typename = void>
 		struct pow_ret_type_ {};
@@ -2079,20 +2153,7 @@ class series: detail::series_tag, series_operators
 		 */
 		void negate()
 		{
-			try {
-				const auto it_f = m_container.end();
-				for (auto it = m_container.begin(); it != it_f;) {
-					math::negate(it->m_cf);
-					if (unlikely(it->is_ignorable(m_symbol_set))) {
-						it = m_container.erase(it);
-					} else {
-						++it;
-					}
-				}
-			} catch (...) {
-				m_container.clear();
-				throw;
-			}
+			detail::apply_cf_kernel(m_container,detail::cf_negate_kernel<Cf>{},m_symbol_set);
 		}
 		/** @name Table-querying methods
 		 * Methods to query the properties of the internal container used to store the terms.
@@ -2144,11 +2205,16 @@ class series: detail::series_tag, series_operators
 		 * - if \p x is zero (as established by piranha::math::is_zero()), a series with a single term
 		 *   with unitary key and coefficient constructed from the integer numeral "1" is returned (i.e., any series raised to
 		 *   the power of zero is 1 - including empty series);
-		 * - if \p x represents a non-negative integral value, the return value is constructed via repeated multiplications;
+		 * - if \p x represents a non-negative integral value, the return value is constructed via repeated multiplications
+		 *   or exponentiation by squaring, as established by select_pow_strategy();
 		 * - otherwise, an exception will be raised.
 		 *
 		 * An internal thread-safe cache of natural powers of series is maintained in order to improve performance during, e.g., substitution operations.
-		 * This cache can be cleared with clear_pow_cache().
+		 * The cache is split in shards which are locked independently and only briefly, so that powers of different series can be computed
+		 * concurrently, while concurrent requests for the same power will wait for a single computation. When the estimated memory
+		 * footprint of the cache exceeds piranha::tuning::get_pow_cache_memory_limit(), the powers of the least recently used
+		 * series are evicted. The cache can be inspected with get_pow_cache_stats() and cleared with clear_pow_cache(). The intermediate
+		 * powers computed by exponentiation by squaring are stored in the cache as well.
 		 *
 		 * @param[in] x exponent.
 		 * 
@@ -2209,23 +2275,53 @@ class series: detail::series_tag, series_operators
 			if (n.sign() < 0) {
 				piranha_throw(std::invalid_argument,"invalid argument for series exponentiation: negative integral value");
 			}
-			// Lock the cache for the rest of the method.
-			std::lock_guard<std::mutex> lock(s_pow_mutex);
-			auto &v = get_pow_cache()[*static_cast<Derived const *>(this)];
-			using s_type = decltype(v.size());
-			// Init the vector, if needed.
-			if (!v.size()) {
+			const auto &d = *static_cast<Derived const *>(this);
+			auto init = []() -> m_type {
 				m_type tmp;
 				tmp.insert(m_term_type(m_cf_type(1),m_key_type(symbol_set{})));
-				v.push_back(std::move(tmp));
-			}
-			// Fill in the missing powers.
-			while (v.size() <= n) {
-				// NOTE: for series it seems like it is better to run the dumb algorithm instead of, e.g.,
-				// exponentiation by squaring - the growth in number of terms seems to be slower.
-				v.push_back(v.back() * (*static_cast<Derived const *>(this)));
+				return tmp;
+			};
+			auto next = [&d](const m_type &p) -> m_type {
+				return p * d;
+			};
+			auto square = [](const m_type &p) -> m_type {
+				return pow_square(p);
+			};
+			const auto nn = safe_cast<std::size_t>(n);
+			auto &cache = get_pow_cache();
+			const auto f = cache.get(d,nn,select_pow_strategy_impl(nn,cache.highest_cached(d,nn)),init,next,square);
+			return ret_type(f.get());
+		}
+		/// Exponentiation strategy.
+		/**
+		 * This method will return the algorithm that pow() would use to compute the natural power \p n of \p this,
+		 * given the current content of the cache of natural powers. If the strategy selected via piranha::tuning::set_pow_strategy() is
+		 * piranha::pow_strategy::automatic, the size of the <tt>k</tt>-th power is modelled as the size of \p this multiplied by <tt>k**a</tt>,
+		 * where \p a is determined from the estimated size of the square of \p this (see piranha::base_series_multiplier::estimate_result_size()).
+		 * The cost of each multiplication is modelled as the product of the sizes of the operands, and the strategy with the lowest total cost
+		 * (taking into account the powers already in the cache) is returned. Exponentiation by squaring is never selected if the product
+		 * of two powers of \p this is not of the same type as the powers, and for exponents less than 4 repeated
+		 * multiplication is always returned, as the two algorithms coincide.
+		 *
+		 * @param[in] n exponent.
+		 *
+		 * @return either piranha::pow_strategy::multiplication or piranha::pow_strategy::squaring.
+		 *
+		 * @throws std::invalid_argument if \p n is negative.
+		 * @throws unspecified any exception thrown by:
+		 * - piranha::safe_cast(),
+		 * - the construction of the series multiplier and its size estimation,
+		 * - hash() or is_identical(),
+		 * - threading primitives.
+		 */
+		template <typename U = Derived>
+		pow_strategy select_pow_strategy(const integer &n) const
+		{
+			if (n.sign() < 0) {
+				piranha_throw(std::invalid_argument,"invalid argument for series exponentiation: negative integral value");
 			}
-			return ret_type(v[static_cast<s_type>(n)]);
+			const auto nn = safe_cast<std::size_t>(n);
+			return select_pow_strategy_impl<U>(nn,get_pow_cache<U>().highest_cached(*static_cast<Derived const *>(this),nn));
 		}
 		/// Clear the internal cache of natural powers.
 		/**
@@ -2236,9 +2332,24 @@ class series: detail::series_tag, series_operators
 		template <typename T = Derived, is_identical_enabler<T> = 0>
 		static void clear_pow_cache()
 		{
-			std::lock_guard<std::mutex> lock(s_pow_mutex);
 			get_pow_cache().clear();
 		}
+		/// Statistics of the internal cache of natural powers.
+		/**
+		 * The returned piranha::pow_cache_stats contains the numbers of requests to the cache of natural powers maintained by
+		 * piranha::series::pow() that were served by powers already in the cache (hits) and that required the computation of new
+		 * powers (misses), the number of evictions, the number of series whose powers are in the cache and an estimate of
+		 * the memory footprint of the cache. The statistics are reset by clear_pow_cache().
+		 *
+		 * @return the statistics of the cache of natural powers.
+		 *
+		 * @throws unspecified any exception thrown by threading primitives.
+		 */
+		template <typename T = Derived, is_identical_enabler<T> = 0>
+		static pow_cache_stats get_pow_cache_stats()
+		{
+			return get_pow_cache().stats();
+		}
 		/// Partial derivative.
 		/**
 		 * \note
@@ -2879,17 +2990,12 @@ class series: detail::series_tag, series_operators
 	private:
 		// Custom derivatives machinery.
 		static std::mutex	s_cp_mutex;
-		// Pow cache machinery;
-		static std::mutex	s_pow_mutex;
 
 };
 
 template <typename Cf, typename Key, typename Derived>
 std::mutex series<Cf,Key,Derived>::s_cp_mutex;
 
-template <typename Cf, typename Key, typename Derived>
-std::mutex series<Cf,Key,Derived>::s_pow_mutex;
-
 /// Specialisation of piranha::print_coefficient_impl for series.
 /**
  * This specialisation is enabled if \p Series is an instance of piranha::series.
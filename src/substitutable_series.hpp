@@ -21,15 +21,22 @@
 #ifndef PIRANHA_SUBSTITUTABLE_SERIES_HPP
 #define PIRANHA_SUBSTITUTABLE_SERIES_HPP
 
+#include <algorithm>
+#include <map>
 #include <string>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
+#include "config.hpp"
 #include "forwarding.hpp"
 #include "math.hpp"
+#include "pow.hpp"
 #include "serialization.hpp"
 #include "series.hpp"
+#include "settings.hpp"
 #include "symbol_set.hpp"
+#include "thread_pool.hpp"
 #include "type_traits.hpp"
 
 namespace piranha
@@ -149,6 +156,100 @@ class substitutable_series: public Series, detail::substitutable_series_tag
 		template <typename T>
 		using subs_type = typename std::enable_if<std::is_constructible<subs_type_<T>,int>::value && is_addable_in_place<subs_type_<T>>::value,
 			subs_type_<T>>::type;
+		// Grouped substitution. This is available if the substitution happens only on the key, and if the key can be split
+		// into the exponent of the substituted symbol and the remaining part (via an extract_exponent() method).
+		template <typename Key>
+		using key_exponent_type = typename decltype(std::declval<const Key &>().extract_exponent(std::declval<const std::string &>(),
+			std::declval<const symbol_set &>()))::first_type;
+		template <typename T, typename Term, typename = void>
+		struct grouped_subs_enabled
+		{
+			static const bool value = false;
+		};
+		template <typename T, typename Term>
+		struct grouped_subs_enabled<T,Term,typename std::enable_if<subs_term_score<Term,T>::value == 2u &&
+			detail::true_tt<key_exponent_type<typename Term::key_type>>::value>::type>
+		{
+			using exp_type = key_exponent_type<typename Term::key_type>;
+			static const bool value = is_less_than_comparable<exp_type>::value &&
+				std::is_same<decltype(math::pow(std::declval<const T &>(),std::declval<const exp_type &>())),k_subs_type<T,Term>>::value;
+		};
+		// Sum the elements of v via a tree reduction. At each level, the pairwise additions are run in parallel
+		// if there is enough work.
+		template <typename U>
+		static U tree_sum(std::vector<U> &v)
+		{
+			using size_type = typename std::vector<U>::size_type;
+			if (v.empty()) {
+				return U(0);
+			}
+			while (v.size() > 1u) {
+				const size_type n_pairs = static_cast<size_type>(v.size() / 2u);
+				unsigned long long work = 0u;
+				for (const auto &s: v) {
+					work += static_cast<unsigned long long>(s.size());
+				}
+				const unsigned n_threads = work ? static_cast<unsigned>(std::min<unsigned long long>(n_pairs,
+					thread_pool::use_threads(work,settings::get_min_work_per_thread()))) : 1u;
+				auto f = [&v,n_pairs,n_threads](unsigned idx) {
+					for (size_type i = idx; i < n_pairs; i += n_threads) {
+						v[static_cast<size_type>(2u * i)] += std::move(v[static_cast<size_type>(2u * i + 1u)]);
+					}
+				};
+				if (n_threads == 1u) {
+					f(0u);
+				} else {
+					thread_pool::parallel_invoke(n_threads,f);
+				}
+				// Compact the partial sums at the beginning of the vector.
+				for (size_type i = 1u; i < n_pairs; ++i) {
+					v[i] = std::move(v[static_cast<size_type>(2u * i)]);
+				}
+				if (v.size() % 2u) {
+					v[n_pairs] = std::move(v.back());
+					v.resize(static_cast<size_type>(n_pairs + 1u));
+				} else {
+					v.resize(n_pairs);
+				}
+			}
+			return std::move(v[0u]);
+		}
+		// Term-by-term substitution.
+		template <typename T, typename std::enable_if<!grouped_subs_enabled<T,typename Series::term_type>::value,int>::type = 0>
+		subs_type<T> subs_impl(const std::string &name, const T &x) const
+		{
+			subs_type<T> retval(0);
+			for (const auto &t: this->m_container) {
+				retval += subs_term_impl(t,name,x,this->m_symbol_set);
+			}
+			return retval;
+		}
+		// Grouped substitution: the terms are grouped according to the exponent of the substituted symbol, each
+		// distinct power of x is computed once and multiplied by the group, and the results are summed via tree_sum().
+		template <typename T, typename std::enable_if<grouped_subs_enabled<T,typename Series::term_type>::value,int>::type = 0>
+		subs_type<T> subs_impl(const std::string &name, const T &x) const
+		{
+			using term_type = typename Series::term_type;
+			using exp_type = key_exponent_type<typename term_type::key_type>;
+			std::map<exp_type,Derived> groups;
+			for (const auto &t: this->m_container) {
+				auto p = t.m_key.extract_exponent(name,this->m_symbol_set);
+				auto it = groups.find(p.first);
+				if (it == groups.end()) {
+					Derived tmp;
+					tmp.set_symbol_set(this->m_symbol_set);
+					it = groups.insert(std::make_pair(std::move(p.first),std::move(tmp))).first;
+				}
+				it->second.insert(term_type{t.m_cf,std::move(p.second)});
+			}
+			std::vector<subs_type<T>> parts;
+			parts.reserve(groups.size());
+			for (auto &g: groups) {
+				// NOTE: if x is a series, the natural powers will be computed via the cache in piranha::series::pow().
+				parts.push_back(std::move(g.second) * math::pow(x,g.first));
+			}
+			return tree_sum(parts);
+		}
 	public:
 		/// Defaulted default constructor.
 		substitutable_series() = default;
@@ -179,6 +280,12 @@ class substitutable_series: public Series, detail::substitutable_series_tag
 		 * This method will return an object resulting from the substitution of the symbol called \p name
 		 * in \p this with the generic object \p x.
 		 *
+		 * If the substitution involves only the keys, and the key type provides an <tt>extract_exponent()</tt> method
+		 * (e.g., piranha::monomial and piranha::kronecker_monomial), the terms of \p this are first grouped according to the
+		 * exponent of \p name. Each distinct power of \p x is then computed only once via piranha::math::pow() and multiplied
+		 * by its group, and the products are summed via a tree reduction which is run in parallel if there is enough work
+		 * (see piranha::settings::get_min_work_per_thread()). Otherwise, the substitution is performed term by term.
+		 *
 		 * @param[in] name name of the symbol to be substituted.
 		 * @param[in] x object used for the substitution.
 		 *
@@ -187,16 +294,15 @@ class substitutable_series: public Series, detail::substitutable_series_tag
 		 * @throws unspecified any exception resulting from:
 		 * - the substitution routines for the coefficients and/or keys,
 		 * - the computation of the return value,
-		 * - piranha::series::insert().
+		 * - piranha::series::insert(),
+		 * - the <tt>extract_exponent()</tt> method of the key type,
+		 * - memory errors in standard containers,
+		 * - thread_pool::use_threads() and thread_pool::parallel_invoke().
 		 */
 		template <typename T>
 		subs_type<T> subs(const std::string &name, const T &x) const
 		{
-			subs_type<T> retval(0);
-			for (const auto &t: this->m_container) {
-				retval += subs_term_impl(t,name,x,this->m_symbol_set);
-			}
-			return retval;
+			return subs_impl(name,x);
 		}
 };
 
@@ -142,7 +142,7 @@ class symbol: private detail::base_symbol<>
 		/**
 		 * @return a hash value for the symbol.
 		 */
-		std::size_t hash() const
+		std::size_t hash() const noexcept
 		{
 			return std::hash<std::string const *>()(m_ptr);
 		}
@@ -216,7 +216,7 @@ struct hash<piranha::symbol>
 	 * 
 	 * @return piranha::symbol::hash().
 	 */
-	result_type operator()(const argument_type &s) const
+	result_type operator()(const argument_type &s) const noexcept
 	{
 		return s.hash();
 	}
@@ -22,14 +22,16 @@
 #define PIRANHA_THREAD_POOL_HPP
 
 #include <algorithm>
+#include <atomic>
 #include <condition_variable>
 #include <cstdlib>
+#include <exception>
 #include <functional>
 #include <future>
+#include <limits>
 #include <list>
 #include <memory>
 #include <mutex>
-#include <queue>
 #include <stdexcept>
 #include <thread>
 #include <type_traits>
@@ -50,8 +52,252 @@ namespace piranha
 namespace detail
 {
 
+// Index of the task queue served by the calling thread. For threads not belonging to the pool,
+// the value is the maximum unsigned.
+inline unsigned &pool_thread_index()
+{
+	static thread_local unsigned idx = std::numeric_limits<unsigned>::max();
+	return idx;
+}
+
+// Base class for the tasks consumed by the threads in the pool. Tasks are linked intrusively
+// into the task queues, and they are run via a plain function pointer.
+// A task is referenced both by the queue it was pushed into and by the parallel region (the
+// piranha::future_list or the parallel_invoke() call) which submitted it. The thread waiting for the
+// completion of a region can claim and run in place the tasks of the region which were not started yet,
+// while the consumer of the queue will skip them: in this way a waiting thread never runs unrelated tasks.
+// The task is destroyed when both references have been released.
+struct task_node
+{
+	// Set up the references and the claim flag before the task is pushed into a queue.
+	void reset()
+	{
+		m_claimed.store(false,std::memory_order_relaxed);
+		m_refs.store(2u,std::memory_order_relaxed);
+	}
+	// Returns true if the calling thread is the one which must run the task.
+	bool claim()
+	{
+		return !m_claimed.exchange(true);
+	}
+	void release()
+	{
+		if (m_refs.fetch_sub(1u) == 1u) {
+			m_destroy(this);
+		}
+	}
+	std::atomic<task_node *>	m_next;
+	std::atomic<bool>		m_claimed;
+	std::atomic<unsigned>		m_refs;
+	void				(*m_run)(task_node *);
+	void				(*m_destroy)(task_node *);
+};
+
+// Reference to a task held by the parallel region which submitted it.
+class task_handle
+{
+	public:
+		task_handle():m_task(nullptr) {}
+		explicit task_handle(task_node *t):m_task(t) {}
+		task_handle(const task_handle &) = delete;
+		task_handle(task_handle &&other) noexcept:m_task(other.m_task)
+		{
+			other.m_task = nullptr;
+		}
+		task_handle &operator=(const task_handle &) = delete;
+		task_handle &operator=(task_handle &&other) noexcept
+		{
+			if (this != &other) {
+				reset();
+				m_task = other.m_task;
+				other.m_task = nullptr;
+			}
+			return *this;
+		}
+		~task_handle()
+		{
+			reset();
+		}
+		// Run the task in the calling thread, if it was not started yet.
+		void try_run() const
+		{
+			if (m_task != nullptr && m_task->claim()) {
+				m_task->m_run(m_task);
+			}
+		}
+		void reset()
+		{
+			if (m_task != nullptr) {
+				m_task->release();
+				m_task = nullptr;
+			}
+		}
+	private:
+		task_node *m_task;
+};
+
+// Task wrapping a packaged task, allocated on submission.
+template <typename P>
+struct packaged_task_node: task_node
+{
+	explicit packaged_task_node(P &&p):m_p(std::move(p))
+	{
+		m_run = &run;
+		m_destroy = &destroy;
+	}
+	static void run(task_node *n)
+	{
+		auto t = static_cast<packaged_task_node *>(n);
+		t->m_p();
+		// Destroy the callable and its arguments as soon as possible, the node might
+		// be kept alive for a while by the submitting region.
+		t->m_p = P{};
+	}
+	static void destroy(task_node *n)
+	{
+		::delete static_cast<packaged_task_node *>(n);
+	}
+	P m_p;
+};
+
+// Completion latch: counts down the number of tasks still to be completed, and stores the first
+// exception thrown by the tasks.
+class task_latch
+{
+	public:
+		explicit task_latch(unsigned n):m_count(n),m_done(n == 0u) {}
+		task_latch(const task_latch &) = delete;
+		task_latch(task_latch &&) = delete;
+		task_latch &operator=(const task_latch &) = delete;
+		task_latch &operator=(task_latch &&) = delete;
+		void count_down()
+		{
+			if (m_count.fetch_sub(1u) == 1u) {
+				// NOTE: the notification happens with the mutex locked, so that the latch
+				// can be safely destroyed by the waiter as soon as it sees m_done.
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_done = true;
+				m_cond.notify_all();
+			}
+		}
+		void set_exception(std::exception_ptr e)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!m_exc) {
+				m_exc = e;
+			}
+		}
+		// Wait for the completion of the tasks, and re-throw the first exception thrown by the tasks (if any).
+		void wait_and_rethrow()
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_cond.wait(lock,[this]() {return m_done;});
+			if (m_exc) {
+				std::rethrow_exception(m_exc);
+			}
+		}
+	private:
+		std::atomic<unsigned>	m_count;
+		bool			m_done;
+		std::exception_ptr	m_exc;
+		std::mutex		m_mutex;
+		std::condition_variable	m_cond;
+};
+
+// Task counting down a latch on completion. These tasks are kept in per-thread pools
+// and reused across submissions.
+struct latch_task_node: task_node
+{
+	latch_task_node()
+	{
+		m_run = &run;
+		m_destroy = &destroy;
+	}
+	static void run(task_node *n)
+	{
+		auto t = static_cast<latch_task_node *>(n);
+		try {
+			t->m_f(t->m_ctx,t->m_idx);
+		} catch (...) {
+			t->m_latch->set_exception(std::current_exception());
+		}
+		t->m_latch->count_down();
+	}
+	// NOTE: defined below, the node goes back to the pool of the thread releasing it last.
+	static void destroy(task_node *);
+	void			(*m_f)(const void *, unsigned);
+	const void		*m_ctx;
+	unsigned		m_idx;
+	task_latch		*m_latch;
+	latch_task_node		*m_pool_next;
+};
+
+// Per-thread pool of latch tasks.
+class latch_task_pool
+{
+		// NOTE: this is a tuning parameter, the maximum number of tasks kept in a pool.
+		static const unsigned max_size = 1024u;
+	public:
+		latch_task_pool():m_head(nullptr),m_size(0u) {}
+		latch_task_pool(const latch_task_pool &) = delete;
+		latch_task_pool &operator=(const latch_task_pool &) = delete;
+		~latch_task_pool()
+		{
+			while (m_head != nullptr) {
+				auto next = m_head->m_pool_next;
+				::delete m_head;
+				m_head = next;
+			}
+		}
+		latch_task_node *get()
+		{
+			if (m_head == nullptr) {
+				return ::new latch_task_node;
+			}
+			auto retval = m_head;
+			m_head = m_head->m_pool_next;
+			--m_size;
+			return retval;
+		}
+		void put(latch_task_node *t)
+		{
+			if (m_size == max_size) {
+				::delete t;
+				return;
+			}
+			t->m_pool_next = m_head;
+			m_head = t;
+			++m_size;
+		}
+	private:
+		latch_task_node	*m_head;
+		unsigned	m_size;
+};
+
+inline latch_task_pool &get_latch_task_pool()
+{
+	static thread_local latch_task_pool pool;
+	return pool;
+}
+
+inline void latch_task_node::destroy(task_node *n)
+{
+	get_latch_task_pool().put(static_cast<latch_task_node *>(n));
+}
+
+// NUMA node of the n-th thread in the pool. The n-th thread is bound, if possible, to the n-th logical processor.
+// If the topology is not available, zero will be returned.
+inline unsigned thread_numa_node(unsigned n)
+{
+	const auto &nodes = runtime_info::get_numa_nodes();
+	return (n < nodes.size()) ? nodes[n] : 0u;
+}
+
 // Task queue class. Inspired by:
 // https://github.com/progschj/ThreadPool
+// The tasks are stored in an intrusive lock-free multiple-producer single-consumer queue, adapted from:
+// http://www.1024cores.net/home/lock-free-algorithms/queues/intrusive-mpsc-node-based-queue
+// The mutex and the condition variable are used only to put to sleep the thread when there are no tasks to consume.
 class task_queue
 {
 		struct runner
@@ -59,6 +305,7 @@ class task_queue
 			runner(task_queue *ptr, unsigned n):m_ptr(ptr),m_n(n) {}
 			void operator()() const
 			{
+				pool_thread_index() = m_n;
 				// Don't stop if we cannot bind.
 				try {
 					thread_management::bind_to_proc(m_n);
@@ -67,30 +314,36 @@ class task_queue
 				}
 				try {
 					while (true) {
+						auto task = m_ptr->try_pop();
+						if (task != nullptr) {
+							// NOTE: the task might have been already run by the thread waiting
+							// for its completion.
+							if (task->claim()) {
+								task->m_run(task);
+							}
+							task->release();
+							continue;
+						}
 						std::unique_lock<std::mutex> lock(m_ptr->m_mutex);
-						while (!m_ptr->m_stop && m_ptr->m_tasks.empty()) {
-							// Need to wait for something to happen only if the task
-							// list is empty and we are not stopping.
-							// NOTE: wait will be noexcept in C++14.
-							m_ptr->m_cond.wait(lock);
+						m_ptr->m_sleeping.store(true);
+						if (m_ptr->m_size.load() != 0u) {
+							// There are tasks in the queue, but they are being pushed. Try again.
+							m_ptr->m_sleeping.store(false);
+							lock.unlock();
+							std::this_thread::yield();
+							continue;
 						}
-						if (m_ptr->m_stop && m_ptr->m_tasks.empty()) {
+						if (m_ptr->m_stop.load()) {
 							// If the stop flag was set, and we do not have more tasks,
 							// just exit.
 							break;
 						}
-						// NOTE: move constructor of std::function could throw, unfortunately.
-						std::function<void()> task(std::move(m_ptr->m_tasks.front()));
-						m_ptr->m_tasks.pop();
-						lock.unlock();
-						task();
+						// NOTE: wait will be noexcept in C++14.
+						m_ptr->m_cond.wait(lock);
+						m_ptr->m_sleeping.store(false);
 					}
 				} catch (...) {
-					// The errors we could get here are:
-					// - threading primitives,
-					// - move-construction of std::function,
-					// - queue popping (I guess unlikely, as the destructor of std::function
-					//   is noexcept).
+					// The errors we could get here are from threading primitives.
 					// In any case, not much that can be done to recover from this, better to abort.
 					// NOTE: logging candidate.
 					std::abort();
@@ -101,9 +354,47 @@ class task_queue
 			task_queue	*m_ptr;
 			const unsigned	m_n;
 		};
+		// Link a node at the head of the queue.
+		void link(task_node *n)
+		{
+			n->m_next.store(nullptr,std::memory_order_relaxed);
+			auto prev = m_head.exchange(n,std::memory_order_acq_rel);
+			prev->m_next.store(n,std::memory_order_release);
+		}
+		// Unlink a node from the tail of the queue.
+		task_node *unlink()
+		{
+			task_node *tail = m_tail, *next = tail->m_next.load(std::memory_order_acquire);
+			if (tail == &m_stub) {
+				if (next == nullptr) {
+					return nullptr;
+				}
+				m_tail = next;
+				tail = next;
+				next = next->m_next.load(std::memory_order_acquire);
+			}
+			if (next != nullptr) {
+				m_tail = next;
+				return tail;
+			}
+			if (tail != m_head.load(std::memory_order_acquire)) {
+				// A producer is in the middle of a push.
+				return nullptr;
+			}
+			link(&m_stub);
+			next = tail->m_next.load(std::memory_order_acquire);
+			if (next != nullptr) {
+				m_tail = next;
+				return tail;
+			}
+			return nullptr;
+		}
 	public:
-		task_queue(unsigned n):m_stop(false)
+		task_queue(unsigned n):m_head(&m_stub),m_tail(&m_stub),m_size(0u),m_stop(false),m_sleeping(false)
 		{
+			m_stub.m_next.store(nullptr);
+			m_stub.m_run = nullptr;
+			m_stub.m_destroy = nullptr;
 			m_thread.reset(::new std::thread(runner{this,n}));
 		}
 		~task_queue()
@@ -116,24 +407,55 @@ class task_queue
 				std::abort();
 			}
 		}
+		// Push a task into the queue. The queue takes ownership of the task.
+		void push(task_node *t)
+		{
+			m_size.fetch_add(1u);
+			link(t);
+			if (m_sleeping.load()) {
+				// NOTE: locking the mutex guarantees that the consumer thread is either waiting
+				// on the condition variable or it will see the new task.
+				{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				}
+				// NOTE: notify_one is noexcept.
+				m_cond.notify_one();
+			}
+		}
+		// Try to extract a task from the queue, without waiting. If the queue is empty, nullptr will be returned.
+		// NOTE: this must be called only by the thread consuming the queue.
+		task_node *try_pop()
+		{
+			auto retval = unlink();
+			if (retval != nullptr) {
+				m_size.fetch_sub(1u);
+			}
+			return retval;
+		}
+		// Enqueue a task, returning its future together with a handle to the task.
 		template <typename F, typename ... Args>
-		auto enqueue(F &&f, Args && ... args) -> std::future<decltype(f(args...))>
+		auto enqueue_task(F &&f, Args && ... args) -> std::pair<std::future<decltype(f(args...))>,task_handle>
 		{
 			using f_ret_type = decltype(f(args...));
 			using p_task_type = std::packaged_task<f_ret_type()>;
-			auto task = std::make_shared<p_task_type>(std::bind(std::forward<F>(f),std::forward<Args>(args)...));
-			std::future<f_ret_type> res = task->get_future();
-			{
-			std::unique_lock<std::mutex> lock(m_mutex);
-			if (m_stop) {
+			using node_type = packaged_task_node<p_task_type>;
+			if (m_stop.load()) {
 				// Enqueueing is not allowed if the queue is stopped.
 				piranha_throw(std::runtime_error,"cannot enqueue task while task queue is stopping");
 			}
-			m_tasks.push([task](){(*task)();});
-			}
-			// NOTE: notify_one is noexcept.
-			m_cond.notify_one();
-			return res;
+			std::unique_ptr<node_type> node(::new node_type(p_task_type(std::bind(std::forward<F>(f),std::forward<Args>(args)...))));
+			std::future<f_ret_type> res = node->m_p.get_future();
+			node->reset();
+			auto ptr = node.release();
+			task_handle h(ptr);
+			push(ptr);
+			return std::make_pair(std::move(res),std::move(h));
+		}
+		// Enqueue a task, returning only its future.
+		template <typename F, typename ... Args>
+		auto enqueue(F &&f, Args && ... args) -> std::future<decltype(f(args...))>
+		{
+			return std::move(enqueue_task(std::forward<F>(f),std::forward<Args>(args)...).first);
 		}
 		// NOTE: we call this only from dtor, it is here in order to be able to test it.
 		// So the exception handling in dtor will suffice, keep it in mind if things change.
@@ -141,11 +463,11 @@ class task_queue
 		{
 			{
 			std::unique_lock<std::mutex> lock(m_mutex);
-			if (m_stop) {
+			if (m_stop.load()) {
 				// Already stopped.
 				return;
 			}
-			m_stop = true;
+			m_stop.store(true);
 			}
 			// Notify the thread that queue has been stopped, wait for it
 			// to consume the remaining tasks and exit.
@@ -153,11 +475,15 @@ class task_queue
 			m_thread->join();
 		}
 	private:
-		bool					m_stop;
-		std::condition_variable			m_cond;
-		std::mutex				m_mutex;
-		std::queue<std::function<void()>>	m_tasks;
-		std::unique_ptr<std::thread>		m_thread;
+		task_node			m_stub;
+		std::atomic<task_node *>	m_head;
+		task_node			*m_tail;
+		std::atomic<unsigned long>	m_size;
+		std::atomic<bool>		m_stop;
+		std::atomic<bool>		m_sleeping;
+		std::condition_variable		m_cond;
+		std::mutex			m_mutex;
+		std::unique_ptr<std::thread>	m_thread;
 };
 
 inline std::vector<std::unique_ptr<task_queue>> get_initial_thread_queues()
@@ -201,6 +527,12 @@ std::mutex thread_pool_base<T>::s_mutex;
  * This class provides methods to enqueue arbitray tasks to the threads in the pool, query the size of the pool
  * and resize the pool. All methods, unless otherwise specified, are thread-safe, and they provide the strong
  * exception safety guarantee.
+ *
+ * Tasks can be enqueued from any thread, including the threads in the pool. A thread waiting for the completion
+ * of a parallel region (that is, the tasks submitted via parallel_invoke() or the tasks whose futures are stored
+ * in a piranha::future_list) will run in place the tasks of the region which have not been started yet,
+ * so that parallel regions can be nested and started concurrently from different threads without deadlocking.
+ * A waiting thread never runs tasks belonging to other parallel regions.
  */
 // \todo work around MSVC bug in destruction of statically allocated threads (if needed once we support MSVC), as per:
 // http://stackoverflow.com/questions/10915233/stdthreadjoin-hangs-if-called-after-main-exits-when-using-vs2012-rc
@@ -214,6 +546,23 @@ class thread_pool_: private detail::thread_pool_base<>
 		template <typename Int>
 		using use_threads_enabler = typename std::enable_if<(std::is_integral<Int>::value && std::is_unsigned<Int>::value) ||
 			std::is_same<Int,integer>::value,int>::type;
+		static void give_back(detail::latch_task_pool &pool, detail::latch_task_node *tasks)
+		{
+			while (tasks != nullptr) {
+				auto next = tasks->m_pool_next;
+				pool.put(tasks);
+				tasks = next;
+			}
+		}
+		// Release the references to the tasks held by the submitting thread.
+		static void release(detail::latch_task_node *tasks)
+		{
+			while (tasks != nullptr) {
+				auto next = tasks->m_pool_next;
+				tasks->release();
+				tasks = next;
+			}
+		}
 	public:
 		/// Append task
 		/**
@@ -247,6 +596,114 @@ class thread_pool_: private detail::thread_pool_base<>
 			}
 			return base::s_queues[static_cast<size_type>(n)]->enqueue(std::forward<F>(f),std::forward<Args>(args)...);
 		}
+		/// Append task to a parallel region.
+		/**
+		 * \note
+		 * This method is enabled only if the expression <tt>f(args...)</tt> is well-formed.
+		 *
+		 * This method is equivalent to enqueue(), but the returned future is paired with an opaque handle to the task.
+		 * The pair is meant to be inserted into a piranha::future_list via piranha::future_list::push_back(): while waiting
+		 * on the future, the piranha::future_list will run the task in place if it was not started yet by the pool.
+		 *
+		 * @param[in] n index of the thread that will consume the task.
+		 * @param[in] f callable object representing the task.
+		 * @param[in] args arguments to \p f.
+		 *
+		 * @return an <tt>std::pair</tt> containing an <tt>std::future</tt> that will store the result of <tt>f(args...)</tt>
+		 * and a handle to the task.
+		 *
+		 * @throws std::invalid_argument if the thread index is equal to or larger than the current pool size.
+		 * @throws unspecified any exception thrown by:
+		 * - threading primitives,
+		 * - memory allocation errors,
+		 * - the constructors of \p f or \p args.
+		 */
+		template <typename F, typename ... Args>
+		static auto enqueue_task(unsigned n, F &&f, Args && ... args) ->
+			decltype(base::s_queues[0u]->enqueue_task(std::forward<F>(f),std::forward<Args>(args)...))
+		{
+			std::lock_guard<std::mutex> lock(s_mutex);
+			using size_type = decltype(base::s_queues.size());
+			if (n >= s_queues.size()) {
+				piranha_throw(std::invalid_argument,"thread index is out of range");
+			}
+			return base::s_queues[static_cast<size_type>(n)]->enqueue_task(std::forward<F>(f),std::forward<Args>(args)...);
+		}
+		/// Run tasks in parallel.
+		/**
+		 * This method will call <tt>f(i)</tt> for each \p i in the <tt>[0,n)</tt> range, assigning the <tt>i</tt>-th call to
+		 * the <tt>i</tt>-th thread in the pool, and it will wait for the completion of all the calls. While waiting, the calling
+		 * thread will run in place the calls which have not been started yet by the threads in the pool.
+		 *
+		 * This is a low-overhead alternative to enqueue() and piranha::future_list: the tasks are submitted to the lock-free
+		 * queues of the threads under a single acquisition of the pool's mutex, the task objects are drawn from a per-thread
+		 * pool and reused, and the completion is tracked by a latch instead of futures.
+		 * If any call to \p f throws, the method will re-throw the first exception after all the calls have completed.
+		 *
+		 * @param[in] n number of tasks to run.
+		 * @param[in] f callable object representing the tasks.
+		 *
+		 * @throws std::invalid_argument if \p n is zero or larger than the current pool size.
+		 * @throws unspecified any exception thrown by:
+		 * - threading primitives,
+		 * - memory allocation errors,
+		 * - the calls to \p f.
+		 */
+		template <typename F>
+		static void parallel_invoke(unsigned n, F &&f)
+		{
+			using f_type = typename std::remove_reference<F>::type;
+			if (unlikely(n == 0u)) {
+				piranha_throw(std::invalid_argument,"the number of tasks must be strictly positive");
+			}
+			auto &pool = detail::get_latch_task_pool();
+			// Fetch the task objects from the pool, and set them up.
+			detail::latch_task_node *tasks = nullptr;
+			try {
+				for (unsigned i = 0u; i < n; ++i) {
+					auto t = pool.get();
+					t->m_f = [](const void *ctx, unsigned idx) {
+						(*const_cast<f_type *>(static_cast<const f_type *>(ctx)))(idx);
+					};
+					t->m_ctx = static_cast<const void *>(std::addressof(f));
+					t->m_idx = n - i - 1u;
+					t->reset();
+					t->m_pool_next = tasks;
+					tasks = t;
+				}
+			} catch (...) {
+				give_back(pool,tasks);
+				throw;
+			}
+			detail::task_latch latch(n);
+			{
+				std::unique_lock<std::mutex> lock(s_mutex);
+				using size_type = decltype(base::s_queues.size());
+				if (n > s_queues.size()) {
+					lock.unlock();
+					give_back(pool,tasks);
+					piranha_throw(std::invalid_argument,"thread index is out of range");
+				}
+				// NOTE: after this point nothing can throw.
+				for (auto t = tasks; t != nullptr; t = t->m_pool_next) {
+					t->m_latch = &latch;
+					base::s_queues[static_cast<size_type>(t->m_idx)]->push(t);
+				}
+			}
+			// Run the calls not started yet, then wait for the others.
+			for (auto t = tasks; t != nullptr; t = t->m_pool_next) {
+				if (t->claim()) {
+					t->m_run(t);
+				}
+			}
+			try {
+				latch.wait_and_rethrow();
+			} catch (...) {
+				release(tasks);
+				throw;
+			}
+			release(tasks);
+		}
 		/// Size
 		/**
 		 * @return the number of threads in the pool.
@@ -278,7 +735,6 @@ class thread_pool_: private detail::thread_pool_base<>
 			if (unlikely(new_size == 0u)) {
 				piranha_throw(std::invalid_argument,"cannot resize the thread pool to zero");
 			}
-			std::lock_guard<std::mutex> lock(s_mutex);
 			using size_type = decltype(base::s_queues.size());
 			const size_type new_s = static_cast<size_type>(new_size);
 			if (unlikely(new_s != new_size)) {
@@ -289,11 +745,16 @@ class thread_pool_: private detail::thread_pool_base<>
 			for (size_type i = 0u; i < new_s; ++i) {
 				new_queues.emplace_back(::new detail::task_queue(static_cast<unsigned>(i)));
 			}
-			// NOTE: here the allocator is not swapped, as std::allocator won't propagate on swap.
-			// Besides, all instances of std::allocator are equal, so the operation is well-defined.
-			// http://en.cppreference.com/w/cpp/container/vector/swap
-			// If an exception gets actually thrown, no big deal.
-			new_queues.swap(base::s_queues);
+			{
+				std::lock_guard<std::mutex> lock(s_mutex);
+				// NOTE: here the allocator is not swapped, as std::allocator won't propagate on swap.
+				// Besides, all instances of std::allocator are equal, so the operation is well-defined.
+				// http://en.cppreference.com/w/cpp/container/vector/swap
+				// If an exception gets actually thrown, no big deal.
+				new_queues.swap(base::s_queues);
+			}
+			// NOTE: the old queues are destroyed here, outside the critical section, as the tasks
+			// still running in the old threads might need to access the pool.
 		}
 		/// Compute number of threads to use.
 		/**
@@ -303,8 +764,9 @@ class thread_pool_: private detail::thread_pool_base<>
 		 * This function computes the suggested number of threads to use, given an amount of total \p work_size units of work
 		 * and a minimum amount of work units per thread \p min_work_per_thread.
 		 * 
-		 * The returned value will always be 1 if the calling thread is not the main thread; otherwise, a number of threads
-		 * such that each thread has at least \p min_work_per_thread units of work to consume will be returned. In any case, the return
+		 * The returned value will be a number of threads such that each thread has at least \p min_work_per_thread units of work
+		 * to consume. The function can be called from any thread, including the threads in the pool: nested and concurrent parallel
+		 * regions are supported (see piranha::thread_pool_). In any case, the return
 		 * value is always greater than zero.
 		 * 
 		 * @param[in] work_size total number of work units.
@@ -325,10 +787,6 @@ class thread_pool_: private detail::thread_pool_base<>
 			if (unlikely(min_work_per_thread <= Int(0))) {
 				piranha_throw(std::invalid_argument,"invalid value for minimum work per thread");
 			}
-			// Don't use threads if we are not in the main thread.
-			if (std::this_thread::get_id() != runtime_info::get_main_thread_id()) {
-				return 1u;
-			}
 			std::lock_guard<std::mutex> lock(s_mutex);
 			const auto n_threads = static_cast<unsigned>(base::s_queues.size());
 			piranha_assert(n_threads);
@@ -352,6 +810,8 @@ using thread_pool = thread_pool_<>;
 /**
  * This class is a minimal thin wrapper around an \p std::list of \p std::future objects.
  * The class provides convenience methods to interact with the set of futures in an exception-safe manner.
+ * The futures returned by piranha::thread_pool_::enqueue_task() are inserted together with the handles to their tasks:
+ * when waiting on such a future, the task will be run in the waiting thread if it was not started yet by the pool.
  *
  * ## Type requirements ##
  *
@@ -365,17 +825,37 @@ template <typename F>
 class future_list
 {
 		PIRANHA_TT_CHECK(is_instance_of,F,std::future);
-		// Wait on a valid future, or abort.
-		static void wait_or_abort(const F &fut)
+		// Wait on a valid future, or abort. If the associated task was not started yet, it will be
+		// run in the calling thread.
+		static void wait_or_abort(const F &fut, const detail::task_handle &task)
 		{
 			piranha_assert(fut.valid());
 			try {
+				task.try_run();
 				fut.wait();
 			} catch (...) {
 				// TODO logging candidate, with info from exception.
 				std::abort();
 			}
 		}
+		void push_back_impl(F &&f, detail::task_handle &&task)
+		{
+			// Push back empty future.
+			try {
+				m_list.emplace_back();
+			} catch (...) {
+				// If we get some error here, we want to make sure we wait on the future
+				// before escaping out.
+				// NOTE: calling wait() on an invalid future is UB.
+				if (f.valid()) {
+					wait_or_abort(f,task);
+				}
+				throw;
+			}
+			// This cannot throw.
+			m_list.back().first = std::move(f);
+			m_list.back().second = std::move(task);
+		}
 	public:
 		/// Defaulted default constructor.
 		/**
@@ -410,20 +890,21 @@ class future_list
 		 */
 		void push_back(F &&f)
 		{
-			// Push back empty future.
-			try {
-				m_list.emplace_back();
-			} catch (...) {
-				// If we get some error here, we want to make sure we wait on the future
-				// before escaping out.
-				// NOTE: calling wait() on an invalid future is UB.
-				if (f.valid()) {
-					wait_or_abort(f);
-				}
-				throw;
-			}
-			// This cannot throw.
-			m_list.back() = std::move(f);
+			push_back_impl(std::move(f),detail::task_handle{});
+		}
+		/// Move-insert a future and the handle to its task.
+		/**
+		 * Will move-insert the future and the task handle in \p p, as returned by piranha::thread_pool_::enqueue_task(),
+		 * into the internal container. If the insertion fails due to memory allocation errors and the future is valid,
+		 * then the method will wait on the future (possibly running the task in the calling thread) before throwing the exception.
+		 *
+		 * @param[in] p future and task handle to be move-inserted.
+		 *
+		 * @throws unspecified any exception thrown by memory allocation errors.
+		 */
+		void push_back(std::pair<F,detail::task_handle> &&p)
+		{
+			push_back_impl(std::move(p.first),std::move(p.second));
 		}
 		/// Wait on all the futures.
 		/**
@@ -431,9 +912,9 @@ class future_list
 		 */
 		void wait_all()
 		{
-			for (auto &f: m_list) {
-				if (f.valid()) {
-					wait_or_abort(f);
+			for (auto &p: m_list) {
+				if (p.first.valid()) {
+					wait_or_abort(p.first,p.second);
 				}
 			}
 		}
@@ -446,15 +927,16 @@ class future_list
 		 */
 		void get_all()
 		{
-			for (auto &f: m_list) {
+			for (auto &p: m_list) {
 				// NOTE: std::future's valid() method is noexcept.
-				if (f.valid()) {
-					(void)f.get();
+				if (p.first.valid()) {
+					p.second.try_run();
+					(void)p.first.get();
 				}
 			}
 		}
 	private:
-		std::list<F> m_list;
+		std::list<std::pair<F,detail::task_handle>> m_list;
 };
 
 }
@@ -22,7 +22,12 @@
 #define PIRANHA_TUNING_HPP
 
 #include <atomic>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <mutex>
 #include <stdexcept>
+#include <utility>
 
 #include "config.hpp"
 #include "exceptions.hpp"
@@ -31,14 +36,82 @@
 namespace piranha
 {
 
+/// Methods for the estimation of the size of the result of series multiplications.
+/**
+ * @see piranha::tuning::get_size_estimator().
+ */
+enum class size_estimator
+{
+	/// Statistical estimate from the number of random term-by-term multiplications performed before finding the first duplicate term.
+	first_duplicate,
+	/// Distinct-count estimate of a random sample of term-by-term multiplications via a HyperLogLog sketch.
+	distinct_count,
+	/// Upper bound from the number of term-by-term multiplications and, where available, from the exponent ranges of the operands.
+	upper_bound
+};
+
+/// Algorithms for the multiplication of series with large integer coefficients.
+/**
+ * @see piranha::tuning::get_integer_multiplication().
+ */
+enum class integer_multiplication
+{
+	/// Multiply the coefficients directly.
+	standard,
+	/// Multiply the residues of the coefficients modulo a set of word-sized primes and reconstruct the result via the Chinese remainder theorem.
+	multi_modular
+};
+
+/// Algorithms for the computation of natural powers of series.
+/**
+ * @see piranha::tuning::get_pow_strategy().
+ */
+enum class pow_strategy
+{
+	/// Select the algorithm from the estimated sizes of the powers.
+	automatic,
+	/// Repeated multiplications by the base.
+	multiplication,
+	/// Exponentiation by squaring.
+	squaring
+};
+
+/// Size estimation record.
+/**
+ * This structure is passed to the size estimation hook (see piranha::tuning::set_size_estimation_hook())
+ * at the end of a series multiplication.
+ */
+struct size_estimation_record
+{
+	/// The method used for the estimation.
+	size_estimator	method;
+	/// Size of the first operand.
+	std::size_t	size1;
+	/// Size of the second operand.
+	std::size_t	size2;
+	/// The estimated size of the result.
+	std::size_t	estimate;
+	/// The actual size of the result.
+	std::size_t	actual;
+	/// Wall time spent computing the estimate, in seconds.
+	double		runtime;
+};
+
 namespace detail
 {
 
 template <typename = int>
 struct base_tuning
 {
-	static std::atomic<bool>	s_parallel_memory_set;
-	static std::atomic<unsigned>	s_mult_block_size;
+	static std::atomic<bool>					s_parallel_memory_set;
+	static std::atomic<unsigned>					s_mult_block_size;
+	static std::atomic<size_estimator>				s_size_estimator;
+	static std::mutex						s_hook_mutex;
+	static std::atomic<bool>					s_has_hook;
+	static std::function<void(const size_estimation_record &)>	s_hook;
+	static std::atomic<integer_multiplication>			s_integer_multiplication;
+	static std::atomic_ullong					s_pow_cache_memory_limit;
+	static std::atomic<pow_strategy>				s_pow_strategy;
 };
 
 template <typename T>
@@ -47,6 +120,27 @@ std::atomic<bool> base_tuning<T>::s_parallel_memory_set(true);
 template <typename T>
 std::atomic<unsigned> base_tuning<T>::s_mult_block_size(256u);
 
+template <typename T>
+std::atomic<size_estimator> base_tuning<T>::s_size_estimator(size_estimator::first_duplicate);
+
+template <typename T>
+std::mutex base_tuning<T>::s_hook_mutex;
+
+template <typename T>
+std::atomic<bool> base_tuning<T>::s_has_hook(false);
+
+template <typename T>
+std::function<void(const size_estimation_record &)> base_tuning<T>::s_hook;
+
+template <typename T>
+std::atomic<integer_multiplication> base_tuning<T>::s_integer_multiplication(integer_multiplication::standard);
+
+template <typename T>
+std::atomic_ullong base_tuning<T>::s_pow_cache_memory_limit(std::numeric_limits<unsigned long long>::max());
+
+template <typename T>
+std::atomic<pow_strategy> base_tuning<T>::s_pow_strategy(pow_strategy::automatic);
+
 }
 
 /// Performance tuning.
@@ -133,6 +227,219 @@ class tuning: private detail::base_tuning<>
 		 {
 			s_mult_block_size.store(256u);
 		 }
+		/// Get the size estimator.
+		/**
+		 * Before performing a series multiplication, Piranha estimates the size of the result in order to
+		 * allocate the memory for it in one go. This flag selects the estimation method:
+		 * - piranha::size_estimator::first_duplicate performs a few trials of random term-by-term multiplications,
+		 *   and derives the estimate from the number of multiplications performed before finding the first duplicate term.
+		 *   It is cheap, but it tends to underestimate results with a very uneven distribution of the terms;
+		 * - piranha::size_estimator::distinct_count performs a fixed number of random term-by-term multiplications, counts
+		 *   the distinct terms generated with a HyperLogLog sketch and extrapolates the count to the full multiplication.
+		 *   It is more expensive but more stable than the first method;
+		 * - piranha::size_estimator::upper_bound does not perform any term-by-term multiplication, and returns
+		 *   the number of term-by-term multiplications, further limited (for polynomials with Kronecker monomials)
+		 *   by the ranges of the exponents of the operands. It never underestimates, but it can overestimate by large factors.
+		 *
+		 * The default value of this flag is piranha::size_estimator::first_duplicate.
+		 *
+		 * @return the current size estimator.
+		 */
+		static size_estimator get_size_estimator()
+		{
+			return s_size_estimator.load();
+		}
+		/// Set the size estimator.
+		/**
+		 * @see piranha::tuning::get_size_estimator() for an explanation of the meaning of this value.
+		 *
+		 * @param[in] e the desired size estimator.
+		 *
+		 * @throws std::invalid_argument if \p e is not a valid enumerator of piranha::size_estimator.
+		 */
+		static void set_size_estimator(size_estimator e)
+		{
+			if (unlikely(e != size_estimator::first_duplicate && e != size_estimator::distinct_count &&
+				e != size_estimator::upper_bound))
+			{
+				piranha_throw(std::invalid_argument,"invalid size estimator");
+			}
+			s_size_estimator.store(e);
+		}
+		/// Reset the size estimator.
+		/**
+		 * This method will reset the size estimator to its default value.
+		 *
+		 * @see piranha::tuning::get_size_estimator() for an explanation of the meaning of this value.
+		 */
+		static void reset_size_estimator()
+		{
+			s_size_estimator.store(size_estimator::first_duplicate);
+		}
+		/// Set the size estimation hook.
+		/**
+		 * The hook will be called at the end of each series multiplication for which a size estimation was performed,
+		 * with a piranha::size_estimation_record containing the estimated and actual sizes of the result, and the time spent
+		 * computing the estimate. The hook might be called concurrently from multiple threads, and it must not throw.
+		 *
+		 * @param[in] hook the desired size estimation hook. An empty function object disables the hook.
+		 *
+		 * @throws unspecified any exception thrown by threading primitives.
+		 */
+		static void set_size_estimation_hook(std::function<void(const size_estimation_record &)> hook)
+		{
+			std::lock_guard<std::mutex> lock(s_hook_mutex);
+			s_has_hook.store(static_cast<bool>(hook));
+			s_hook = std::move(hook);
+		}
+		/// Reset the size estimation hook.
+		/**
+		 * After a call to this method, no hook will be called at the end of series multiplications.
+		 *
+		 * @throws unspecified any exception thrown by threading primitives.
+		 */
+		static void reset_size_estimation_hook()
+		{
+			set_size_estimation_hook(std::function<void(const size_estimation_record &)>{});
+		}
+		/// Get the size estimation hook.
+		/**
+		 * @return a copy of the current size estimation hook (an empty function object if no hook is set).
+		 *
+		 * @throws unspecified any exception thrown by threading primitives or by the copy constructor of \p std::function.
+		 */
+		static std::function<void(const size_estimation_record &)> get_size_estimation_hook()
+		{
+			if (!s_has_hook.load()) {
+				return std::function<void(const size_estimation_record &)>{};
+			}
+			std::lock_guard<std::mutex> lock(s_hook_mutex);
+			return s_hook;
+		}
+		/// Get the integer multiplication algorithm.
+		/**
+		 * This flag selects the algorithm used in the multiplication of polynomials with piranha::mp_integer coefficients
+		 * and Kronecker monomials:
+		 * - piranha::integer_multiplication::standard multiplies and accumulates the coefficients directly;
+		 * - piranha::integer_multiplication::multi_modular bounds the size of the coefficients of the result, performs
+		 *   the multiplication modulo a number of word-sized primes large enough to represent any coefficient of the result
+		 *   and reconstructs the coefficients via the Chinese remainder theorem. The modular multiplications avoid any multiprecision
+		 *   arithmetic in the inner loop, which pays off when the coefficients of the operands span several limbs. If the
+		 *   bound on the coefficients exceeds an implementation-defined limit, the standard algorithm is used.
+		 *
+		 * The default value of this flag is piranha::integer_multiplication::standard.
+		 *
+		 * @return the current integer multiplication algorithm.
+		 */
+		static integer_multiplication get_integer_multiplication()
+		{
+			return s_integer_multiplication.load();
+		}
+		/// Set the integer multiplication algorithm.
+		/**
+		 * @see piranha::tuning::get_integer_multiplication() for an explanation of the meaning of this value.
+		 *
+		 * @param[in] m the desired integer multiplication algorithm.
+		 *
+		 * @throws std::invalid_argument if \p m is not a valid enumerator of piranha::integer_multiplication.
+		 */
+		static void set_integer_multiplication(integer_multiplication m)
+		{
+			if (unlikely(m != integer_multiplication::standard && m != integer_multiplication::multi_modular)) {
+				piranha_throw(std::invalid_argument,"invalid integer multiplication algorithm");
+			}
+			s_integer_multiplication.store(m);
+		}
+		/// Reset the integer multiplication algorithm.
+		/**
+		 * This method will reset the integer multiplication algorithm to its default value.
+		 *
+		 * @see piranha::tuning::get_integer_multiplication() for an explanation of the meaning of this value.
+		 */
+		static void reset_integer_multiplication()
+		{
+			s_integer_multiplication.store(integer_multiplication::standard);
+		}
+		/// Get the memory limit of the natural power caches.
+		/**
+		 * piranha::series::pow() caches the natural powers of the series it computes. When the estimated memory footprint
+		 * of the cache of a series type exceeds this limit, the powers of the least recently used bases are evicted from the cache.
+		 * The limit applies separately to the cache of each series type.
+		 *
+		 * The default value of this flag is the maximum value representable by <tt>unsigned long long</tt> (i.e., no limit).
+		 *
+		 * @return the current memory limit of the natural power caches, in bytes.
+		 */
+		static unsigned long long get_pow_cache_memory_limit()
+		{
+			return s_pow_cache_memory_limit.load();
+		}
+		/// Set the memory limit of the natural power caches.
+		/**
+		 * @see piranha::tuning::get_pow_cache_memory_limit() for an explanation of the meaning of this value.
+		 *
+		 * @param[in] limit the desired memory limit, in bytes.
+		 */
+		static void set_pow_cache_memory_limit(unsigned long long limit)
+		{
+			s_pow_cache_memory_limit.store(limit);
+		}
+		/// Reset the memory limit of the natural power caches.
+		/**
+		 * This method will reset the memory limit of the natural power caches to its default value.
+		 *
+		 * @see piranha::tuning::get_pow_cache_memory_limit() for an explanation of the meaning of this value.
+		 */
+		static void reset_pow_cache_memory_limit()
+		{
+			s_pow_cache_memory_limit.store(std::numeric_limits<unsigned long long>::max());
+		}
+		/// Get the exponentiation strategy.
+		/**
+		 * This flag selects the algorithm used by piranha::series::pow() to compute natural powers of series:
+		 * - piranha::pow_strategy::multiplication computes the powers via repeated multiplications by the base, starting
+		 *   from the highest power already in the cache. The number of terms of the operands grows slowly, which makes
+		 *   this method preferable for series whose size grows quickly with the exponent (e.g., multivariate polynomials);
+		 * - piranha::pow_strategy::squaring uses exponentiation by squaring, which needs only a logarithmic number of
+		 *   multiplications but multiplies larger operands. It is preferable when the size of the powers is bounded
+		 *   (e.g., truncated power series) or grows slowly (e.g., Poisson series with few terms);
+		 * - piranha::pow_strategy::automatic models the growth of the size of the powers from the estimated size of the
+		 *   square of the base (see piranha::base_series_multiplier::estimate_result_size()), and selects the method with the
+		 *   lowest estimated cost (see piranha::series::select_pow_strategy()).
+		 *
+		 * The default value of this flag is piranha::pow_strategy::automatic.
+		 *
+		 * @return the current exponentiation strategy.
+		 */
+		static pow_strategy get_pow_strategy()
+		{
+			return s_pow_strategy.load();
+		}
+		/// Set the exponentiation strategy.
+		/**
+		 * @see piranha::tuning::get_pow_strategy() for an explanation of the meaning of this value.
+		 *
+		 * @param[in] s the desired exponentiation strategy.
+		 *
+		 * @throws std::invalid_argument if \p s is not a valid enumerator of piranha::pow_strategy.
+		 */
+		static void set_pow_strategy(pow_strategy s)
+		{
+			if (unlikely(s != pow_strategy::automatic && s != pow_strategy::multiplication && s != pow_strategy::squaring)) {
+				piranha_throw(std::invalid_argument,"invalid exponentiation strategy");
+			}
+			s_pow_strategy.store(s);
+		}
+		/// Reset the exponentiation strategy.
+		/**
+		 * This method will reset the exponentiation strategy to its default value.
+		 *
+		 * @see piranha::tuning::get_pow_strategy() for an explanation of the meaning of this value.
+		 */
+		static void reset_pow_strategy()
+		{
+			s_pow_strategy.store(pow_strategy::automatic);
+		}
 };
 
 }
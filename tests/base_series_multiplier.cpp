@@ -91,15 +91,19 @@ struct m_checker: public base_series_multiplier<Series>
 		std::unordered_set<const typename T::term_type *> h1, h2;
 		std::transform(s1._container().begin(),s1._container().end(),std::inserter(h1,h1.begin()),[](const typename T::term_type &t){return &t;});
 		std::transform(s2._container().begin(),s2._container().end(),std::inserter(h2,h2.begin()),[](const typename T::term_type &t){return &t;});
+		// If all the coefficients are integral, the original terms are used directly.
+		const auto is_int = [](const typename T::term_type &t) {return t.m_cf.den() == 1;};
+		const bool all_int = std::all_of(s1._container().begin(),s1._container().end(),is_int) &&
+			std::all_of(s2._container().begin(),s2._container().end(),is_int);
 		for (size_type i = 0u; i != s1.size(); ++i) {
-			BOOST_CHECK(h1.find(this->m_v1[i]) == h1.end());
+			BOOST_CHECK((h1.find(this->m_v1[i]) == h1.end()) != all_int);
 			BOOST_CHECK(this->m_v1[i]->m_cf.den() == 1);
 			auto it = s1._container().find(*this->m_v1[i]);
 			BOOST_CHECK(it != s1._container().end());
 			BOOST_CHECK(this->m_v1[i]->m_cf.num() % it->m_cf.num() == 0);
 		}
 		for (size_type i = 0u; i != s2.size(); ++i) {
-			BOOST_CHECK(h2.find(this->m_v2[i]) == h2.end());
+			BOOST_CHECK((h2.find(this->m_v2[i]) == h2.end()) != all_int);
 			BOOST_CHECK(this->m_v2[i]->m_cf.den() == 1);
 			auto it = s2._container().find(*this->m_v2[i]);
 			BOOST_CHECK(it != s2._container().end());
@@ -136,6 +140,7 @@ struct m_checker: public base_series_multiplier<Series>
 	{
 		return this->m_n_threads;
 	}
+	using p_mult = typename base::template plain_multiplier<false>;
 };
 
 BOOST_AUTO_TEST_CASE(base_series_multiplier_constructor_test)
@@ -160,6 +165,19 @@ BOOST_AUTO_TEST_CASE(base_series_multiplier_constructor_test)
 	s2 = 0;
 	m_checker<pt> m2(s1,s2);
 	BOOST_CHECK_THROW(m_checker<pt>(x,z),std::invalid_argument);
+	// Integral coefficients only.
+	m_checker<pt> m3((x+y).pow(5),(x-y).pow(6));
+	// Check the renormalisation with multiple threads.
+	settings::set_min_work_per_thread(1u);
+	s1 = (x/2+y/5+z/7).pow(10);
+	s2 = (x/3+y/22-z).pow(12);
+	for (unsigned nt = 1u; nt <= 4u; ++nt) {
+		settings::set_n_threads(nt);
+		m_checker<pt> m4(s1,s2);
+		m_checker<pt> m5(s1,(x+y-z).pow(3));
+	}
+	settings::reset_n_threads();
+	settings::reset_min_work_per_thread();
 	}
 	{
 	using pt = p_type<integer>;
@@ -401,6 +419,85 @@ BOOST_AUTO_TEST_CASE(base_series_multiplier_estimate_final_series_size_test)
 	settings::reset_n_threads();
 }
 
+BOOST_AUTO_TEST_CASE(base_series_multiplier_size_estimators_test)
+{
+	using pt = p_type<integer>;
+	using mt = m_checker<pt>;
+	using kpt = polynomial<integer,k_monomial>;
+	settings::set_min_work_per_thread(1u);
+	std::vector<size_estimation_record> records;
+	tuning::set_size_estimation_hook([&records](const size_estimation_record &r) {
+		records.push_back(r);
+	});
+	pt x{"x"}, y{"y"}, z{"z"};
+	kpt kx{"x"}, ky{"y"}, kz{"z"};
+	const auto a = (x + y + 1).pow(3), b = (x + 2 * y + 3).pow(3), c = (x + y + z + 1).pow(10), d = c + x.pow(20);
+	const auto ka = (kx + ky + 1).pow(3), kb = (kx + 2 * ky + 3).pow(3);
+	pt::size_type est_ref = 0u;
+	for (auto nt = 1u; nt < 4u; ++nt) {
+		settings::set_n_threads(nt);
+		// Upper bound.
+		tuning::set_size_estimator(size_estimator::upper_bound);
+		{
+		mt m0(a,b);
+		BOOST_CHECK_EQUAL((m0.estimate_final_series_size<1u,mt::p_mult>()),100u);
+		BOOST_CHECK_EQUAL((m0.estimate_final_series_size<2u,mt::p_mult>()),200u);
+		BOOST_CHECK_EQUAL((m0.estimate_final_series_size<1u,mt::p_mult>(l_functor_0{3u})),30u);
+		BOOST_CHECK_EQUAL((m0.estimate_final_series_size<1u,mt::p_mult>(l_functor_0{0u})),1u);
+		}
+		// Distinct count, with all the multiplications performed.
+		tuning::set_size_estimator(size_estimator::distinct_count);
+		{
+		mt m0(a,b);
+		const auto est = m0.estimate_final_series_size<1u,mt::p_mult>();
+		BOOST_CHECK(est >= 25u && est <= 32u);
+		BOOST_CHECK_EQUAL((m0.estimate_final_series_size<1u,mt::p_mult>(l_functor_0{0u})),1u);
+		}
+		// Distinct count, with sampling. The estimate should not depend on the number of threads.
+		{
+		mt m0(c,d);
+		const auto est = m0.estimate_final_series_size<1u,mt::p_mult>();
+		const auto actual = (c * d).size();
+		BOOST_CHECK(est >= actual / 4u && est <= actual * 4u);
+		if (nt == 1u) {
+			est_ref = est;
+		}
+		BOOST_CHECK_EQUAL(est,est_ref);
+		}
+		// Check the hook.
+		for (auto se: {size_estimator::first_duplicate,size_estimator::distinct_count,size_estimator::upper_bound}) {
+			tuning::set_size_estimator(se);
+			records.clear();
+			const auto r = c * d;
+			BOOST_CHECK_EQUAL(records.size(),1u);
+			BOOST_CHECK(records[0u].method == se);
+			BOOST_CHECK_EQUAL(records[0u].size1,287u);
+			BOOST_CHECK_EQUAL(records[0u].size2,286u);
+			BOOST_CHECK_EQUAL(records[0u].actual,r.size());
+			BOOST_CHECK(records[0u].estimate >= 1u);
+			BOOST_CHECK(records[0u].runtime >= 0.);
+			if (se == size_estimator::upper_bound) {
+				BOOST_CHECK_EQUAL(records[0u].estimate,287u * 286u);
+			}
+			// Kronecker monomials: the upper bound is refined via the exponent ranges.
+			records.clear();
+			const auto kr = ka * kb;
+			BOOST_CHECK_EQUAL(records.size(),1u);
+			BOOST_CHECK_EQUAL(records[0u].actual,kr.size());
+			if (se == size_estimator::upper_bound) {
+				BOOST_CHECK_EQUAL(records[0u].estimate,49u);
+			}
+		}
+	}
+	tuning::reset_size_estimation_hook();
+	records.clear();
+	(void)(c * d);
+	BOOST_CHECK(records.empty());
+	tuning::reset_size_estimator();
+	settings::reset_n_threads();
+	settings::reset_min_work_per_thread();
+}
+
 BOOST_AUTO_TEST_CASE(base_series_multiplier_sanitise_series_test)
 {
 	using pt = p_type<integer>;
@@ -0,0 +1,321 @@
+/***************************************************************************
+ *   Copyright (C) 2009-2011 by Francesco Biscani                          *
+ *   bluescarni@gmail.com                                                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "../src/double_double.hpp"
+
+#define BOOST_TEST_MODULE double_double_test
+#include <boost/test/unit_test.hpp>
+
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/lexical_cast.hpp>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include "../src/environment.hpp"
+#include "../src/is_cf.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/math.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/mp_rational.hpp"
+#include "../src/poisson_series.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/pow.hpp"
+#include "../src/real.hpp"
+#include "../src/safe_cast.hpp"
+#include "../src/type_traits.hpp"
+
+static std::mt19937 rng;
+static const int ntries = 1000;
+
+using namespace piranha;
+
+using dd = double_double;
+
+// Random double_double in ]-1,1[ using all the bits of both components.
+static dd random_dd()
+{
+	std::uniform_real_distribution<double> dist(-1.,1.);
+	dd retval(dist(rng));
+	retval += std::ldexp(dist(rng),-53);
+	return retval;
+}
+
+// Check that x approximates r with a relative error not greater than 2**-n_bits.
+static bool check_rel_error(const dd &x, const real &r, int n_bits)
+{
+	if (r.sign() == 0) {
+		return x.is_zero();
+	}
+	real diff = static_cast<real>(x) - r;
+	diff = diff.abs() / r.abs();
+	return diff <= real{std::ldexp(1.,-n_bits)};
+}
+
+static real to_real(const dd &x)
+{
+	return static_cast<real>(x);
+}
+
+BOOST_AUTO_TEST_CASE(double_double_constructors_test)
+{
+	environment env;
+	BOOST_CHECK(is_cf<dd>::value);
+	BOOST_CHECK(dd{}.is_zero());
+	BOOST_CHECK_EQUAL(dd{}.hi(),0.);
+	BOOST_CHECK_EQUAL(dd{}.lo(),0.);
+	BOOST_CHECK_EQUAL(dd{42}.hi(),42.);
+	BOOST_CHECK_EQUAL(dd{-1.5f}.hi(),-1.5);
+	BOOST_CHECK_EQUAL(dd{0.1}.hi(),0.1);
+	BOOST_CHECK_EQUAL(dd{0.1}.lo(),0.);
+	// Integers wider than the significand of double.
+	const long long n = (1ll << 62) + 1;
+	BOOST_CHECK_EQUAL(dd{n}.hi(),std::ldexp(1.,62));
+	BOOST_CHECK_EQUAL(dd{n}.lo(),1.);
+	BOOST_CHECK_EQUAL(static_cast<long long>(dd{n}),n);
+	const integer big = integer(2).pow(100) + 3;
+	BOOST_CHECK_EQUAL(dd{big}.hi(),std::ldexp(1.,100));
+	BOOST_CHECK_EQUAL(dd{big}.lo(),3.);
+	BOOST_CHECK_EQUAL(static_cast<integer>(dd{big}),big);
+	BOOST_CHECK_EQUAL(static_cast<integer>(-dd{big}),-big);
+	// Rationals and strings are rounded to the nearest double_double.
+	BOOST_CHECK(check_rel_error(dd{rational(1,3)},real{1} / 3,106));
+	BOOST_CHECK(check_rel_error(dd{"0.1"},real{"0.1",200},106));
+	BOOST_CHECK(check_rel_error(dd{std::string("-1.234567890123456789012345678901234e-10")},
+		real{"-1.234567890123456789012345678901234e-10",200},106));
+	BOOST_CHECK(dd{"0.1"}.lo() != 0.);
+	BOOST_CHECK_THROW(dd{"foo"},std::invalid_argument);
+	// Conversion from and to real.
+	const real r_pi = real{0}.pi();
+	const dd d_pi(r_pi);
+	BOOST_CHECK_EQUAL(d_pi.hi(),static_cast<double>(r_pi));
+	BOOST_CHECK(check_rel_error(d_pi,r_pi,106));
+	BOOST_CHECK_EQUAL(dd{static_cast<real>(d_pi)},d_pi);
+	// Exact conversion to rational.
+	const dd third = dd{1} / 3;
+	BOOST_CHECK_EQUAL(static_cast<rational>(third),rational(third.hi()) + rational(third.lo()));
+	// Truncation in the conversion to integral types.
+	BOOST_CHECK_EQUAL(static_cast<int>(dd{5} - dd{"1e-25"}),4);
+	BOOST_CHECK_EQUAL(static_cast<int>(dd{-5} + dd{"1e-25"}),-4);
+	BOOST_CHECK_EQUAL(static_cast<double>(third),1. / 3.);
+	// Assignment.
+	dd x;
+	x = 3;
+	BOOST_CHECK_EQUAL(x,3);
+	x = big;
+	BOOST_CHECK_EQUAL(x,big);
+	x = d_pi;
+	BOOST_CHECK_EQUAL(x,d_pi);
+}
+
+BOOST_AUTO_TEST_CASE(double_double_arithmetic_test)
+{
+	for (int i = 0; i < ntries; ++i) {
+		const dd a = random_dd(), b = random_dd();
+		const real ra = to_real(a), rb = to_real(b);
+		BOOST_CHECK(check_rel_error(a + b,ra + rb,104));
+		BOOST_CHECK(check_rel_error(a - b,ra - rb,104));
+		BOOST_CHECK(check_rel_error(a * b,ra * rb,104));
+		BOOST_CHECK(check_rel_error(a / b,ra / rb,103));
+		BOOST_CHECK(check_rel_error(a * 3,ra * 3,104));
+		BOOST_CHECK(check_rel_error(3 * a,ra * 3,104));
+		BOOST_CHECK(check_rel_error(a / 7.,ra / 7,103));
+		BOOST_CHECK(check_rel_error(1 - a,1 - ra,104));
+		BOOST_CHECK(check_rel_error(2. / a,2 / ra,103));
+		BOOST_CHECK(check_rel_error(a + integer(2).pow(70),ra + integer(2).pow(70),104));
+		BOOST_CHECK(check_rel_error(a * rational(1,3),ra * rational(1,3),103));
+		dd c(a);
+		c += b;
+		BOOST_CHECK_EQUAL(c,a + b);
+		c -= b;
+		BOOST_CHECK(check_rel_error(c,ra,100));
+		c = a;
+		c *= b;
+		BOOST_CHECK_EQUAL(c,a * b);
+		c /= b;
+		BOOST_CHECK(check_rel_error(c,ra,100));
+		c = a;
+		c.multiply_accumulate(b,b);
+		BOOST_CHECK(check_rel_error(c,ra + rb * rb,100));
+		math::multiply_accumulate(c,a,b);
+		BOOST_CHECK(check_rel_error(c,ra + rb * rb + ra * rb,98));
+	}
+	// Cancellation.
+	const dd x = dd{1} + std::ldexp(1. / 3.,-60);
+	BOOST_CHECK_EQUAL(x.lo(),std::ldexp(1. / 3.,-60));
+	BOOST_CHECK_EQUAL(x - 1,std::ldexp(1. / 3.,-60));
+	BOOST_CHECK_EQUAL(x - x.lo(),1);
+	BOOST_CHECK_EQUAL(dd{"0.1"} * 10 - 1 + 1,1);
+	// Identity and negation.
+	BOOST_CHECK_EQUAL(+x,x);
+	BOOST_CHECK_EQUAL(-(-x),x);
+	BOOST_CHECK_EQUAL((-x).lo(),-x.lo());
+	// Division by zero.
+	BOOST_CHECK(std::isinf((dd{1} / dd{0}).hi()));
+	BOOST_CHECK(std::isinf((dd{1} / 0).hi()));
+	// Types.
+	BOOST_CHECK((std::is_same<decltype(dd{} + 1),dd>::value));
+	BOOST_CHECK((std::is_same<decltype(1. * dd{}),dd>::value));
+	BOOST_CHECK((std::is_same<decltype(integer{} - dd{}),dd>::value));
+	BOOST_CHECK((std::is_same<decltype(dd{} / rational{1}),dd>::value));
+	BOOST_CHECK((!is_addable<dd,real>::value));
+	BOOST_CHECK((!is_addable<dd,std::string>::value));
+}
+
+BOOST_AUTO_TEST_CASE(double_double_comparison_test)
+{
+	const dd one(1), eps(std::ldexp(1.,-80));
+	BOOST_CHECK(one + eps != one);
+	BOOST_CHECK(one < one + eps);
+	BOOST_CHECK(one - eps < one);
+	BOOST_CHECK(one + eps > one);
+	BOOST_CHECK(one <= one);
+	BOOST_CHECK(one >= one);
+	BOOST_CHECK(one == 1);
+	BOOST_CHECK(1. == one);
+	BOOST_CHECK(integer(1) == one);
+	BOOST_CHECK(one + eps > 1);
+	BOOST_CHECK(2 > one + eps);
+	BOOST_CHECK(one + eps != rational(1));
+	BOOST_CHECK(dd{(1ll << 62) + 1} > (1ll << 62));
+	BOOST_CHECK_EQUAL(one.sign(),1);
+	BOOST_CHECK_EQUAL((-one).sign(),-1);
+	BOOST_CHECK_EQUAL(dd{}.sign(),0);
+}
+
+BOOST_AUTO_TEST_CASE(double_double_math_test)
+{
+	const dd x = dd{1} / 3;
+	const real rx = to_real(x);
+	BOOST_CHECK(math::is_zero(dd{}));
+	BOOST_CHECK(!math::is_zero(x));
+	BOOST_CHECK(math::is_unitary(dd{1}));
+	BOOST_CHECK(!math::is_unitary(dd{1} + std::ldexp(1.,-80)));
+	dd y(x);
+	math::negate(y);
+	BOOST_CHECK_EQUAL(y,-x);
+	BOOST_CHECK_EQUAL(math::abs(y),x);
+	BOOST_CHECK_EQUAL(math::abs(x),x);
+	BOOST_CHECK_EQUAL(math::partial(x,"x"),0);
+	BOOST_CHECK_EQUAL(math::evaluate(x,std::unordered_map<std::string,dd>{}),x);
+	// Pow.
+	BOOST_CHECK_EQUAL(math::pow(x,0),1);
+	BOOST_CHECK_EQUAL(math::pow(x,1),x);
+	BOOST_CHECK(check_rel_error(math::pow(x,7),rx.pow(real{7}),100));
+	BOOST_CHECK(check_rel_error(math::pow(x,-5),rx.pow(real{-5}),100));
+	BOOST_CHECK(check_rel_error(math::pow(x,integer(10)),rx.pow(real{10}),100));
+	BOOST_CHECK(check_rel_error(math::pow(x,0.5),rx.pow(real{.5}),104));
+	BOOST_CHECK(check_rel_error(math::pow(dd{2},x),real{2}.pow(rx),104));
+	BOOST_CHECK_EQUAL(math::pow(dd{2},-3),dd{1} / 8);
+	BOOST_CHECK((std::is_same<decltype(math::pow(x,2)),dd>::value));
+	// Trigonometric functions.
+	BOOST_CHECK(check_rel_error(math::sin(x),rx.sin(),104));
+	BOOST_CHECK(check_rel_error(math::cos(x),rx.cos(),104));
+	BOOST_CHECK(has_sine<dd>::value);
+	BOOST_CHECK(has_cosine<dd>::value);
+	BOOST_CHECK(is_differentiable<dd>::value);
+	BOOST_CHECK(has_negate<dd>::value);
+	BOOST_CHECK((is_evaluable<dd,int>::value));
+	// Safe cast.
+	BOOST_CHECK_EQUAL(safe_cast<int>(dd{-42}),-42);
+	BOOST_CHECK_EQUAL(safe_cast<integer>(dd{integer(2).pow(80) + 1}),integer(2).pow(80) + 1);
+	BOOST_CHECK_EQUAL(safe_cast<rational>(dd{1} / 4),rational(1,4));
+	BOOST_CHECK_THROW(safe_cast<integer>(dd{1} / 3),std::invalid_argument);
+	BOOST_CHECK_THROW(safe_cast<integer>(dd{integer(2).pow(80)} + .5),std::invalid_argument);
+	BOOST_CHECK_THROW(safe_cast<int>(dd{1e100}),std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(double_double_stream_test)
+{
+	for (int i = 0; i < ntries; ++i) {
+		const dd x = random_dd();
+		// Round trip via the string representation.
+		BOOST_CHECK_EQUAL(dd{boost::lexical_cast<std::string>(x)},x);
+		std::stringstream ss;
+		ss << x;
+		dd y;
+		ss >> y;
+		BOOST_CHECK_EQUAL(x,y);
+	}
+	BOOST_CHECK_EQUAL(boost::lexical_cast<std::string>(dd{1}),boost::lexical_cast<std::string>(real{1}));
+}
+
+BOOST_AUTO_TEST_CASE(double_double_serialization_test)
+{
+	for (int i = 0; i < ntries; ++i) {
+		const dd tmp = random_dd();
+		std::stringstream ss;
+		{
+		boost::archive::text_oarchive oa(ss);
+		oa << tmp;
+		}
+		dd tmp_out;
+		{
+		boost::archive::text_iarchive ia(ss);
+		ia >> tmp_out;
+		}
+		BOOST_CHECK_EQUAL(tmp,tmp_out);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(double_double_series_test)
+{
+	// Polynomials.
+	using p_dd = polynomial<dd,k_monomial>;
+	using p_real = polynomial<real,k_monomial>;
+	{
+		p_dd x{"x"}, y{"y"};
+		p_real xr{"x"}, yr{"y"};
+		const auto f = math::pow(x + y / 3 + dd{"0.1"},8), g = math::pow(x + y / 7 + dd{"0.3"},7);
+		const auto fr = math::pow(xr + yr / 3 + real{"0.1"},8), gr = math::pow(xr + yr / 7 + real{"0.3"},7);
+		const auto h = f * g;
+		const auto hr = fr * gr;
+		BOOST_CHECK_EQUAL(h.size(),hr.size());
+		for (const auto &t: hr._container()) {
+			// Locate the corresponding term and compare the coefficients.
+			const auto it = h._container().find(p_dd::term_type(dd{},t.m_key));
+			BOOST_CHECK(it != h._container().end());
+			BOOST_CHECK(check_rel_error(it->m_cf,t.m_cf,96));
+		}
+		// Evaluation and differentiation.
+		const std::unordered_map<std::string,dd> dict{{"x",dd{1} / 3},{"y",dd{"0.2"}}};
+		const std::unordered_map<std::string,real> dict_r{{"x",real{1} / 3},{"y",real{"0.2"}}};
+		BOOST_CHECK(check_rel_error(math::evaluate(h,dict),math::evaluate(hr,dict_r),96));
+		BOOST_CHECK_EQUAL(math::partial(x * x * y / 3,"x"),2 * x * y * (dd{1} / 3));
+	}
+	// Poisson series.
+	using ps_dd = poisson_series<p_dd>;
+	using ps_real = poisson_series<p_real>;
+	{
+		ps_dd x{"x"}, th{"th"};
+		ps_real xr{"x"}, thr{"th"};
+		const auto f = math::pow(x * math::cos(th) + math::sin(2 * th) / 3 - dd{"0.1"},6);
+		const auto fr = math::pow(xr * math::cos(thr) + math::sin(2 * thr) / 3 - real{"0.1"},6);
+		BOOST_CHECK_EQUAL(f.size(),fr.size());
+		const std::unordered_map<std::string,dd> dict{{"x",dd{"0.7"}},{"th",dd{"0.3"}}};
+		const std::unordered_map<std::string,real> dict_r{{"x",real{"0.7"}},{"th",real{"0.3"}}};
+		BOOST_CHECK(check_rel_error(math::evaluate(f * f,dict),math::evaluate(fr * fr,dict_r),96));
+	}
+}
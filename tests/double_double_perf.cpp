@@ -0,0 +1,73 @@
+/***************************************************************************
+ *   Copyright (C) 2009-2011 by Francesco Biscani                          *
+ *   bluescarni@gmail.com                                                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+#include "../src/double_double.hpp"
+
+#define BOOST_TEST_MODULE double_double_test
+#include <boost/test/unit_test.hpp>
+
+#include <boost/lexical_cast.hpp>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "../src/environment.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/math.hpp"
+#include "../src/poisson_series.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/real.hpp"
+#include "../src/settings.hpp"
+
+using namespace piranha;
+
+// Comparison of the multiplication of Poisson series with double, double_double and real coefficients. The workload
+// is the square of a truncated expansion in the style of the perturbation theories of celestial mechanics.
+
+template <typename Cf>
+static poisson_series<polynomial<Cf,k_monomial>> run_workload(const std::string &name)
+{
+	using ps_type = poisson_series<polynomial<Cf,k_monomial>>;
+	ps_type x("x"), y("y"), e("e"), l("l"), g("g"), h("h");
+	auto f = (Cf(1) + x / 3 + y / 7) * math::cos(l) + e * math::sin(l - g) / 11 + Cf(1) / 5 * math::cos(g + h) +
+		x * y * math::sin(l + h) / 13 + Cf(1);
+	f = math::pow(f,6);
+	const auto start = std::chrono::steady_clock::now();
+	auto res = f * f;
+	const auto runtime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << name << ": " << runtime << "s, " << res.size() << " terms\n";
+	return res;
+}
+
+BOOST_AUTO_TEST_CASE(double_double_setup)
+{
+	environment env;
+	if (boost::unit_test::framework::master_test_suite().argc > 1) {
+		settings::set_n_threads(boost::lexical_cast<unsigned>(boost::unit_test::framework::master_test_suite().argv[1u]));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(double_double_poisson_series_test)
+{
+	const auto r1 = run_workload<double>("double");
+	const auto r2 = run_workload<double_double>("double_double");
+	const auto r3 = run_workload<real>("real");
+	BOOST_CHECK_EQUAL(r1.size(),r2.size());
+	BOOST_CHECK_EQUAL(r2.size(),r3.size());
+}
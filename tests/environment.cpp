@@ -23,8 +23,13 @@
 #define BOOST_TEST_MODULE environment_test
 #include <boost/test/unit_test.hpp>
 
+#include <future>
 #include <iostream>
+#include <vector>
 
+#include "../src/mp_integer.hpp"
+#include "../src/real.hpp"
+#include "../src/runtime_info.hpp"
 #include "../src/settings.hpp"
 #include "../src/thread_pool.hpp"
 
@@ -52,3 +57,62 @@ BOOST_AUTO_TEST_CASE(environment_main_test)
 	f2.wait();
 	BOOST_CHECK(!environment::shutdown());
 }
+
+BOOST_AUTO_TEST_CASE(environment_gmp_allocator_test)
+{
+	environment env;
+	// Objects created with the default GMP allocation functions.
+	const integer n0 = integer(3).pow(500);
+	const real r0{"1.1",300};
+	BOOST_CHECK(!environment::gmp_allocator_installed());
+	environment::install_gmp_allocator();
+	BOOST_CHECK(environment::gmp_allocator_installed());
+	// Multiple installations are harmless.
+	environment::install_gmp_allocator();
+	BOOST_CHECK(environment::gmp_allocator_installed());
+	// Work with dynamic integers and reals in multiple threads.
+	settings::set_n_threads(4u);
+	auto work = [](unsigned i) {
+		integer acc(1);
+		real racc{1,200};
+		for (unsigned j = 1u; j < 300u; ++j) {
+			acc *= integer(j + i);
+			racc *= real{j + i,200};
+			racc += j;
+			if (j % 50u == 0u) {
+				// Shrink and regrow the integer.
+				acc = integer(2).pow(j) + acc % integer(1000);
+			}
+		}
+		return std::make_pair(acc,racc);
+	};
+	std::vector<std::future<std::pair<integer,real>>> futures;
+	for (unsigned i = 0u; i < 4u; ++i) {
+		futures.push_back(thread_pool::enqueue(i,work,i));
+	}
+	std::vector<std::pair<integer,real>> results;
+	for (auto &f: futures) {
+		results.push_back(f.get());
+	}
+	// Check the results against the computation in this thread.
+	for (unsigned i = 0u; i < 4u; ++i) {
+		BOOST_CHECK(results[i] == work(i));
+	}
+	BOOST_CHECK(runtime_info::get_gmp_allocations() > 0u);
+	BOOST_CHECK(runtime_info::get_gmp_peak_bytes() > 0u);
+	// Objects created before the installation can be used and destroyed normally.
+	integer n1 = n0 * n0;
+	BOOST_CHECK_EQUAL(n1,integer(3).pow(1000));
+	real r1 = r0 * r0;
+	BOOST_CHECK_EQUAL(r1,real("1.1",300) * real("1.1",300));
+	environment::uninstall_gmp_allocator();
+	BOOST_CHECK(!environment::gmp_allocator_installed());
+	environment::uninstall_gmp_allocator();
+	BOOST_CHECK(!environment::gmp_allocator_installed());
+	// Objects created with the allocator can be used and destroyed after the uninstallation.
+	n1 *= n1;
+	BOOST_CHECK_EQUAL(n1,integer(3).pow(2000));
+	r1 += results[0u].second;
+	results.clear();
+	settings::reset_n_threads();
+}
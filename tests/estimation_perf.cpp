@@ -26,9 +26,12 @@
 #include <algorithm>
 #include <boost/lexical_cast.hpp>
 #include <boost/timer/timer.hpp>
+#include <chrono>
 #include <cstddef>
+#include <iomanip>
 #include <iostream>
 #include <iterator>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -38,6 +41,8 @@
 #include "../src/pow.hpp"
 #include "../src/power_series.hpp"
 #include "../src/settings.hpp"
+#include "../src/tuning.hpp"
+#include "monagan.hpp"
 
 using namespace piranha;
 using t_type = boost::timer::auto_cpu_timer;
@@ -105,6 +110,54 @@ struct multiplier: base_series_multiplier<p_type>
 	}
 };
 
+// The size estimators to be compared.
+static const std::vector<std::pair<size_estimator,std::string>> estimators = {
+	{size_estimator::first_duplicate,"first_duplicate"},
+	{size_estimator::distinct_count,"distinct_count"},
+	{size_estimator::upper_bound,"upper_bound"}
+};
+
+// Run all the size estimators on the multiplier m, printing the ratio between the real size and the
+// estimate (values larger than 1 indicate an underestimate) and the time spent computing the estimate.
+template <typename ... Args>
+static void run_estimators(const multiplier &m, double real_size, const Args & ... args)
+{
+	for (const auto &e: estimators) {
+		tuning::set_size_estimator(e.first);
+		const auto start = std::chrono::steady_clock::now();
+		const auto estimate = m.estimate_final_series_size<1u,multiplier::p_mult>(args...);
+		const auto runtime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::cout << std::setw(16) << e.second << ": " << real_size / static_cast<double>(estimate) << " (" << runtime << "s)\n";
+	}
+	tuning::reset_size_estimator();
+}
+
+// Run all the size estimators during the full multiplications performed by f, collecting the estimated
+// and the actual size of the result of the last multiplication via the size estimation hook.
+template <typename F>
+static void run_estimators_hook(const F &f)
+{
+	std::vector<size_estimation_record> records;
+	tuning::set_size_estimation_hook([&records](const size_estimation_record &r) {
+		records.push_back(r);
+	});
+	for (unsigned nt = 1u; nt <= max_nt(); ++nt) {
+		std::cout << "Threads: " << nt << '\n';
+		settings::set_n_threads(nt);
+		for (const auto &e: estimators) {
+			tuning::set_size_estimator(e.first);
+			records.clear();
+			f();
+			BOOST_CHECK(!records.empty());
+			const auto &r = records.back();
+			std::cout << std::setw(16) << e.second << ": " << static_cast<double>(r.actual) / static_cast<double>(r.estimate)
+				<< " (" << r.runtime << "s)\n";
+		}
+	}
+	tuning::reset_size_estimator();
+	tuning::reset_size_estimation_hook();
+}
+
 BOOST_AUTO_TEST_CASE(initial_setup)
 {
 	environment env;
@@ -125,9 +178,10 @@ BOOST_AUTO_TEST_CASE(fateman1_test)
 	auto g = f + 1;
 	const double real_size = 135751.;
 	for (unsigned nt = 1u; nt <= max_nt(); ++nt) {
+		std::cout << "Threads: " << nt << '\n';
 		settings::set_n_threads(nt);
 		multiplier m(f,g);
-		std::cout << real_size / m.estimate_final_series_size<1u,multiplier::p_mult>() << '\n';
+		run_estimators(m,real_size);
 	}
 	std::cout << "\n\n";
 }
@@ -145,10 +199,11 @@ BOOST_AUTO_TEST_CASE(fateman1_truncated_test)
 	auto g = f + 1;
 	const double real_size = 46376.;
 	for (unsigned nt = 1u; nt <= max_nt(); ++nt) {
+		std::cout << "Threads: " << nt << '\n';
 		settings::set_n_threads(nt);
 		multiplier m(f,g);
 		multiplier::lf lf(&m,30);
-		std::cout << real_size / m.estimate_final_series_size<1u,multiplier::p_mult>(lf) << '\n';
+		run_estimators(m,real_size,lf);
 	}
 	std::cout << "\n\n";
 }
@@ -166,9 +221,10 @@ BOOST_AUTO_TEST_CASE(fateman2_test)
 	auto g = f + 1;
 	const double real_size = 635376.;
 	for (unsigned nt = 1u; nt <= max_nt(); ++nt) {
+		std::cout << "Threads: " << nt << '\n';
 		settings::set_n_threads(nt);
 		multiplier m(f,g);
-		std::cout << real_size / m.estimate_final_series_size<1u,multiplier::p_mult>() << '\n';
+		run_estimators(m,real_size);
 	}
 	std::cout << "\n\n";
 }
@@ -186,10 +242,11 @@ BOOST_AUTO_TEST_CASE(fateman2_truncated_test)
 	auto g = f + 1;
 	const double real_size = 46376.;
 	for (unsigned nt = 1u; nt <= max_nt(); ++nt) {
+		std::cout << "Threads: " << nt << '\n';
 		settings::set_n_threads(nt);
 		multiplier m(f,g);
 		multiplier::lf lf(&m,30);
-		std::cout << real_size / m.estimate_final_series_size<1u,multiplier::p_mult>(lf) << '\n';
+		run_estimators(m,real_size,lf);
 	}
 	std::cout << "\n\n";
 }
@@ -209,9 +266,10 @@ BOOST_AUTO_TEST_CASE(pearce1_test)
 	}
 	const double real_size = 5821335.;
 	for (unsigned nt = 1u; nt <= max_nt(); ++nt) {
+		std::cout << "Threads: " << nt << '\n';
 		settings::set_n_threads(nt);
 		multiplier m(f,g);
-		std::cout << real_size / m.estimate_final_series_size<1u,multiplier::p_mult>() << '\n';
+		run_estimators(m,real_size);
 	}
 	std::cout << "\n\n";
 }
@@ -231,10 +289,11 @@ BOOST_AUTO_TEST_CASE(pearce1_truncated_test)
 	}
 	const double real_size = 3419167.;
 	for (unsigned nt = 1u; nt <= max_nt(); ++nt) {
+		std::cout << "Threads: " << nt << '\n';
 		settings::set_n_threads(nt);
 		multiplier m(f,g);
 		multiplier::lf lf(&m,60);
-		std::cout << real_size / m.estimate_final_series_size<1u,multiplier::p_mult>(lf) << '\n';
+		run_estimators(m,real_size,lf);
 		p_type::set_auto_truncate_degree(60);
 	}
 	std::cout << "\n\n";
@@ -255,9 +314,10 @@ BOOST_AUTO_TEST_CASE(pearce2_test)
 	}
 	const double real_size = 28398035.;
 	for (unsigned nt = 1u; nt <= max_nt(); ++nt) {
+		std::cout << "Threads: " << nt << '\n';
 		settings::set_n_threads(nt);
 		multiplier m(f,g);
-		std::cout << real_size / m.estimate_final_series_size<1u,multiplier::p_mult>() << '\n';
+		run_estimators(m,real_size);
 	}
 	std::cout << "\n\n";
 }
@@ -277,10 +337,11 @@ BOOST_AUTO_TEST_CASE(pearce2_truncated_test)
 	}
 	const double real_size = 17860117.;
 	for (unsigned nt = 1u; nt <= max_nt(); ++nt) {
+		std::cout << "Threads: " << nt << '\n';
 		settings::set_n_threads(nt);
 		multiplier m(f,g);
 		multiplier::lf lf(&m,85);
-		std::cout << real_size / m.estimate_final_series_size<1u,multiplier::p_mult>(lf) << '\n';
+		run_estimators(m,real_size,lf);
 	}
 	std::cout << "\n\n";
 }
@@ -300,9 +361,10 @@ BOOST_AUTO_TEST_CASE(gastineau2_test)
 	}
 	const double real_size = 312855140.;
 	for (unsigned nt = 1u; nt <= max_nt(); ++nt) {
+		std::cout << "Threads: " << nt << '\n';
 		settings::set_n_threads(nt);
 		multiplier m(f,g);
-		std::cout << real_size / m.estimate_final_series_size<1u,multiplier::p_mult>() << '\n';
+		run_estimators(m,real_size);
 	}
 	std::cout << "\n\n";
 }
@@ -322,9 +384,10 @@ BOOST_AUTO_TEST_CASE(gastineau3_test)
 	g += 1;
 	const double real_size = 144049555.;
 	for (unsigned nt = 1u; nt <= max_nt(); ++nt) {
+		std::cout << "Threads: " << nt << '\n';
 		settings::set_n_threads(nt);
 		multiplier m(f,g);
-		std::cout << real_size / m.estimate_final_series_size<1u,multiplier::p_mult>() << '\n';
+		run_estimators(m,real_size);
 	}
 	std::cout << "\n\n";
 }
@@ -339,9 +402,10 @@ BOOST_AUTO_TEST_CASE(audi_test)
 	auto g = math::pow(1-x1-x2-x3-x4-x5-x6-x7-x8-x9-x10,10);
 	const double real_size = 17978389.;
 	for (unsigned nt = 1u; nt <= max_nt(); ++nt) {
+		std::cout << "Threads: " << nt << '\n';
 		settings::set_n_threads(nt);
 		multiplier m(f,g);
-		std::cout << real_size / m.estimate_final_series_size<1u,multiplier::p_mult>() << '\n';
+		run_estimators(m,real_size);
 	}
 	std::cout << "\n\n";
 }
@@ -356,10 +420,28 @@ BOOST_AUTO_TEST_CASE(audi_truncated_test)
 	auto g = math::pow(1-x1-x2-x3-x4-x5-x6-x7-x8-x9-x10,10);
 	const double real_size = 122464.;
 	for (unsigned nt = 1u; nt <= max_nt(); ++nt) {
+		std::cout << "Threads: " << nt << '\n';
 		settings::set_n_threads(nt);
 		multiplier m(f,g);
 		multiplier::lf lf(&m,10);
-		std::cout << real_size / m.estimate_final_series_size<1u,multiplier::p_mult>(lf) << '\n';
+		run_estimators(m,real_size,lf);
 	}
 	std::cout << "\n\n";
 }
+
+BOOST_AUTO_TEST_CASE(monagan_test)
+{
+	const std::vector<std::pair<std::string,p_type (*)()>> benchmarks = {
+		{"Monagan 1",&monagan1<double,k_monomial>},
+		{"Monagan 2",&monagan2<double,k_monomial>},
+		{"Monagan 3",&monagan3<double,k_monomial>},
+		{"Monagan 4",&monagan4<double,k_monomial>},
+		{"Monagan 5",&monagan5<double,k_monomial>}
+	};
+	for (const auto &b: benchmarks) {
+		std::cout << b.first << ":\n";
+		std::cout << std::string(b.first.size() + 1u,'=') << "\n\n";
+		run_estimators_hook(b.second);
+		std::cout << "\n\n";
+	}
+}
@@ -22,8 +22,13 @@
 #include <boost/test/unit_test.hpp>
 
 #include <boost/timer/timer.hpp>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 
 #include "../src/environment.hpp"
+#include "../src/evaluation_plan.hpp"
 #include "../src/kronecker_monomial.hpp"
 #include "../src/mp_integer.hpp"
 #include "../src/mp_rational.hpp"
@@ -56,6 +61,24 @@ BOOST_AUTO_TEST_CASE(evaluate_test)
 	boost::timer::auto_cpu_timer t;
 	std::cout << math::evaluate<double>(ret1,{{"x",1.},{"y",1.},{"z",1.},{"t",1.},{"u",1.}}) << '\n';
 	}
+	std::unique_ptr<evaluation_plan<double>> ep;
+	{
+	std::cout << "Timing evaluation plan compilation, double: ";
+	boost::timer::auto_cpu_timer t;
+	ep.reset(new evaluation_plan<double>(ret1));
+	std::cout << '\n';
+	}
+	{
+	std::cout << "Timing evaluation plan, double: ";
+	boost::timer::auto_cpu_timer t;
+	std::cout << ep->evaluate({{"x",1.},{"y",1.},{"z",1.},{"t",1.},{"u",1.}}) << '\n';
+	}
+	{
+	std::cout << "Timing batched evaluation plan, double, 16 points: ";
+	std::vector<std::unordered_map<std::string,double>> points(16u,{{"x",1.},{"y",1.},{"z",1.},{"t",1.},{"u",1.}});
+	boost::timer::auto_cpu_timer t;
+	std::cout << ep->evaluate(points)[0u] << '\n';
+	}
 	}
 	{
 	std::cout << "Timing multiplication, rational:\n";
@@ -0,0 +1,197 @@
+/***************************************************************************
+ *   Copyright (C) 2009-2011 by Francesco Biscani                          *
+ *   bluescarni@gmail.com                                                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "../src/evaluation_plan.hpp"
+
+#define BOOST_TEST_MODULE evaluation_plan_test
+#include <boost/test/unit_test.hpp>
+
+#include <cmath>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "../src/environment.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/math.hpp"
+#include "../src/monomial.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/mp_rational.hpp"
+#include "../src/poisson_series.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/pow.hpp"
+#include "../src/real.hpp"
+#include "../src/settings.hpp"
+#include "../src/symbol.hpp"
+#include "../src/symbol_set.hpp"
+
+using namespace piranha;
+
+BOOST_AUTO_TEST_CASE(evaluation_plan_integer_test)
+{
+	environment env;
+	using p_type = polynomial<integer,kronecker_monomial<>>;
+	using d_type = std::unordered_map<std::string,integer>;
+	p_type x{"x"}, y{"y"}, z{"z"};
+	// Empty series.
+	evaluation_plan<integer> ep0{p_type{}};
+	BOOST_CHECK_EQUAL(ep0.size(),0u);
+	BOOST_CHECK_EQUAL(ep0.evaluate(d_type{}),0);
+	// Constant series.
+	evaluation_plan<integer> ep1{p_type{3}};
+	BOOST_CHECK_EQUAL(ep1.size(),1u);
+	BOOST_CHECK_EQUAL(ep1.evaluate(d_type{{"x",5_z}}),3);
+	BOOST_CHECK_EQUAL(ep1.evaluate(std::vector<integer>{}),3);
+	// A dense-ish polynomial.
+	auto f = math::pow(1 + x + y + 2 * z * z + 3 * x * x * x + 5 * y * y * y * y * y,5);
+	evaluation_plan<integer> ep2{f};
+	BOOST_CHECK_EQUAL(ep2.size(),f.size());
+	BOOST_CHECK(ep2.get_symbol_set() == f.get_symbol_set());
+	const std::vector<d_type> points = {d_type{{"x",1_z},{"y",2_z},{"z",3_z}},d_type{{"x",-4_z},{"y",0_z},{"z",7_z}},
+		d_type{{"x",0_z},{"y",0_z},{"z",0_z}},d_type{{"x",-1_z},{"y",-2_z},{"z",11_z},{"t",3_z}}};
+	for (const auto &p: points) {
+		BOOST_CHECK_EQUAL(ep2.evaluate(p),math::evaluate(f,p));
+	}
+	BOOST_CHECK_EQUAL(ep2.evaluate(std::vector<integer>{1_z,2_z,3_z}),math::evaluate(f,points[0u]));
+	// Batched evaluation.
+	const auto res = ep2.evaluate(points);
+	BOOST_CHECK_EQUAL(res.size(),points.size());
+	for (decltype(res.size()) i = 0u; i < res.size(); ++i) {
+		BOOST_CHECK_EQUAL(res[i],math::evaluate(f,points[i]));
+	}
+	BOOST_CHECK(ep2.evaluate(std::vector<d_type>{}).empty());
+	// Symbols with all-zero exponents must still be present in the dictionary.
+	auto g = x + y + z - z;
+	BOOST_CHECK_EQUAL(g.get_symbol_set().size(),3u);
+	evaluation_plan<integer> ep3{g};
+	BOOST_CHECK_EQUAL(ep3.evaluate(d_type{{"x",1_z},{"y",2_z},{"z",3_z}}),3);
+	// Error handling.
+	BOOST_CHECK_THROW(ep2.evaluate(d_type{{"x",1_z},{"y",2_z}}),std::invalid_argument);
+	BOOST_CHECK_THROW(ep2.evaluate(std::vector<integer>{1_z,2_z}),std::invalid_argument);
+	BOOST_CHECK_THROW(ep2.evaluate(std::vector<d_type>{d_type{{"x",1_z}}}),std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(evaluation_plan_rational_test)
+{
+	using p_type = polynomial<rational,monomial<int>>;
+	using d_type = std::unordered_map<std::string,rational>;
+	p_type x{"x"}, y{"y"};
+	// Negative and sparse exponents.
+	auto f = math::pow(x,-3) * y / 7 + 2 * math::pow(x,20) - math::pow(y,-1) + x * y + 1 / 3_q;
+	evaluation_plan<rational> ep{f};
+	const std::vector<d_type> points = {d_type{{"x",1/2_q},{"y",3_q}},d_type{{"x",-5/3_q},{"y",-2/7_q}}};
+	for (const auto &p: points) {
+		BOOST_CHECK_EQUAL(ep.evaluate(p),math::evaluate(f,p));
+	}
+	const auto res = ep.evaluate(points);
+	BOOST_CHECK_EQUAL(res[0u],math::evaluate(f,points[0u]));
+	BOOST_CHECK_EQUAL(res[1u],math::evaluate(f,points[1u]));
+	// Integer coefficients converted to rational.
+	using p_type2 = polynomial<integer,monomial<int>>;
+	p_type2 a{"a"};
+	evaluation_plan<rational> ep2{a * a + 2 * a};
+	BOOST_CHECK_EQUAL(ep2.evaluate(d_type{{"a",1/2_q}}),5/4_q);
+}
+
+BOOST_AUTO_TEST_CASE(evaluation_plan_double_test)
+{
+	using p_type = polynomial<double,kronecker_monomial<>>;
+	using d_type = std::unordered_map<std::string,double>;
+	p_type x{"x"}, y{"y"};
+	auto f = math::pow(1.5 * x - y + 0.25,7);
+	evaluation_plan<double> ep{f};
+	std::vector<d_type> points;
+	for (int i = 0; i < 10; ++i) {
+		points.push_back(d_type{{"x",i / 10.},{"y",1. - i / 5.}});
+	}
+	const auto res = ep.evaluate(points);
+	for (decltype(res.size()) i = 0u; i < res.size(); ++i) {
+		const auto ref = math::evaluate(f,points[i]);
+		BOOST_CHECK(std::abs(res[i] - ref) <= 1E-12 * (1. + std::abs(ref)));
+		BOOST_CHECK_EQUAL(res[i],ep.evaluate(points[i]));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(evaluation_plan_poisson_series_test)
+{
+	using math::cos;
+	using math::sin;
+	using math::pow;
+	using p_type = poisson_series<polynomial<rational,monomial<short>>>;
+	using d_type = std::unordered_map<std::string,double>;
+	p_type x{"x"}, y{"y"}, z{"z"};
+	// NOTE: x appears both as a polynomial variable and as an angle.
+	auto f = (x + pow(y,2) / 3) * cos(3 * x - 2 * y) + 2 * x * z * sin(x + 5 * y) + pow(z,3) * cos(y) - sin(2 * x) / 7 +
+		pow(x,-2) * cos(4 * x + 4 * y) + 1 / 5_q;
+	evaluation_plan<double> ep{f};
+	BOOST_CHECK(ep.get_symbol_set() == (symbol_set{symbol{"x"},symbol{"y"},symbol{"z"}}));
+	std::vector<d_type> points;
+	for (int i = 0; i < 21; ++i) {
+		points.push_back(d_type{{"x",.1 + i / 7.},{"y",-1. + i / 3.},{"z",.5 - i / 11.}});
+	}
+	auto res = ep.evaluate(points);
+	BOOST_CHECK_EQUAL(res.size(),points.size());
+	for (decltype(res.size()) i = 0u; i < res.size(); ++i) {
+		const auto ref = math::evaluate(f,points[i]);
+		BOOST_CHECK(std::abs(res[i] - ref) <= 1E-12 * (1. + std::abs(ref)));
+		BOOST_CHECK(std::abs(ep.evaluate(points[i]) - ref) <= 1E-12 * (1. + std::abs(ref)));
+	}
+	// Multi-threaded evaluation.
+	for (unsigned nt = 2u; nt <= 4u; ++nt) {
+		settings::set_n_threads(nt);
+		settings::set_min_work_per_thread(1u);
+		const auto res_mt = ep.evaluate(points);
+		for (decltype(res.size()) i = 0u; i < res.size(); ++i) {
+			BOOST_CHECK(std::abs(res[i] - res_mt[i]) <= 1E-12 * (1. + std::abs(res[i])));
+		}
+	}
+	settings::reset_n_threads();
+	settings::reset_min_work_per_thread();
+	// Purely trigonometric series.
+	p_type a{"a"}, b{"b"};
+	auto g = 3 * cos(a + b) - sin(2 * a - 7 * b) / 2 + 1;
+	evaluation_plan<double> ep2{g};
+	const d_type p{{"a",.3},{"b",-1.7}};
+	BOOST_CHECK(std::abs(ep2.evaluate(p) - math::evaluate(g,p)) <= 1E-12);
+	// Missing symbols.
+	BOOST_CHECK_THROW(ep.evaluate(d_type{{"x",1.},{"y",2.}}),std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(evaluation_plan_real_test)
+{
+	using math::cos;
+	using math::sin;
+	using math::pow;
+	using p_type = poisson_series<polynomial<rational,monomial<short>>>;
+	using d_type = std::unordered_map<std::string,real>;
+	p_type x{"x"}, y{"y"};
+	auto f = pow(x + y - 1,4) * cos(x - 3 * y) - pow(y,2) * sin(5 * x + 6 * y) / 3;
+	evaluation_plan<real> ep{f};
+	std::vector<d_type> points;
+	for (int i = 0; i < 11; ++i) {
+		points.push_back(d_type{{"x",real(1.234) + i},{"y",real(-5.678) / (i + 1)}});
+	}
+	const auto res = ep.evaluate(points);
+	for (decltype(res.size()) i = 0u; i < res.size(); ++i) {
+		const auto ref = math::evaluate(f,points[i]);
+		BOOST_CHECK(math::abs(res[i] - ref) <= real{"1E-25"} * (1 + math::abs(ref)));
+	}
+}
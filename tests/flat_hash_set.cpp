@@ -0,0 +1,414 @@
+/***************************************************************************
+ *   Copyright (C) 2009-2011 by Francesco Biscani                          *
+ *   bluescarni@gmail.com                                                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "../src/flat_hash_set.hpp"
+
+#define BOOST_TEST_MODULE flat_hash_set_test
+#include <boost/test/unit_test.hpp>
+
+#include <boost/lexical_cast.hpp>
+#include <boost/mpl/for_each.hpp>
+#include <boost/mpl/vector.hpp>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <map>
+#include <random>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../src/debug_access.hpp"
+#include "../src/environment.hpp"
+#include "../src/exceptions.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/serialization.hpp"
+#include "../src/thread_pool.hpp"
+#include "../src/type_traits.hpp"
+
+static const int ntries = 1000;
+
+static std::mt19937 rng;
+
+using namespace piranha;
+
+typedef boost::mpl::vector<int,integer,std::string> key_types;
+
+const int N = 10000;
+
+struct sanity_tag {};
+
+namespace piranha
+{
+
+template <>
+class debug_access<sanity_tag>
+{
+	public:
+		template <typename T>
+		static bool check(const T &h)
+		{
+			return h.sanity_check();
+		}
+};
+
+}
+
+using sanity_checker = debug_access<sanity_tag>;
+
+// Hasher sending all the elements in the same bucket.
+struct zero_hasher
+{
+	std::size_t operator()(int) const
+	{
+		return 0u;
+	}
+};
+
+// Identity hasher, as used by Kronecker monomials.
+struct id_hasher
+{
+	std::size_t operator()(int n) const
+	{
+		return static_cast<std::size_t>(n);
+	}
+};
+
+template <typename T>
+static inline flat_hash_set<T> make_flat_hash_set()
+{
+	flat_hash_set<T> retval;
+	for (int i = 0; i < N; ++i) {
+		retval.insert(boost::lexical_cast<T>(i));
+	}
+	return retval;
+}
+
+struct constructors_tester
+{
+	template <typename T>
+	void operator()(const T &)
+	{
+		flat_hash_set<T> h0;
+		BOOST_CHECK(h0.empty());
+		BOOST_CHECK_EQUAL(h0.bucket_count(),0u);
+		BOOST_CHECK(h0.begin() == h0.end());
+		flat_hash_set<T> h1(100u);
+		BOOST_CHECK(h1.bucket_count() >= 100u);
+		BOOST_CHECK(h1.begin() == h1.end());
+		auto h = make_flat_hash_set<T>();
+		BOOST_CHECK_EQUAL(h.size(),unsigned(N));
+		BOOST_CHECK(sanity_checker::check(h));
+		// Copy.
+		flat_hash_set<T> h_copy(h);
+		BOOST_CHECK_EQUAL(h_copy.size(),unsigned(N));
+		auto it1 = h.begin();
+		for (auto it2 = h_copy.begin(); it2 != h_copy.end(); ++it1, ++it2) {
+			BOOST_CHECK_EQUAL(*it1,*it2);
+		}
+		BOOST_CHECK(it1 == h.end());
+		// Move.
+		flat_hash_set<T> h_move(std::move(h_copy));
+		BOOST_CHECK_EQUAL(h_move.size(),unsigned(N));
+		BOOST_CHECK_EQUAL(h_copy.size(),0u);
+		BOOST_CHECK_EQUAL(h_copy.bucket_count(),0u);
+		// Assignment.
+		h_copy = h_move;
+		BOOST_CHECK_EQUAL(h_copy.size(),unsigned(N));
+		h_copy = std::move(h_move);
+		BOOST_CHECK_EQUAL(h_copy.size(),unsigned(N));
+		BOOST_CHECK(sanity_checker::check(h_copy));
+		// Range and init list.
+		std::vector<T> v(h.begin(),h.end());
+		flat_hash_set<T> h_range(v.begin(),v.end());
+		BOOST_CHECK_EQUAL(h_range.size(),unsigned(N));
+		flat_hash_set<T> h_list{boost::lexical_cast<T>(1),boost::lexical_cast<T>(2),boost::lexical_cast<T>(1)};
+		BOOST_CHECK_EQUAL(h_list.size(),2u);
+	}
+};
+
+BOOST_AUTO_TEST_CASE(flat_hash_set_constructors_test)
+{
+	environment env;
+	boost::mpl::for_each<key_types>(constructors_tester());
+	BOOST_CHECK_THROW(flat_hash_set<int>(10u,std::hash<int>(),std::equal_to<int>(),0u),std::invalid_argument);
+	BOOST_CHECK_THROW(flat_hash_set<int>{}.bucket(0),zero_division_error);
+}
+
+struct insert_find_erase_tester
+{
+	template <typename T>
+	void operator()(const T &)
+	{
+		// Random operations checked against std::set.
+		std::uniform_int_distribution<int> val_dist(0,200), op_dist(0,2);
+		flat_hash_set<T> h;
+		std::set<T> s;
+		for (int i = 0; i < ntries * 10; ++i) {
+			const auto x = boost::lexical_cast<T>(val_dist(rng));
+			switch (op_dist(rng)) {
+				case 0: {
+					const auto res = h.insert(x);
+					BOOST_CHECK_EQUAL(res.second,s.insert(x).second);
+					BOOST_CHECK_EQUAL(*res.first,x);
+					break;
+				}
+				case 1: {
+					const auto it = h.find(x);
+					BOOST_CHECK_EQUAL(it != h.end(),s.count(x) == 1u);
+					if (it != h.end()) {
+						h.erase(it);
+						s.erase(x);
+					}
+					break;
+				}
+				default:
+					BOOST_CHECK_EQUAL(h.find(x) != h.end(),s.count(x) == 1u);
+			}
+			BOOST_CHECK_EQUAL(h.size(),s.size());
+		}
+		BOOST_CHECK(sanity_checker::check(h));
+		BOOST_CHECK(std::set<T>(h.begin(),h.end()) == s);
+		// Erase everything via the returned iterators.
+		for (auto it = h.begin(); it != h.end();) {
+			it = h.erase(it);
+		}
+		BOOST_CHECK(h.empty());
+		BOOST_CHECK(h.begin() == h.end());
+		BOOST_CHECK(sanity_checker::check(h));
+	}
+};
+
+BOOST_AUTO_TEST_CASE(flat_hash_set_insert_find_erase_test)
+{
+	boost::mpl::for_each<key_types>(insert_find_erase_tester());
+	// All elements colliding in the same bucket.
+	flat_hash_set<int,zero_hasher> h;
+	for (int i = 0; i < 1000; ++i) {
+		BOOST_CHECK(h.insert(i).second);
+		BOOST_CHECK(!h.insert(i).second);
+	}
+	BOOST_CHECK_EQUAL(h.size(),1000u);
+	for (int i = 0; i < 1000; i += 2) {
+		h.erase(h.find(i));
+	}
+	for (int i = 0; i < 1000; ++i) {
+		BOOST_CHECK_EQUAL(h.find(i) != h.end(),i % 2 == 1);
+	}
+	BOOST_CHECK(sanity_checker::check(h));
+	// Erase returning the next element, or end.
+	flat_hash_set<int,id_hasher> h2(16u);
+	h2.insert(3);
+	h2.insert(5);
+	auto it = h2.erase(h2.find(3));
+	BOOST_CHECK(it != h2.end());
+	BOOST_CHECK_EQUAL(*it,5);
+	it = h2.erase(it);
+	BOOST_CHECK(it == h2.end());
+}
+
+BOOST_AUTO_TEST_CASE(flat_hash_set_tombstones_test)
+{
+	// Repeated insertions and erasures in a table of fixed size: the tombstones
+	// must be purged without growing the table.
+	flat_hash_set<int,id_hasher> h(64u);
+	const auto b_count = h.bucket_count();
+	for (int i = 0; i < ntries * 10; ++i) {
+		h.insert(i);
+		h.erase(h.find(i));
+		BOOST_CHECK(h.empty());
+	}
+	BOOST_CHECK_EQUAL(h.bucket_count(),b_count);
+	BOOST_CHECK(sanity_checker::check(h));
+	// The load factor is honoured.
+	flat_hash_set<int> h2;
+	for (int i = 0; i < N; ++i) {
+		h2.insert(i);
+		BOOST_CHECK(h2.load_factor() <= h2.max_load_factor());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(flat_hash_set_low_level_test)
+{
+	// Emulate the usage in the multipliers: insertion via _find()/_unique_insert(),
+	// with a cached end iterator and the size fixed at the end.
+	flat_hash_set<int,id_hasher> h(16u);
+	const auto it_end = h.end();
+	std::uniform_int_distribution<int> val_dist(0,10000);
+	std::set<int> s;
+	for (int i = 0; i < ntries * 10; ++i) {
+		const auto x = val_dist(rng);
+		const auto b_idx = h._bucket(x);
+		BOOST_CHECK_EQUAL(b_idx,h._bucket_from_hash(static_cast<std::size_t>(x)));
+		BOOST_CHECK_EQUAL(b_idx,static_cast<std::size_t>(x) % h.bucket_count());
+		if (h._find(x,b_idx) == it_end) {
+			// NOTE: this will grow the table when needed.
+			BOOST_CHECK_EQUAL(*h._unique_insert(x,b_idx),x);
+			s.insert(x);
+		}
+	}
+	BOOST_CHECK(h.end() == it_end);
+	BOOST_CHECK(h.bucket_count() > 16u);
+	h._update_size(s.size());
+	BOOST_CHECK(sanity_checker::check(h));
+	// Iteration via the buckets.
+	std::set<int> tmp;
+	for (std::size_t i = 0u; i < h.bucket_count(); ++i) {
+		for (const auto &n: h._get_bucket_list(i)) {
+			BOOST_CHECK(tmp.insert(n).second);
+		}
+	}
+	BOOST_CHECK(tmp == s);
+	// Low-level erase.
+	for (std::size_t i = 0u; i < h.bucket_count(); ++i) {
+		const auto l = h._get_bucket_list(i);
+		if (!l.empty() && *l.begin() % 2 == 0) {
+			const auto n = *l.begin();
+			BOOST_CHECK(h._erase(h._find(n,h._bucket(n))) == h._get_bucket_list(i).end());
+			BOOST_CHECK(h._get_bucket_list(i).empty());
+			s.erase(n);
+		}
+	}
+	h._update_size(s.size());
+	BOOST_CHECK(sanity_checker::check(h));
+	BOOST_CHECK(std::set<int>(h.begin(),h.end()) == s);
+	// Mutable iterators.
+	flat_hash_set<std::string> h2{std::string("a"),std::string("b")};
+	std::vector<std::string> v;
+	for (auto it = h2._m_begin(); it != h2._m_end(); ++it) {
+		v.push_back(std::move(*it));
+	}
+	h2.clear();
+	BOOST_CHECK_EQUAL(v.size(),2u);
+	// Increase size.
+	flat_hash_set<int> h3;
+	h3._increase_size();
+	BOOST_CHECK_EQUAL(h3.bucket_count(),16u);
+	h3.insert(1);
+	h3._increase_size();
+	BOOST_CHECK_EQUAL(h3.bucket_count(),32u);
+	BOOST_CHECK(h3.find(1) != h3.end());
+}
+
+struct misc_tester
+{
+	template <typename T>
+	void operator()(const T &)
+	{
+		// Clear and swap.
+		auto h = make_flat_hash_set<T>();
+		flat_hash_set<T> h2;
+		h2.insert(boost::lexical_cast<T>(-1));
+		h.swap(h2);
+		BOOST_CHECK_EQUAL(h.size(),1u);
+		BOOST_CHECK_EQUAL(h2.size(),unsigned(N));
+		BOOST_CHECK(h2.find(boost::lexical_cast<T>(N - 1)) != h2.end());
+		h2.clear();
+		BOOST_CHECK(h2.empty());
+		BOOST_CHECK_EQUAL(h2.bucket_count(),0u);
+		// Rehash.
+		h2 = make_flat_hash_set<T>();
+		const auto old = h2.bucket_count();
+		h2.rehash(old * 2u);
+		BOOST_CHECK(h2.bucket_count() >= old * 2u);
+		// Rehashing below the max load factor is a no-op.
+		h2.rehash(1u);
+		BOOST_CHECK(h2.bucket_count() >= old * 2u);
+		h2.rehash(0u);
+		BOOST_CHECK(h2.bucket_count() >= old * 2u);
+		for (int i = 0; i < N; ++i) {
+			BOOST_CHECK(h2.find(boost::lexical_cast<T>(i)) != h2.end());
+		}
+		BOOST_CHECK_THROW(h2.rehash(10u,0u),std::invalid_argument);
+		flat_hash_set<T> h3(100u);
+		h3.rehash(0u);
+		BOOST_CHECK_EQUAL(h3.bucket_count(),0u);
+		// Sparsity.
+		using size_type = typename flat_hash_set<T>::size_type;
+		BOOST_CHECK((h3.evaluate_sparsity() == std::map<size_type,size_type>{}));
+		h3.insert(T());
+		BOOST_CHECK((h3.evaluate_sparsity() == std::map<size_type,size_type>{{0u,1u}}));
+		size_type count = 0u;
+		for (const auto &p: h2.evaluate_sparsity()) {
+			count += p.second;
+		}
+		BOOST_CHECK_EQUAL(count,h2.size());
+		// Type traits.
+		BOOST_CHECK(is_container_element<flat_hash_set<T>>::value);
+		BOOST_CHECK(!is_equality_comparable<flat_hash_set<T>>::value);
+	}
+};
+
+BOOST_AUTO_TEST_CASE(flat_hash_set_misc_test)
+{
+	boost::mpl::for_each<key_types>(misc_tester());
+}
+
+BOOST_AUTO_TEST_CASE(flat_hash_set_mt_test)
+{
+	thread_pool::resize(4u);
+	std::uniform_int_distribution<std::size_t> size_dist(0u,100000u);
+	std::uniform_int_distribution<unsigned> thread_dist(1u,4u);
+	for (int i = 0; i < 100; ++i) {
+		auto bcount = size_dist(rng);
+		flat_hash_set<int> h(bcount,std::hash<int>(),std::equal_to<int>(),thread_dist(rng));
+		BOOST_CHECK(h.bucket_count() >= bcount);
+		for (int j = 0; j < 100; ++j) {
+			h.insert(j);
+		}
+		bcount = size_dist(rng);
+		h.rehash(bcount,thread_dist(rng));
+		BOOST_CHECK(h.bucket_count() >= bcount);
+		BOOST_CHECK_EQUAL(h.size(),100u);
+		BOOST_CHECK(sanity_checker::check(h));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(flat_hash_set_serialization_test)
+{
+	flat_hash_set<integer> tmp;
+	std::uniform_int_distribution<int> int_dist(std::numeric_limits<int>::min(),
+		std::numeric_limits<int>::max());
+	std::uniform_int_distribution<unsigned> size_dist(0u,100u);
+	for (int i = 0; i < ntries; ++i) {
+		flat_hash_set<integer> h;
+		const auto size = size_dist(rng);
+		for (auto j = 0u; j < size; ++j) {
+			h.insert(integer(int_dist(rng)));
+		}
+		std::stringstream ss;
+		{
+		boost::archive::text_oarchive oa(ss);
+		oa << h;
+		}
+		{
+		boost::archive::text_iarchive ia(ss);
+		ia >> tmp;
+		}
+		BOOST_CHECK(tmp.size() == h.size());
+		for (const auto &n: h) {
+			BOOST_CHECK(tmp.find(n) != tmp.end());
+		}
+	}
+}
@@ -41,8 +41,11 @@
 #include <stdexcept>
 #include <string>
 #include <type_traits>
+#include <thread>
 #include <tuple>
+#include <vector>
 
+#include "../src/debug_access.hpp"
 #include "../src/environment.hpp"
 #include "../src/exceptions.hpp"
 #include "../src/mp_integer.hpp"
@@ -746,3 +749,158 @@ BOOST_AUTO_TEST_CASE(hash_set_serialization_test)
 	}
 	}
 }
+
+struct node_pool_tag {};
+
+namespace piranha
+{
+
+template <>
+class debug_access<node_pool_tag>
+{
+	public:
+		// Number of nodes managed by the pool of the set.
+		template <typename T>
+		static std::size_t capacity(T &h)
+		{
+			auto p = h.m_pool.load();
+			return p ? p->capacity() : 0u;
+		}
+		// Number of stripes created in the pool of the set.
+		template <typename T>
+		static unsigned n_stripes(T &h)
+		{
+			auto p = h.m_pool.load();
+			return p ? p->n_stripes_in_use() : 0u;
+		}
+};
+
+}
+
+using node_pool_tester = debug_access<node_pool_tag>;
+
+// Hasher sending all the elements in the same bucket.
+struct zero_hasher
+{
+	std::size_t operator()(int) const
+	{
+		return 0u;
+	}
+};
+
+BOOST_AUTO_TEST_CASE(hash_set_node_pool_test)
+{
+	using h_type = hash_set<int,zero_hasher>;
+	h_type h;
+	BOOST_CHECK_EQUAL(node_pool_tester::capacity(h),0u);
+	for (int i = 0; i < 1000; ++i) {
+		h.insert(i);
+	}
+	BOOST_CHECK_EQUAL(h.size(),1000u);
+	const auto cap = node_pool_tester::capacity(h);
+	BOOST_CHECK(cap >= 999u);
+	// The slabs grow geometrically from a single node.
+	BOOST_CHECK(cap < 2u * 999u);
+	// Only the stripe of the calling thread is created.
+	BOOST_CHECK_EQUAL(node_pool_tester::n_stripes(h),1u);
+	// Erase and re-insert: the nodes are recycled.
+	for (int k = 0; k < 10; ++k) {
+		for (int i = 0; i < 1000; i += 2) {
+			h.erase(h.find(i));
+		}
+		BOOST_CHECK_EQUAL(h.size(),500u);
+		for (int i = 0; i < 1000; i += 2) {
+			BOOST_CHECK(h.insert(i).second);
+		}
+		BOOST_CHECK_EQUAL(h.size(),1000u);
+	}
+	BOOST_CHECK_EQUAL(node_pool_tester::capacity(h),cap);
+	// Rehash: the nodes are recycled.
+	h.rehash(h.bucket_count() * 4u);
+	BOOST_CHECK_EQUAL(h.size(),1000u);
+	const auto cap2 = node_pool_tester::capacity(h);
+	for (int k = 0; k < 3; ++k) {
+		h.rehash(h.bucket_count() * 2u);
+	}
+	BOOST_CHECK_EQUAL(node_pool_tester::capacity(h),cap2);
+	// Clear: the nodes are released.
+	h.clear();
+	BOOST_CHECK_EQUAL(node_pool_tester::capacity(h),0u);
+	for (int i = 0; i < 1000; ++i) {
+		h.insert(i);
+	}
+	BOOST_CHECK_EQUAL(node_pool_tester::capacity(h),cap);
+	for (int i = 0; i < 1000; ++i) {
+		BOOST_CHECK(h.find(i) != h.end());
+	}
+	// Copy, move and swap. The copy allocates exactly the nodes it needs.
+	auto h2(h);
+	BOOST_CHECK_EQUAL(h2.size(),1000u);
+	BOOST_CHECK_EQUAL(node_pool_tester::capacity(h2),999u);
+	auto h3(std::move(h2));
+	BOOST_CHECK_EQUAL(node_pool_tester::capacity(h2),0u);
+	h3.swap(h2);
+	BOOST_CHECK_EQUAL(h2.size(),1000u);
+	for (int i = 0; i < 1000; ++i) {
+		BOOST_CHECK(h2.find(i) != h2.end());
+	}
+	// Concurrent insertions in different buckets from the threads in the pool.
+	thread_pool::resize(4u);
+	hash_set<int> h4(1024u);
+	thread_pool::parallel_invoke(4u,[&h4](unsigned n) {
+		for (int i = 0; i < 10000; ++i) {
+			// Element i goes in bucket i % 1024: each thread writes into a separate range of buckets.
+			const int value = i * 1024 + static_cast<int>(n) * 256 + (i % 256);
+			h4._unique_insert(value,h4._bucket(value));
+		}
+	});
+	h4._update_size(40000u);
+	for (unsigned n = 0u; n < 4u; ++n) {
+		for (int i = 0; i < 10000; ++i) {
+			BOOST_CHECK(h4.find(i * 1024 + static_cast<int>(n) * 256 + (i % 256)) != h4.end());
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(hash_set_parallel_rehash_test)
+{
+	thread_pool::resize(4u);
+	// Grow and shrink sets with a variable number of threads, and check that the content
+	// is preserved.
+	std::uniform_int_distribution<int> size_dist(0,20000), bucket_dist(1,40000);
+	std::uniform_int_distribution<unsigned> thread_dist(1u,4u);
+	for (int i = 0; i < 100; ++i) {
+		hash_set<integer> h;
+		const auto size = size_dist(rng);
+		for (int j = 0; j < size; ++j) {
+			h.insert(integer(j));
+		}
+		const auto n_buckets = static_cast<hash_set<integer>::size_type>(bucket_dist(rng));
+		h.rehash(n_buckets,thread_dist(rng));
+		if (static_cast<double>(size) / static_cast<double>(n_buckets) <= h.max_load_factor()) {
+			BOOST_CHECK(h.bucket_count() >= n_buckets);
+		}
+		BOOST_CHECK_EQUAL(h.size(),static_cast<hash_set<integer>::size_type>(size));
+		for (int j = 0; j < size; ++j) {
+			BOOST_CHECK(h.find(integer(j)) != h.end());
+		}
+		BOOST_CHECK_EQUAL(std::distance(h.begin(),h.end()),size);
+	}
+	// Colliding elements, and more threads than buckets.
+	hash_set<int,zero_hasher> h;
+	for (int i = 0; i < 1000; ++i) {
+		h.insert(i);
+	}
+	h.rehash(1u << 12u,4u);
+	h.rehash(2000u,4u);
+	BOOST_CHECK_EQUAL(h.size(),1000u);
+	for (int i = 0; i < 1000; ++i) {
+		BOOST_CHECK(h.find(i) != h.end());
+	}
+	hash_set<int> h2;
+	h2.insert(1);
+	h2.insert(2);
+	h2.rehash(2u,4u);
+	BOOST_CHECK_EQUAL(h2.size(),2u);
+	BOOST_CHECK(h2.find(1) != h2.end() && h2.find(2) != h2.end());
+}
@@ -963,6 +963,17 @@ struct subs_tester
 			BOOST_CHECK_EQUAL(ret3[0u].first,rational(1,4));
 			BOOST_CHECK((ret3[0u].second == k_type{T(0),T(3)}));
 			BOOST_CHECK((std::is_same<rational,decltype(ret3[0u].first)>::value));
+			// Exponent extraction.
+			auto e1 = k1.extract_exponent("x",vs);
+			BOOST_CHECK_EQUAL(e1.first,T(2));
+			BOOST_CHECK((e1.second == k_type{T(0),T(3)}));
+			e1 = k1.extract_exponent("y",vs);
+			BOOST_CHECK_EQUAL(e1.first,T(3));
+			BOOST_CHECK((e1.second == k_type{T(2),T(0)}));
+			e1 = k1.extract_exponent("z",vs);
+			BOOST_CHECK_EQUAL(e1.first,T(0));
+			BOOST_CHECK(e1.second == k1);
+			BOOST_CHECK_THROW(k_type{T(1)}.extract_exponent("x",vs),std::invalid_argument);
 		}
 	};
 	template <typename T>
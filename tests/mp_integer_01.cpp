@@ -2543,6 +2543,94 @@ BOOST_AUTO_TEST_CASE(mp_integer_static_integer_division_test)
 	boost::mpl::for_each<size_types>(static_test_div_tester());
 }
 
+// Static integers with a number of limbs different from two, checked against GMP.
+template <std::size_t NLimbs>
+struct static_n_limbs_tester
+{
+	template <typename T>
+	void operator()(const T &)
+	{
+		using int_type = detail::static_integer<T::value,NLimbs>;
+		using limb_t = typename int_type::limb_t;
+		const auto limb_bits = int_type::limb_bits;
+		BOOST_CHECK_EQUAL(int_type::max_bits,limb_bits * NLimbs);
+		std::uniform_int_distribution<std::size_t> size_dist(0u,NLimbs);
+		std::uniform_int_distribution<int> bit_dist(0,1);
+		// Random integer of at most n limbs, with its GMP counterpart.
+		auto random_int = [&size_dist,&bit_dist,limb_bits](std::size_t n, int_type &x, mpz_raii &m) {
+			x = int_type();
+			::mpz_set_si(&m.m_mpz,0);
+			for (limb_t i = 0u; i < limb_bits * n; ++i) {
+				if (bit_dist(rng)) {
+					x.set_bit(i);
+					::mpz_setbit(&m.m_mpz,static_cast< ::mp_bitcnt_t>(i));
+				}
+			}
+			if (bit_dist(rng)) {
+				x.negate();
+				::mpz_neg(&m.m_mpz,&m.m_mpz);
+			}
+		};
+		auto equal = [](const int_type &x, const mpz_raii &m) {
+			auto v = x.get_mpz_view();
+			return ::mpz_cmp(v,&m.m_mpz) == 0;
+		};
+		auto fits = [limb_bits](const mpz_raii &m) {
+			return ::mpz_sizeinbase(&m.m_mpz,2) <= limb_bits * NLimbs;
+		};
+		int_type a, b, c;
+		mpz_raii ma, mb, mc, mr, mq;
+		for (int i = 0; i < ntries; ++i) {
+			const std::size_t na = size_dist(rng), nb = size_dist(rng);
+			random_int(na,a,ma);
+			random_int(nb,b,mb);
+			// Addition and subtraction.
+			::mpz_add(&mr.m_mpz,&ma.m_mpz,&mb.m_mpz);
+			BOOST_CHECK_EQUAL(int_type::add(c,a,b),fits(mr) ? 0 : 1);
+			BOOST_CHECK(!fits(mr) || equal(c,mr));
+			::mpz_sub(&mr.m_mpz,&ma.m_mpz,&mb.m_mpz);
+			BOOST_CHECK_EQUAL(int_type::sub(c,a,b),fits(mr) ? 0 : 1);
+			BOOST_CHECK(!fits(mr) || equal(c,mr));
+			// Multiplication, computed in static storage if the sum of the sizes fits.
+			::mpz_mul(&mr.m_mpz,&ma.m_mpz,&mb.m_mpz);
+			const bool mul_ok = a.is_zero() || b.is_zero() || a.abs_size() + b.abs_size() <= detail::mpz_size_t(NLimbs);
+			BOOST_CHECK_EQUAL(int_type::mul(c,a,b),mul_ok ? 0 : 1);
+			BOOST_CHECK(!mul_ok || equal(c,mr));
+			// Multiply-accumulate.
+			random_int(size_dist(rng),c,mc);
+			::mpz_addmul(&mc.m_mpz,&ma.m_mpz,&mb.m_mpz);
+			if (mul_ok) {
+				BOOST_CHECK_EQUAL(c.multiply_accumulate(a,b),fits(mc) ? 0 : 1);
+				BOOST_CHECK(!fits(mc) || equal(c,mc));
+			} else {
+				BOOST_CHECK_EQUAL(c.multiply_accumulate(a,b),1);
+			}
+			// Division.
+			if (!b.is_zero()) {
+				::mpz_tdiv_qr(&mq.m_mpz,&mr.m_mpz,&ma.m_mpz,&mb.m_mpz);
+				int_type::div(c,a,a,b);
+				BOOST_CHECK(equal(c,mq));
+				BOOST_CHECK(equal(a,mr));
+				BOOST_CHECK(c.consistency_checks() && a.consistency_checks());
+			}
+			// Left shift.
+			if (b.bits_size() < int_type::max_bits) {
+				::mpz_mul_2exp(&mr.m_mpz,&mb.m_mpz,1u);
+				b.lshift1();
+				BOOST_CHECK(equal(b,mr));
+				BOOST_CHECK(b.consistency_checks());
+			}
+		}
+	}
+};
+
+BOOST_AUTO_TEST_CASE(mp_integer_static_integer_n_limbs_test)
+{
+	boost::mpl::for_each<size_types>(static_n_limbs_tester<1u>());
+	boost::mpl::for_each<size_types>(static_n_limbs_tester<3u>());
+	boost::mpl::for_each<size_types>(static_n_limbs_tester<4u>());
+}
+
 struct union_ctor_tester
 {
 	template <typename T>
@@ -4296,3 +4384,56 @@ BOOST_AUTO_TEST_CASE(mp_integer_stream_test)
 {
 	boost::mpl::for_each<size_types>(stream_tester());
 }
+
+struct n_limbs_tester
+{
+	template <typename T>
+	void operator()(const T &)
+	{
+		using int_type = mp_integer<T::value,4u>;
+		using int_type2 = mp_integer<T::value>;
+		const auto limb_bits = detail::static_integer<T::value,4u>::limb_bits;
+		// A number of slightly more than one limb.
+		int_type n(1);
+		int_type2 n2(1);
+		for (unsigned i = 0u; i < limb_bits + 1u; ++i) {
+			n *= 2;
+			n2 *= 2;
+		}
+		n += 1;
+		n2 += 1;
+		BOOST_CHECK(n.is_static());
+		// The product of two 2-limb numbers is computed in static storage.
+		auto p = n * n;
+		auto p2 = n2 * n2;
+		BOOST_CHECK(p.is_static());
+		BOOST_CHECK(!p2.is_static());
+		BOOST_CHECK_EQUAL(boost::lexical_cast<std::string>(p),boost::lexical_cast<std::string>(p2));
+		BOOST_CHECK_EQUAL(p.hash(),p2.hash());
+		BOOST_CHECK_EQUAL(p / n,n);
+		BOOST_CHECK_EQUAL(p % n,0);
+		p.multiply_accumulate(n,-n);
+		BOOST_CHECK(p.is_static());
+		BOOST_CHECK_EQUAL(p,0);
+		// Promotion when exceeding the static storage.
+		p = n * n * n;
+		BOOST_CHECK(!p.is_static());
+		BOOST_CHECK_EQUAL(boost::lexical_cast<std::string>(p),boost::lexical_cast<std::string>(n2 * n2 * n2));
+		BOOST_CHECK_EQUAL(boost::lexical_cast<std::string>(int_type(-3).pow(100)),
+			boost::lexical_cast<std::string>(int_type2(-3).pow(100)));
+		BOOST_CHECK_EQUAL(std::hash<int_type>()(int_type(42)),std::hash<int_type2>()(int_type2(42)));
+		BOOST_CHECK(detail::is_mp_integer<int_type>::value);
+		// 1 limb only.
+		using int_type1 = mp_integer<T::value,1u>;
+		int_type1 m(3);
+		BOOST_CHECK(m.is_static());
+		BOOST_CHECK_EQUAL(m * m,9);
+		BOOST_CHECK(!(m * m).is_static());
+		BOOST_CHECK_EQUAL(boost::lexical_cast<std::string>(int_type1(-12345) / int_type1(-7)),"1763");
+	}
+};
+
+BOOST_AUTO_TEST_CASE(mp_integer_n_limbs_test)
+{
+	boost::mpl::for_each<size_types>(n_limbs_tester());
+}
@@ -2730,3 +2730,43 @@ BOOST_AUTO_TEST_CASE(mp_integer_mpz_t_ctor_test)
 {
 	boost::mpl::for_each<size_types>(mpz_t_ctor_tester());
 }
+
+struct div_2exp_tester
+{
+	template <typename T>
+	void operator()(const T &)
+	{
+		typedef mp_integer<T::value> int_type;
+		detail::mpz_raii m;
+		std::uniform_int_distribution<long long> int_dist;
+		std::uniform_int_distribution<unsigned> shift_dist(0u,200u), bool_dist(0u,1u);
+		BOOST_CHECK_EQUAL(int_type(0).div_2exp(0u),0);
+		BOOST_CHECK_EQUAL(int_type(0).div_2exp(5u),0);
+		BOOST_CHECK_EQUAL(int_type(5).div_2exp(1u),2);
+		BOOST_CHECK_EQUAL(int_type(-5).div_2exp(1u),-2);
+		BOOST_CHECK_EQUAL(int_type(-1).div_2exp(1u),0);
+		BOOST_CHECK_EQUAL(int_type(7).div_2exp(1000u),0);
+		for (int i = 0; i < ntries; ++i) {
+			// Build a random integer of up to 3 long long factors, randomly promoting it.
+			::mpz_set_si(&m.m_mpz,int_dist(rng));
+			::mpz_mul_si(&m.m_mpz,&m.m_mpz,int_dist(rng));
+			if (bool_dist(rng)) {
+				::mpz_mul_si(&m.m_mpz,&m.m_mpz,int_dist(rng));
+			}
+			int_type n{&m.m_mpz}, n_copy(n);
+			if (n.is_static() && bool_dist(rng)) {
+				n.promote();
+			}
+			const unsigned s = shift_dist(rng);
+			n.div_2exp(s);
+			BOOST_CHECK_EQUAL(n,n_copy / int_type(2).pow(s));
+			::mpz_tdiv_q_2exp(&m.m_mpz,&m.m_mpz,s);
+			BOOST_CHECK_EQUAL(n,int_type{&m.m_mpz});
+		}
+	}
+};
+
+BOOST_AUTO_TEST_CASE(mp_integer_div_2exp_test)
+{
+	boost::mpl::for_each<size_types>(div_2exp_tester());
+}
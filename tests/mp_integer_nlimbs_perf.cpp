@@ -0,0 +1,101 @@
+/***************************************************************************
+ *   Copyright (C) 2009-2011 by Francesco Biscani                          *
+ *   bluescarni@gmail.com                                                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "../src/mp_integer.hpp"
+
+#define BOOST_TEST_MODULE mp_integer_nlimbs_test
+#include <boost/test/unit_test.hpp>
+
+#include <boost/lexical_cast.hpp>
+#include <chrono>
+#include <cstddef>
+#include <iomanip>
+#include <iostream>
+#include <string>
+
+#include "../src/environment.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/settings.hpp"
+
+using namespace piranha;
+
+// Comparison of the static storage sizes of mp_integer on workloads whose coefficients
+// exceed 128 bits. For each limb count, the runtime and the fraction of coefficients in the result
+// which had to be promoted to dynamic storage are printed. The workloads are variations of Fateman's
+// first benchmark, f * (f + 1) with f = (1+x+y+z+t)**n, in which the coefficients of the operands are
+// scaled by large factors.
+
+static const unsigned n_power = 16u;
+
+template <std::size_t NLimbs>
+static std::string run_workload(const std::string &f_factor, const std::string &g_factor)
+{
+	using int_type = mp_integer<64,NLimbs>;
+	using p_type = polynomial<int_type,k_monomial>;
+	p_type x("x"), y("y"), z("z"), t("t");
+	auto f = x + y + z + t + 1;
+	auto tmp(f);
+	for (auto i = 1u; i < n_power; ++i) {
+		f *= tmp;
+	}
+	auto g = f + 1;
+	f *= int_type(f_factor);
+	g *= int_type(g_factor);
+	const auto start = std::chrono::steady_clock::now();
+	const auto res = f * g;
+	const auto runtime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::size_t n_promoted = 0u;
+	for (const auto &term: res._container()) {
+		n_promoted += !term.m_cf.is_static();
+	}
+	std::cout << "Limbs: " << NLimbs << ", time: " << runtime << "s, promoted: " << std::setprecision(4)
+		<< 100. * static_cast<double>(n_promoted) / static_cast<double>(res.size()) << "%\n";
+	return boost::lexical_cast<std::string>(res);
+}
+
+static void run_all(const std::string &f_factor, const std::string &g_factor)
+{
+	const auto r2 = run_workload<2u>(f_factor,g_factor);
+	const auto r3 = run_workload<3u>(f_factor,g_factor);
+	const auto r4 = run_workload<4u>(f_factor,g_factor);
+	BOOST_CHECK(r2 == r3);
+	BOOST_CHECK(r2 == r4);
+}
+
+BOOST_AUTO_TEST_CASE(mp_integer_nlimbs_setup)
+{
+	environment env;
+	settings::set_n_threads(1u);
+}
+
+BOOST_AUTO_TEST_CASE(mp_integer_nlimbs_two_by_one_test)
+{
+	// Two-limb coefficients times one-limb coefficients, results in three limbs.
+	std::cout << "Two-limb by one-limb coefficients:\n";
+	run_all("1180591620717411303424","1");
+}
+
+BOOST_AUTO_TEST_CASE(mp_integer_nlimbs_two_by_two_test)
+{
+	// Two-limb coefficients times two-limb coefficients, results in four limbs.
+	std::cout << "Two-limb by two-limb coefficients:\n";
+	run_all("1180591620717411303424","1180591620717411303425");
+}
@@ -0,0 +1,95 @@
+/***************************************************************************
+ *   Copyright (C) 2009-2011 by Francesco Biscani                          *
+ *   bluescarni@gmail.com                                                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+#include "../src/polynomial.hpp"
+
+#define BOOST_TEST_MODULE multi_modular_test
+#include <boost/test/unit_test.hpp>
+
+#include <boost/lexical_cast.hpp>
+#include <chrono>
+#include <iostream>
+
+#include "../src/environment.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/mp_integer.hpp"
+#include "../src/settings.hpp"
+#include "../src/tuning.hpp"
+
+using namespace piranha;
+
+// Comparison of the standard and multi-modular multiplication of polynomials with large integer coefficients.
+// The workloads are variations of Fateman's first benchmark, f * (f + 1) with f = (1+x+y+z+t)**n, in which
+// the coefficients of the operands are scaled by 2**n_bits + 1.
+
+using p_type = polynomial<integer,k_monomial>;
+
+static const unsigned n_power = 16u;
+
+static p_type run_workload(unsigned n_bits, integer_multiplication m)
+{
+	p_type x("x"), y("y"), z("z"), t("t");
+	auto f = x + y + z + t + 1;
+	auto tmp(f);
+	for (auto i = 1u; i < n_power; ++i) {
+		f *= tmp;
+	}
+	auto g = f + 1;
+	const integer factor = integer(2).pow(n_bits) + 1;
+	f *= factor;
+	g *= -factor;
+	tuning::set_integer_multiplication(m);
+	const auto start = std::chrono::steady_clock::now();
+	auto res = f * g;
+	const auto runtime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	tuning::reset_integer_multiplication();
+	std::cout << (m == integer_multiplication::standard ? "Standard" : "Multi-modular") << ", " << n_bits
+		<< " bits: " << runtime << "s\n";
+	return res;
+}
+
+static void run_all(unsigned n_bits)
+{
+	const auto r1 = run_workload(n_bits,integer_multiplication::standard);
+	const auto r2 = run_workload(n_bits,integer_multiplication::multi_modular);
+	BOOST_CHECK(r1 == r2);
+}
+
+BOOST_AUTO_TEST_CASE(multi_modular_setup)
+{
+	environment env;
+	if (boost::unit_test::framework::master_test_suite().argc > 1) {
+		settings::set_n_threads(boost::lexical_cast<unsigned>(boost::unit_test::framework::master_test_suite().argv[1u]));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(multi_modular_128_test)
+{
+	run_all(128u);
+}
+
+BOOST_AUTO_TEST_CASE(multi_modular_512_test)
+{
+	run_all(512u);
+}
+
+BOOST_AUTO_TEST_CASE(multi_modular_1024_test)
+{
+	run_all(1024u);
+}
@@ -23,12 +23,14 @@
 #define BOOST_TEST_MODULE poisson_series_test
 #include <boost/test/unit_test.hpp>
 
+#include <array>
 #include <boost/lexical_cast.hpp>
 #include <boost/mpl/for_each.hpp>
 #include <boost/mpl/vector.hpp>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
@@ -39,6 +41,7 @@
 #include "../src/environment.hpp"
 #include "../src/exceptions.hpp"
 #include "../src/invert.hpp"
+#include "../src/kronecker_array.hpp"
 #include "../src/math.hpp"
 #include "../src/monomial.hpp"
 #include "../src/mp_integer.hpp"
@@ -50,6 +53,7 @@
 #include "../src/real.hpp"
 #include "../src/serialization.hpp"
 #include "../src/series.hpp"
+#include "../src/settings.hpp"
 #include "../src/symbol_set.hpp"
 #include "../src/type_traits.hpp"
 
@@ -940,3 +944,42 @@ BOOST_AUTO_TEST_CASE(poisson_series_multiplier_test)
 	settings::reset_min_work_per_thread();
 	}
 }
+
+BOOST_AUTO_TEST_CASE(poisson_series_packed_multiplier_test)
+{
+	// Check the multiplication on the codified trigonometric keys against the term-by-term multiplication.
+	using ps = poisson_series<polynomial<integer,monomial<short>>>;
+	using term_type = ps::term_type;
+	using key_type = term_type::key_type;
+	using math::cos;
+	using math::sin;
+	ps x{"x"}, y{"y"}, a{"a"}, b{"b"}, c{"c"};
+	auto f = math::pow(x*cos(a) + y*sin(b - 2*c) + 3*cos(a - b + c) + x*y*sin(2*a + c),3);
+	auto g = math::pow(y*cos(b) - 2*x*sin(a + 3*b) + cos(c - a) + sin(3*a - b - c),3);
+	BOOST_CHECK(f.get_symbol_set() == g.get_symbol_set());
+	ps cmp;
+	cmp.set_symbol_set(f.get_symbol_set());
+	std::array<term_type,2u> tmp;
+	for (const auto &t1: f._container()) {
+		for (const auto &t2: g._container()) {
+			key_type::multiply(tmp,t1,t2,f.get_symbol_set());
+			cmp.insert(tmp[0u]);
+			cmp.insert(tmp[1u]);
+		}
+	}
+	cmp /= 2;
+	settings::set_min_work_per_thread(1u);
+	for (unsigned nt = 1u; nt <= 4u; ++nt) {
+		settings::set_n_threads(nt);
+		BOOST_CHECK_EQUAL(f * g,cmp);
+	}
+	settings::reset_n_threads();
+	settings::reset_min_work_per_thread();
+	// Multipliers at the limits of the codification: the multiplication falls back to the unpacked keys.
+	using ka = kronecker_array<key_type::value_type>;
+	const auto max = std::get<0u>(ka::get_limits()[1u])[0u];
+	BOOST_CHECK_THROW(cos(ps{max} * a) * cos(a),std::invalid_argument);
+	const auto &mm2 = std::get<0u>(ka::get_limits()[2u]);
+	const ps ma{mm2[0u]}, mb{mm2[1u]};
+	BOOST_CHECK_EQUAL(cos(ma * a) * cos(mb * b),(cos(ma * a + mb * b) + cos(ma * a - mb * b))/2);
+}
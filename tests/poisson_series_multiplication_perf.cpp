@@ -0,0 +1,102 @@
+/***************************************************************************
+ *   Copyright (C) 2009-2011 by Francesco Biscani                          *
+ *   bluescarni@gmail.com                                                  *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) any later version.                                   *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.             *
+ ***************************************************************************/
+
+#include "../src/poisson_series.hpp"
+
+#define BOOST_TEST_MODULE poisson_series_multiplication_test
+#include <boost/test/unit_test.hpp>
+
+#include <array>
+#include <boost/lexical_cast.hpp>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "../src/environment.hpp"
+#include "../src/kronecker_monomial.hpp"
+#include "../src/math.hpp"
+#include "../src/polynomial.hpp"
+#include "../src/real_trigonometric_kronecker_monomial.hpp"
+#include "../src/settings.hpp"
+
+using namespace piranha;
+
+// Multiplication of Poisson series, comparing the term-by-term multiplication of the trigonometric keys
+// performed on the unpacked multipliers with the one performed on the codified values of the keys.
+
+using ps_type = poisson_series<polynomial<double,k_monomial>>;
+
+static ps_type workload()
+{
+	ps_type l{"l"}, g{"g"}, h{"h"}, k{"k"};
+	auto f = 1 + math::cos(l) / 2 + math::sin(g) / 3 + math::cos(h) / 5 + math::cos(l - g + k) / 7 +
+		math::sin(l + h - 2 * k) / 11;
+	return math::pow(f,6);
+}
+
+template <typename F>
+static double time_key_multiplication(const ps_type &f, const F &mult)
+{
+	using term_type = ps_type::term_type;
+	std::vector<const term_type *> v;
+	for (const auto &t: f._container()) {
+		v.push_back(&t);
+	}
+	std::array<term_type,term_type::key_type::multiply_arity> res;
+	const auto &args = f.get_symbol_set();
+	double acc = 0.;
+	const auto start = std::chrono::steady_clock::now();
+	for (const auto &p1: v) {
+		for (const auto &p2: v) {
+			mult(res,*p1,*p2,args);
+			acc += static_cast<double>(res[0u].m_key.get_int() + res[1u].m_key.get_int());
+		}
+	}
+	const auto runtime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::cout << "(checksum: " << acc << ") ";
+	return runtime;
+}
+
+BOOST_AUTO_TEST_CASE(poisson_series_multiplication_test)
+{
+	environment env;
+	if (boost::unit_test::framework::master_test_suite().argc > 1) {
+		settings::set_n_threads(boost::lexical_cast<unsigned>(boost::unit_test::framework::master_test_suite().argv[1u]));
+	}
+	using term_type = ps_type::term_type;
+	using key_type = term_type::key_type;
+	const auto f = workload();
+	std::cout << "Operand size: " << f.size() << '\n';
+	std::cout << "Unpacked key multiplication: ";
+	const auto t_unpacked = time_key_multiplication(f,[](std::array<term_type,key_type::multiply_arity> &res,
+		const term_type &t1, const term_type &t2, const symbol_set &args) {key_type::multiply(res,t1,t2,args);});
+	std::cout << t_unpacked << "s\n";
+	std::cout << "Packed key multiplication: ";
+	const auto t_packed = time_key_multiplication(f,[](std::array<term_type,key_type::multiply_arity> &res,
+		const term_type &t1, const term_type &t2, const symbol_set &args) {key_type::multiply_packed(res,t1,t2,args);});
+	std::cout << t_packed << "s\n";
+	// Series multiplication, performed on the codified values of the keys.
+	const auto start = std::chrono::steady_clock::now();
+	const auto res = f * f;
+	std::cout << "Series multiplication: " << std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()
+		<< "s, " << res.size() << " terms\n";
+	// NOTE: the coefficients are floating-point, compare only the number of terms.
+	BOOST_CHECK_EQUAL(res.size(),math::pow(workload(),2).size());
+}
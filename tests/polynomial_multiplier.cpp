@@ -27,10 +27,13 @@
 #include <boost/mpl/vector.hpp>
 #include <cstddef>
 #include <cstdint>
+#include <future>
 #include <limits>
+#include <map>
 #include <stdexcept>
 #include <tuple>
 #include <type_traits>
+#include <vector>
 
 #include "../src/environment.hpp"
 #include "../src/kronecker_array.hpp"
@@ -42,6 +45,7 @@
 #include "../src/settings.hpp"
 #include "../src/symbol.hpp"
 #include "../src/symbol_set.hpp"
+#include "../src/tuning.hpp"
 
 using namespace piranha;
 
@@ -333,3 +337,219 @@ BOOST_AUTO_TEST_CASE(polynomial_multiplier_multiplier_finalise_test)
 	}
 	settings::reset_n_threads();
 }
+
+// Flatten a polynomial into a map from exponents to coefficients, so that results computed
+// with different key types can be compared.
+template <typename Cf, typename Key>
+static std::map<std::vector<int>,Cf> to_map(const polynomial<Cf,Key> &p)
+{
+	std::map<std::vector<int>,Cf> retval;
+	for (const auto &t: p._container()) {
+		std::vector<int> v;
+		for (const auto &n: t.m_key.unpack(p.get_symbol_set())) {
+			v.push_back(static_cast<int>(n));
+		}
+		retval[v] = t.m_cf;
+	}
+	return retval;
+}
+
+template <typename Cf>
+static std::map<std::vector<int>,Cf> to_map(const polynomial<Cf,monomial<int>> &p)
+{
+	std::map<std::vector<int>,Cf> retval;
+	for (const auto &t: p._container()) {
+		retval[std::vector<int>(t.m_key.begin(),t.m_key.end())] = t.m_cf;
+	}
+	return retval;
+}
+
+struct dense_tester
+{
+	template <typename Cf>
+	void operator()(const Cf &)
+	{
+		using pt1 = polynomial<Cf,k_monomial>;
+		using pt2 = polynomial<Cf,monomial<int>>;
+		// Compute the same products with Kronecker and plain monomials and compare.
+		auto checker = [](const pt1 &a1, const pt1 &b1, const pt2 &a2, const pt2 &b2) {
+			const auto r1 = a1 * b1;
+			const auto r2 = a2 * b2;
+			BOOST_CHECK_EQUAL(r1.size(),r2.size());
+			BOOST_CHECK((to_map(r1) == to_map(r2)));
+		};
+		pt1 x1{"x"}, y1{"y"}, z1{"z"};
+		pt2 x2{"x"}, y2{"y"}, z2{"z"};
+		// Univariate, dense.
+		checker(math::pow(1 + x1,20),math::pow(1 - x1,15),math::pow(1 + x2,20),math::pow(1 - x2,15));
+		// Multivariate, dense, with negative exponents and cancellations.
+		checker(math::pow(x1.pow(-1) + y1 + z1 - 2,8),math::pow(x1 - y1.pow(-2) + z1 + 1,7) * (x1 - 1),
+			math::pow(x2.pow(-1) + y2 + z2 - 2,8),math::pow(x2 - y2.pow(-2) + z2 + 1,7) * (x2 - 1));
+		// Complete cancellation.
+		checker(1 + x1 * y1,x1 * y1 - 1 - x1 * y1 + 1,1 + x2 * y2,x2 * y2 - 1 - x2 * y2 + 1);
+		// Sparse, will use the hash-based multiplication.
+		checker(math::pow(x1.pow(100) + y1.pow(-50) + z1.pow(70) + 1,3),math::pow(x1.pow(-30) + y1.pow(90) + z1 + 2,3),
+			math::pow(x2.pow(100) + y2.pow(-50) + z2.pow(70) + 1,3),math::pow(x2.pow(-30) + y2.pow(90) + z2 + 2,3));
+	}
+};
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_dense_test)
+{
+	settings::set_min_work_per_thread(1u);
+	for (unsigned nt = 1u; nt <= 4u; ++nt) {
+		settings::set_n_threads(nt);
+		boost::mpl::for_each<cf_types>(dense_tester());
+	}
+	settings::reset_n_threads();
+	settings::reset_min_work_per_thread();
+}
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_work_stealing_test)
+{
+	using pt1 = polynomial<integer,k_monomial>;
+	using pt2 = polynomial<integer,monomial<int>>;
+	using sm_type = series_multiplier<pt1>;
+	settings::set_min_work_per_thread(1u);
+	pt1 x1{"x"}, y1{"y"}, z1{"z"};
+	pt2 x2{"x"}, y2{"y"}, z2{"z"};
+	// Sparse operands with a skewed distribution of the terms.
+	const auto a1 = math::pow(x1.pow(200) + y1.pow(-70) + z1.pow(30) + 1,6) + math::pow(x1 + y1 + z1,8),
+		b1 = math::pow(x1.pow(-40) + y1.pow(110) + z1 + 2,6) * (x1 * y1 - z1);
+	const auto a2 = math::pow(x2.pow(200) + y2.pow(-70) + z2.pow(30) + 1,6) + math::pow(x2 + y2 + z2,8),
+		b2 = math::pow(x2.pow(-40) + y2.pow(110) + z2 + 2,6) * (x2 * y2 - z2);
+	const auto r2 = to_map(a2 * b2);
+	for (unsigned nt = 2u; nt <= 4u; ++nt) {
+		settings::set_n_threads(nt);
+		const auto r1 = a1 * b1;
+		BOOST_CHECK((to_map(r1) == r2));
+		const auto stats = sm_type::get_thread_stats();
+		BOOST_CHECK_EQUAL(stats.size(),nt);
+		unsigned n_zones = 0u;
+		for (const auto &t: stats) {
+			BOOST_CHECK(std::get<0u>(t) >= 0.);
+			BOOST_CHECK(std::get<1u>(t) >= 0.);
+			BOOST_CHECK(std::get<3u>(t) <= std::get<2u>(t));
+			n_zones += std::get<2u>(t);
+		}
+		// Every zone is consumed exactly once, and there are at least 8 zones per thread.
+		BOOST_CHECK(n_zones >= nt * 8u);
+		BOOST_CHECK_EQUAL(n_zones % nt,0u);
+		// The statistics are kept per calling thread.
+		BOOST_CHECK(std::async(std::launch::async,[]() {return sm_type::get_thread_stats().empty();}).get());
+	}
+	settings::reset_n_threads();
+	settings::reset_min_work_per_thread();
+}
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_table_growth_test)
+{
+	using pt1 = polynomial<integer,k_monomial>;
+	using pt2 = polynomial<integer,monomial<int>>;
+	settings::set_min_work_per_thread(1u);
+	pt1 x1{"x"}, y1{"y"}, z1{"z"};
+	pt2 x2{"x"}, y2{"y"}, z2{"z"};
+	// Operands made of a dense core plus a sparse tail. The random term-by-term products performed by the
+	// size estimator fall mostly into the core, so that the final size is underestimated by a large factor
+	// and retval needs to be grown during the multiplication.
+	pt1 a1 = math::pow(1 + x1 + y1 + z1,16), b1 = a1;
+	pt2 a2 = math::pow(1 + x2 + y2 + z2,16), b2 = a2;
+	for (int i = 0; i < 100; ++i) {
+		a1 += x1.pow(100 + 50 * i) * y1.pow(i);
+		b1 += z1.pow(100 + 50 * i) * y1.pow(i);
+		a2 += x2.pow(100 + 50 * i) * y2.pow(i);
+		b2 += z2.pow(100 + 50 * i) * y2.pow(i);
+	}
+	const auto r2 = to_map(a2 * b2);
+	for (unsigned nt = 1u; nt <= 4u; ++nt) {
+		settings::set_n_threads(nt);
+		const auto r1 = a1 * b1;
+		BOOST_CHECK_EQUAL(r1.size(),r2.size());
+		BOOST_CHECK((to_map(r1) == r2));
+	}
+	settings::reset_n_threads();
+	settings::reset_min_work_per_thread();
+}
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_accumulator_test)
+{
+	using pt1 = polynomial<integer,k_monomial>;
+	using pt2 = polynomial<integer,monomial<int>>;
+	settings::set_min_work_per_thread(1u);
+	pt1 x1{"x"}, y1{"y"};
+	pt2 x2{"x"}, y2{"y"};
+	// Sparse operands with coefficients close to the limits of a single limb and alternating signs.
+	// Many products end up in the same term of the result, and their sums exceed 2**128.
+	const integer max_limb = integer(2).pow(64) - 1;
+	pt1 a1, b1;
+	pt2 a2, b2;
+	for (int i = 0; i < 12; ++i) {
+		for (int j = 0; j < 12; ++j) {
+			const integer c1 = ((i + j) % 2 ? -1 : 1) * (max_limb - i - j), c2 = (i % 3 ? 1 : -1) * (max_limb / 2 + i * j);
+			a1 += c1 * x1.pow(100 * i) * y1.pow(100 * j);
+			a2 += c1 * x2.pow(100 * i) * y2.pow(100 * j);
+			b1 += c2 * x1.pow(100 * j) * y1.pow(-100 * i);
+			b2 += c2 * x2.pow(100 * j) * y2.pow(-100 * i);
+		}
+	}
+	const auto r2 = to_map(a2 * b2);
+	for (unsigned nt = 1u; nt <= 4u; ++nt) {
+		settings::set_n_threads(nt);
+		const auto r1 = a1 * b1;
+		BOOST_CHECK_EQUAL(r1.size(),r2.size());
+		BOOST_CHECK((to_map(r1) == r2));
+		// Changing the sign of an operand changes the signs of all the accumulated products.
+		BOOST_CHECK_EQUAL((a1 * (-b1) + r1).size(),0u);
+		// A coefficient which does not fit in a limb disables the accumulation.
+		BOOST_CHECK((to_map((a1 + max_limb + 1) * b1) == to_map((a2 + max_limb + 1) * b2)));
+	}
+	// Rational coefficients, whose renormalised numerators are accumulated.
+	using pq1 = polynomial<rational,k_monomial>;
+	using pq2 = polynomial<rational,monomial<int>>;
+	pq1 xq1{"x"}, yq1{"y"}, zq1{"z"};
+	pq2 xq2{"x"}, yq2{"y"}, zq2{"z"};
+	const auto fq1 = (xq1 + yq1 / 2 + zq1 / 3 + 1).pow(8), gq1 = (xq1 - yq1 / 5 + 3 * zq1 / 7 - 2).pow(7);
+	const auto fq2 = (xq2 + yq2 / 2 + zq2 / 3 + 1).pow(8), gq2 = (xq2 - yq2 / 5 + 3 * zq2 / 7 - 2).pow(7);
+	const auto rq2 = to_map(fq2 * gq2);
+	for (unsigned nt = 1u; nt <= 4u; ++nt) {
+		settings::set_n_threads(nt);
+		BOOST_CHECK((to_map(fq1 * gq1) == rq2));
+		// Integral rational coefficients.
+		const auto hq1 = (xq1 + 2 * yq1 - zq1 + 1).pow(10);
+		const auto hq2 = (xq2 + 2 * yq2 - zq2 + 1).pow(10);
+		BOOST_CHECK((to_map(hq1 * (hq1 + 1)) == to_map(hq2 * (hq2 + 1))));
+	}
+	settings::reset_n_threads();
+	settings::reset_min_work_per_thread();
+}
+
+BOOST_AUTO_TEST_CASE(polynomial_multiplier_multi_modular_test)
+{
+	using pt1 = polynomial<integer,k_monomial>;
+	using pt2 = polynomial<integer,monomial<int>>;
+	settings::set_min_work_per_thread(1u);
+	pt1 x1{"x"}, y1{"y"}, z1{"z"};
+	pt2 x2{"x"}, y2{"y"}, z2{"z"};
+	// Multi-limb coefficients with mixed signs, spanning a few primes.
+	const integer big = integer(2).pow(300) + 1;
+	const auto a1 = (big * x1 - 3 * y1 + (big - 2) * z1 - big * 5).pow(6), b1 = (x1 + big * y1 - z1 - 1).pow(5);
+	const auto a2 = (big * x2 - 3 * y2 + (big - 2) * z2 - big * 5).pow(6), b2 = (x2 + big * y2 - z2 - 1).pow(5);
+	const auto r2 = to_map(a2 * b2);
+	tuning::set_integer_multiplication(integer_multiplication::multi_modular);
+	for (unsigned nt = 1u; nt <= 4u; ++nt) {
+		settings::set_n_threads(nt);
+		const auto r1 = a1 * b1;
+		BOOST_CHECK_EQUAL(r1.size(),r2.size());
+		BOOST_CHECK((to_map(r1) == r2));
+		// Cancellations in the result.
+		BOOST_CHECK_EQUAL((a1 * (-b1) + r1).size(),0u);
+		BOOST_CHECK((to_map((a1 + 1) * (a1 - 1)) == to_map((a2 + 1) * (a2 - 1))));
+		// Small coefficients, with a single prime.
+		BOOST_CHECK((to_map((x1 - y1 + 1).pow(4) * (x1 + y1 - 1).pow(3)) == to_map((x2 - y2 + 1).pow(4) * (x2 + y2 - 1).pow(3))));
+		// Coefficients too large for the available primes fall back to the standard multiplication.
+		const integer huge = integer(2).pow(2500);
+		BOOST_CHECK((to_map((a1 + huge) * b1) == to_map((a2 + huge) * b2)));
+	}
+	tuning::reset_integer_multiplication();
+	settings::reset_n_threads();
+	settings::reset_min_work_per_thread();
+}
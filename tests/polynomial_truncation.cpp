@@ -38,6 +38,7 @@
 #include "../src/mp_rational.hpp"
 #include "../src/real.hpp"
 #include "../src/settings.hpp"
+#include "../src/tuning.hpp"
 
 using namespace piranha;
 
@@ -201,3 +202,37 @@ BOOST_AUTO_TEST_CASE(polynomial_truncation_recursive_test)
 	BOOST_CHECK(x*x*x*x*x*y*z == 0);
 	p1::unset_auto_truncate_degree();
 }
+
+struct kronecker_tester
+{
+	template <typename Cf>
+	void operator()(const Cf &)
+	{
+		// Check the truncated Kronecker multiplication against the truncation of the full product.
+		using pt = polynomial<Cf,k_monomial>;
+		pt x{"x"}, y{"y"}, z{"z"}, t{"t"};
+		auto f = (1 + x + 2*y + z*z + t.pow(3) + x.pow(-1)).pow(4), g = (1 - x + y*y - 3*z + t*x.pow(-1)).pow(4);
+		settings::set_min_work_per_thread(1u);
+		// Small blocks, to have many partially truncated blocks.
+		tuning::set_multiplication_block_size(16u);
+		for (unsigned nt = 1u; nt <= 4u; ++nt) {
+			settings::set_n_threads(nt);
+			const auto full = f * g;
+			for (int d = -4; d <= 20; d += 3) {
+				pt::set_auto_truncate_degree(d);
+				BOOST_CHECK_EQUAL(f * g,math::truncate_degree(full,d));
+				pt::set_auto_truncate_degree(d,{"x","t"});
+				BOOST_CHECK_EQUAL(f * g,math::truncate_degree(full,d,{"x","t"}));
+				pt::unset_auto_truncate_degree();
+			}
+		}
+		tuning::reset_multiplication_block_size();
+		settings::reset_n_threads();
+		settings::reset_min_work_per_thread();
+	}
+};
+
+BOOST_AUTO_TEST_CASE(polynomial_truncation_kronecker_test)
+{
+	boost::mpl::for_each<cf_types>(kronecker_tester());
+}
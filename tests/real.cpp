@@ -29,6 +29,7 @@
 #include <boost/fusion/include/algorithm.hpp>
 #include <boost/fusion/include/sequence.hpp>
 #include <boost/fusion/sequence.hpp>
+#include <algorithm>
 #include <boost/lexical_cast.hpp>
 #include <complex>
 #include <limits>
@@ -36,6 +37,7 @@
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
@@ -2185,3 +2187,52 @@ BOOST_AUTO_TEST_CASE(real_mpfr_t_get_test)
 	const real r1{-1};
 	BOOST_CHECK(r1.get_mpfr_t() != nullptr);
 }
+
+BOOST_AUTO_TEST_CASE(real_scratch_test)
+{
+	// The temporaries of the in-place operations with floating-point values, of multiply_accumulate() and of
+	// binomial() live in thread-local scratch floats whose precision changes on demand. Interleave operations
+	// at different precisions and check the results against reference computations without temporaries.
+	std::uniform_real_distribution<double> value_dist(-10.,10.);
+	const ::mpfr_prec_t precs[] = {real::default_prec, 500, 20, real::default_prec + 1};
+	auto checker = [&value_dist,&precs](std::mt19937 &eng) {
+		bool retval = true;
+		for (int i = 0; i < ntries; ++i) {
+			const auto prec = precs[i % 4];
+			const double d = value_dist(eng);
+			real r{value_dist(eng),prec}, cmp{r};
+			r += d;
+			cmp += real{d,prec};
+			retval = retval && r == cmp && r.get_prec() == prec;
+			r /= d;
+			cmp /= real{d,prec};
+			retval = retval && r == cmp;
+			r.multiply_accumulate(cmp,real{d,prec + 10});
+			cmp += cmp * real{d,prec + 10};
+			retval = retval && r == cmp && r.get_prec() == prec + 10;
+		}
+		return retval;
+	};
+	BOOST_CHECK(checker(rng));
+	// Run the same checks concurrently.
+	std::vector<std::thread> threads;
+	std::vector<char> results(4u,0);
+	for (unsigned i = 0u; i < 4u; ++i) {
+		threads.emplace_back([i,&results,&checker]() {
+			std::mt19937 eng(i);
+			results[i] = checker(eng);
+		});
+	}
+	for (auto &t: threads) {
+		t.join();
+	}
+	BOOST_CHECK(std::all_of(results.begin(),results.end(),[](char c) {return c != 0;}));
+	// Binomial at mixed precisions, interleaved with operations using the scratch floats.
+	const auto b1 = math::binomial(real{"12345.6"},real{"7.89"});
+	BOOST_CHECK_EQUAL(math::binomial(real{"12345.6",500},real{"7.89"}).get_prec(),500);
+	real tmp{1,500};
+	tmp += 1.5;
+	BOOST_CHECK_EQUAL(math::binomial(real{"12345.6"},real{"7.89"}),b1);
+	BOOST_CHECK_EQUAL(b1,real{"5.99111763882803518776029814739451218e27"});
+	BOOST_CHECK_EQUAL(math::binomial(real{"-3",20},real{"-5"}).get_prec(),real::default_prec);
+}
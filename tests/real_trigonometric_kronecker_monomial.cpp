@@ -23,6 +23,7 @@
 #define BOOST_TEST_MODULE real_trigonometric_kronecker_monomial_test
 #include <boost/test/unit_test.hpp>
 
+#include <algorithm>
 #include <array>
 #include <boost/lexical_cast.hpp>
 #include <boost/mpl/for_each.hpp>
@@ -31,10 +32,12 @@
 #include <cstddef>
 #include <initializer_list>
 #include <limits>
+#include <random>
 #include <set>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <tuple>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
@@ -733,6 +736,72 @@ BOOST_AUTO_TEST_CASE(rtkm_multiply_test)
 	boost::mpl::for_each<int_types>(multiply_tester());
 }
 
+struct multiply_packed_tester
+{
+	template <typename T>
+	void operator()(const T &)
+	{
+		using key_type = real_trigonometric_kronecker_monomial<T>;
+		using v_type = typename key_type::v_type;
+		using ka = kronecker_array<T>;
+		using term_type = term<integer,key_type>;
+		const auto &limits = ka::get_limits();
+		std::mt19937 rng;
+		symbol_set vs;
+		for (typename v_type::size_type size = 0u; size < limits.size() && size < 6u; ++size) {
+			if (size) {
+				vs.add(symbol(std::string(1u,static_cast<char>('a' + size - 1u))));
+			}
+			// Half of the smallest limit for the current size.
+			v_type max_v(size,T(0));
+			T half(0);
+			if (size) {
+				const auto &minmax = std::get<0u>(limits[size]);
+				half = static_cast<T>(*std::min_element(minmax.begin(),minmax.begin() + size) / 2);
+				std::fill(max_v.begin(),max_v.end(),half);
+			}
+			BOOST_CHECK(key_type::check_multiply_packed(max_v,max_v));
+			if (half) {
+				// Exceed the limit on the last component.
+				auto max_v2(max_v);
+				max_v2[static_cast<typename v_type::size_type>(size - 1u)] = std::get<0u>(limits[size])[size - 1u];
+				BOOST_CHECK(!key_type::check_multiply_packed(max_v,max_v2));
+				BOOST_CHECK(key_type::check_multiply_packed(v_type(size,T(0)),max_v2));
+			}
+			// Mismatched sizes.
+			BOOST_CHECK(!key_type::check_multiply_packed(max_v,v_type(size + 1u,T(0))));
+			// Random keys, with some zero multipliers to exercise the canonicalisation.
+			std::uniform_int_distribution<long long> dist(-static_cast<long long>(half),static_cast<long long>(half));
+			std::uniform_int_distribution<int> zdist(0,2);
+			auto random_key = [&]() -> key_type {
+				v_type v;
+				for (typename v_type::size_type i = 0u; i < size; ++i) {
+					v.push_back(zdist(rng) == 0 ? T(0) : static_cast<T>(dist(rng)));
+				}
+				key_type retval(v.begin(),v.end());
+				retval.canonicalise(vs);
+				retval.set_flavour(zdist(rng) != 0);
+				return retval;
+			};
+			std::array<term_type,2u> r1, r2;
+			for (int i = 0; i < 1000; ++i) {
+				term_type t1{integer(dist(rng)),random_key()}, t2{integer(dist(rng)),random_key()};
+				key_type::multiply(r1,t1,t2,vs);
+				key_type::multiply_packed(r2,t1,t2,vs);
+				for (std::size_t j = 0u; j < 2u; ++j) {
+					BOOST_CHECK_EQUAL(r1[j].m_cf,r2[j].m_cf);
+					BOOST_CHECK(r1[j].m_key == r2[j].m_key);
+				}
+			}
+		}
+	}
+};
+
+BOOST_AUTO_TEST_CASE(rtkm_multiply_packed_test)
+{
+	boost::mpl::for_each<int_types>(multiply_packed_tester());
+}
+
 struct equality_tester
 {
 	template <typename T>
@@ -24,10 +24,14 @@
 #include <boost/test/unit_test.hpp>
 
 #include <iostream>
+#include <limits>
+#include <string>
 #include <thread>
+#include <vector>
 
 #include "../src/environment.hpp"
 #include "../src/memory.hpp"
+#include "../src/mp_integer.hpp"
 #include "../src/settings.hpp"
 
 using namespace piranha;
@@ -43,6 +47,11 @@ BOOST_AUTO_TEST_CASE(runtime_info_print_test)
 {
 	std::cout << "Concurrency: " << runtime_info::get_hardware_concurrency() << '\n';
 	std::cout << "Cache line size: " << runtime_info::get_cache_line_size() << '\n';
+	std::cout << "NUMA nodes:";
+	for (const auto &n: runtime_info::get_numa_nodes()) {
+		std::cout << ' ' << n;
+	}
+	std::cout << '\n';
 	std::cout << "Memory alignment primitives: " <<
 #if defined(PIRANHA_HAVE_MEMORY_ALIGNMENT_PRIMITIVES)
 		"available\n";
@@ -56,3 +65,51 @@ BOOST_AUTO_TEST_CASE(runtime_info_settings_test)
 	BOOST_CHECK(runtime_info::get_hardware_concurrency() == settings::get_n_threads() || runtime_info::get_hardware_concurrency() == 0u);
 	BOOST_CHECK_EQUAL(runtime_info::get_cache_line_size(),settings::get_cache_line_size());
 }
+
+BOOST_AUTO_TEST_CASE(runtime_info_numa_test)
+{
+#if defined(__linux__)
+	BOOST_CHECK(detail::parse_sys_list("").empty());
+	BOOST_CHECK((detail::parse_sys_list("0") == std::vector<unsigned>{0u}));
+	BOOST_CHECK((detail::parse_sys_list("0-3,8,10-11") == std::vector<unsigned>{0u,1u,2u,3u,8u,10u,11u}));
+	BOOST_CHECK(detail::parse_sys_list("0-a").empty());
+	const auto umax = std::numeric_limits<unsigned>::max();
+	BOOST_CHECK((detail::parse_sys_list(std::to_string(umax - 1u) + "-" + std::to_string(umax)) ==
+		std::vector<unsigned>{umax - 1u,umax}));
+	BOOST_CHECK((detail::parse_sys_list(std::to_string(umax) + "-" + std::to_string(umax)) == std::vector<unsigned>{umax}));
+#endif
+	const auto &nodes = runtime_info::get_numa_nodes();
+	// If the topology is available, each logical processor must be mapped to a node.
+	BOOST_CHECK(nodes.empty() || nodes.size() >= runtime_info::get_hardware_concurrency());
+}
+
+BOOST_AUTO_TEST_CASE(runtime_info_gmp_allocator_test)
+{
+	environment::install_gmp_allocator();
+	const auto n_allocs = runtime_info::get_gmp_allocations(), bytes = runtime_info::get_gmp_bytes();
+	{
+		// The operations in this thread are accounted for exactly.
+		integer n = integer(2).pow(10000);
+		BOOST_CHECK(runtime_info::get_gmp_allocations() > n_allocs);
+		BOOST_CHECK(runtime_info::get_gmp_bytes() >= bytes + 10000u / 8u);
+		BOOST_CHECK(runtime_info::get_gmp_peak_bytes() >= runtime_info::get_gmp_bytes());
+	}
+	BOOST_CHECK_EQUAL(runtime_info::get_gmp_bytes(),bytes);
+	const auto peak = runtime_info::get_gmp_peak_bytes();
+	BOOST_CHECK(peak >= bytes + 10000u / 8u);
+	{
+		// Small values are served from the cache of the thread.
+		const auto n_allocs2 = runtime_info::get_gmp_allocations();
+		for (int i = 0; i < 1000; ++i) {
+			integer n = integer(2).pow(200);
+		}
+		BOOST_CHECK(runtime_info::get_gmp_allocations() >= n_allocs2 + 1000u);
+		BOOST_CHECK_EQUAL(runtime_info::get_gmp_bytes(),bytes);
+		BOOST_CHECK_EQUAL(runtime_info::get_gmp_peak_bytes(),peak);
+	}
+	environment::uninstall_gmp_allocator();
+	// No more statistics collected after the uninstallation.
+	const auto n_allocs3 = runtime_info::get_gmp_allocations();
+	integer n = integer(2).pow(10000);
+	BOOST_CHECK_EQUAL(runtime_info::get_gmp_allocations(),n_allocs3);
+}
@@ -27,6 +27,7 @@
 #include <boost/lexical_cast.hpp>
 #include <boost/mpl/for_each.hpp>
 #include <boost/mpl/vector.hpp>
+#include <functional>
 #include <initializer_list>
 #include <limits>
 #include <sstream>
@@ -36,6 +37,7 @@
 #include <tuple>
 #include <type_traits>
 #include <utility>
+#include <vector>
 
 #include "../src/base_series_multiplier.hpp"
 #include "../src/config.hpp"
@@ -59,6 +61,7 @@
 #include "../src/settings.hpp"
 #include "../src/symbol.hpp"
 #include "../src/symbol_set.hpp"
+#include "../src/tuning.hpp"
 #include "../src/type_traits.hpp"
 
 using namespace piranha;
@@ -1079,6 +1082,228 @@ BOOST_AUTO_TEST_CASE(series_pow_test)
 	p_type3::clear_pow_cache();
 }
 
+BOOST_AUTO_TEST_CASE(series_pow_cache_test)
+{
+	using p_type = g_series_type<integer,int>;
+	p_type::clear_pow_cache();
+	// Compute the powers by repeated multiplication, so that all the intermediate powers are cached.
+	tuning::set_pow_strategy(pow_strategy::multiplication);
+	auto st = p_type::get_pow_cache_stats();
+	BOOST_CHECK_EQUAL(st.hits,0u);
+	BOOST_CHECK_EQUAL(st.misses,0u);
+	BOOST_CHECK_EQUAL(st.evictions,0u);
+	BOOST_CHECK_EQUAL(st.bytes,0u);
+	BOOST_CHECK_EQUAL(st.entries,0u);
+	p_type x{"x"}, y{"y"};
+	BOOST_CHECK_EQUAL((x + 1).pow(4),(x + 1) * (x + 1) * (x + 1) * (x + 1));
+	st = p_type::get_pow_cache_stats();
+	BOOST_CHECK_EQUAL(st.misses,1u);
+	BOOST_CHECK_EQUAL(st.entries,1u);
+	BOOST_CHECK(st.bytes > 0u);
+	BOOST_CHECK_EQUAL((x + 1).pow(3),(x + 1) * (x + 1) * (x + 1));
+	BOOST_CHECK_EQUAL((x + 1).pow(5),(x + 1).pow(4) * (x + 1));
+	st = p_type::get_pow_cache_stats();
+	BOOST_CHECK_EQUAL(st.hits,2u);
+	BOOST_CHECK_EQUAL(st.misses,2u);
+	BOOST_CHECK_EQUAL(st.entries,1u);
+	// Concurrent requests for the same and for different bases.
+	std::vector<std::thread> threads;
+	std::vector<p_type> res(8u);
+	for (unsigned i = 0u; i < 8u; ++i) {
+		threads.emplace_back([i,&res,&x,&y]() {
+			res[i] = (i % 2u) ? (x - y).pow(10) : (x + y + 1).pow(10u - i);
+		});
+	}
+	for (auto &t: threads) {
+		t.join();
+	}
+	for (unsigned i = 0u; i < 8u; ++i) {
+		p_type cmp{1};
+		for (unsigned j = 0u; j < ((i % 2u) ? 10u : 10u - i); ++j) {
+			cmp *= (i % 2u) ? (x - y) : (x + y + 1);
+		}
+		BOOST_CHECK_EQUAL(res[i],cmp);
+	}
+	st = p_type::get_pow_cache_stats();
+	BOOST_CHECK_EQUAL(st.entries,3u);
+	BOOST_CHECK_EQUAL(st.hits + st.misses,12u);
+	// Memory limit: the cache is emptied, and the powers are evicted as soon as they are computed.
+	tuning::set_pow_cache_memory_limit(0u);
+	BOOST_CHECK_EQUAL((x + y).pow(3),(x + y) * (x + y) * (x + y));
+	st = p_type::get_pow_cache_stats();
+	BOOST_CHECK_EQUAL(st.entries,0u);
+	BOOST_CHECK_EQUAL(st.bytes,0u);
+	BOOST_CHECK_EQUAL(st.evictions,4u);
+	BOOST_CHECK_EQUAL((x + y).pow(3),(x + y) * (x + y) * (x + y));
+	BOOST_CHECK_EQUAL(p_type::get_pow_cache_stats().misses,st.misses + 1u);
+	tuning::reset_pow_cache_memory_limit();
+	const auto n_entries = p_type::get_pow_cache_stats().entries;
+	BOOST_CHECK_EQUAL((x + y).pow(3),(x + y) * (x + y) * (x + y));
+	BOOST_CHECK_EQUAL(p_type::get_pow_cache_stats().entries,n_entries + 1u);
+	tuning::reset_pow_strategy();
+	p_type::clear_pow_cache();
+	st = p_type::get_pow_cache_stats();
+	BOOST_CHECK_EQUAL(st.hits,0u);
+	BOOST_CHECK_EQUAL(st.entries,0u);
+	BOOST_CHECK_EQUAL(st.bytes,0u);
+}
+
+BOOST_AUTO_TEST_CASE(series_pow_cache_memory_limit_test)
+{
+	using p_type = g_series_type<integer,int>;
+	tuning::set_pow_strategy(pow_strategy::multiplication);
+	p_type x{"x"}, y{"y"}, z{"z"};
+	const auto b1 = x + y + z + 1, b2 = x - y - z + 2;
+	// Footprints of the powers of the two bases.
+	p_type::clear_pow_cache();
+	b1.pow(10);
+	const auto bytes1 = p_type::get_pow_cache_stats().bytes;
+	p_type::clear_pow_cache();
+	b2.pow(10);
+	const auto bytes2 = p_type::get_pow_cache_stats().bytes;
+	p_type::clear_pow_cache();
+	// A limit which can hold the powers of either base, but not both.
+	tuning::set_pow_cache_memory_limit(std::max(bytes1,bytes2) + std::min(bytes1,bytes2) / 2u);
+	// A base using most of the budget stays in the cache.
+	b1.pow(10);
+	auto st = p_type::get_pow_cache_stats();
+	BOOST_CHECK_EQUAL(st.entries,1u);
+	BOOST_CHECK_EQUAL(st.evictions,0u);
+	BOOST_CHECK_EQUAL(st.bytes,bytes1);
+	// The second base evicts the least recently used one, whichever shard it belongs to.
+	b2.pow(10);
+	st = p_type::get_pow_cache_stats();
+	BOOST_CHECK_EQUAL(st.entries,1u);
+	BOOST_CHECK_EQUAL(st.evictions,1u);
+	BOOST_CHECK_EQUAL(st.bytes,bytes2);
+	BOOST_CHECK_EQUAL(p_type::get_pow_cache_stats().hits,0u);
+	b2.pow(7);
+	BOOST_CHECK_EQUAL(p_type::get_pow_cache_stats().hits,1u);
+	// The powers of the first base must be computed again.
+	const auto n_misses = p_type::get_pow_cache_stats().misses;
+	b1.pow(10);
+	BOOST_CHECK_EQUAL(p_type::get_pow_cache_stats().misses,n_misses + 1u);
+	tuning::reset_pow_cache_memory_limit();
+	tuning::reset_pow_strategy();
+	p_type::clear_pow_cache();
+}
+
+BOOST_AUTO_TEST_CASE(series_pow_strategy_test)
+{
+	using p_type = g_series_type<integer,int>;
+	p_type::clear_pow_cache();
+	p_type x{"x"}, y{"y"}, z{"z"};
+	const auto b = x + y + 1;
+	p_type cmp{1};
+	std::vector<p_type> powers{cmp};
+	for (int i = 0; i < 13; ++i) {
+		cmp *= b;
+		powers.push_back(cmp);
+	}
+	BOOST_CHECK_THROW(x.select_pow_strategy(integer(-1)),std::invalid_argument);
+	BOOST_CHECK(b.select_pow_strategy(integer(3)) == pow_strategy::multiplication);
+	// Forced squaring: the intermediate powers end up in the cache.
+	tuning::set_pow_strategy(pow_strategy::squaring);
+	BOOST_CHECK(b.select_pow_strategy(integer(13)) == pow_strategy::squaring);
+	BOOST_CHECK_EQUAL(b.pow(13),powers[13u]);
+	BOOST_CHECK_EQUAL(p_type::get_pow_cache_stats().misses,1u);
+	BOOST_CHECK_EQUAL(b.pow(12),powers[12u]);
+	BOOST_CHECK_EQUAL(b.pow(6),powers[6u]);
+	BOOST_CHECK_EQUAL(b.pow(3),powers[3u]);
+	BOOST_CHECK_EQUAL(b.pow(2),powers[2u]);
+	BOOST_CHECK_EQUAL(p_type::get_pow_cache_stats().hits,4u);
+	BOOST_CHECK_EQUAL(p_type::get_pow_cache_stats().misses,1u);
+	// Forced multiplication fills the holes left by squaring.
+	tuning::set_pow_strategy(pow_strategy::multiplication);
+	BOOST_CHECK(b.select_pow_strategy(integer(13)) == pow_strategy::multiplication);
+	for (unsigned i = 0u; i <= 13u; ++i) {
+		BOOST_CHECK_EQUAL(b.pow(i),powers[i]);
+	}
+	BOOST_CHECK_EQUAL(b.pow(11),powers[11u]);
+	p_type::clear_pow_cache();
+	BOOST_CHECK_EQUAL(b.pow(13),powers[13u]);
+	// Automatic selection.
+	tuning::reset_pow_strategy();
+	tuning::set_size_estimator(size_estimator::upper_bound);
+	// A single-term base does not grow: squaring is cheaper.
+	BOOST_CHECK(x.select_pow_strategy(integer(100)) == pow_strategy::squaring);
+	BOOST_CHECK_EQUAL((2*x*y).pow(100),math::pow(2_z,100) * x.pow(100) * y.pow(100));
+	// A multivariate base grows quickly: repeated multiplication.
+	const auto b2 = x + y + z + p_type{"t"} + p_type{"u"} + p_type{"v"} + 1;
+	BOOST_CHECK(b2.select_pow_strategy(integer(10)) == pow_strategy::multiplication);
+	// With the previous power in the cache, one multiplication suffices.
+	BOOST_CHECK(b.select_pow_strategy(integer(14)) == pow_strategy::multiplication);
+	tuning::reset_size_estimator();
+	p_type::clear_pow_cache();
+}
+
+struct pow_cache_hasher
+{
+	template <typename T>
+	std::size_t operator()(const T &s) const
+	{
+		return s.hash();
+	}
+};
+
+struct pow_cache_equal_to
+{
+	template <typename T>
+	bool operator()(const T &a, const T &b) const
+	{
+		return a.is_identical(b);
+	}
+};
+
+BOOST_AUTO_TEST_CASE(series_pow_cache_reentrancy_test)
+{
+	using p_type = g_series_type<integer,int>;
+	detail::pow_cache<p_type,p_type,pow_cache_hasher,pow_cache_equal_to> cache;
+	p_type x{"x"}, y{"y"};
+	const auto b = x + y;
+	auto init = []() {return p_type{1};};
+	auto square = [](const p_type &p) {return p * p;};
+	// The computation of a power requests again the powers of the same base on the same thread: the pending
+	// powers must be bypassed rather than waited for.
+	unsigned n_nested = 0u;
+	std::function<p_type(const p_type &)> next = [&](const p_type &p) -> p_type {
+		if (n_nested++ == 1u) {
+			// The first two powers are ready, the others are being computed by this thread.
+			BOOST_CHECK_EQUAL(cache.get(b,4u,pow_strategy::multiplication,init,next,square).get(),b * b * b * b);
+			BOOST_CHECK_EQUAL(cache.get(b,1u,pow_strategy::multiplication,init,next,square).get(),b);
+		}
+		return p * b;
+	};
+	BOOST_CHECK_EQUAL(cache.get(b,3u,pow_strategy::multiplication,init,next,square).get(),b * b * b);
+	// The nested request for the fourth power did not end up in the cache, the nested request for the first one was a hit.
+	BOOST_CHECK_EQUAL(cache.highest_cached(b,10u),3u);
+	BOOST_CHECK_EQUAL(cache.stats().misses,2u);
+	BOOST_CHECK_EQUAL(cache.stats().hits,1u);
+	// The same with squaring.
+	cache.clear();
+	n_nested = 0u;
+	BOOST_CHECK_EQUAL(cache.get(b,3u,pow_strategy::squaring,init,next,square).get(),b * b * b);
+	BOOST_CHECK_EQUAL(cache.highest_cached(b,10u),3u);
+	// Requests from other threads wait for the powers being computed.
+	cache.clear();
+	n_nested = 2u;
+	std::thread t;
+	p_type other;
+	std::function<p_type(const p_type &)> next2 = [&](const p_type &p) -> p_type {
+		if (p.size() == 3u) {
+			t = std::thread([&]() {
+				other = cache.get(b,3u,pow_strategy::multiplication,init,next,square).get();
+			});
+		}
+		return p * b;
+	};
+	BOOST_CHECK_EQUAL(cache.get(b,3u,pow_strategy::multiplication,init,next2,square).get(),b * b * b);
+	t.join();
+	BOOST_CHECK_EQUAL(other,b * b * b);
+	BOOST_CHECK_EQUAL(cache.stats().hits,1u);
+	BOOST_CHECK_EQUAL(cache.stats().misses,1u);
+}
+
 BOOST_AUTO_TEST_CASE(series_is_single_coefficient_test)
 {
 	typedef g_series_type<integer,int> p_type;
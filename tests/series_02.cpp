@@ -1879,6 +1879,19 @@ BOOST_AUTO_TEST_CASE(series_arithmetics_div_test)
 	tmp = 2 * x + y;
 	BOOST_CHECK_THROW(tmp /= 0,zero_division_error);
 	BOOST_CHECK(tmp.empty());
+	tmp = 2 * x + y;
+	BOOST_CHECK_THROW(tmp /= integer{},zero_division_error);
+	BOOST_CHECK(tmp.empty());
+	// Division by powers of two and by negative values, with coefficients in both static and dynamic storage.
+	const integer big = integer(2).pow(200u);
+	tmp = 5 * x - 7 * y + big * x * y - (big + 3) * x * x;
+	BOOST_CHECK_EQUAL(tmp / 2,2 * x - 3 * y + (big / 2) * x * y - (big / 2 + 1) * x * x);
+	BOOST_CHECK_EQUAL(tmp / -2,-2 * x + 3 * y - (big / 2) * x * y + (big / 2 + 1) * x * x);
+	BOOST_CHECK_EQUAL(tmp / integer(-4),-x + y - (big / 4) * x * y + (big / 4) * x * x);
+	BOOST_CHECK_EQUAL(tmp / 3,x - 2 * y + (big / 3) * x * y - ((big + 3) / 3) * x * x);
+	BOOST_CHECK_EQUAL(tmp / integer(-3),-x + 2 * y - (big / 3) * x * y + ((big + 3) / 3) * x * x);
+	BOOST_CHECK_EQUAL(tmp / big,x * y - x * x);
+	BOOST_CHECK_EQUAL(tmp / (big * 2),integer{});
 }
 
 struct eq_tag {};
@@ -48,6 +48,7 @@
 #include "../src/serialization.hpp"
 #include "../src/series.hpp"
 #include "../src/series_multiplier.hpp"
+#include "../src/settings.hpp"
 #include "../src/symbol_set.hpp"
 #include "../src/term.hpp"
 
@@ -279,6 +280,25 @@ BOOST_AUTO_TEST_CASE(subs_series_subs_test)
 	}
 }
 
+BOOST_AUTO_TEST_CASE(subs_series_grouped_subs_test)
+{
+	// Substitutions on larger series, which exercise the grouping by exponent and the tree reduction.
+	using stype = g_series_type<rational,monomial<int>>;
+	stype x{"x"}, y{"y"}, z{"z"};
+	const auto f = math::pow(x + y + z + 1,8), g = math::pow(x/2 - y + 3*z,6) * (x - 1);
+	settings::set_min_work_per_thread(1u);
+	for (unsigned nt = 1u; nt <= 4u; ++nt) {
+		settings::set_n_threads(nt);
+		BOOST_CHECK_EQUAL(f.subs("x",2*z - y),math::pow(3*z + 1,8));
+		BOOST_CHECK_EQUAL(f.subs("x",-3_q),math::pow(y + z - 2,8));
+		BOOST_CHECK_EQUAL(g.subs("x",2*y),math::pow(3*z,6) * (2*y - 1));
+		BOOST_CHECK_EQUAL(g.subs("t",2*y),g);
+		BOOST_CHECK_EQUAL(stype{}.subs("x",y),0);
+	}
+	settings::reset_n_threads();
+	settings::reset_min_work_per_thread();
+}
+
 BOOST_AUTO_TEST_CASE(subs_series_serialization_test)
 {
 	using stype = g_series_type<rational,monomial<int>>;
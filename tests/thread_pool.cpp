@@ -24,9 +24,12 @@
 #include <boost/test/unit_test.hpp>
 
 #include <algorithm>
+#include <atomic>
 #include <boost/integer_traits.hpp>
 #include <chrono>
+#include <future>
 #include <list>
+#include <numeric>
 #include <stdexcept>
 #include <thread>
 #include <utility>
@@ -276,8 +279,8 @@ BOOST_AUTO_TEST_CASE(thread_pool_use_threads_test)
 	auto f3 = thread_pool::enqueue(0u,[]() {
 		return thread_pool::use_threads(100u,0u);
 	});
-	BOOST_CHECK_EQUAL(f1.get(),1u);
-	BOOST_CHECK_EQUAL(f2.get(),1u);
+	BOOST_CHECK_EQUAL(f1.get(),4u);
+	BOOST_CHECK_EQUAL(f2.get(),4u);
 	BOOST_CHECK_THROW(f3.get(),std::invalid_argument);
 	thread_pool::resize(1u);
 	BOOST_CHECK(thread_pool::use_threads(100u,3u) == 1u);
@@ -308,7 +311,172 @@ BOOST_AUTO_TEST_CASE(thread_pool_use_threads_test)
 	auto f9 = thread_pool::enqueue(0u,[]() {
 		return thread_pool::use_threads(integer(100u),integer(0u));
 	});
-	BOOST_CHECK_EQUAL(f7.get(),1u);
-	BOOST_CHECK_EQUAL(f8.get(),1u);
+	BOOST_CHECK_EQUAL(f7.get(),4u);
+	BOOST_CHECK_EQUAL(f8.get(),4u);
 	BOOST_CHECK_THROW(f9.get(),std::invalid_argument);
 }
+
+// Recursive parallel sum of the integers in [a,b[, nesting parallel regions down to a given depth.
+static unsigned long nested_sum(unsigned long a, unsigned long b, unsigned depth)
+{
+	if (depth == 0u || b - a < 2u) {
+		unsigned long retval = 0u;
+		for (; a < b; ++a) {
+			retval += a;
+		}
+		return retval;
+	}
+	const unsigned n_threads = thread_pool::use_threads(b - a,1ul);
+	std::vector<unsigned long> partials(n_threads,0u);
+	future_list<std::future<void>> ff_list;
+	const auto block = (b - a) / n_threads;
+	for (unsigned i = 0u; i < n_threads; ++i) {
+		const auto start = a + i * block, end = (i == n_threads - 1u) ? b : start + block;
+		ff_list.push_back(thread_pool::enqueue_task(i,[&partials,i,start,end,depth]() {
+			partials[i] = nested_sum(start,end,depth - 1u);
+		}));
+	}
+	ff_list.wait_all();
+	ff_list.get_all();
+	return std::accumulate(partials.begin(),partials.end(),0ul);
+}
+
+BOOST_AUTO_TEST_CASE(thread_pool_nested_test)
+{
+	for (unsigned size = 1u; size <= 4u; ++size) {
+		thread_pool::resize(size);
+		// Nested parallel regions started from the main thread.
+		BOOST_CHECK_EQUAL(nested_sum(0u,10000u,3u),49995000ul);
+		// Nested parallel regions started from threads in the pool.
+		auto f1 = thread_pool::enqueue(0u,nested_sum,0ul,10000ul,3u);
+		BOOST_CHECK_EQUAL(f1.get(),49995000ul);
+		// Concurrent parallel regions started from threads outside the pool.
+		std::vector<unsigned long> res(4u,0u);
+		std::vector<unsigned> n_threads(4u,0u);
+		std::vector<std::thread> threads;
+		for (unsigned i = 0u; i < 4u; ++i) {
+			threads.emplace_back([&res,&n_threads,i]() {
+				n_threads[i] = thread_pool::use_threads(100u,1u);
+				res[i] = nested_sum(0u,1000u * (i + 1u),2u);
+			});
+		}
+		for (auto &t: threads) {
+			t.join();
+		}
+		for (unsigned i = 0u; i < 4u; ++i) {
+			const unsigned long n = 1000u * (i + 1u);
+			BOOST_CHECK_EQUAL(res[i],n * (n - 1u) / 2u);
+			BOOST_CHECK_EQUAL(n_threads[i],size);
+		}
+	}
+	thread_pool::resize(runtime_info::get_hardware_concurrency() ? runtime_info::get_hardware_concurrency() : 1u);
+}
+
+BOOST_AUTO_TEST_CASE(thread_pool_parallel_invoke_test)
+{
+	for (unsigned size = 1u; size <= 4u; ++size) {
+		thread_pool::resize(size);
+		BOOST_CHECK_THROW(thread_pool::parallel_invoke(0u,[](unsigned) {}),std::invalid_argument);
+		BOOST_CHECK_THROW(thread_pool::parallel_invoke(size + 1u,[](unsigned) {}),std::invalid_argument);
+		// Each task writes its own slot.
+		for (unsigned n = 1u; n <= size; ++n) {
+			std::vector<unsigned> v(n,0u);
+			// Repeat a few times in order to exercise the reuse of the task objects.
+			for (int k = 0; k < 100; ++k) {
+				thread_pool::parallel_invoke(n,[&v](unsigned i) {v[i] += i + 1u;});
+			}
+			for (unsigned i = 0u; i < n; ++i) {
+				BOOST_CHECK_EQUAL(v[i],100u * (i + 1u));
+			}
+		}
+		// Exceptions are re-thrown after all the tasks are completed.
+		std::atomic<unsigned> counter(0u);
+		BOOST_CHECK_THROW(thread_pool::parallel_invoke(size,[&counter](unsigned i) {
+			++counter;
+			if (i == 0u) {
+				throw std::runtime_error("");
+			}
+		}),std::runtime_error);
+		BOOST_CHECK_EQUAL(counter.load(),size);
+		// Const and mutable callables.
+		std::atomic<unsigned> c_counter(0u);
+		const auto c_func = [&c_counter](unsigned) {++c_counter;};
+		thread_pool::parallel_invoke(size,c_func);
+		BOOST_CHECK_EQUAL(c_counter.load(),size);
+		std::vector<unsigned> m_v(size,0u);
+		auto m_func = [&m_v](unsigned i) mutable {m_v[i] = i + 1u;};
+		thread_pool::parallel_invoke(size,m_func);
+		BOOST_CHECK_EQUAL(std::accumulate(m_v.begin(),m_v.end(),0u),size * (size + 1u) / 2u);
+		// Nesting, from the main thread and from the pool.
+		auto nested = [size]() {
+			std::atomic<unsigned> c(0u);
+			thread_pool::parallel_invoke(size,[&c,size](unsigned) {
+				thread_pool::parallel_invoke(size,[&c](unsigned) {++c;});
+			});
+			return c.load();
+		};
+		BOOST_CHECK_EQUAL(nested(),size * size);
+		BOOST_CHECK_EQUAL(thread_pool::enqueue(0u,nested).get(),size * size);
+	}
+	thread_pool::resize(runtime_info::get_hardware_concurrency() ? runtime_info::get_hardware_concurrency() : 1u);
+}
+
+BOOST_AUTO_TEST_CASE(thread_pool_region_test)
+{
+	thread_pool::resize(1u);
+	// Keep the only thread in the pool busy, and queue behind it a task unrelated to the parallel regions below.
+	std::atomic<bool> go(false);
+	auto blocker = thread_pool::enqueue(0u,[&go]() {
+		while (!go.load()) {
+			std::this_thread::yield();
+		}
+	});
+	auto foreign = thread_pool::enqueue(0u,[]() {return std::this_thread::get_id();});
+	// The waiting thread must run its own tasks, and only those.
+	std::vector<std::thread::id> ids(2u);
+	future_list<std::future<void>> ff_list;
+	ff_list.push_back(thread_pool::enqueue_task(0u,[&ids]() {ids[0u] = std::this_thread::get_id();}));
+	ff_list.wait_all();
+	ff_list.get_all();
+	thread_pool::parallel_invoke(1u,[&ids](unsigned) {ids[1u] = std::this_thread::get_id();});
+	BOOST_CHECK(ids[0u] == std::this_thread::get_id());
+	BOOST_CHECK(ids[1u] == std::this_thread::get_id());
+	// The tasks are paired with their own futures, whatever the order of insertion.
+	std::vector<std::thread::id> ids2(2u);
+	auto t1 = thread_pool::enqueue_task(0u,[&ids2]() {ids2[0u] = std::this_thread::get_id();});
+	auto t2 = thread_pool::enqueue_task(0u,[&ids2]() {ids2[1u] = std::this_thread::get_id();});
+	future_list<std::future<void>> l1, l2;
+	l2.push_back(std::move(t2));
+	l1.push_back(std::move(t1));
+	l1.wait_all();
+	BOOST_CHECK(ids2[0u] == std::this_thread::get_id());
+	BOOST_CHECK(ids2[1u] == std::thread::id());
+	l2.wait_all();
+	BOOST_CHECK(ids2[1u] == std::this_thread::get_id());
+	BOOST_CHECK(foreign.wait_for(std::chrono::milliseconds(0)) != std::future_status::ready);
+	go.store(true);
+	blocker.get();
+	BOOST_CHECK(foreign.get() != std::this_thread::get_id());
+	thread_pool::resize(runtime_info::get_hardware_concurrency() ? runtime_info::get_hardware_concurrency() : 1u);
+}
+
+BOOST_AUTO_TEST_CASE(thread_pool_task_queue_producers_test)
+{
+	// Several threads submitting concurrently to the same queue.
+	std::atomic<unsigned> counter(0u);
+	{
+	detail::task_queue tq(0);
+	std::vector<std::thread> threads;
+	for (unsigned i = 0u; i < 4u; ++i) {
+		threads.emplace_back([&tq,&counter]() {
+			for (int j = 0; j < 10000; ++j) {
+				tq.enqueue([&counter]() {++counter;});
+			}
+		});
+	}
+	for (auto &t: threads) {
+		t.join();
+	}
+	}
+	BOOST_CHECK_EQUAL(counter.load(),40000u);
+}
@@ -23,6 +23,7 @@
 #define BOOST_TEST_MODULE tuning_test
 #include <boost/test/unit_test.hpp>
 
+#include <limits>
 #include <stdexcept>
 #include <thread>
 
@@ -69,3 +70,97 @@ BOOST_AUTO_TEST_CASE(tuning_block_size_test)
 	tuning::reset_multiplication_block_size();
 	BOOST_CHECK_EQUAL(tuning::get_multiplication_block_size(),256u);
 }
+
+BOOST_AUTO_TEST_CASE(tuning_size_estimator_test)
+{
+	BOOST_CHECK(tuning::get_size_estimator() == size_estimator::first_duplicate);
+	tuning::set_size_estimator(size_estimator::distinct_count);
+	BOOST_CHECK(tuning::get_size_estimator() == size_estimator::distinct_count);
+	std::thread t1([](){
+		while (tuning::get_size_estimator() != size_estimator::upper_bound) {}
+	});
+	std::thread t2([](){
+		tuning::set_size_estimator(size_estimator::upper_bound);
+	});
+	t1.join();
+	t2.join();
+	BOOST_CHECK_THROW(tuning::set_size_estimator(static_cast<size_estimator>(42)),std::invalid_argument);
+	BOOST_CHECK(tuning::get_size_estimator() == size_estimator::upper_bound);
+	tuning::reset_size_estimator();
+	BOOST_CHECK(tuning::get_size_estimator() == size_estimator::first_duplicate);
+}
+
+BOOST_AUTO_TEST_CASE(tuning_size_estimation_hook_test)
+{
+	BOOST_CHECK(!tuning::get_size_estimation_hook());
+	std::size_t n_calls = 0u;
+	tuning::set_size_estimation_hook([&n_calls](const size_estimation_record &r) {
+		n_calls += r.actual;
+	});
+	auto hook = tuning::get_size_estimation_hook();
+	BOOST_CHECK(hook);
+	hook(size_estimation_record{size_estimator::first_duplicate,1u,2u,3u,4u,0.});
+	BOOST_CHECK_EQUAL(n_calls,4u);
+	tuning::set_size_estimation_hook(nullptr);
+	BOOST_CHECK(!tuning::get_size_estimation_hook());
+	tuning::set_size_estimation_hook(hook);
+	BOOST_CHECK(tuning::get_size_estimation_hook());
+	tuning::reset_size_estimation_hook();
+	BOOST_CHECK(!tuning::get_size_estimation_hook());
+}
+
+BOOST_AUTO_TEST_CASE(tuning_integer_multiplication_test)
+{
+	BOOST_CHECK(tuning::get_integer_multiplication() == integer_multiplication::standard);
+	tuning::set_integer_multiplication(integer_multiplication::multi_modular);
+	BOOST_CHECK(tuning::get_integer_multiplication() == integer_multiplication::multi_modular);
+	std::thread t1([](){
+		while (tuning::get_integer_multiplication() != integer_multiplication::standard) {}
+	});
+	std::thread t2([](){
+		tuning::set_integer_multiplication(integer_multiplication::standard);
+	});
+	t1.join();
+	t2.join();
+	tuning::set_integer_multiplication(integer_multiplication::multi_modular);
+	BOOST_CHECK_THROW(tuning::set_integer_multiplication(static_cast<integer_multiplication>(42)),std::invalid_argument);
+	BOOST_CHECK(tuning::get_integer_multiplication() == integer_multiplication::multi_modular);
+	tuning::reset_integer_multiplication();
+	BOOST_CHECK(tuning::get_integer_multiplication() == integer_multiplication::standard);
+}
+
+BOOST_AUTO_TEST_CASE(tuning_pow_cache_memory_limit_test)
+{
+	BOOST_CHECK_EQUAL(tuning::get_pow_cache_memory_limit(),std::numeric_limits<unsigned long long>::max());
+	tuning::set_pow_cache_memory_limit(1024u);
+	BOOST_CHECK_EQUAL(tuning::get_pow_cache_memory_limit(),1024u);
+	std::thread t1([](){
+		while (tuning::get_pow_cache_memory_limit() != 0u) {}
+	});
+	std::thread t2([](){
+		tuning::set_pow_cache_memory_limit(0u);
+	});
+	t1.join();
+	t2.join();
+	tuning::reset_pow_cache_memory_limit();
+	BOOST_CHECK_EQUAL(tuning::get_pow_cache_memory_limit(),std::numeric_limits<unsigned long long>::max());
+}
+
+BOOST_AUTO_TEST_CASE(tuning_pow_strategy_test)
+{
+	BOOST_CHECK(tuning::get_pow_strategy() == pow_strategy::automatic);
+	tuning::set_pow_strategy(pow_strategy::squaring);
+	BOOST_CHECK(tuning::get_pow_strategy() == pow_strategy::squaring);
+	std::thread t1([](){
+		while (tuning::get_pow_strategy() != pow_strategy::multiplication) {}
+	});
+	std::thread t2([](){
+		tuning::set_pow_strategy(pow_strategy::multiplication);
+	});
+	t1.join();
+	t2.join();
+	BOOST_CHECK_THROW(tuning::set_pow_strategy(static_cast<pow_strategy>(42)),std::invalid_argument);
+	BOOST_CHECK(tuning::get_pow_strategy() == pow_strategy::multiplication);
+	tuning::reset_pow_strategy();
+	BOOST_CHECK(tuning::get_pow_strategy() == pow_strategy::automatic);
+}